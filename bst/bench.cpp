@@ -0,0 +1,1751 @@
+/**
+	@file bench.cpp
+
+	@brief Benchmark delle classi di alberi binari di ricerca
+*/
+
+// Direttive per il pre-compilatore
+
+#include <iostream> // std::cout, std::endl
+#include <iomanip> // std::setw, std::setprecision
+#include <cstdlib> // std::atoi
+#include <cstddef> // std::size_t
+#include <vector> // std::vector
+#include <algorithm> // std::upper_bound
+#include <cmath> // std::pow
+#include <string> // std::string
+#include <random> // std::mt19937
+#include <chrono> // std::chrono::steady_clock
+#include "bst.h" // binary_search_tree
+#include "bsttypes.h" // funtori di confronto, complex
+#include "bstcompact.h" // compact_binary_search_tree
+#include "bstmap.h" // bst_map
+#include "bstsplay.h" // splay_tree
+#include "bstbloom.h" // filtered_binary_search_tree
+#include "bststatic.h" // static_binary_search_tree
+#include "bstsharded.h" // sharded_bst
+#include "bstinterval.h" // interval_tree
+#include "bstkd.h" // kd_tree
+#include "bststring.h" // string_binary_search_tree
+#include <thread> // std::thread
+#include "bstjournal.h" // journaled_bst
+#include <cstdio> // std::remove
+#include "bstpaged.h" // paged_binary_search_tree
+#include "bstsnapshot.h" // compressed_int_snapshot
+#include "bstlatency.h" // timed_binary_search_tree
+#include <mutex> // std::mutex, std::lock_guard
+#include <queue> // std::priority_queue
+#include <set> // std::set
+#include <functional> // std::greater
+#include "bstmerge.h" // merge_iterator
+#include <memory> // std::unique_ptr
+#include "bstloader.h" // bst_load, bst_int_parser, bst_record_parser
+#include "bsttrace.h" // recording_binary_search_tree, bst_trace_reader
+#include "bstmultiset.h" // bst_multiset
+#include "bstlru.h" // bst_lru_cache
+
+/**
+	@brief Cronometro
+
+	Struttura di supporto che misura il tempo trascorso
+	dalla sua costruzione.
+*/
+struct stopwatch {
+	std::chrono::steady_clock::time_point start; ///< istante di partenza
+
+	/**
+		@brief Costruttore
+
+		Costruttore che fa partire il cronometro.
+	*/
+	stopwatch() : start(std::chrono::steady_clock::now()) {} // initialization list
+
+	/**
+		@brief Tempo trascorso
+
+		Ritorna il tempo trascorso dalla partenza del cronometro.
+
+		@return tempo trascorso in nanosecondi
+	*/
+	double elapsed_ns() const {
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+/**
+	@brief Nodo di binary_search_tree
+
+	Struttura con la stessa disposizione in memoria del nodo
+	di binary_search_tree, usata per calcolarne la dimensione.
+
+	@param T tipo dei dati
+*/
+template <typename T>
+struct pointer_node {
+	T value; ///< dato
+	void *left; ///< figlio sinistro
+	void *right; ///< figlio destro
+	void *parent; ///< padre
+};
+
+/**
+	@brief Stampa di una riga del benchmark
+
+	Stampa il nome della misura seguito dal suo valore.
+
+	@param name nome della misura
+	@param value valore della misura
+	@param unit unita' di misura
+*/
+void report(const std::string &name, double value, const std::string &unit) {
+	std::cout << "  " << std::left << std::setw(48) << name << std::right
+			  << std::setw(12) << std::fixed << std::setprecision(2) << value
+			  << " " << unit << std::endl;
+}
+
+/**
+	@brief Valori casuali distinti
+
+	Genera n valori casuali distinti a partire da un generatore.
+
+	@param n numero di valori da generare
+	@param seed seme del generatore
+
+	@return vettore di n valori interi distinti in ordine casuale
+*/
+std::vector<int> distinct_random_ints(std::size_t n, unsigned int seed) {
+	std::vector<int> values(n);
+	for(std::size_t i = 0; i < n; ++i)
+		values[i] = static_cast<int>(i * 2);
+
+	std::mt19937 gen(seed);
+	for(std::size_t i = n; i > 1; --i)
+		std::swap(values[i - 1], values[gen() % i]);
+
+	return values;
+}
+
+/**
+	@brief Memoria per elemento di un albero compatto
+
+	Inserisce n valori in un albero compatto e ne stampa i byte
+	per elemento.
+
+	@param name nome della configurazione
+	@param values valori da inserire
+*/
+template <typename tree, typename T>
+void bench_compact_memory(const std::string &name, const std::vector<T> &values) {
+	tree t;
+	t.reserve(static_cast<unsigned int>(values.size()));
+	for(std::size_t i = 0; i < values.size(); ++i)
+		t.insert(values[i]);
+
+	report(name + " (byte/elemento)", static_cast<double>(t.memory_usage()) / t.size(), "B");
+}
+
+/**
+	@brief Benchmark della rappresentazione compatta dei nodi
+
+	Confronta i byte per elemento di binary_search_tree e di
+	compact_binary_search_tree, con e senza l'indice del nodo padre,
+	per dati int, float e complex, e il tempo di ricerca.
+
+	@param n numero di elementi
+*/
+void bench_compact(std::size_t n) {
+	std::cout << "== Rappresentazione compatta dei nodi (n = " << n << ") ==" << std::endl;
+
+	report("binary_search_tree<int> (sizeof nodo)", sizeof(pointer_node<int>), "B");
+	report("binary_search_tree<float> (sizeof nodo)", sizeof(pointer_node<float>), "B");
+	report("binary_search_tree<complex> (sizeof nodo)", sizeof(pointer_node<complex>), "B");
+
+	std::vector<int> ints = distinct_random_ints(n, 1);
+	std::vector<float> floats(ints.begin(), ints.end());
+	std::vector<complex> complexes;
+	for(std::size_t i = 0; i < n; ++i)
+		complexes.push_back(complex(ints[i], -ints[i]));
+
+	bench_compact_memory<compact_binary_search_tree<int, compare_int, equal_int, true> >("compact<int>, con padre", ints);
+	bench_compact_memory<compact_binary_search_tree<int, compare_int, equal_int, false> >("compact<int>, senza padre", ints);
+	bench_compact_memory<compact_binary_search_tree<float, compare_float, equal_float, true> >("compact<float>, con padre", floats);
+	bench_compact_memory<compact_binary_search_tree<float, compare_float, equal_float, false> >("compact<float>, senza padre", floats);
+	bench_compact_memory<compact_binary_search_tree<complex, compare_complex, equal_complex, true> >("compact<complex>, con padre", complexes);
+	bench_compact_memory<compact_binary_search_tree<complex, compare_complex, equal_complex, false> >("compact<complex>, senza padre", complexes);
+
+	bst_int tree;
+	compact_binary_search_tree<int, compare_int, equal_int, false> compact_tree;
+	for(std::size_t i = 0; i < n; ++i) {
+		tree.insert(ints[i]);
+		compact_tree.insert(ints[i]);
+	}
+
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += tree.exists(static_cast<int>(i));
+	report("binary_search_tree<int>::exists", sw.elapsed_ns() / n, "ns/op");
+
+	stopwatch csw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += compact_tree.exists(static_cast<int>(i));
+	report("compact<int>, senza padre::exists", csw.elapsed_ns() / n, "ns/op");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Record con un carico utile voluminoso
+
+	Struttura di supporto che rappresenta un record identificato
+	da una chiave intera e con un carico utile di 256 byte.
+*/
+struct record {
+	int key; ///< chiave del record
+	char payload[252]; ///< carico utile del record
+
+	/**
+		@brief Costruttore
+
+		Costruttore che prende la chiave del record.
+
+		@param k chiave del record
+	*/
+	record(int k) : key(k) {} // initialization list
+};
+
+/**
+	@brief Funtore per il confronto tra record
+
+	Funtore per il confronto tra record sulla base della chiave.
+*/
+struct compare_record {
+	bool operator()(const record &a, const record &b) const {
+		return a.key < b.key;
+	}
+};
+
+/**
+	@brief Funtore per l'uguaglianza tra record
+
+	Funtore per l'uguaglianza tra record sulla base della chiave.
+*/
+struct equal_record {
+	bool operator()(const record &a, const record &b) const {
+		return a.key == b.key;
+	}
+};
+
+/**
+	@brief Benchmark della mappa con chiavi separate dai valori
+
+	Confronta il tempo di ricerca in un albero di record da 256 byte
+	con quello in una bst_map che separa le chiavi dai record.
+
+	@param n numero di elementi
+*/
+void bench_map(std::size_t n) {
+	std::cout << "== Chiavi separate dai valori (n = " << n << ", record da "
+			  << sizeof(record) << " byte) ==" << std::endl;
+
+	std::vector<int> keys = distinct_random_ints(n, 2);
+
+	binary_search_tree<record, compare_record, equal_record> records;
+	bst_map<int, record, compare_int, equal_int> map;
+	for(std::size_t i = 0; i < n; ++i)
+		records.insert(record(keys[i]));
+	for(std::size_t i = 0; i < n; ++i)
+		map.try_emplace(keys[i], keys[i]);
+
+	std::vector<int> queries = distinct_random_ints(n, 3);
+
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += records.exists(record(queries[i]));
+	report("binary_search_tree<record>::exists", sw.elapsed_ns() / n, "ns/op");
+
+	stopwatch msw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += map.find(queries[i]) != nullptr;
+	report("bst_map<int, record>::find", msw.elapsed_ns() / n, "ns/op");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Benchmark delle ricerche a gruppi
+
+	Confronta il throughput di exists chiamato in un ciclo con quello
+	di exists_batch, che interlaccia le ricerche con prefetch software.
+	Per n dell'ordine di 1e6 o superiore l'albero non sta nella cache
+	di ultimo livello.
+
+	@param n numero di elementi
+*/
+void bench_batch(std::size_t n) {
+	std::cout << "== Ricerche a gruppi (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> keys = distinct_random_ints(n, 4);
+	bst_int tree;
+	for(std::size_t i = 0; i < n; ++i)
+		tree.insert(keys[i]);
+
+	std::vector<int> queries = distinct_random_ints(n, 5);
+	for(std::size_t i = 0; i < n; i += 2)
+		queries[i]++; // meta' delle ricerche fallisce
+
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += tree.exists(queries[i]);
+	report("exists in un ciclo", n / (sw.elapsed_ns() / 1e3), "Mop/s");
+
+	std::vector<char> results(n);
+	stopwatch bsw;
+	tree.exists_batch(queries.begin(), queries.end(), results.begin());
+	report("exists_batch", n / (bsw.elapsed_ns() / 1e3), "Mop/s");
+	for(std::size_t i = 0; i < n; ++i)
+		found += results[i];
+
+	std::vector<bst_int::const_iterator> iterators(n);
+	stopwatch fsw;
+	tree.find_batch(queries.begin(), queries.end(), iterators.begin());
+	report("find_batch", n / (fsw.elapsed_ns() / 1e3), "Mop/s");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Benchmark degli inserimenti a gruppi
+
+	Confronta l'inserimento in un albero gia' popolato di una sequenza
+	con il 10% di duplicati, eseguito con insert (catturando
+	l'eccezione di ogni duplicato) e con insert_batch.
+
+	@param n numero di elementi dell'albero e della sequenza
+*/
+void bench_insert_batch(std::size_t n) {
+	std::cout << "== Inserimenti a gruppi (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> keys = distinct_random_ints(2 * n, 6);
+	std::vector<int> initial(keys.begin(), keys.begin() + n);
+	std::vector<int> batch(keys.begin() + n, keys.end());
+	for(std::size_t i = 0; i < n; i += 10)
+		batch[i] = initial[i]; // 10% di duplicati
+
+	bst_int tree;
+	tree.insert_batch(initial.begin(), initial.end());
+	bst_int batch_tree(tree);
+
+	std::size_t rejected = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		try {
+			tree.insert(batch[i]);
+		}
+		catch(bst_duplicated_value_exception<int> &) {
+			rejected++;
+		}
+	report("insert con try/catch", sw.elapsed_ns() / n, "ns/elemento");
+
+	stopwatch bsw;
+	rejected += batch_tree.insert_batch(batch.begin(), batch.end());
+	report("insert_batch", bsw.elapsed_ns() / n, "ns/elemento");
+
+	std::cout << "  (scartati: " << rejected << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Benchmark degli inserimenti con suggerimento di posizione
+
+	Inserisce un flusso di chiavi simili a timestamp (crescenti a meno
+	di piccole oscillazioni) con il 30% di duplicati, usando insert
+	con try/catch, try_insert e try_insert con suggerimento
+	(l'iteratore all'ultimo elemento inserito).
+
+	@param n numero di chiavi del flusso
+*/
+void bench_try_insert(std::size_t n) {
+	std::cout << "== Inserimenti con suggerimento, timestamp con 30% di duplicati (n = " << n << ") ==" << std::endl;
+
+	std::mt19937 gen(7);
+	std::vector<int> stream(n);
+	for(std::size_t i = 0; i < n; ++i)
+		if(i > 16 && gen() % 10 < 3)
+			stream[i] = stream[i - 1 - gen() % 16];
+		else
+			stream[i] = static_cast<int>(i * 4 + gen() % 8);
+
+	std::size_t rejected = 0;
+	bst_int tree;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		try {
+			tree.insert(stream[i]);
+		}
+		catch(bst_duplicated_value_exception<int> &) {
+			rejected++;
+		}
+	report("insert con try/catch", sw.elapsed_ns() / n, "ns/op");
+
+	bst_int try_tree;
+	stopwatch tsw;
+	for(std::size_t i = 0; i < n; ++i)
+		rejected += !try_tree.try_insert(stream[i]).second;
+	report("try_insert", tsw.elapsed_ns() / n, "ns/op");
+
+	bst_int hint_tree;
+	bst_int::const_iterator hint = hint_tree.end();
+	stopwatch hsw;
+	for(std::size_t i = 0; i < n; ++i) {
+		std::pair<bst_int::const_iterator, bool> result = hint_tree.try_insert(hint, stream[i]);
+		if(result.second)
+			hint = result.first;
+		else
+			rejected++;
+	}
+	report("try_insert con suggerimento", hsw.elapsed_ns() / n, "ns/op");
+
+	std::cout << "  (scartati: " << rejected << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Valori con distribuzione di Zipf
+
+	Genera n valori scelti tra quelli di keys con distribuzione di Zipf
+	di parametro s: il valore di rango k viene scelto con probabilita'
+	proporzionale a 1 / k^s. Il rango dei valori e' casuale.
+
+	@param keys valori tra cui scegliere
+	@param n numero di valori da generare
+	@param s parametro della distribuzione
+	@param seed seme del generatore
+
+	@return vettore di n valori scelti da keys
+*/
+std::vector<int> zipf_ints(const std::vector<int> &keys, std::size_t n, double s, unsigned int seed) {
+	std::vector<double> cdf(keys.size());
+	double sum = 0;
+	for(std::size_t k = 0; k < keys.size(); ++k) {
+		sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+		cdf[k] = sum;
+	}
+
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<double> uniform(0, sum);
+	std::vector<int> values(n);
+	for(std::size_t i = 0; i < n; ++i) {
+		std::size_t k = std::upper_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin();
+		values[i] = keys[k < keys.size() ? k : keys.size() - 1];
+	}
+
+	return values;
+}
+
+/**
+	@brief Tempo medio di ricerca
+
+	Misura il tempo medio di exists su una sequenza di valori.
+
+	@param tree albero in cui cercare
+	@param queries valori da cercare
+
+	@return tempo medio di una ricerca in nanosecondi
+*/
+template <typename tree>
+double exists_ns(tree &t, const std::vector<int> &queries) {
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < queries.size(); ++i)
+		found += t.exists(queries[i]);
+	double ns = sw.elapsed_ns() / queries.size();
+	if(found != queries.size())
+		std::cout << "  errore: trovati " << found << " valori su " << queries.size() << std::endl;
+	return ns;
+}
+
+/**
+	@brief Benchmark dello splay tree
+
+	Confronta il tempo di ricerca in un binary_search_tree costruito
+	in ordine casuale, in uno bilanciato (costruito con insert_batch)
+	e in uno splay_tree, con ricerche uniformi e con distribuzione
+	di Zipf (s = 1 e s = 1.5).
+
+	@param n numero di elementi
+*/
+void bench_splay(std::size_t n) {
+	std::cout << "== Splay tree (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> keys = distinct_random_ints(n, 8);
+
+	bst_int tree;
+	for(std::size_t i = 0; i < n; ++i)
+		tree.insert(keys[i]);
+	bst_int balanced;
+	balanced.insert_batch(keys.begin(), keys.end());
+	splay_tree<int, compare_int, equal_int> splay;
+	for(std::size_t i = 0; i < n; ++i)
+		splay.insert(keys[i]);
+
+	std::vector<int> uniform = distinct_random_ints(n, 9);
+	for(std::size_t i = 0; i < n; ++i)
+		uniform[i] = keys[uniform[i] / 2];
+	std::vector<int> skewed = zipf_ints(keys, n, 1.0, 10);
+	std::vector<int> hot = zipf_ints(keys, n, 1.5, 11);
+
+	report("binary_search_tree, uniforme", exists_ns(tree, uniform), "ns/op");
+	report("binary_search_tree bilanciato, uniforme", exists_ns(balanced, uniform), "ns/op");
+	report("splay_tree, uniforme", exists_ns(splay, uniform), "ns/op");
+	report("binary_search_tree, Zipf s = 1", exists_ns(tree, skewed), "ns/op");
+	report("binary_search_tree bilanciato, Zipf s = 1", exists_ns(balanced, skewed), "ns/op");
+	report("splay_tree, Zipf s = 1", exists_ns(splay, skewed), "ns/op");
+	report("binary_search_tree, Zipf s = 1.5", exists_ns(tree, hot), "ns/op");
+	report("binary_search_tree bilanciato, Zipf s = 1.5", exists_ns(balanced, hot), "ns/op");
+	report("splay_tree, Zipf s = 1.5", exists_ns(splay, hot), "ns/op");
+
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark del filtro di Bloom
+
+	Confronta exists su un binary_search_tree e su un
+	filtered_binary_search_tree (1% di falsi positivi) con ricerche
+	che nel 90% dei casi non trovano il valore.
+
+	@param n numero di elementi
+*/
+void bench_bloom(std::size_t n) {
+	std::cout << "== Filtro di Bloom, 90% di ricerche fallite (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> keys = distinct_random_ints(n, 12);
+	bst_int tree;
+	filtered_binary_search_tree<int, compare_int, equal_int, hash_int> filtered(0.01);
+	for(std::size_t i = 0; i < n; ++i) {
+		tree.insert(keys[i]);
+		filtered.insert(keys[i]);
+	}
+
+	std::vector<int> queries = distinct_random_ints(n, 13);
+	for(std::size_t i = 0; i < n; ++i)
+		if(i % 10 != 0)
+			queries[i]++; // i valori dispari non sono presenti
+
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += tree.exists(queries[i]);
+	report("binary_search_tree::exists", sw.elapsed_ns() / n, "ns/op");
+
+	stopwatch fsw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += filtered.exists(queries[i]);
+	report("filtered_binary_search_tree::exists", fsw.elapsed_ns() / n, "ns/op");
+
+	bst_filter_stats stats = filtered.filter_stats();
+	report("ricerche concluse dal filtro", 100.0 * stats.filtered / stats.queries, "%");
+	report("falsi positivi sulle ricerche fallite", 100.0 * stats.false_positives / (stats.filtered + stats.false_positives), "%");
+	report("memoria del filtro", static_cast<double>(filtered.filter_memory()) / n, "B/elemento");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Tabella costante del benchmark degli alberi statici
+*/
+constexpr int static_table[] = {
+	0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45,
+	48, 51, 54, 57, 60, 63, 66, 69, 72, 75, 78, 81, 84, 87, 90, 93,
+	96, 99, 102, 105, 108, 111, 114, 117, 120, 123, 126, 129, 132, 135, 138, 141,
+	144, 147, 150, 153, 156, 159, 162, 165, 168, 171, 174, 177, 180, 183, 186, 189
+};
+
+/**
+	@brief Benchmark dell'albero statico
+
+	Confronta il costo di costruzione a ogni avvio di un binary_search_tree
+	a partire da una tabella costante con quello (nullo) di uno
+	static_binary_search_tree constexpr, e le ricerche sui due alberi.
+
+	@param n numero di ricerche
+*/
+void bench_static(std::size_t n) {
+	const unsigned int table_size = sizeof(static_table) / sizeof(static_table[0]);
+	static constexpr static_binary_search_tree<int, table_size, compare_int, equal_int> table(static_table);
+
+	std::cout << "== Albero statico (" << table_size << " chiavi costanti, " << n << " ricerche) ==" << std::endl;
+
+	const std::size_t builds = 10000;
+	std::size_t found = 0;
+	stopwatch bsw;
+	for(std::size_t b = 0; b < builds; ++b) {
+		bst_int tree;
+		for(unsigned int i = 0; i < table_size; ++i)
+			tree.insert(static_table[(i * 37) % table_size]);
+		found += tree.size();
+	}
+	report("costruzione binary_search_tree", bsw.elapsed_ns() / builds, "ns/albero");
+	report("costruzione static_binary_search_tree", 0, "ns/albero");
+
+	bst_int tree;
+	for(unsigned int i = 0; i < table_size; ++i)
+		tree.insert(static_table[(i * 37) % table_size]);
+
+	std::vector<int> queries = distinct_random_ints(n, 14);
+	for(std::size_t i = 0; i < n; ++i)
+		queries[i] %= 3 * table_size; // due terzi delle ricerche falliscono
+
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += tree.exists(queries[i]);
+	report("binary_search_tree::exists", sw.elapsed_ns() / n, "ns/op");
+
+	stopwatch ssw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += table.exists(queries[i]);
+	report("static_binary_search_tree::exists", ssw.elapsed_ns() / n, "ns/op");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Albero con un unico lock
+
+	Struttura di supporto che protegge un binary_search_tree
+	con un solo mutex, come termine di confronto per sharded_bst.
+*/
+struct locked_bst {
+	bst_int tree; ///< albero
+	mutable std::mutex lock; ///< mutex dell'albero
+
+	bool try_insert(int value) {
+		std::lock_guard<std::mutex> guard(lock);
+		return tree.try_insert(value).second;
+	}
+
+	bool exists(int value) const {
+		std::lock_guard<std::mutex> guard(lock);
+		return tree.exists(value);
+	}
+};
+
+/**
+	@brief Lavoro di un thread del benchmark concorrente
+
+	Inserisce e poi cerca i valori di un intervallo di keys.
+
+	@param t albero condiviso
+	@param keys valori da inserire
+	@param first indice del primo valore del thread
+	@param last indice successivo all'ultimo valore del thread
+	@param found numero di valori trovati
+*/
+template <typename tree>
+void concurrent_work(tree *t, const std::vector<int> *keys, std::size_t first, std::size_t last, std::size_t *found) {
+	for(std::size_t i = first; i < last; ++i)
+		t->try_insert((*keys)[i]);
+	std::size_t count = 0;
+	for(std::size_t i = first; i < last; ++i)
+		count += t->exists((*keys)[i]);
+	*found = count;
+}
+
+/**
+	@brief Throughput concorrente
+
+	Divide n inserimenti e n ricerche tra threads thread.
+
+	@param t albero condiviso
+	@param keys valori da inserire
+	@param threads numero di thread
+
+	@return milioni di operazioni al secondo
+*/
+template <typename tree>
+double concurrent_mops(tree &t, const std::vector<int> &keys, unsigned int threads) {
+	std::vector<std::thread> workers;
+	std::vector<std::size_t> found(threads);
+	stopwatch sw;
+	for(unsigned int i = 0; i < threads; ++i)
+		workers.push_back(std::thread(concurrent_work<tree>, &t, &keys,
+									  keys.size() * i / threads, keys.size() * (i + 1) / threads, &found[i]));
+	for(unsigned int i = 0; i < threads; ++i)
+		workers[i].join();
+	double mops = 2.0 * keys.size() / sw.elapsed_ns() * 1000.0;
+
+	for(unsigned int i = 1; i < threads; ++i)
+		found[0] += found[i];
+	if(found[0] != keys.size())
+		std::cout << "  ERRORE: trovati " << found[0] << " valori su " << keys.size() << std::endl;
+	return mops;
+}
+
+/**
+	@brief Benchmark dell'albero partizionato
+
+	Misura il throughput di inserimenti e ricerche concorrenti
+	da 1 a 64 thread su un binary_search_tree con un unico lock
+	e su uno sharded_bst con 64 shard.
+
+	@param n numero di elementi
+*/
+void bench_sharded(std::size_t n) {
+	std::cout << "== Albero partizionato, inserimenti e ricerche concorrenti (n = " << n
+			  << ", core = " << std::thread::hardware_concurrency() << ") ==" << std::endl;
+
+	std::vector<int> keys = distinct_random_ints(n, 15);
+	for(unsigned int threads = 1; threads <= 64; threads *= 2) {
+		locked_bst locked;
+		sharded_bst<int, compare_int, equal_int> sharded(64);
+		std::string suffix = ", " + std::to_string(threads) + " thread";
+		report("binary_search_tree con un lock" + suffix, concurrent_mops(locked, keys, threads), "Mop/s");
+		report("sharded_bst" + suffix, concurrent_mops(sharded, keys, threads), "Mop/s");
+	}
+
+	std::cout << std::endl;
+}
+
+/**
+	@brief Albero di alberi del benchmark degli hash
+
+	Inserisce e poi cerca in un albero di alberi gli alberi di inner,
+	misurando il tempo per operazione.
+
+	@param inner alberi da inserire
+	@param name nome della configurazione
+
+	@return numero di alberi trovati
+*/
+template <typename T>
+std::size_t tree_of_trees(const std::vector<T> &inner, const std::string &name) {
+	binary_search_tree<T, compare_bst_int, equal_bst_int> outer;
+
+	stopwatch sw;
+	for(std::size_t i = 0; i < inner.size(); ++i)
+		outer.insert(inner[i]);
+	report(name + ", insert", sw.elapsed_ns() / inner.size(), "ns/op");
+
+	std::size_t found = 0;
+	stopwatch fsw;
+	for(std::size_t i = 0; i < inner.size(); ++i)
+		found += outer.exists(inner[i]);
+	report(name + ", exists", fsw.elapsed_ns() / inner.size(), "ns/op");
+
+	return found;
+}
+
+/**
+	@brief Benchmark degli alberi con hash del contenuto
+
+	Confronta un albero di bst_int e un albero di hashed_bst_int.
+	Gli alberi interni hanno 100 valori, dei quali i primi 99
+	sono comuni a tutti: i confronti elemento per elemento
+	devono visitare quasi tutto l'albero prima di trovare la differenza.
+
+	@param n numero di alberi interni
+*/
+void bench_hash(std::size_t n) {
+	std::cout << "== Albero di alberi, 100 valori per albero (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> last = distinct_random_ints(n, 16);
+	std::vector<bst_int> plain(n);
+	std::vector<hashed_bst_int> hashed(n);
+	for(std::size_t i = 0; i < n; ++i) {
+		for(int v = 0; v < 99; ++v) {
+			plain[i].insert(v);
+			hashed[i].insert(v);
+		}
+		plain[i].insert(last[i] + 1000);
+		hashed[i].insert(last[i] + 1000);
+	}
+
+	std::size_t found = tree_of_trees(plain, "binary_search_tree<bst_int>");
+	found += tree_of_trees(hashed, "binary_search_tree<hashed_bst_int>");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Benchmark dell'albero di intervalli
+
+	Confronta le ricerche per sovrapposizione di interval_tree con
+	il filtro lineare di printIF (una visita completa con predicato)
+	su n intervalli di lunghezza fino a 100 in [0, 20 n).
+
+	@param n numero di intervalli
+*/
+void bench_interval(std::size_t n) {
+	std::cout << "== Albero di intervalli, ricerche per sovrapposizione (n = " << n << ") ==" << std::endl;
+
+	typedef bst_interval<int> interval;
+	interval_tree<int, compare_int, equal_int> tree;
+	std::vector<int> lows = distinct_random_ints(n, 17);
+	std::mt19937 gen(18);
+	stopwatch isw;
+	for(std::size_t i = 0; i < n; ++i) {
+		int low = lows[i] * 10;
+		tree.insert(interval(low, low + static_cast<int>(gen() % 100)));
+	}
+	report("interval_tree::insert", isw.elapsed_ns() / n, "ns/op");
+
+	const std::size_t queries = 1000;
+	std::vector<int> windows(queries);
+	for(std::size_t q = 0; q < queries; ++q)
+		windows[q] = static_cast<int>(gen() % (20 * n));
+
+	std::size_t found = 0;
+	std::vector<interval> out;
+	stopwatch sw;
+	for(std::size_t q = 0; q < queries; ++q) {
+		out.clear();
+		tree.overlapping(windows[q], windows[q] + 1000, std::back_inserter(out));
+		found += out.size();
+	}
+	report("interval_tree::overlapping", sw.elapsed_ns() / queries, "ns/op");
+
+	stopwatch lsw;
+	for(std::size_t q = 0; q < queries; ++q) {
+		interval_tree<int, compare_int, equal_int>::const_iterator i, ie;
+		for(i = tree.begin(), ie = tree.end(); i != ie; ++i)
+			if(i->low <= windows[q] + 1000 && i->high >= windows[q])
+				found++;
+	}
+	report("filtro lineare (come printIF)", lsw.elapsed_ns() / queries, "ns/op");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Distanza al quadrato tra due numeri complessi
+
+	@param c1 primo numero
+	@param c2 secondo numero
+
+	@return quadrato della distanza tra i due numeri nel piano complesso
+*/
+double complex_distance2(const complex &c1, const complex &c2) {
+	double re = static_cast<double>(c1.re) - c2.re;
+	double im = static_cast<double>(c1.im) - c2.im;
+	return re * re + im * im;
+}
+
+/**
+	@brief Benchmark del k-d tree
+
+	Confronta le ricerche degli 8 punti piu' vicini e dei punti in un box
+	su un kd_tree di numeri complessi con una scansione esaustiva
+	degli stessi punti.
+
+	@param n numero di punti
+*/
+void bench_kd(std::size_t n) {
+	std::cout << "== k-d tree di numeri complessi (n = " << n << ") ==" << std::endl;
+
+	std::mt19937 gen(19);
+	std::vector<complex> points;
+	points.reserve(n);
+	for(std::size_t i = 0; i < n; ++i)
+		points.push_back(complex(static_cast<int>(gen() % 100000), static_cast<int>(gen() % 100000)));
+
+	kd_tree<complex, 2, complex_axis, equal_complex> tree;
+	stopwatch bsw;
+	tree.build(points.begin(), points.end());
+	report("kd_tree::build", bsw.elapsed_ns() / n, "ns/punto");
+
+	const std::size_t queries = 200;
+	std::vector<complex> targets;
+	for(std::size_t q = 0; q < queries; ++q)
+		targets.push_back(complex(static_cast<int>(gen() % 100000), static_cast<int>(gen() % 100000)));
+
+	double checksum = 0;
+	std::vector<complex> out;
+	stopwatch ksw;
+	for(std::size_t q = 0; q < queries; ++q) {
+		out.clear();
+		tree.nearest(targets[q], 8, std::back_inserter(out));
+		checksum += complex_distance2(targets[q], out.back());
+	}
+	report("kd_tree::nearest, k = 8", ksw.elapsed_ns() / queries, "ns/op");
+
+	stopwatch bfsw;
+	for(std::size_t q = 0; q < queries; ++q) {
+		std::vector<double> best(8, 1e300); // ordinati in modo crescente
+		for(std::size_t i = 0; i < n; ++i) {
+			double d = complex_distance2(targets[q], points[i]);
+			if(d < best[7]) {
+				best[7] = d;
+				for(unsigned int j = 7; j > 0 && best[j] < best[j - 1]; --j)
+					std::swap(best[j], best[j - 1]);
+			}
+		}
+		checksum -= best[7];
+	}
+	report("scansione esaustiva, k = 8", bfsw.elapsed_ns() / queries, "ns/op");
+
+	std::size_t found = 0;
+	stopwatch rsw;
+	for(std::size_t q = 0; q < queries; ++q) {
+		out.clear();
+		tree.range(targets[q], complex(targets[q].re + 1000, targets[q].im + 1000), std::back_inserter(out));
+		found += out.size();
+	}
+	report("kd_tree::range, box 1000 x 1000", rsw.elapsed_ns() / queries, "ns/op");
+
+	stopwatch rbsw;
+	for(std::size_t q = 0; q < queries; ++q)
+		for(std::size_t i = 0; i < n; ++i)
+			found -= points[i].re >= targets[q].re && points[i].re <= targets[q].re + 1000
+					 && points[i].im >= targets[q].im && points[i].im <= targets[q].im + 1000;
+	report("scansione esaustiva, box 1000 x 1000", rbsw.elapsed_ns() / queries, "ns/op");
+
+	// Su punti duplicati le due ricerche possono differire: la differenza e' solo un controllo
+	std::cout << "  (differenze: " << checksum << ", " << static_cast<long>(found) << ")" << std::endl << std::endl;
+}
+
+/**
+	@brief Confronto tra alberi di stringhe
+
+	Inserisce le stesse chiavi in un binary_search_tree di std::string
+	e in uno string_binary_search_tree e ne confronta la memoria
+	per chiave e il tempo di ricerca.
+
+	@param name nome dell'insieme di chiavi
+	@param keys chiavi distinte da inserire
+*/
+void bench_string_keys(const std::string &name, const std::vector<std::string> &keys) {
+	std::size_t n = keys.size();
+	binary_search_tree<std::string, compare_string_lexicographic, equal_string_content> tree;
+	string_binary_search_tree string_tree;
+	std::size_t heap = 0;
+	for(std::size_t i = 0; i < n; ++i) {
+		tree.insert(keys[i]);
+		if(keys[i].capacity() > std::string().capacity())
+			heap += keys[i].capacity() + 1; // buffer esterno (senza overhead dell'allocatore)
+	}
+	for(std::size_t i = 0; i < n; ++i)
+		string_tree.insert(keys[i]);
+
+	report("binary_search_tree<string>, " + name, (sizeof(pointer_node<std::string>) * n + heap) / static_cast<double>(n), "B/chiave");
+	report("string_binary_search_tree, " + name, static_cast<double>(string_tree.memory_usage()) / n, "B/chiave");
+
+	std::vector<int> order = distinct_random_ints(n, 21);
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += tree.exists(keys[order[i] / 2]);
+	report("binary_search_tree<string>::exists, " + name, sw.elapsed_ns() / n, "ns/op");
+
+	stopwatch ssw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += string_tree.exists(keys[order[i] / 2]);
+	report("string_binary_search_tree::exists, " + name, ssw.elapsed_ns() / n, "ns/op");
+
+	std::cout << "  (trovati: " << found << ")" << std::endl;
+}
+
+/**
+	@brief Benchmark dell'albero di stringhe
+
+	Confronta binary_search_tree<std::string> e string_binary_search_tree
+	su chiavi casuali di 8-32 lettere e su chiavi con un prefisso comune
+	("user:" seguito da un numero di 10 cifre).
+
+	@param n numero di chiavi
+*/
+void bench_string(std::size_t n) {
+	std::cout << "== Albero di stringhe (n = " << n << ") ==" << std::endl;
+
+	std::mt19937 gen(20);
+	std::vector<std::string> words;
+	string_binary_search_tree seen;
+	while(words.size() < n) {
+		std::string word(8 + gen() % 25, 'a');
+		for(std::size_t i = 0; i < word.size(); ++i)
+			word[i] = static_cast<char>('a' + gen() % 26);
+		if(seen.try_insert(word))
+			words.push_back(word);
+	}
+	bench_string_keys("parole", words);
+
+	std::vector<int> ids = distinct_random_ints(n, 22);
+	std::vector<std::string> users(n);
+	for(std::size_t i = 0; i < n; ++i) {
+		std::string digits = std::to_string(1000000000LL + ids[i]);
+		users[i] = "user:" + digits;
+	}
+	bench_string_keys("user:N", users);
+
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark dell'albero con giornale
+
+	Misura il throughput degli inserimenti al variare del numero
+	di operazioni per sincronizzazione (group commit) e il tempo
+	di ripristino dal giornale e dal checkpoint.
+	I file temporanei vengono creati nella directory corrente.
+
+	@param n numero di inserimenti per la misura del ripristino
+*/
+void bench_journal(std::size_t n) {
+	std::cout << "== Albero con giornale (n = " << n << ") ==" << std::endl;
+
+	typedef journaled_bst<int, compare_int, equal_int, bst_pod_codec<int> > journaled_bst_int;
+	const std::string path = "bench_journal";
+	std::vector<int> values = distinct_random_ints(n, 23);
+
+	unsigned int groups[4] = {1, 16, 256, 4096};
+	for(unsigned int g = 0; g < 4; ++g) {
+		std::remove((path + ".log").c_str());
+		std::remove((path + ".ckpt").c_str());
+		bst_journal_options options;
+		options.group_size = groups[g];
+		options.max_delay = std::chrono::hours(1);
+		options.checkpoint_bytes = 0;
+		std::size_t ops = std::min(n, static_cast<std::size_t>(500) * groups[g]);
+
+		journaled_bst_int tree(path, options);
+		stopwatch sw;
+		for(std::size_t i = 0; i < ops; ++i)
+			tree.insert(values[i]);
+		tree.sync();
+		double seconds = sw.elapsed_ns() / 1e9;
+		report("insert, group_size = " + std::to_string(groups[g]), ops / seconds, "op/s");
+	}
+
+	std::remove((path + ".log").c_str());
+	std::remove((path + ".ckpt").c_str());
+	bst_journal_options options;
+	options.group_size = 4096;
+	options.checkpoint_bytes = 0;
+	unsigned long long bytes;
+	{
+		journaled_bst_int tree(path, options);
+		tree.insert_batch(values.begin(), values.end());
+		tree.sync();
+		bytes = tree.journal_bytes();
+	}
+
+	std::size_t recovered = 0;
+	{
+		stopwatch sw;
+		journaled_bst_int tree(path, options);
+		double seconds = sw.elapsed_ns() / 1e9;
+		report("ripristino dal giornale", seconds * 1e9 / bytes, "s/GB");
+		recovered += tree.size();
+		tree.checkpoint();
+	}
+
+	stopwatch csw;
+	{
+		journaled_bst_int tree(path, options);
+		recovered += tree.size();
+	}
+	report("ripristino dal checkpoint", csw.elapsed_ns() / 1e6, "ms");
+	std::cout << "  (ripristinati: " << recovered << ")" << std::endl;
+
+	std::remove((path + ".log").c_str());
+	std::remove((path + ".ckpt").c_str());
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark dell'albero paginato su file
+
+	Costruisce un albero paginato con n dati casuali e lo riapre con
+	buffer pool di dimensione pari a 10, 1 e 0.1 volte le pagine del file
+	(insieme di lavoro pari a 0.1x, 1x e 10x il pool), misurando le
+	pagine lette per ricerca e il throughput delle ricerche casuali.
+	Le letture sono mancanze nel pool: il file puo' comunque trovarsi
+	nella cache del sistema operativo.
+
+	@param n numero di dati
+*/
+void bench_paged(std::size_t n) {
+	std::cout << "== Albero paginato su file (n = " << n << ") ==" << std::endl;
+
+	typedef paged_binary_search_tree<int, compare_int, equal_int> paged_bst_int;
+	const std::string path = "bench_paged.db";
+	std::remove(path.c_str());
+	std::vector<int> values = distinct_random_ints(n, 24);
+
+	unsigned int pages;
+	{
+		paged_bst_int tree(path, 64);
+		stopwatch sw;
+		for(std::size_t i = 0; i < n; ++i)
+			tree.insert(values[i]);
+		tree.flush();
+		report("insert, pool di 64 pagine", sw.elapsed_ns() / n, "ns/op");
+		report("insert, pagine lette", static_cast<double>(tree.page_reads()) / n, "pag/op");
+		report("insert, pagine scritte", static_cast<double>(tree.page_writes()) / n, "pag/op");
+		pages = tree.page_count();
+		std::cout << "  (pagine del file: " << pages << ")" << std::endl;
+	}
+
+	std::vector<int> order = distinct_random_ints(n, 25);
+	const char *labels[3] = {"0.1x", "1x", "10x"};
+	double ratios[3] = {0.1, 1, 10};
+	std::size_t found = 0;
+	for(unsigned int r = 0; r < 3; ++r) {
+		unsigned int pool = static_cast<unsigned int>(pages / ratios[r]);
+		paged_bst_int tree(path, pool < 4 ? 4 : pool);
+		for(std::size_t i = 0; i < n; ++i) // riscaldamento del pool
+			found += tree.exists(values[order[i]]);
+		unsigned long long reads = tree.page_reads();
+
+		stopwatch sw;
+		for(std::size_t i = 0; i < n; ++i)
+			found += tree.exists(values[order[(i * 7) % n]] + (i & 1));
+		double elapsed = sw.elapsed_ns();
+		std::string name = std::string("exists, insieme di lavoro ") + labels[r] + " del pool";
+		report(name, n / (elapsed / 1e9), "op/s");
+		report(name, static_cast<double>(tree.page_reads() - reads) / n, "pag/op");
+	}
+
+	{
+		paged_bst_int tree(path, 64);
+		std::vector<int> ordered;
+		ordered.reserve(n);
+		stopwatch sw;
+		tree.copy_in_order(std::back_inserter(ordered));
+		report("copy_in_order, pool di 64 pagine", sw.elapsed_ns() / n, "ns/dato");
+		found += ordered.size();
+	}
+	std::cout << "  (trovati: " << found << ")" << std::endl;
+
+	std::remove(path.c_str());
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark di un'istantanea compressa
+
+	Confronta memoria e latenza di exists di un bst_int
+	e della sua istantanea compressa.
+
+	@param name nome dell'insieme di chiavi
+	@param keys chiavi distinte in ordine casuale
+*/
+void bench_snapshot_keys(const std::string &name, const std::vector<int> &keys) {
+	std::size_t n = keys.size();
+	bst_int tree;
+	tree.insert_batch(keys.begin(), keys.end());
+	compressed_int_snapshot snapshot(tree);
+
+	report("bst_int, " + name, sizeof(pointer_node<int>) * 8.0, "bit/chiave");
+	report("compressed_int_snapshot, " + name, snapshot.memory_usage() * 8.0 / n, "bit/chiave");
+
+	std::vector<int> order = distinct_random_ints(n, 26);
+	std::size_t found = 0;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += tree.exists(keys[order[i] / 2] + (i & 1));
+	report("bst_int::exists, " + name, sw.elapsed_ns() / n, "ns/op");
+
+	stopwatch ssw;
+	for(std::size_t i = 0; i < n; ++i)
+		found += snapshot.exists(keys[order[i] / 2] + (i & 1));
+	report("compressed_int_snapshot::exists, " + name, ssw.elapsed_ns() / n, "ns/op");
+
+	stopwatch isw;
+	long long sum = 0;
+	for(compressed_int_snapshot::const_iterator i = snapshot.begin(), last = snapshot.end(); i != last; ++i)
+		sum += *i;
+	report("compressed_int_snapshot, visita, " + name, isw.elapsed_ns() / n, "ns/dato");
+
+	std::cout << "  (trovati: " << found << ", somma: " << sum << ")" << std::endl;
+}
+
+/**
+	@brief Benchmark dell'istantanea compressa
+
+	Misura bit per chiave e latenza di exists su chiavi dense
+	(numeri pari) e su chiavi casuali su tutto l'intervallo degli int.
+
+	@param n numero di chiavi
+*/
+void bench_snapshot(std::size_t n) {
+	std::cout << "== Istantanea compressa di interi (n = " << n << ") ==" << std::endl;
+
+	bench_snapshot_keys("dense", distinct_random_ints(n, 27));
+
+	std::mt19937 gen(28);
+	std::vector<int> sparse;
+	bst_int seen;
+	while(sparse.size() < n) {
+		int value = static_cast<int>(gen());
+		if(seen.try_insert(value).second)
+			sparse.push_back(value);
+	}
+	bench_snapshot_keys("casuali", sparse);
+
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark della misura delle latenze
+
+	Misura il costo aggiunto da timed_binary_search_tree a insert
+	ed exists rispetto a bst_int e stampa le latenze registrate.
+
+	@param n numero di elementi
+*/
+void bench_latency(std::size_t n) {
+	std::cout << "== Misura delle latenze (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> values = distinct_random_ints(n, 29);
+	std::vector<int> queries = distinct_random_ints(n, 30);
+	for(std::size_t i = 0; i < n; ++i)
+		queries[i] = values[queries[i] / 2];
+
+	bst_int tree;
+	stopwatch sw;
+	for(std::size_t i = 0; i < n; ++i)
+		tree.insert(values[i]);
+	double plain_insert = sw.elapsed_ns() / n;
+
+	timed_binary_search_tree<int, compare_int, equal_int> timed;
+	stopwatch tsw;
+	for(std::size_t i = 0; i < n; ++i)
+		timed.insert(values[i]);
+	double timed_insert = tsw.elapsed_ns() / n;
+
+	double plain_exists = exists_ns(tree, queries);
+	double timed_exists = exists_ns(timed, queries);
+
+	report("bst_int::insert", plain_insert, "ns/op");
+	report("timed_binary_search_tree::insert", timed_insert, "ns/op");
+	report("bst_int::exists", plain_exists, "ns/op");
+	report("timed_binary_search_tree::exists", timed_exists, "ns/op");
+	report("costo della misura, exists", timed_exists - plain_exists, "ns/op");
+	report("frequenza del contatore", bst_cycle_clock::ticks_per_ns(), "tick/ns");
+
+	timed.latency().write_text(std::cout);
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark di uso come coda di priorita'
+
+	Modello "hold" di uno scheduler: con pending eventi in attesa,
+	ogni passo estrae l'evento con l'istante minimo e ne inserisce
+	uno nuovo in un istante successivo casuale. Confronta
+	binary_search_tree (pop_min e try_insert), std::set
+	e std::priority_queue.
+
+	@param pending numero di eventi in attesa
+	@param steps numero di passi
+*/
+void bench_priority_queue(std::size_t pending, std::size_t steps) {
+	std::cout << "== Coda di priorita' (in attesa = " << pending << ", passi = " << steps << ") ==" << std::endl;
+
+	std::vector<int> initial = distinct_random_ints(pending, 31);
+	std::vector<int> delays(steps);
+	std::mt19937 gen(32);
+	for(std::size_t i = 0; i < steps; ++i)
+		delays[i] = 1 + static_cast<int>(gen() % (4 * pending));
+
+	long long checksum[3] = {0, 0, 0};
+
+	bst_int tree;
+	tree.insert_batch(initial.begin(), initial.end());
+	stopwatch sw;
+	for(std::size_t i = 0; i < steps; ++i) {
+		int now = tree.pop_min();
+		checksum[0] += now;
+		int next = now + delays[i];
+		while(!tree.try_insert(next).second) // istanti distinti
+			++next;
+	}
+	report("binary_search_tree, pop_min + insert", sw.elapsed_ns() / steps, "ns/passo");
+
+	std::set<int> set(initial.begin(), initial.end());
+	stopwatch ssw;
+	for(std::size_t i = 0; i < steps; ++i) {
+		int now = *set.begin();
+		set.erase(set.begin());
+		checksum[1] += now;
+		int next = now + delays[i];
+		while(!set.insert(next).second)
+			++next;
+	}
+	report("std::set, erase(begin) + insert", ssw.elapsed_ns() / steps, "ns/passo");
+
+	std::priority_queue<int, std::vector<int>, std::greater<int> > queue(initial.begin(), initial.end());
+	stopwatch qsw;
+	for(std::size_t i = 0; i < steps; ++i) {
+		int now = queue.top();
+		queue.pop();
+		checksum[2] += now;
+		queue.push(now + delays[i]); // ammette istanti duplicati
+	}
+	report("std::priority_queue, pop + push", qsw.elapsed_ns() / steps, "ns/passo");
+
+	if(checksum[0] != checksum[1])
+		std::cout << "  errore: sequenze diverse" << std::endl;
+	std::cout << "  (checksum: " << checksum[0] << ", " << checksum[2] << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark della visita ordinata di piu' alberi
+
+	Confronta la visita dell'unione ordinata di k alberi con
+	merge_iterator e la copia dei valori in un vettore ordinato
+	con std::sort.
+
+	@param n numero complessivo di elementi
+	@param k numero di alberi
+*/
+void bench_merge(std::size_t n, std::size_t k) {
+	std::cout << "== Fusione ordinata (n = " << n << ", alberi = " << k << ") ==" << std::endl;
+
+	std::vector<int> values = distinct_random_ints(n, 33);
+	std::vector<bst_int> trees(k);
+	for(std::size_t i = 0; i < n; ++i)
+		trees[i % k].insert(values[i]);
+	std::vector<const bst_int *> pointers;
+	for(std::size_t t = 0; t < k; ++t)
+		pointers.push_back(&trees[t]);
+
+	long long sum[2] = {0, 0};
+	stopwatch sw;
+	for(merge_iterator<int, compare_int, equal_int> i(pointers.begin(), pointers.end()), ie; i != ie; ++i)
+		sum[0] += *i;
+	report("merge_iterator", sw.elapsed_ns() / n, "ns/dato");
+
+	stopwatch csw;
+	std::vector<int> copy;
+	for(std::size_t t = 0; t < k; ++t)
+		trees[t].copy_in_order(std::back_inserter(copy));
+	std::sort(copy.begin(), copy.end());
+	for(std::size_t i = 0; i < copy.size(); ++i)
+		sum[1] += copy[i];
+	report("copy_in_order + std::sort", csw.elapsed_ns() / n, "ns/dato");
+
+	if(sum[0] != sum[1])
+		std::cout << "  errore: somme diverse" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark della compattazione dei nodi in memoria
+
+	Costruisce un albero con inserimenti casuali, alternati ad allocazioni
+	che restano vive per sparpagliare i nodi nello heap, e misura la visita
+	ordinata, la visita con l'iteratore e exists prima e dopo compact
+	con ogni disposizione.
+
+	@param n numero di elementi
+*/
+void bench_relayout(std::size_t n) {
+	std::cout << "== Compattazione dei nodi (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> values = distinct_random_ints(n, 45);
+	bst_int tree;
+	std::vector<std::unique_ptr<char[]> > noise;
+	for(std::size_t i = 0; i < n; ++i) {
+		tree.insert(values[i]);
+		if(i % 4 == 0)
+			noise.push_back(std::unique_ptr<char[]>(new char[48]));
+	}
+	noise.clear();
+	std::vector<int> queries(values.begin(), values.begin() + std::min<std::size_t>(n, 1000000));
+	std::shuffle(queries.begin(), queries.end(), std::mt19937(46));
+
+	const char *names[4] = {"frammentato", "in ordine", "per livelli", "van Emde Boas"};
+	bst_layout layouts[3] = {bst_layout_in_order, bst_layout_breadth_first, bst_layout_van_emde_boas};
+	long long sum = 0;
+	for(unsigned int l = 0; l < 4; ++l) {
+		if(l > 0) {
+			stopwatch csw;
+			tree.compact(layouts[l - 1]);
+			report(std::string(names[l]) + ", compact", csw.elapsed_ns() / n, "ns/nodo");
+		}
+
+		stopwatch ssw;
+		for(bst_int::const_sorted_iterator i = tree.sorted_begin(), ie = tree.sorted_end(); i != ie; ++i)
+			sum += *i;
+		report(std::string(names[l]) + ", visita ordinata", ssw.elapsed_ns() / n, "ns/dato");
+
+		stopwatch isw;
+		for(bst_int::const_iterator i = tree.begin(), ie = tree.end(); i != ie; ++i)
+			sum += *i;
+		report(std::string(names[l]) + ", visita con iteratore", isw.elapsed_ns() / n, "ns/dato");
+
+		report(std::string(names[l]) + ", exists", exists_ns(tree, queries), "ns/op");
+	}
+	std::cout << "  (checksum: " << sum << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark del caricamento da file
+
+	Scrive n interi casuali distinti in un file di testo e in un file
+	di record binari e confronta bst_load, con un thread e con un thread
+	per core, con il ciclo ingenuo che legge un intero alla volta
+	con fscanf e lo inserisce con try_insert.
+
+	@param n numero di elementi
+*/
+void bench_loader(std::size_t n) {
+	std::cout << "== Caricamento da file (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> values = distinct_random_ints(n, 47);
+	const std::string text_path = "bench_loader.txt";
+	const std::string binary_path = "bench_loader.bin";
+	std::FILE *file = std::fopen(text_path.c_str(), "wb");
+	for(std::size_t i = 0; i < n; ++i)
+		std::fprintf(file, "%d\n", values[i]);
+	double text_bytes = static_cast<double>(std::ftell(file));
+	std::fclose(file);
+	file = std::fopen(binary_path.c_str(), "wb");
+	std::fwrite(values.data(), sizeof(int), n, file);
+	double binary_bytes = static_cast<double>(std::ftell(file));
+	std::fclose(file);
+
+	stopwatch nsw;
+	bst_int naive;
+	file = std::fopen(text_path.c_str(), "rb");
+	int value;
+	while(std::fscanf(file, "%d", &value) == 1)
+		naive.try_insert(value);
+	std::fclose(file);
+	double naive_ns = nsw.elapsed_ns();
+	report("fscanf + try_insert, testo", naive_ns / 1e6, "ms");
+	report("fscanf + try_insert, testo", text_bytes * 1e3 / naive_ns, "MB/s");
+
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+	unsigned int threads[2] = {1, cores};
+	for(unsigned int k = 0; k < (cores > 1 ? 2u : 1u); ++k) {
+		bst_load_options options;
+		options.threads = threads[k];
+		std::string suffix = ", " + std::to_string(threads[k]) + " thread";
+
+		bst_int text_tree;
+		stopwatch tsw;
+		bst_load(text_path, text_tree, bst_int_parser<int>(), options);
+		double text_ns = tsw.elapsed_ns();
+		report("bst_load, testo" + suffix, text_ns / 1e6, "ms");
+		report("bst_load, testo" + suffix, text_bytes * 1e3 / text_ns, "MB/s");
+
+		bst_int binary_tree;
+		stopwatch bsw;
+		bst_load(binary_path, binary_tree, bst_record_parser<int>(), options);
+		double binary_ns = bsw.elapsed_ns();
+		report("bst_load, record binari" + suffix, binary_ns / 1e6, "ms");
+		report("bst_load, record binari" + suffix, binary_bytes * 1e3 / binary_ns, "MB/s");
+
+		if(text_tree.size() != naive.size() || binary_tree.size() != naive.size())
+			std::cout << "  errore: dimensioni diverse" << std::endl;
+	}
+
+	std::remove(text_path.c_str());
+	std::remove(binary_path.c_str());
+	std::cout << std::endl;
+}
+
+/**
+	@brief Benchmark di divisione, unione ed estrazione
+
+	Misura split e join di un albero casuale e lo spostamento di una
+	fascia di valori in un altro albero, confrontandoli con la copia
+	dei valori (copy_range), la ricostruzione con insert_batch e la
+	rimozione dall'albero di partenza. Misura poi lo spostamento di
+	singoli valori con extract e insert rispetto a erase e insert.
+
+	@param n numero di elementi
+*/
+void bench_split_join(std::size_t n) {
+	std::cout << "== Divisione, unione ed estrazione (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> values = distinct_random_ints(n, 49);
+	bst_int tree;
+	tree.insert_batch(values.begin(), values.end());
+	bst_int greater;
+	int top = static_cast<int>(2 * n); // i valori sono i pari in [0, 2n)
+
+	const std::size_t rounds = 1000;
+	std::mt19937 random(50);
+	stopwatch ssw;
+	for(std::size_t r = 0; r < rounds; ++r) {
+		int key = static_cast<int>(random() % top);
+		tree.split(key, greater);
+		tree.join(greater);
+	}
+	report("split + join, chiave casuale", ssw.elapsed_ns() / rounds, "ns/op");
+
+	stopwatch tsw;
+	for(std::size_t r = 0; r < rounds; ++r) {
+		tree.split(top - 2000, greater); // ultimi 1000 valori
+		tree.join(greater);
+	}
+	report("split + join, ultimi 1000 valori", tsw.elapsed_ns() / rounds, "ns/op");
+
+	const std::size_t copy_rounds = 20;
+	stopwatch csw;
+	for(std::size_t r = 0; r < copy_rounds; ++r) {
+		std::vector<int> range;
+		tree.copy_range(top - 2000, top, std::back_inserter(range));
+		bst_int copy;
+		copy.insert_batch(range.begin(), range.end());
+		for(std::size_t i = 0; i < range.size(); ++i)
+			tree.erase(range[i]);
+		tree.insert_batch(range.begin(), range.end());
+	}
+	report("copy_range + insert_batch + erase, 1000 valori", csw.elapsed_ns() / copy_rounds, "ns/op");
+
+	std::vector<int> moved(values.begin(), values.begin() + std::min<std::size_t>(n, 100000));
+	bst_int other;
+	stopwatch esw;
+	for(std::size_t i = 0; i < moved.size(); ++i)
+		other.insert(tree.extract(moved[i]));
+	for(std::size_t i = 0; i < moved.size(); ++i)
+		tree.insert(other.extract(moved[i]));
+	report("extract + insert(node_handle)", esw.elapsed_ns() / (2 * moved.size()), "ns/op");
+
+	stopwatch rsw;
+	for(std::size_t i = 0; i < moved.size(); ++i) {
+		tree.erase(moved[i]);
+		other.insert(moved[i]);
+	}
+	for(std::size_t i = 0; i < moved.size(); ++i) {
+		other.erase(moved[i]);
+		tree.insert(moved[i]);
+	}
+	report("erase + insert", rsw.elapsed_ns() / (2 * moved.size()), "ns/op");
+
+	if(tree.size() != n || other.size() != 0)
+		std::cout << "  errore: dimensioni diverse" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Registrazione di tracce
+
+	Confronta un carico misto (inserimenti, ricerche, rimozioni) su un
+	binary_search_tree e su un recording_binary_search_tree, per misurare
+	il costo della registrazione, e il tempo di rilettura della traccia.
+
+	@param n numero di valori inseriti
+*/
+void bench_trace(std::size_t n) {
+	std::cout << "== Registrazione di tracce (n = " << n << ") ==" << std::endl;
+
+	std::vector<int> values = distinct_random_ints(n, 48);
+	const std::string path = "bench_trace";
+	std::size_t ops = n + n + (n + 1) / 2; // inserimenti, ricerche, rimozioni
+
+	std::size_t found = 0;
+	{
+		bst_int plain;
+		stopwatch psw;
+		for(std::size_t i = 0; i < n; ++i)
+			plain.insert(values[i]);
+		for(std::size_t i = 0; i < n; ++i)
+			found += plain.exists(static_cast<int>(values[i] + (i & 1)));
+		for(std::size_t i = 0; i < n; i += 2)
+			plain.erase(values[i]);
+		report("binary_search_tree", psw.elapsed_ns() / ops, "ns/op");
+	}
+
+	unsigned long long bytes = 0;
+	{
+		recording_binary_search_tree<int, compare_int, equal_int, bst_pod_codec<int> > recorded(path);
+		stopwatch rsw;
+		for(std::size_t i = 0; i < n; ++i)
+			recorded.insert(values[i]);
+		for(std::size_t i = 0; i < n; ++i)
+			found -= recorded.exists(static_cast<int>(values[i] + (i & 1)));
+		for(std::size_t i = 0; i < n; i += 2)
+			recorded.erase(values[i]);
+		recorded.flush_trace();
+		report("recording_binary_search_tree", rsw.elapsed_ns() / ops, "ns/op");
+		bytes = recorded.trace().bytes();
+		report("dimensione della traccia", static_cast<double>(bytes) / recorded.trace().records(), "byte/op");
+	}
+
+	{
+		bst_trace_writer<int, bst_pod_codec<int> > writer(path); // solo la registrazione
+		stopwatch wsw;
+		for(std::size_t i = 0; i < n; ++i)
+			writer.record(bst_op_insert, values[i]);
+		for(std::size_t i = 0; i < n; ++i)
+			writer.record(bst_op_exists, static_cast<int>(values[i] + (i & 1)));
+		for(std::size_t i = 0; i < n; i += 2)
+			writer.record(bst_op_erase, values[i]);
+		writer.flush();
+		report("bst_trace_writer (senza albero)", wsw.elapsed_ns() / ops, "ns/op");
+	}
+
+	stopwatch lsw;
+	bst_trace_reader<int, bst_pod_codec<int> > reader(path);
+	bst_operation op;
+	int key = 0;
+	std::size_t records = 0;
+	while(reader.next(op, key))
+		++records;
+	report("rilettura della traccia", lsw.elapsed_ns() / records, "ns/op");
+	std::remove(path.c_str());
+
+	if(found != 0 || records != ops)
+		std::cout << "  errore: risultati diversi" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Multiinsieme con conteggio
+
+	Conta le occorrenze di un flusso di n eventi con chiavi ripetute
+	(n / 16 chiavi distinte) con un binary_search_tree, catturando
+	l'eccezione dei duplicati, e i conteggi in una bst_map, oppure
+	con un bst_multiset.
+
+	@param n numero di eventi
+*/
+void bench_multiset(std::size_t n) {
+	std::cout << "== Multiinsieme con conteggio (n = " << n << ") ==" << std::endl;
+
+	std::size_t keys = n / 16 + 1;
+	std::vector<int> events(n);
+	std::mt19937 random(49);
+	for(std::size_t i = 0; i < n; ++i)
+		events[i] = static_cast<int>(random() % keys);
+
+	bst_int tree;
+	bst_map<int, unsigned int, compare_int, equal_int> counts;
+	stopwatch esw;
+	for(std::size_t i = 0; i < n; ++i) {
+		try {
+			tree.insert(events[i]);
+		}
+		catch(bst_duplicated_value_exception<int> &e) {}
+		++counts[events[i]];
+	}
+	report("binary_search_tree + eccezioni + bst_map", esw.elapsed_ns() / n, "ns/op");
+
+	bst_multiset<int, compare_int, equal_int> multiset;
+	stopwatch msw;
+	for(std::size_t i = 0; i < n; ++i)
+		multiset.insert(events[i]);
+	report("bst_multiset::insert", msw.elapsed_ns() / n, "ns/op");
+
+	std::size_t total = 0;
+	stopwatch csw;
+	for(std::size_t i = 0; i < n; ++i)
+		total += multiset.count(events[i]);
+	report("bst_multiset::count", csw.elapsed_ns() / n, "ns/op");
+
+	stopwatch rsw;
+	for(std::size_t i = 0; i < n; ++i)
+		multiset.erase(events[i]);
+	report("bst_multiset::erase", rsw.elapsed_ns() / n, "ns/op");
+
+	if(tree.size() != counts.size() || multiset.size() != 0 || total < n)
+		std::cout << "  errore: conteggi diversi" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Cache con rimozione LRU
+
+	Esegue un flusso di n accessi (ricerca, e inserimento se il valore
+	manca) con chiavi concentrate su un insieme caldo, su una cache
+	limitata a n / 10 valori: un bst_lru_cache, e un binary_search_tree
+	ricostruito da zero ogni volta che raggiunge il limite.
+
+	@param n numero di accessi
+*/
+void bench_lru(std::size_t n) {
+	std::cout << "== Cache con rimozione LRU (n = " << n << ") ==" << std::endl;
+
+	unsigned int capacity = static_cast<unsigned int>(n / 10 + 1);
+	std::vector<int> accesses(n);
+	std::mt19937 random(50);
+	for(std::size_t i = 0; i < n; ++i) // 80% degli accessi su capacity / 2 valori
+		accesses[i] = static_cast<int>(random() % 10 < 8 ? random() % (capacity / 2 + 1) : random() % (4 * n));
+
+	bst_int tree;
+	std::size_t tree_hits = 0;
+	stopwatch tsw;
+	for(std::size_t i = 0; i < n; ++i) {
+		if(tree.exists(accesses[i])) {
+			++tree_hits;
+			continue;
+		}
+		if(tree.size() >= capacity)
+			bst_int().swap(tree);
+		tree.insert(accesses[i]);
+	}
+	report("binary_search_tree ricostruito", tsw.elapsed_ns() / n, "ns/op");
+	report("  hit rate", 100.0 * tree_hits / n, "%");
+
+	std::size_t evictions = 0;
+	bst_lru_cache<int, compare_int, equal_int> cache(capacity, 0, [&evictions](int) { ++evictions; });
+	std::size_t cache_hits = 0;
+	stopwatch csw;
+	for(std::size_t i = 0; i < n; ++i) {
+		if(cache.find(accesses[i]) != nullptr) {
+			++cache_hits;
+			continue;
+		}
+		cache.insert(accesses[i]);
+	}
+	report("bst_lru_cache", csw.elapsed_ns() / n, "ns/op");
+	report("  hit rate", 100.0 * cache_hits / n, "%");
+
+	std::vector<int> range;
+	stopwatch rsw;
+	for(int low = 0; low < 1000 * 64; low += 64)
+		cache.copy_range(low, low + 64, std::back_inserter(range));
+	report("bst_lru_cache::copy_range, 64 chiavi", rsw.elapsed_ns() / 1000, "ns/op");
+
+	if(cache.size() > capacity || evictions + cache.size() + cache_hits != n)
+		std::cout << "  errore: capacita' superata" << std::endl;
+	std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+
+	std::size_t n = 1000000;
+	if(argc > 1)
+		n = static_cast<std::size_t>(std::atoi(argv[1]));
+
+	bench_compact(n);
+	bench_map(n / 4);
+	bench_batch(n);
+	bench_insert_batch(n / 10);
+	bench_insert_batch(n);
+	bench_try_insert(n / 50);
+	bench_splay(n);
+	bench_bloom(n);
+	bench_static(n);
+	bench_sharded(n);
+	bench_hash(n / 100);
+	bench_interval(n);
+	bench_kd(n);
+	bench_string(n);
+	bench_journal(n);
+	bench_paged(n);
+	bench_snapshot(n);
+	bench_latency(n);
+	bench_priority_queue(1000, n);
+	bench_priority_queue(n / 10, n);
+	bench_merge(n, 16);
+	bench_merge(n, 256);
+	bench_relayout(n);
+	bench_loader(n);
+	bench_split_join(n);
+	bench_trace(n);
+	bench_multiset(n);
+	bench_lru(n);
+
+	return 0;
+}
+
+// Fine file bench.cpp
@@ -14,7 +14,40 @@
 #include <ostream> // std::ostream
 #include <iterator> // std::forward_iterator_tag
 #include <cstddef> // std::ptrdiff_t
-#include "bstexceptions.h" // bst_duplicated_value_exception, bst_value_not_found_exception
+#include <vector> // std::vector
+#include <utility> // std::pair, std::make_pair, std::move, std::forward
+#include <algorithm> // std::sort, std::copy
+#include <memory> // std::unique_ptr, std::shared_ptr
+#include <new> // operator new, operator delete
+#include <functional> // std::less
+#include <atomic> // std::atomic
+#include <stdexcept> // std::invalid_argument
+#include "bstexceptions.h" // bst_duplicated_value_exception, bst_value_not_found_exception, bst_empty_tree_exception
+
+/**
+	@brief Prefetch software di un indirizzo
+
+	Suggerisce al processore di caricare in cache l'indirizzo p,
+	senza attendere il completamento del caricamento.
+	Con compilatori diversi da GCC e Clang non ha alcun effetto.
+*/
+#if defined(__GNUC__)
+#define BST_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define BST_PREFETCH(p) ((void)(p))
+#endif
+
+/**
+	@brief Disposizione dei nodi in memoria
+
+	Ordine in cui binary_search_tree::compact dispone i nodi
+	in un blocco di memoria contiguo.
+*/
+enum bst_layout {
+	bst_layout_in_order, ///< ordine crescente (visite e copie ordinate)
+	bst_layout_breadth_first, ///< per livelli (ricerche, parte alta dell'albero in poche linee di cache)
+	bst_layout_van_emde_boas ///< ricorsivo di van Emde Boas (ricerche, indipendente dalla dimensione della cache)
+};
 
 /**
 	@brief ALbero binario di ricerca
@@ -35,6 +68,11 @@
 */
 template <typename T, typename O, typename E>
 class binary_search_tree {
+
+protected:
+	
+	// I dati membro e le funzioni helper sono protetti per permettere
+	// alle varianti dell'albero (es. splay_tree) di riusarne i nodi.
 	
 	/**
 		@brief Nodo dell'albero
@@ -67,6 +105,17 @@ class binary_search_tree {
 		node(const T &v) :
 			value(v), left(nullptr), right(nullptr), parent(nullptr) {} // initialization list
 		
+		/**
+			@brief Costruttore secondario
+			
+			Costruttore secondario che permette di istanziare un nodo,
+			spostando al suo interno il valore.
+			
+			@param v valore del dato
+		*/
+		node(T &&v) :
+			value(std::move(v)), left(nullptr), right(nullptr), parent(nullptr) {} // initialization list
+		
 		/**
 			@brief Costruttore secondario
 			
@@ -82,6 +131,21 @@ class binary_search_tree {
 		node(const T &v, node *l, node *r, node *p) :
 			value(v), left(l), right(r), parent(p) {} // initialization list
 
+		/**
+			@brief Costruttore secondario
+			
+			Costruttore secondario che permette di istanziare un nodo,
+			spostando al suo interno il valore e inizializzando i puntatori
+			ai suoi nodi figli sinistro, destro e al suo nodo padre.
+			
+			@param v valore del dato
+			@param l puntatore al nodo figlio sinistro
+			@param r puntatore al nodo figlio destro
+			@param p puntatore al nodo padre
+		*/
+		node(T &&v, node *l, node *r, node *p) :
+			value(std::move(v)), left(l), right(r), parent(p) {} // initialization list
+
 		// Gli altri metodi fondamentali coincidono con quelli di default
 		
 		/**
@@ -96,483 +160,2384 @@ class binary_search_tree {
 		}		
 	}; // struct node
 	
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+	
+	/**
+		@brief Blocco contiguo di nodi
+		
+		Struttura di supporto interna che contiene la memoria dei nodi
+		creati da compact e assign_sorted. I nodi del blocco possono
+		passare ad altri alberi (split, join, extract): ogni albero
+		che contiene nodi del blocco ne condivide la proprieta',
+		e la memoria viene deallocata quando nessun albero lo usa piu'.
+	*/
+	struct node_block {
+		node *nodes; ///< memoria (non inizializzata) dei nodi
+		size_type capacity; ///< numero di nodi del blocco
+		std::atomic<size_type> live; ///< numero di nodi del blocco non ancora distrutti
+		
+		/**
+			@brief Costruttore
+			
+			Costruttore che alloca la memoria di un blocco,
+			senza costruire nessun nodo.
+			
+			@param count numero di nodi del blocco
+			
+			@throw eccezione di allocazione di memoria
+		*/
+		explicit node_block(size_type count) :
+			nodes(static_cast<node *>(::operator new(sizeof(node) * count))), capacity(count), live(0) {} // initialization list
+		
+		node_block(const node_block &other) = delete;
+		node_block &operator=(const node_block &other) = delete;
+		
+		/**
+			@brief Distruttore
+			
+			Distruttore. Dealloca la memoria del blocco: i nodi devono
+			essere gia' stati distrutti.
+		*/
+		~node_block() {
+			::operator delete(nodes);
+		}
+		
+		/**
+			@brief Appartenenza di un nodo al blocco
+			
+			@param n puntatore al nodo
+			
+			@return true se il nodo si trova nella memoria del blocco
+		*/
+		bool contains(const node *n) const {
+			std::less<const node *> before;
+			return !before(n, nodes) && before(n, nodes + capacity);
+		}
+	}; // struct node_block
+	
 	node *_root; ///< puntatore alla radice dell'albero
+	node *_leftmost; ///< puntatore al nodo con il valore minimo
+	node *_rightmost; ///< puntatore al nodo con il valore massimo
 	
-	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
 	size_type _size; ///< numero totale di dati inseriti nell'albero
 	
 	O _order; ///< oggetto funtore per il confronto di ordinamento (<) di due dati
 	E _equals; ///< oggetto funtore per il confronto di uguaglianza (==) di due dati
 	
+	std::vector<std::shared_ptr<node_block> > _blocks; ///< blocchi contigui che possono contenere nodi dell'albero
+	
 	/**
-		@brief Inserimento degli elementi di un albero in quello corrente
+		@brief Blocco di un nodo
 		
-		Inserisce ricorsivamente gli elementi di un albero in quello corrente,
-		secondo l'ordinamento definito dal funtore di confronto
-		di ordinamento (<) _order, di tipo O.
-		Gli elementi dell'albero da inserire sono identificati dal puntatore
-		alla radice dell'albero di cui fanno parte.
+		Funzione privata helper che cerca il blocco che contiene un nodo.
 
-		@pre Nessuno dei valori da inserire dev'essere gia' presente
-			 all'interno dell'albero
+		@param n puntatore al nodo
+
+		@return indice del blocco in _blocks (_blocks.size() se il nodo
+				e' allocato singolarmente)
+	*/
+	size_type block_of(const node *n) const {
+		size_type i = 0;
+		while(i < _blocks.size() && !_blocks[i]->contains(n))
+			i++;
+		return i;
+	}
+	
+	/**
+		@brief Deallocazione di un nodo
 		
-		@param root puntatore al nodo radice dell'albero che contiene
-			   gli elementi da inserire in quello corrente
+		Funzione privata helper che distrugge un nodo scollegato.
+		I nodi allocati singolarmente vengono deallocati subito; quelli
+		di un blocco contiguo vengono solo distrutti, e l'albero rilascia
+		il blocco quando non contiene piu' nodi vivi.
 
-		@throw bst_duplicated_value_exception se uno dei valori da inserire
-			   e' gia' presente all'interno dell'albero corrente
-		@throw eccezione di allocazione di memoria
+		@param n puntatore al nodo da deallocare
 	*/
-	void insert_tree(const node *root) {	
-		if(root != nullptr) {
-			insert(root->value);
-			insert_tree(root->left);
-			insert_tree(root->right);
+	void destroy_node(node *n) {
+		size_type i = block_of(n);
+		if(i == _blocks.size()) {
+			delete n;
+			return;
 		}
+		
+		n->~node();
+		if(--_blocks[i]->live == 0)
+			_blocks.erase(_blocks.begin() + i);
 	}
 	
 	/**
-		@brief Eliminazione dell'intero contenuto dell'albero
+		@brief Acquisizione di un blocco
 		
-		Funzione privata che elimina tutti i nodi dell'albero.
+		Funzione privata helper che aggiunge un blocco a quelli
+		dell'albero, se non e' gia' presente, e rilascia quelli
+		i cui nodi sono stati tutti distrutti (anche da altri alberi).
+
+		@param block blocco da aggiungere
+
+		@throw eccezione di allocazione di memoria
 	*/
-	void clear() {
-		clear_tree(_root);
+	void adopt_block(const std::shared_ptr<node_block> &block) {
+		for(size_type i = 0; i < _blocks.size(); )
+			if(_blocks[i]->live == 0)
+				_blocks.erase(_blocks.begin() + i);
+			else
+				if(_blocks[i] == block)
+					return;
+				else
+					i++;
+		_blocks.push_back(block);
 	}
 	
 	/**
-		@brief Eliminazione ricorsiva di un albero
+		@brief Successore di un nodo
 		
-		Funzione privata helper per l'eliminazione dei nodi di un albero,
-		tramite l'eliminazione ricorsiva dei suoi sottoalberi.
-		Elimina un albero data la sua radice.
+		Funzione privata helper che ritorna il nodo successivo
+		in ordine crescente, risalendo i puntatori al padre.
 
-		@param root puntatore al nodo radice dell'albero da eliminare
+		@param n puntatore al nodo
+
+		@return puntatore al nodo successivo (nullptr se n e' il massimo)
 	*/
-	void clear_tree(node *root) {
-		if(root != nullptr) {
-			clear_tree(root->left);
-			clear_tree(root->right);
-			delete root;
-			root = nullptr;	
-			_size--;
+	static const node *successor(const node *n) {
+		if(n->right != nullptr) {
+			n = n->right;
+			while(n->left != nullptr)
+				n = n->left;
+			return n;
+		}
+		
+		const node *child = n;
+		n = n->parent;
+		while(n != nullptr && child == n->right) {
+			child = n;
+			n = n->parent;
 		}
+		return n;
 	}
 	
 	/**
-		@brief Nodo con un certo valore
+		@brief Altezza dell'albero
 		
-		Funzione privata helper che cerca se esiste nell'albero un nodo
-		con un certo valore cercato e, in caso affermativo,
-		ritorna un puntatore al nodo stesso.
-		L'uguaglianza e' definita dal funtore di confronto di uguaglianza (==)
-		_equals, di tipo E.
+		Funzione privata helper che calcola il numero di livelli
+		dell'albero con una visita per livelli, senza ricorsione.
 
-		@param value valore del nodo da cercare
+		@return numero di livelli (0 se l'albero e' vuoto)
 
-		@return puntatore al nodo che ha il valore cercato,
-				nullptr se non esiste nessun nodo che ha il valore cercato
+		@throw eccezione di allocazione di memoria
 	*/
-	node *search(const T &value) const {
-		node *current = _root;
-		
-		while(current != nullptr && !_equals(current->value, value))
-			if(_order(value, current->value))
-				current = current->left;
-			else
-				current = current->right;
+	size_type height() const {
+		size_type levels = 0;
+		std::vector<node *> level;
+		std::vector<node *> next;
+		if(_root != nullptr)
+			level.push_back(_root);
 		
-		return current;
+		while(!level.empty()) {
+			levels++;
+			next.clear();
+			for(size_type i = 0; i < level.size(); ++i) {
+				if(level[i]->left != nullptr)
+					next.push_back(level[i]->left);
+				if(level[i]->right != nullptr)
+					next.push_back(level[i]->right);
+			}
+			level.swap(next);
+		}
+		return levels;
 	}
-
-public:
-	
-	// Metodi fondamentali
 	
 	/**
-		@brief Costruttore di default (METODO FONDAMENTALE)
+		@brief Nodi dell'albero per livelli
 		
-		Costruttore di default per istanziare un albero vuoto.
-		E' l'unico costruttore che puo' essere utilizzato per istanziare
-		un eventuale array di alberi.
-	*/
-	binary_search_tree() : _root(nullptr), _size(0) {} // initialization list
+		Funzione privata helper che aggiunge a nodes i puntatori ai nodi
+		dell'albero, livello per livello e da sinistra a destra.
 
-	/**
-		@brief Costruttore di copia/Copy Constructor (METODO FONDAMENTALE)
-		
-		Costruttore di copia/Copy Constructor.
-		Permette di istanziare un albero con i valori presi da un altro albero.
+		@param nodes vettore a cui aggiungere i puntatori ai nodi
 
-		@param other albero da copiare per creare quello corrente
-		
 		@throw eccezione di allocazione di memoria
 	*/
-	binary_search_tree(const binary_search_tree &other) : _root(nullptr), _size(0) { // initialization list
-		try {
-			insert_tree(other._root);
-		}
-		catch(...) {
-			clear();
-			throw;
+	void breadth_first(std::vector<node *> &nodes) const {
+		size_type first = static_cast<size_type>(nodes.size());
+		if(_root != nullptr)
+			nodes.push_back(_root);
+		
+		// nodes stesso fa da coda
+		for(size_type i = first; i < nodes.size(); ++i) {
+			if(nodes[i]->left != nullptr)
+				nodes.push_back(nodes[i]->left);
+			if(nodes[i]->right != nullptr)
+				nodes.push_back(nodes[i]->right);
 		}
 	}
-
+	
 	/**
-		@brief Operatore di assegnamento (METODO FONDAMENTALE)
-		
-		Operatore di assegnamento. Permette la copia tra alberi.
+		@brief Nodi di un sottoalbero in ordine di van Emde Boas
 		
-		@param other albero come sorgente da copiare (operando di destra)
-		
-		@return reference a this
+		Funzione privata helper che aggiunge a nodes i puntatori ai nodi
+		del sottoalbero di radice root con profondita' minore di levels.
+		I livelli vengono divisi a meta': prima la parte alta, poi,
+		da sinistra a destra, ognuno dei sottoalberi che pendono da essa.
+		La ricorsione e' profonda O(log levels), quindi non dipende
+		dalla forma dell'albero.
+
+		@param root puntatore alla radice del sottoalbero
+		@param levels numero di livelli da visitare
 
 		@throw eccezione di allocazione di memoria
 	*/
-	binary_search_tree &operator=(const binary_search_tree &other) {
+	static void van_emde_boas(node *root, size_type levels, std::vector<node *> &nodes) {
+		if(levels == 1) {
+			nodes.push_back(root);
+			return;
+		}
 		
-		// Per evitare l'auto-assegnamento (this = this)
-		if(this != &other) {
-			binary_search_tree tmp(other);
-			std::swap(_root,tmp._root);
-			std::swap(_size,tmp._size);
+		size_type top = levels - levels / 2;
+		van_emde_boas(root, top, nodes);
+		
+		// radici dei sottoalberi alla profondita' top, da sinistra a destra
+		std::vector<std::pair<node *, size_type> > pending(1, std::make_pair(root, size_type(0)));
+		while(!pending.empty()) {
+			node *current = pending.back().first;
+			size_type depth = pending.back().second;
+			pending.pop_back();
+			
+			if(depth == top) {
+				van_emde_boas(current, levels - top, nodes);
+				continue;
+			}
+			if(current->right != nullptr)
+				pending.push_back(std::make_pair(current->right, depth + 1));
+			if(current->left != nullptr)
+				pending.push_back(std::make_pair(current->left, depth + 1));
 		}
-		return *this;
 	}
-
+	
 	/**
-		@brief Distruttore (METODO FONDAMENTALE)
+		@brief Inserimento degli elementi di un albero in quello corrente
 		
-		Distruttore. Rimuove la memoria allocata da un albero.
+		Inserisce ricorsivamente gli elementi di un albero in quello corrente,
+		secondo l'ordinamento definito dal funtore di confronto
+		di ordinamento (<) _order, di tipo O.
+		Gli elementi dell'albero da inserire sono identificati dal puntatore
+		alla radice dell'albero di cui fanno parte.
+
+		@pre Nessuno dei valori da inserire dev'essere gia' presente
+			 all'interno dell'albero
+		
+		@param root puntatore al nodo radice dell'albero che contiene
+			   gli elementi da inserire in quello corrente
+
+		@throw bst_duplicated_value_exception se uno dei valori da inserire
+			   e' gia' presente all'interno dell'albero corrente
+		@throw eccezione di allocazione di memoria
 	*/
-	~binary_search_tree() {
-		clear();
+	void insert_tree(const node *root) {	
+		if(root != nullptr) {
+			insert(root->value);
+			insert_tree(root->left);
+			insert_tree(root->right);
+		}
 	}
 	
-	// Fine metodi fondamentali
-	
-	// Ulteriori metodi pubblici
-
 	/**
-		@brief Inserimento di un elemento nell'albero
+		@brief Inserimento senza eccezioni di un elemento nell'albero
 		
-		Inserisce un elemento nell'albero, secondo l'ordinamento definito
+		Funzione privata helper che inserisce un elemento nell'albero,
+		se non e' gia' presente, secondo l'ordinamento definito
 		dal funtore di confronto di ordinamento (<) _order, di tipo O.
-
-		@pre Il valore da inserire non dev'essere gia' presente
-			 all'interno dell'albero
+		La ricerca della posizione parte dal nodo start invece che
+		dalla radice.
 		
-		@param value valore dell'elemento da inserire
+		@pre Il valore deve appartenere al sottoalbero di start
+		
+		@param start puntatore al nodo da cui iniziare la ricerca
+		@param value valore dell'elemento da inserire (copiato o spostato
+			   nel nuovo nodo)
+
+		@return coppia formata dal puntatore al nodo con il valore
+				e da true se il nodo e' stato inserito,
+				false se il valore era gia' presente
 
-		@throw bst_duplicated_value_exception se il valore da inserire
-			   e' gia' presente all'interno dell'albero
 		@throw eccezione di allocazione di memoria
 	*/
-	void insert(const T &value) {	
-		node *current = _root;
+	template <typename V>
+	std::pair<node *, bool> insert_below(node *start, V &&value) {
+		node *current = start;
 		node *previous = nullptr;
 		
 		while(current != nullptr) {
 			previous = current;
 			if(_equals(value, current->value))
-				throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+				return std::make_pair(current, false);
 			if(_order(value, current->value))			
 				current = current->left;
 			else
 				current = current->right;
 		}
 		
-		node *tmp = new node(value);
-		
-		tmp->parent = previous;
+		bool left = (previous != nullptr && _order(value, previous->value));
 		
-		if(previous == nullptr)
-			_root = tmp;
-		else
-			if(_order(value, previous->value))
-				previous->left = tmp;
-			else
-				previous->right = tmp;
-		
-		_size++;
+		return std::make_pair(attach(previous, left, std::forward<V>(value)), true);
 	}
 	
 	/**
-		@brief Numero totale di dati inseriti nell'albero
+		@brief Inserimento senza eccezioni di un elemento nell'albero
 		
-		Ritorna il numero totale di dati inseriti nell'albero
+		Funzione privata helper che inserisce un elemento nell'albero,
+		se non e' gia' presente, cercandone la posizione dalla radice.
+		
+		@param value valore dell'elemento da inserire (copiato o spostato
+			   nel nuovo nodo)
 
-		@return numero totale di dati inseriti nell'albero
+		@return coppia formata dal puntatore al nodo con il valore
+				e da true se il nodo e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
 	*/
-	size_type size() const {
-		return _size;
+	template <typename V>
+	std::pair<node *, bool> insert_unique(V &&value) {
+		return insert_below(_root, std::forward<V>(value));
 	}
-
+	
 	/**
-		@brief Controllo di esistenza di un elemento nell'albero
+		@brief Collegamento di un nuovo nodo
 		
-		Controlla se esiste un elemento di tipo T nell'albero.
-		L'uguaglianza e' definita dal funtore di confronto di uguaglianza (==)
-		_equals, di tipo E.
+		Funzione privata helper che crea un nodo con un certo valore
+		e lo collega come figlio sinistro o destro di un nodo che
+		non ha ancora quel figlio.
+		
+		@pre Il valore deve appartenere alla posizione in cui viene collegato
+		
+		@param parent puntatore al nodo padre (nullptr se l'albero e' vuoto)
+		@param left true per collegare il nodo come figlio sinistro
+		@param value valore del nuovo nodo (copiato o spostato)
 
-		@param value valore da cercare
+		@return puntatore al nuovo nodo
 
-		@return true se esiste l'elemento, false altrimenti
+		@throw eccezione di allocazione di memoria
 	*/
-	bool exists(const T &value) const {
-		return search(value) != nullptr;
+	template <typename V>
+	node *attach(node *parent, bool left, V &&value) {
+		return link(parent, left, new node(std::forward<V>(value)));
 	}
 	
 	/**
-		@brief Sottoalbero
-		
-		Metodo che, passato un dato d dello stesso tipo T dei dati contenuti
-		nell'albero, ritorna un nuovo albero, che corrisponde al sottoalbero
-		avente come radice il nodo con il valore d.
-		
-		@pre Il valore d dev'essere presente all'interno dell'albero
+		@brief Collegamento di un nodo
 		
-		@param d valore del nodo radice del sottoalbero
+		Funzione privata helper che collega un nodo scollegato
+		come figlio sinistro o destro di un nodo che non ha ancora
+		quel figlio.
 		
-		@return sottoalbero avente come radice il nodo con il valore d
+		@pre Il valore del nodo deve appartenere alla posizione
+			 in cui viene collegato
 		
-		@throw bst_value_not_found_exception se il valore d non e' presente
-			   all'interno dell'albero
-		@throw eccezione di allocazione di memoria
+		@param parent puntatore al nodo padre (nullptr se l'albero e' vuoto)
+		@param left true per collegare il nodo come figlio sinistro
+		@param tmp puntatore al nodo da collegare
+
+		@return puntatore al nodo collegato
 	*/
-	binary_search_tree subtree(const T &d) const {
-		binary_search_tree sub_bst;
-		
-		node *sub_root = search(d);
-		if(sub_root == nullptr)
-			throw bst_value_not_found_exception<T>("Valore non trovato: ", d);
+	node *link(node *parent, bool left, node *tmp) {
+		tmp->parent = parent;
 		
-		try {
-			sub_bst.insert_tree(sub_root);
+		if(parent == nullptr) {
+			_root = tmp;
+			_leftmost = tmp;
+			_rightmost = tmp;
+		}
+		else
+			if(left) {
+				parent->left = tmp;
+				if(parent == _leftmost)
+					_leftmost = tmp;
+			}
+			else {
+				parent->right = tmp;
+				if(parent == _rightmost)
+					_rightmost = tmp;
+			}
+		
+		_size++;
+		
+		return tmp;
+	}
+	
+	/**
+		@brief Inserimento senza eccezioni con suggerimento di posizione
+		
+		Funzione privata helper che inserisce un elemento nell'albero,
+		se non e' gia' presente, cercandone la posizione a partire
+		dal nodo suggerito invece che dalla radice.
+		Un valore maggiore del massimo o minore del minimo viene collegato
+		direttamente al nodo massimo o minimo. Altrimenti risale dal nodo suggerito fino al primo
+		antenato il cui sottoalbero puo' contenere il valore e scende
+		da li': il costo dipende dalla distanza tra il valore e hint,
+		non dalla profondita' dell'albero.
+		
+		@param hint puntatore al nodo suggerito (nullptr per la fine)
+		@param value valore dell'elemento da inserire (copiato o spostato)
+
+		@return coppia formata dal puntatore al nodo con il valore
+				e da true se il nodo e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename V>
+	std::pair<node *, bool> insert_hint(node *hint, V &&value) {
+		if(_rightmost == nullptr || _order(_rightmost->value, value))
+			return std::make_pair(attach(_rightmost, false, std::forward<V>(value)), true);
+		if(_order(value, _leftmost->value))
+			return std::make_pair(attach(_leftmost, true, std::forward<V>(value)), true);
+		
+		if(hint == nullptr)
+			hint = _rightmost;
+		
+		if(_equals(value, hint->value))
+			return std::make_pair(hint, false);
+		
+		// Risale finche' il limite del sottoalbero dalla parte del valore
+		// (un antenato raggiunto dal figlio destro se il valore e' minore
+		// di hint, dal figlio sinistro altrimenti) non lascia il valore dentro.
+		node *start = hint;
+		bool before = _order(value, hint->value);
+		while(start->parent != nullptr) {
+			node *parent = start->parent;
+			if(before && start == parent->right) {
+				if(_equals(parent->value, value))
+					return std::make_pair(parent, false);
+				if(_order(parent->value, value))
+					break;
+			}
+			if(!before && start == parent->left) {
+				if(_equals(parent->value, value))
+					return std::make_pair(parent, false);
+				if(_order(value, parent->value))
+					break;
+			}
+			start = parent;
+		}
+		
+		return insert_below(start, std::forward<V>(value));
+	}
+	
+	/**
+		@brief Nodi dell'albero in ordine
+		
+		Funzione privata helper che aggiunge a nodes i puntatori ai nodi
+		dell'albero, in ordine crescente (visita simmetrica).
+		Usa uno stack esplicito, quindi non dipende dalla profondita'
+		dell'albero.
+
+		@param nodes vettore a cui aggiungere i puntatori ai nodi
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void in_order(std::vector<node *> &nodes) const {
+		std::vector<node *> pending;
+		node *current = _root;
+		
+		while(current != nullptr || !pending.empty()) {
+			while(current != nullptr) {
+				pending.push_back(current);
+				current = current->left;
+			}
+			current = pending.back();
+			pending.pop_back();
+			nodes.push_back(current);
+			current = current->right;
+		}
+	}
+	
+	/**
+		@brief Costruzione di un albero bilanciato
+		
+		Funzione privata helper che collega in un albero bilanciato
+		una sequenza di nodi ordinati, scegliendo ricorsivamente come
+		radice il nodo centrale. Non alloca e non copia nessun valore.
+
+		@param nodes puntatore al primo nodo della sequenza ordinata
+		@param count numero di nodi della sequenza
+		@param parent puntatore al nodo padre della radice
+
+		@return puntatore al nodo radice dell'albero costruito
+	*/
+	static node *build_balanced(node **nodes, size_type count, node *parent) {
+		if(count == 0)
+			return nullptr;
+		
+		size_type middle = count / 2;
+		node *root = nodes[middle];
+		root->parent = parent;
+		root->left = build_balanced(nodes, middle, root);
+		root->right = build_balanced(nodes + middle + 1, count - middle - 1, root);
+		
+		return root;
+	}
+	
+	/**
+		@brief Inserimento di una sequenza di elementi nell'albero
+		
+		Funzione privata helper di insert_batch. Ordina i valori e, se sono
+		pochi rispetto agli elementi dell'albero, li inserisce uno alla volta;
+		altrimenti li fonde con gli elementi dell'albero in ordine
+		e ricostruisce l'albero bilanciato.
+
+		@param batch valori da inserire
+		@param rejected vettore a cui aggiungere i valori scartati
+			   (nullptr se non interessano)
+
+		@return numero di valori scartati perche' duplicati
+
+		@throw eccezione di allocazione di memoria
+	*/
+	size_type insert_sorted_batch(std::vector<T> batch, std::vector<T> *rejected) {
+		std::sort(batch.begin(), batch.end(), _order);
+		size_type count = 0;
+		
+		if(batch.size() * 8 < _size) {
+			for(size_type j = 0; j < batch.size(); ++j)
+				if(!insert_unique(batch[j]).second) {
+					count++;
+					if(rejected != nullptr)
+						rejected->push_back(batch[j]);
+				}
+			return count;
+		}
+		
+		std::vector<node *> existing;
+		existing.reserve(_size);
+		in_order(existing);
+		
+		std::vector<node *> merged;
+		merged.reserve(existing.size() + batch.size());
+		std::vector<node *> created;
+		created.reserve(batch.size());
+		
+		try {
+			size_type i = 0;
+			size_type j = 0;
+			while(j < batch.size()) {
+				if(i < existing.size() && !_order(batch[j], existing[i]->value)
+				   && !_equals(batch[j], existing[i]->value)) {
+					merged.push_back(existing[i++]);
+					continue;
+				}
+				
+				if((i < existing.size() && _equals(batch[j], existing[i]->value))
+				   || (!created.empty() && _equals(batch[j], created.back()->value))) {
+					count++;
+					if(rejected != nullptr)
+						rejected->push_back(batch[j]);
+				}
+				else {
+					created.push_back(new node(batch[j]));
+					merged.push_back(created.back());
+				}
+				j++;
+			}
+			while(i < existing.size())
+				merged.push_back(existing[i++]);
 		}
 		catch(...) {
-			sub_bst.clear();
+			for(size_type k = 0; k < created.size(); ++k)
+				delete created[k];
+			throw;
+		}
+		
+		_root = build_balanced(merged.data(), static_cast<size_type>(merged.size()), nullptr);
+		_leftmost = merged.empty() ? nullptr : merged.front();
+		_rightmost = merged.empty() ? nullptr : merged.back();
+		_size = static_cast<size_type>(merged.size());
+		
+		return count;
+	}
+	
+	/**
+		@brief Sostituzione di un sottoalbero
+		
+		Funzione privata helper che sostituisce, nel padre di un nodo,
+		il collegamento al nodo con quello a un altro nodo.
+
+		@param n puntatore al nodo da sostituire
+		@param replacement puntatore al nodo sostituto (puo' essere nullptr)
+	*/
+	void transplant(node *n, node *replacement) {
+		if(n->parent == nullptr)
+			_root = replacement;
+		else
+			if(n == n->parent->left)
+				n->parent->left = replacement;
+			else
+				n->parent->right = replacement;
+		
+		if(replacement != nullptr)
+			replacement->parent = n->parent;
+	}
+	
+	/**
+		@brief Scollegamento di un nodo
+		
+		Funzione privata helper che scollega un nodo dall'albero,
+		ricollegando i nodi rimanenti senza copiare nessun valore.
+		Il nodo non viene deallocato.
+
+		@param n puntatore al nodo da scollegare
+	*/
+	void unlink(node *n) {
+		if(n == _leftmost) {
+			// il nodo minimo non ha figlio sinistro: il nuovo minimo
+			// e' il minimo del sottoalbero destro o il padre
+			if(n->right != nullptr) {
+				_leftmost = n->right;
+				while(_leftmost->left != nullptr)
+					_leftmost = _leftmost->left;
+			}
+			else
+				_leftmost = n->parent;
+		}
+		
+		if(n == _rightmost) {
+			// il nodo massimo non ha figlio destro: il nuovo massimo
+			// e' il massimo del sottoalbero sinistro o il padre
+			if(n->left != nullptr) {
+				_rightmost = n->left;
+				while(_rightmost->right != nullptr)
+					_rightmost = _rightmost->right;
+			}
+			else
+				_rightmost = n->parent;
+		}
+		
+		if(n->left == nullptr)
+			transplant(n, n->right);
+		else
+			if(n->right == nullptr)
+				transplant(n, n->left);
+			else {
+				node *next = n->right;
+				while(next->left != nullptr)
+					next = next->left;
+				
+				if(next->parent != n) {
+					transplant(next, next->right);
+					next->right = n->right;
+					next->right->parent = next;
+				}
+				transplant(n, next);
+				next->left = n->left;
+				next->left->parent = next;
+			}
+		
+		n->left = nullptr;
+		n->right = nullptr;
+		n->parent = nullptr;
+		_size--;
+	}
+	
+	/**
+		@brief Estrazione del valore di un nodo
+		
+		Funzione privata helper che scollega un nodo dall'albero
+		e lo dealloca, spostandone il valore senza copiarlo.
+
+		@param n puntatore al nodo da estrarre
+
+		@return valore del nodo
+	*/
+	T release_value(node *n) {
+		unlink(n);
+		T value(std::move(n->value));
+		destroy_node(n);
+		return value;
+	}
+	
+	/**
+		@brief Carico utile di un node_handle
+		
+		Struttura di supporto interna con il nodo posseduto da un
+		node_handle e il blocco che eventualmente lo contiene.
+	*/
+	struct handle_payload {
+		node *n; ///< puntatore al nodo scollegato
+		std::shared_ptr<node_block> block; ///< blocco del nodo (vuoto se allocato singolarmente)
+	};
+	
+	/**
+		@brief Scollegamento di un nodo con passaggio di proprieta'
+		
+		Funzione privata helper che scollega un nodo dall'albero
+		senza distruggerlo, per affidarlo a un node_handle.
+
+		@param n puntatore al nodo da scollegare
+
+		@return nodo e blocco che lo contiene
+	*/
+	handle_payload detach(node *n) {
+		unlink(n);
+		handle_payload payload;
+		payload.n = n;
+		size_type i = block_of(n);
+		if(i < _blocks.size())
+			payload.block = _blocks[i];
+		return payload;
+	}
+	
+	/**
+		@brief Collegamento di un nodo con passaggio di proprieta'
+		
+		Funzione privata helper che collega all'albero un nodo scollegato,
+		se il suo valore non e' gia' presente, prendendone la proprieta'.
+
+		@param payload nodo da collegare e blocco che lo contiene
+
+		@return coppia formata dal puntatore al nodo con il valore
+				e da true se il nodo e' stato collegato,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria (il nodo non viene collegato)
+	*/
+	std::pair<node *, bool> attach_node(const handle_payload &payload) {
+		node *current = _root;
+		node *previous = nullptr;
+		const T &value = payload.n->value;
+		
+		while(current != nullptr) {
+			previous = current;
+			if(_equals(value, current->value))
+				return std::make_pair(current, false);
+			if(_order(value, current->value))
+				current = current->left;
+			else
+				current = current->right;
+		}
+		
+		if(payload.block)
+			adopt_block(payload.block);
+		bool left = (previous != nullptr && _order(value, previous->value));
+		return std::make_pair(link(previous, left, payload.n), true);
+	}
+	
+	/**
+		@brief Eliminazione dell'intero contenuto dell'albero
+		
+		Funzione privata che elimina tutti i nodi dell'albero.
+	*/
+	void clear() {
+		clear_tree(_root);
+		_blocks.clear();
+		_root = nullptr;
+		_leftmost = nullptr;
+		_rightmost = nullptr;
+	}
+	
+	/**
+		@brief Eliminazione ricorsiva di un albero
+		
+		Funzione privata helper per l'eliminazione dei nodi di un albero,
+		tramite l'eliminazione ricorsiva dei suoi sottoalberi.
+		Elimina un albero data la sua radice.
+
+		@param root puntatore al nodo radice dell'albero da eliminare
+	*/
+	void clear_tree(node *root) {
+		if(root != nullptr) {
+			clear_tree(root->left);
+			clear_tree(root->right);
+			destroy_node(root);
+			root = nullptr;	
+			_size--;
+		}
+	}
+	
+	/**
+		@brief Nodo con un certo valore
+		
+		Funzione privata helper che cerca se esiste nell'albero un nodo
+		con un certo valore cercato e, in caso affermativo,
+		ritorna un puntatore al nodo stesso.
+		L'uguaglianza e' definita dal funtore di confronto di uguaglianza (==)
+		_equals, di tipo E.
+
+		@param value valore del nodo da cercare
+
+		@return puntatore al nodo che ha il valore cercato,
+				nullptr se non esiste nessun nodo che ha il valore cercato
+	*/
+	node *search(const T &value) const {
+		node *current = _root;
+		
+		while(current != nullptr && !_equals(current->value, value))
+			if(_order(value, current->value))
+				current = current->left;
+			else
+				current = current->right;
+		
+		return current;
+	}
+	
+	static const unsigned int batch_group_size = 16; ///< numero di ricerche eseguite in modo interlacciato
+	
+	/**
+		@brief Ricerca interlacciata di un gruppo di valori
+		
+		Funzione privata helper che cerca contemporaneamente fino a
+		batch_group_size valori. Ad ogni passo fa scendere di un livello
+		tutte le ricerche non ancora concluse e richiede in anticipo
+		(prefetch) il nodo successivo di ciascuna, in modo che i caricamenti
+		dalla memoria delle diverse ricerche si sovrappongano invece
+		di essere attesi uno alla volta.
+
+		@param values puntatori ai valori da cercare
+		@param found puntatori ai nodi trovati (nullptr se il valore
+			   non e' presente nell'albero)
+		@param n numero di valori da cercare
+	*/
+	void search_group(const T *const *values, const node **found, unsigned int n) const {
+		bool done[batch_group_size];
+		unsigned int active = 0;
+		
+		for(unsigned int i = 0; i < n; ++i) {
+			found[i] = _root;
+			done[i] = (_root == nullptr);
+			if(!done[i])
+				active++;
+		}
+		
+		while(active > 0)
+			for(unsigned int i = 0; i < n; ++i) {
+				if(done[i])
+					continue;
+				
+				const node *current = found[i];
+				if(_equals(current->value, *values[i])) {
+					done[i] = true;
+					active--;
+					continue;
+				}
+				
+				if(_order(*values[i], current->value))
+					current = current->left;
+				else
+					current = current->right;
+				
+				found[i] = current;
+				if(current == nullptr) {
+					done[i] = true;
+					active--;
+				}
+				else
+					BST_PREFETCH(current);
+			}
+	}
+	
+	/**
+		@brief Prossimo gruppo di valori da cercare
+		
+		Funzione privata helper che raccoglie i puntatori ai prossimi
+		(al massimo batch_group_size) valori di una sequenza,
+		facendo avanzare l'iteratore first.
+
+		@param first iteratore forward al prossimo valore da cercare
+		@param last iteratore forward alla fine della sequenza
+		@param values puntatori ai valori raccolti
+
+		@return numero di valori raccolti, 0 se la sequenza e' terminata
+	*/
+	template <typename I>
+	static unsigned int next_group(I &first, I last, const T **values) {
+		unsigned int n = 0;
+		for(; n < batch_group_size && first != last; ++n, ++first)
+			values[n] = &*first;
+		return n;
+	}
+
+public:
+	
+	// Metodi fondamentali
+	
+	/**
+		@brief Costruttore di default (METODO FONDAMENTALE)
+		
+		Costruttore di default per istanziare un albero vuoto.
+		E' l'unico costruttore che puo' essere utilizzato per istanziare
+		un eventuale array di alberi.
+	*/
+	binary_search_tree() : _root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0) {} // initialization list
+
+	/**
+		@brief Costruttore di copia/Copy Constructor (METODO FONDAMENTALE)
+		
+		Costruttore di copia/Copy Constructor.
+		Permette di istanziare un albero con i valori presi da un altro albero.
+
+		@param other albero da copiare per creare quello corrente
+		
+		@throw eccezione di allocazione di memoria
+	*/
+	binary_search_tree(const binary_search_tree &other) : _root(nullptr), _leftmost(nullptr), _rightmost(nullptr), _size(0) { // initialization list
+		try {
+			insert_tree(other._root);
+		}
+		catch(...) {
+			clear();
 			throw;
 		}
+	}
+
+	/**
+		@brief Operatore di assegnamento (METODO FONDAMENTALE)
+		
+		Operatore di assegnamento. Permette la copia tra alberi.
+		
+		@param other albero come sorgente da copiare (operando di destra)
+		
+		@return reference a this
+
+		@throw eccezione di allocazione di memoria
+	*/
+	binary_search_tree &operator=(const binary_search_tree &other) {
+		
+		// Per evitare l'auto-assegnamento (this = this)
+		if(this != &other) {
+			binary_search_tree tmp(other);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Distruttore (METODO FONDAMENTALE)
+		
+		Distruttore. Rimuove la memoria allocata da un albero.
+	*/
+	~binary_search_tree() {
+		clear();
+	}
+	
+	// Fine metodi fondamentali
+	
+	// Ulteriori metodi pubblici
+
+	/**
+		@brief Scambio del contenuto di due alberi
+		
+		Scambia in tempo costante il contenuto dell'albero con quello
+		di un altro albero, senza copiare nessun valore.
+
+		@param other albero con cui scambiare il contenuto
+	*/
+	void swap(binary_search_tree &other) {
+		std::swap(_root,other._root);
+		std::swap(_leftmost,other._leftmost);
+		std::swap(_rightmost,other._rightmost);
+		std::swap(_size,other._size);
+		_blocks.swap(other._blocks);
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+		
+		Inserisce un elemento nell'albero, secondo l'ordinamento definito
+		dal funtore di confronto di ordinamento (<) _order, di tipo O.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+		
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		if(!insert_unique(value).second)
+			throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+	}
+	
+	/**
+		@brief Inserimento di una sequenza di elementi nell'albero
+		
+		Inserisce nell'albero i valori di una sequenza, scartando
+		senza lanciare eccezioni quelli gia' presenti nell'albero
+		o ripetuti nella sequenza.
+		I valori vengono ordinati e poi fusi con gli elementi dell'albero
+		in un unico passaggio che ricostruisce l'albero bilanciato
+		riutilizzandone i nodi; se la sequenza e' piccola rispetto
+		all'albero, i valori ordinati vengono invece inseriti uno alla volta.
+
+		@param first iteratore al primo valore da inserire
+		@param last iteratore alla fine della sequenza
+
+		@return numero di valori scartati perche' duplicati
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	size_type insert_batch(I first, I last) {
+		return insert_sorted_batch(std::vector<T>(first, last), nullptr);
+	}
+	
+	/**
+		@brief Inserimento di una sequenza di elementi nell'albero
+		
+		Come insert_batch(first, last), ma scrive anche i valori scartati
+		perche' duplicati, in ordine crescente, sull'iteratore di output
+		rejected.
+
+		@param first iteratore al primo valore da inserire
+		@param last iteratore alla fine della sequenza
+		@param rejected iteratore di output su cui scrivere i valori scartati
+
+		@return numero di valori scartati perche' duplicati
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I, typename OI>
+	size_type insert_batch(I first, I last, OI rejected) {
+		std::vector<T> duplicates;
+		size_type count = insert_sorted_batch(std::vector<T>(first, last), &duplicates);
+		std::copy(duplicates.begin(), duplicates.end(), rejected);
+		return count;
+	}
+	
+	/**
+		@brief Sostituzione del contenuto con una sequenza ordinata
+		
+		Sostituisce il contenuto dell'albero con i valori di una sequenza
+		strettamente crescente, costruendo in tempo O(n) un albero
+		bilanciato i cui nodi sono disposti in ordine crescente in un
+		unico blocco di memoria (come dopo compact). Per spostare
+		i valori invece di copiarli si puo' usare std::make_move_iterator.
+		
+		@pre La sequenza dev'essere strettamente crescente secondo _order
+		
+		@param first iteratore (almeno forward) al primo valore
+		@param last iteratore alla fine della sequenza
+		
+		@throw std::invalid_argument se la sequenza non e' strettamente
+			   crescente (l'albero non cambia)
+		@throw eccezione di allocazione di memoria (l'albero non cambia)
+	*/
+	template <typename I>
+	void assign_sorted(I first, I last) {
+		size_type count = 0;
+		for(I previous = first, current = first; current != last; previous = current++, ++count)
+			if(current != first && !_order(*previous, *current))
+				throw std::invalid_argument("binary_search_tree: sequenza non strettamente crescente");
+		
+		binary_search_tree tmp;
+		if(count > 0) {
+			std::vector<node *> nodes(count);
+			tmp._blocks.push_back(std::make_shared<node_block>(count));
+			node *block = tmp._blocks[0]->nodes;
+			size_type built = 0;
+			try {
+				for(; built < count; ++built, ++first)
+					nodes[built] = new (block + built) node(*first);
+			}
+			catch(...) {
+				while(built > 0)
+					block[--built].~node();
+				throw;
+			}
+			
+			tmp._blocks[0]->live = count;
+			tmp._root = build_balanced(nodes.data(), count, nullptr);
+			tmp._leftmost = block;
+			tmp._rightmost = block + count - 1;
+			tmp._size = count;
+		}
+		swap(tmp);
+	}
+	
+	/**
+		@brief Numero totale di dati inseriti nell'albero
+		
+		Ritorna il numero totale di dati inseriti nell'albero
+
+		@return numero totale di dati inseriti nell'albero
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+		
+		Controlla se esiste un elemento di tipo T nell'albero.
+		L'uguaglianza e' definita dal funtore di confronto di uguaglianza (==)
+		_equals, di tipo E.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return search(value) != nullptr;
+	}
+	
+	/**
+		@brief Rimozione di un elemento dall'albero
+		
+		Rimuove un elemento dall'albero. I nodi rimanenti vengono
+		ricollegati senza copiare nessun valore.
+		
+		@pre Il valore da rimuovere dev'essere presente all'interno dell'albero
+		
+		@param value valore dell'elemento da rimuovere
+		
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+	*/
+	void erase(const T &value) {
+		node *n = search(value);
+		if(n == nullptr)
+			throw bst_value_not_found_exception<T>("Valore non trovato: ", value);
+		
+		unlink(n);
+		destroy_node(n);
+	}
+	
+	/**
+		@brief Valore minimo
+		
+		Ritorna in tempo costante il valore minimo dell'albero.
+		
+		@pre L'albero non dev'essere vuoto
+		
+		@return reference costante al valore minimo
+		
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	const T &min() const {
+		if(_leftmost == nullptr)
+			throw bst_empty_tree_exception("Albero vuoto");
+		return _leftmost->value;
+	}
+	
+	/**
+		@brief Valore massimo
+		
+		Ritorna in tempo costante il valore massimo dell'albero.
+		
+		@pre L'albero non dev'essere vuoto
+		
+		@return reference costante al valore massimo
+		
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	const T &max() const {
+		if(_rightmost == nullptr)
+			throw bst_empty_tree_exception("Albero vuoto");
+		return _rightmost->value;
+	}
+	
+	/**
+		@brief Estrazione del valore minimo
+		
+		Rimuove dall'albero il valore minimo e lo ritorna spostandolo,
+		senza copiarlo e senza allocare memoria. Il nodo minimo non ha
+		figlio sinistro: lo scollegamento e il calcolo del nuovo minimo
+		costano in media tempo costante (per un uso come coda di priorita').
+		
+		@pre L'albero non dev'essere vuoto
+		
+		@return valore minimo
+		
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	T pop_min() {
+		if(_leftmost == nullptr)
+			throw bst_empty_tree_exception("Albero vuoto");
+		return release_value(_leftmost);
+	}
+	
+	/**
+		@brief Estrazione del valore massimo
+		
+		Rimuove dall'albero il valore massimo e lo ritorna spostandolo,
+		senza copiarlo e senza allocare memoria.
+		
+		@pre L'albero non dev'essere vuoto
+		
+		@return valore massimo
+		
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	T pop_max() {
+		if(_rightmost == nullptr)
+			throw bst_empty_tree_exception("Albero vuoto");
+		return release_value(_rightmost);
+	}
+	
+	/**
+		@brief Compattazione dei nodi in memoria
+		
+		Sposta tutti i nodi dell'albero in un unico blocco di memoria
+		contiguo, disposti nell'ordine scelto, e ne ricollega i puntatori.
+		La forma dell'albero e i valori non cambiano (i valori vengono
+		spostati, non copiati), e l'albero resta modificabile: i nuovi
+		nodi vengono allocati singolarmente e il blocco viene deallocato
+		quando tutti i suoi nodi sono stati rimossi.
+		Durante l'operazione servono la memoria del nuovo blocco
+		e un vettore di puntatori ai nodi.
+		
+		Puntatori, reference e iteratori ai valori dell'albero
+		non sono piu' validi dopo la compattazione.
+		
+		@param layout ordine dei nodi nel blocco
+		
+		@throw eccezione di allocazione di memoria (l'albero non cambia)
+	*/
+	void compact(bst_layout layout = bst_layout_in_order) {
+		if(_size == 0)
+			return;
+		
+		std::vector<node *> nodes;
+		nodes.reserve(_size);
+		if(layout == bst_layout_breadth_first)
+			breadth_first(nodes);
+		else
+			if(layout == bst_layout_van_emde_boas)
+				van_emde_boas(_root, height(), nodes);
+			else
+				in_order(nodes);
+		
+		size_type count = static_cast<size_type>(nodes.size());
+		std::vector<std::shared_ptr<node_block> > blocks(1, std::make_shared<node_block>(count));
+		node *block = blocks[0]->nodes;
+		size_type built = 0;
+		try {
+			for(; built < count; ++built)
+				new (block + built) node(std::move_if_noexcept(nodes[built]->value),
+										 nodes[built]->left, nodes[built]->right, nodes[built]->parent);
+		}
+		catch(...) {
+			while(built > 0)
+				block[--built].~node();
+			throw;
+		}
+		
+		// Il campo parent dei vecchi nodi diventa l'indirizzo del nuovo nodo
+		for(size_type i = 0; i < count; ++i)
+			nodes[i]->parent = block + i;
+		for(size_type i = 0; i < count; ++i) {
+			node &n = block[i];
+			if(n.left != nullptr)
+				n.left = n.left->parent;
+			if(n.right != nullptr)
+				n.right = n.right->parent;
+			if(n.parent != nullptr)
+				n.parent = n.parent->parent;
+		}
+		_root = _root->parent;
+		_leftmost = _leftmost->parent;
+		_rightmost = _rightmost->parent;
+		
+		for(size_type i = 0; i < count; ++i)
+			destroy_node(nodes[i]);
+		blocks[0]->live = count;
+		_blocks.swap(blocks); // i blocchi precedenti non contengono piu' nodi dell'albero
+	}
+	
+	/**
+		@brief Sottoalbero
+		
+		Metodo che, passato un dato d dello stesso tipo T dei dati contenuti
+		nell'albero, ritorna un nuovo albero, che corrisponde al sottoalbero
+		avente come radice il nodo con il valore d.
+		
+		@pre Il valore d dev'essere presente all'interno dell'albero
+		
+		@param d valore del nodo radice del sottoalbero
+		
+		@return sottoalbero avente come radice il nodo con il valore d
+		
+		@throw bst_value_not_found_exception se il valore d non e' presente
+			   all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	binary_search_tree subtree(const T &d) const {
+		binary_search_tree sub_bst;
+		
+		node *sub_root = search(d);
+		if(sub_root == nullptr)
+			throw bst_value_not_found_exception<T>("Valore non trovato: ", d);
+		
+		try {
+			sub_bst.insert_tree(sub_root);
+		}
+		catch(...) {
+			sub_bst.clear();
+			throw;
+		}
+		
+		return sub_bst;
+	}
+
+	/**
+		@brief Copia ordinata dei valori dell'albero
+		
+		Copia i valori dell'albero in ordine crescente (visita simmetrica)
+		in una sequenza di output.
+
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		std::vector<const node *> pending;
+		const node *current = _root;
+		
+		while(current != nullptr || !pending.empty()) {
+			while(current != nullptr) {
+				pending.push_back(current);
+				current = current->left;
+			}
+			current = pending.back();
+			pending.pop_back();
+			*out++ = current->value;
+			current = current->right;
+		}
+		
+		return out;
+	}
+	
+	/**
+		@brief Copia ordinata dei valori di un intervallo
+		
+		Copia in ordine crescente in una sequenza di output i valori v
+		dell'albero compresi nell'intervallo [low, high), cioe' tali che
+		!(v < low) e v < high. I sottoalberi esterni all'intervallo
+		non vengono visitati.
+
+		@param low estremo inferiore dell'intervallo (incluso)
+		@param high estremo superiore dell'intervallo (escluso)
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_range(const T &low, const T &high, OI out) const {
+		std::vector<const node *> pending;
+		const node *current = _root;
+		
+		while(current != nullptr || !pending.empty()) {
+			while(current != nullptr)
+				if(_order(current->value, low))
+					current = current->right; // sottoalbero sinistro fuori intervallo
+				else {
+					pending.push_back(current);
+					current = current->left;
+				}
+			if(pending.empty())
+				break;
+			current = pending.back();
+			pending.pop_back();
+			if(!_order(current->value, high))
+				break; // tutti i valori successivi sono fuori intervallo
+			*out++ = current->value;
+			current = current->right;
+		}
+		
+		return out;
+	}
+
+	/**
+		@brief Iteratore costante di tipo forward dell'albero
+		
+		Iteratore a sola lettura (costante) di tipo forward
+		per accedere ai dati presenti nell'albero.
+		Iteratore da usarsi su oggetti const (non modifica i dati puntati).
+	*/
+	class const_iterator {
+		const node *_n; ///< puntatore a un nodo dell'albero
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+		
+		/**
+			@brief Costruttore di default
+			
+			Costruttore di default per istanziare un iteratore costante
+			che punta a nullptr.
+		*/
+		const_iterator() : _n(nullptr) { // initialization list
+		}
+		
+		/**
+			@brief Costruttore di copia/Copy Constructor
+			
+			Costruttore di copia/Copy Constructor per l'iteratore costante.
+			Permette di istanziare un iteratore costante
+			con i valori presi da un altro iteratore costante.
+			
+			@param other iteratore costante da copiare per creare quello corrente
+		*/
+		const_iterator(const const_iterator &other) : _n(other._n) {} // initialization list
+
+		/**
+			@brief Operatore di assegnamento
+			
+			Operatore di assegnamento per l'iteratore costante.
+			Permette la copia tra iteratori costanti.
+			
+			@param other iteratore costante come sorgente da copiare
+				   (operando di destra)
+			
+			@return reference a this
+		*/
+		const_iterator &operator=(const const_iterator &other) {
+			_n = other._n;
+			return *this;
+		}
+
+		/**
+			@brief Distruttore
+			
+			Distruttore per l'iteratore costante.
+			Rimuove la memoria allocata da un iteratore costante.
+		*/
+		~const_iterator() {}
+
+		/**
+			@brief Operatore di dereferenziamento
+			
+			Operatore di dereferenziamento per l'accesso in lettura dei dati.
+			
+			@return dato riferito dall'iteratore costante
+		*/
+		reference operator*() const {
+			return _n->value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+			
+			Operatore di accesso in lettura ai dati.
+			
+			@return puntatore al dato riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &(_n->value);
+		}
+		
+		/**
+			@brief Operatore di iterazione pre-incremento
+			
+			Operatore di iterazione pre-incremento per l'iteratore costante.
+			
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			// ha figli
+			if(_n->left != nullptr) // ha un figlio sinistro
+				_n = _n->left;
+			else // non ha un figlio sinistro
+				if(_n->right != nullptr) // ha un figlio destro
+					_n = _n->right;
+				else { // non ha un figlio destro
+					// non ha figli
+					while(_n->parent != nullptr) // ha un padre
+						if(_n == _n->parent->left) { // e' figlio sinistro
+							_n = _n->parent;
+							if(_n->right != nullptr) { // ha un figlio destro
+								_n = _n->right;
+								return *this;
+							}
+						}
+						else //  figlio destro
+							_n = _n->parent;
+					
+					// se si esce dal corpo del ciclo while,
+					// l'iteratore ora punta alla radice e ha visitato tutti i nodi
+					
+					_n = nullptr;
+				}
+			
+			// se non si entra nel corpo dell'else,
+			// l'iteratore ora punta a un figlio sinistro o destro da visitare
+			
+			return *this;
+		}
+		
+		/**
+			@brief Operatore di iterazione post-incremento
+			
+			Operatore di iterazione post-incremento per l'iteratore costante.
+			
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+			
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+			
+			Operatore di uguaglianza per l'iteratore costante.
+			
+			@param other iteratore da confrontare con this
+			
+			@return true se gli iteratori this e other puntano allo stesso nodo,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (_n == other._n);
+		}
+		
+		/**
+			@brief Operatore di diversit
+			
+			Operatore di diversit per l'iteratore costante.
+			
+			@param other iteratore da confrontare con this
+			
+			@return true se gli iteratori this e other puntano a nodi diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return (_n != other._n);
+		}
+
+	private:
+		
+		// Dati membro
+
+		// La classe container (binary_search_tree) dev'essere dichiarata friend
+		// dell'iteratore per concederle l'accesso al costruttore privato
+		// di inizializzazione nei metodi begin ed end.
+		friend class binary_search_tree; 
+
+		/**
+			@brief Costruttore privato
+			
+			Costruttore privato di inizializzazione utilizzato
+			dalla classe container (binary_search_tree) nei metodi begin ed end.
+			
+			@param n puntatore a un nodo dell'albero
+		*/
+		const_iterator(const node *n) : _n(n) {} // initialization list
+		
+	}; // class const_iterator
+	
+	// Funzioni membro per l'utilizzo degli iteratori
+	// da parte della classe container (binary_search_tree)
+	
+	/**
+		@brief Iteratore che punta all'inizio dell'albero
+		
+		Funzione membro che ritorna un iteratore
+		che punta all'inizio dell'albero (alla sua radice).
+	
+		@return iteratore che punta all'inizio dell'albero
+	*/
+	const_iterator begin() const {
+		return const_iterator(_root);
+	}
+	
+	/**
+		@brief Iteratore che punta alla fine dell'albero
+		
+		Funzione membro che ritorna un iteratore
+		che punta alla fine dell'albero.
+	
+		@return iteratore che punta alla fine dell'albero
+	*/
+	const_iterator end() const {
+		return const_iterator(nullptr);
+	}
+	
+	/**
+		@brief Iteratore costante ordinato dell'albero
+		
+		Classe che implementa un iteratore costante di tipo forward
+		che visita l'albero in ordine crescente (in-order), senza copiare
+		i valori e senza memoria aggiuntiva: il successore di un nodo
+		si raggiunge scendendo nel sottoalbero destro o risalendo
+		i puntatori ai padri, con costo medio costante per passo.
+	*/
+	class const_sorted_iterator {
+		
+		const node *_n; ///< puntatore a un nodo dell'albero
+		
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+		
+		/**
+			@brief Costruttore di default
+			
+			Costruttore di default per istanziare un iteratore costante
+			che punta a nullptr.
+		*/
+		const_sorted_iterator() : _n(nullptr) {} // initialization list
+		
+		// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+		// coincidono con quelli di default
+		
+		/**
+			@brief Operatore di dereferenziamento
+			
+			@return dato riferito dall'iteratore costante
+		*/
+		reference operator*() const {
+			return _n->value;
+		}
+		
+		/**
+			@brief Operatore di accesso ai dati
+			
+			@return puntatore al dato riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &(_n->value);
+		}
+		
+		/**
+			@brief Operatore di iterazione pre-incremento
+			
+			Sposta l'iteratore sul valore successivo in ordine crescente.
+			
+			@return reference all'iteratore incrementato
+		*/
+		const_sorted_iterator &operator++() {
+			_n = successor(_n);
+			return *this;
+		}
+		
+		/**
+			@brief Operatore di iterazione post-incremento
+			
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+			
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_sorted_iterator operator++(int) {
+			const_sorted_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+		
+		/**
+			@brief Operatore di uguaglianza
+			
+			@param other iteratore da confrontare con this
+			
+			@return true se gli iteratori this e other puntano allo stesso nodo,
+					false altrimenti
+		*/
+		bool operator==(const const_sorted_iterator &other) const {
+			return (_n == other._n);
+		}
+		
+		/**
+			@brief Operatore di diversita'
+			
+			@param other iteratore da confrontare con this
+			
+			@return true se gli iteratori this e other puntano a nodi diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_sorted_iterator &other) const {
+			return (_n != other._n);
+		}
+		
+	private:
+		
+		// La classe container (binary_search_tree) dev'essere dichiarata friend
+		// dell'iteratore per concederle l'accesso al costruttore privato
+		friend class binary_search_tree;
+		
+		/**
+			@brief Costruttore privato
+			
+			@param n puntatore a un nodo dell'albero
+		*/
+		explicit const_sorted_iterator(const node *n) : _n(n) {} // initialization list
+		
+	}; // class const_sorted_iterator
+	
+	/**
+		@brief Iteratore ordinato che punta al valore minimo
+		
+		@return iteratore ordinato che punta al valore minimo
+				(in tempo costante)
+	*/
+	const_sorted_iterator sorted_begin() const {
+		return const_sorted_iterator(_leftmost);
+	}
+	
+	/**
+		@brief Iteratore ordinato che punta alla fine dell'albero
+		
+		@return iteratore ordinato che punta alla fine dell'albero
+	*/
+	const_sorted_iterator sorted_end() const {
+		return const_sorted_iterator(nullptr);
+	}
+	
+	/**
+		@brief Primo valore non minore di un valore
+		
+		@param value valore da cercare
+		
+		@return iteratore ordinato al primo valore non minore di value,
+				sorted_end() se non esiste
+	*/
+	const_sorted_iterator sorted_lower_bound(const T &value) const {
+		const node *found = nullptr;
+		const node *current = _root;
+		while(current != nullptr)
+			if(_order(current->value, value))
+				current = current->right;
+			else {
+				found = current;
+				current = current->left;
+			}
+		return const_sorted_iterator(found);
+	}
+	
+	/**
+		@brief Ricerca di un elemento nell'albero
+		
+		Cerca un elemento di tipo T nell'albero e ritorna un iteratore
+		che punta ad esso.
+		L'uguaglianza e' definita dal funtore di confronto di uguaglianza (==)
+		_equals, di tipo E.
+
+		@param value valore da cercare
+
+		@return iteratore che punta all'elemento cercato,
+				end() se l'elemento non e' presente nell'albero
+	*/
+	const_iterator find(const T &value) const {
+		return const_iterator(search(value));
+	}
+	
+	/**
+		@brief Controllo di esistenza di una sequenza di elementi
+		
+		Controlla se esistono nell'albero i valori di una sequenza e scrive
+		il risultato (bool) di ciascun controllo, nell'ordine della sequenza,
+		sull'iteratore di output out.
+		Equivale a chiamare exists per ogni valore, ma esegue le ricerche
+		a gruppi in modo interlacciato, sovrapponendo gli accessi in memoria
+		di ricerche diverse: conviene per sequenze lunghe su alberi
+		che non stanno in cache.
+
+		@param first iteratore forward al primo valore da cercare
+		@param last iteratore forward alla fine della sequenza
+		@param out iteratore di output su cui scrivere i risultati
+
+		@return iteratore di output dopo l'ultimo risultato scritto
+	*/
+	template <typename I, typename OI>
+	OI exists_batch(I first, I last, OI out) const {
+		const T *values[batch_group_size];
+		const node *found[batch_group_size];
+		unsigned int n;
+		
+		while((n = next_group(first, last, values)) > 0) {
+			search_group(values, found, n);
+			for(unsigned int i = 0; i < n; ++i)
+				*out++ = (found[i] != nullptr);
+		}
+		
+		return out;
+	}
+	
+	/**
+		@brief Ricerca di una sequenza di elementi
+		
+		Cerca nell'albero i valori di una sequenza e scrive un iteratore
+		all'elemento trovato (o end() se il valore non e' presente),
+		nell'ordine della sequenza, sull'iteratore di output out.
+		Esegue le ricerche in modo interlacciato come exists_batch.
+
+		@param first iteratore forward al primo valore da cercare
+		@param last iteratore forward alla fine della sequenza
+		@param out iteratore di output su cui scrivere i const_iterator
+
+		@return iteratore di output dopo l'ultimo risultato scritto
+	*/
+	template <typename I, typename OI>
+	OI find_batch(I first, I last, OI out) const {
+		const T *values[batch_group_size];
+		const node *found[batch_group_size];
+		unsigned int n;
+		
+		while((n = next_group(first, last, values)) > 0) {
+			search_group(values, found, n);
+			for(unsigned int i = 0; i < n; ++i)
+				*out++ = const_iterator(found[i]);
+		}
+		
+		return out;
+	}
+	
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+		
+		Inserisce un elemento nell'albero, se non e' gia' presente.
+		A differenza di insert, un valore duplicato non e' un errore:
+		non viene lanciata nessuna eccezione e non viene allocata memoria.
+
+		@param value valore dell'elemento da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const T &value) {
+		std::pair<node *, bool> result = insert_unique(value);
+		return std::make_pair(const_iterator(result.first), result.second);
+	}
+	
+	/**
+		@brief Inserimento senza eccezioni con suggerimento di posizione
+		
+		Inserisce un elemento nell'albero, se non e' gia' presente,
+		usando hint come suggerimento della posizione: se il valore
+		appartiene vicino all'elemento riferito da hint (o al valore
+		massimo, se hint e' end()), l'inserimento avviene in tempo costante
+		ammortizzato senza scendere dalla radice.
+		Per flussi di valori quasi crescenti conviene passare come hint
+		l'iteratore ritornato dall'inserimento precedente, oppure end().
+
+		@param hint iteratore all'elemento vicino al quale inserire il valore
+		@param value valore dell'elemento da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const_iterator hint, const T &value) {
+		std::pair<node *, bool> result = insert_hint(const_cast<node *>(hint._n), value);
+		return std::make_pair(const_iterator(result.first), result.second);
+	}
+	
+	/**
+		@brief Inserimento con suggerimento di posizione
+		
+		Inserisce un elemento nell'albero come try_insert(hint, value),
+		ma lancia un'eccezione se il valore e' gia' presente, come insert.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param hint iteratore all'elemento vicino al quale inserire il valore
+		@param value valore dell'elemento da inserire
+
+		@return iteratore all'elemento inserito
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	const_iterator insert(const_iterator hint, const T &value) {
+		std::pair<const_iterator, bool> result = try_insert(hint, value);
+		if(!result.second)
+			throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+		return result.first;
+	}
+	
+	/**
+		@brief Inserimento senza eccezioni di un elemento costruito sul posto
+		
+		Costruisce un valore con gli argomenti passati e lo sposta
+		in un nuovo nodo dell'albero, se non e' gia' presente.
+		Se il valore e' un duplicato non viene lanciata nessuna eccezione
+		e il nodo non viene allocato.
+
+		@param args argomenti per il costruttore del valore
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename... Args>
+	std::pair<const_iterator, bool> try_emplace(Args&&... args) {
+		std::pair<node *, bool> result = insert_unique(T(std::forward<Args>(args)...));
+		return std::make_pair(const_iterator(result.first), result.second);
+	}
+	
+	// Fine funzioni membro per l'utilizzo degli iteratori
+	
+protected:
+	
+	// Funzioni helper per le classi derivate
+	
+	/**
+		@brief Nodo con una certa chiave
+		
+		Funzione privata helper che cerca un nodo come search, ma con
+		una chiave di tipo K invece che con un valore di tipo T, senza
+		costruire un valore temporaneo: i funtori devono accettare
+		_order(key, value) e _equals(value, key).
+		
+		@param key chiave del nodo da cercare
+		
+		@return puntatore al nodo che ha la chiave cercata,
+				nullptr se non esiste
+	*/
+	template <typename K>
+	node *search_key(const K &key) const {
+		node *current = _root;
+		
+		while(current != nullptr && !_equals(current->value, key))
+			if(_order(key, current->value))
+				current = current->left;
+			else
+				current = current->right;
+		
+		return current;
+	}
+	
+	/**
+		@brief Inserimento senza eccezioni di un valore con una certa chiave
+		
+		Funzione privata helper che cerca la posizione di una chiave
+		come search_key e, se la chiave non e' presente, costruisce
+		il valore con gli argomenti passati in un nuovo nodo.
+		Se la chiave e' presente il valore non viene costruito.
+		
+		@pre Il valore costruito deve avere la chiave key
+		
+		@param key chiave del valore
+		@param args argomenti per il costruttore del valore
+		
+		@return coppia formata dal puntatore al nodo con la chiave
+				e da true se il nodo e' stato inserito,
+				false se la chiave era gia' presente
+		
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename K, typename... Args>
+	std::pair<node *, bool> emplace_key(const K &key, Args&&... args) {
+		node *current = _root;
+		node *previous = nullptr;
+		
+		while(current != nullptr) {
+			previous = current;
+			if(_equals(current->value, key))
+				return std::make_pair(current, false);
+			if(_order(key, current->value))
+				current = current->left;
+			else
+				current = current->right;
+		}
 		
-		return sub_bst;
+		bool left = (previous != nullptr && _order(key, previous->value));
+		
+		return std::make_pair(attach(previous, left, T(std::forward<Args>(args)...)), true);
 	}
-
+	
 	/**
-		@brief Iteratore costante di tipo forward dell'albero
+		@brief Primo nodo non minore di una chiave
 		
-		Iteratore a sola lettura (costante) di tipo forward
-		per accedere ai dati presenti nell'albero.
-		Iteratore da usarsi su oggetti const (non modifica i dati puntati).
+		Funzione privata helper che cerca il primo nodo come
+		sorted_lower_bound, ma con una chiave di tipo K: il funtore
+		di ordinamento deve accettare _order(value, key).
+		
+		@param key chiave da cercare
+		
+		@return puntatore al primo nodo non minore di key,
+				nullptr se non esiste
 	*/
-	class const_iterator {
-		const node *_n; ///< puntatore a un nodo dell'albero
-
-	public:
-		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
-		typedef T                         value_type; ///< tipo dei dati puntati: T
-		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
-		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
-		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+	template <typename K>
+	node *lower_bound_key(const K &key) const {
+		node *found = nullptr;
+		node *current = _root;
+		while(current != nullptr)
+			if(_order(current->value, key))
+				current = current->right;
+			else {
+				found = current;
+				current = current->left;
+			}
+		return found;
+	}
+	
+	/**
+		@brief Iteratore a un nodo
 		
-		/**
-			@brief Costruttore di default
-			
-			Costruttore di default per istanziare un iteratore costante
-			che punta a nullptr.
-		*/
-		const_iterator() : _n(nullptr) { // initialization list
-		}
+		@param n puntatore a un nodo dell'albero (nullptr per end())
+		
+		@return iteratore che punta al nodo
+	*/
+	static const_iterator iterator_to(const node *n) {
+		return const_iterator(n);
+	}
+	
+	/**
+		@brief Iteratore ordinato a un nodo
+		
+		@param n puntatore a un nodo dell'albero (nullptr per sorted_end())
+		
+		@return iteratore ordinato che punta al nodo
+	*/
+	static const_sorted_iterator sorted_iterator_to(const node *n) {
+		return const_sorted_iterator(n);
+	}
+	
+	/**
+		@brief Nodo di un iteratore
+		
+		@param i iteratore a un elemento dell'albero
+		
+		@return puntatore al nodo riferito dall'iteratore
+	*/
+	static node *node_of(const_iterator i) {
+		return const_cast<node *>(i._n);
+	}
+	
+public:
+	
+	// Divisione, unione ed estrazione senza copie	
+	/**
+		@brief Nodo estratto da un albero
+		
+		Classe che possiede un nodo estratto da un albero con extract,
+		che puo' essere inserito in un altro albero (o nello stesso)
+		con insert senza copiare il valore e senza allocare memoria.
+		Il valore puo' essere modificato prima dell'inserimento.
+		Se il nodo non viene inserito, il distruttore lo dealloca.
+		Un node_handle puo' essere spostato ma non copiato.
+	*/
+	class node_handle {
+		
+		friend class binary_search_tree; // per la costruzione e l'inserimento
+		
+		handle_payload _payload; ///< nodo posseduto e blocco che lo contiene
 		
 		/**
-			@brief Costruttore di copia/Copy Constructor
+			@brief Costruttore secondario
 			
-			Costruttore di copia/Copy Constructor per l'iteratore costante.
-			Permette di istanziare un iteratore costante
-			con i valori presi da un altro iteratore costante.
+			Costruttore secondario che prende la proprieta' di un nodo
+			scollegato.
 			
-			@param other iteratore costante da copiare per creare quello corrente
+			@param payload nodo e blocco che lo contiene
 		*/
-		const_iterator(const const_iterator &other) : _n(other._n) {} // initialization list
-
+		explicit node_handle(const handle_payload &payload) : _payload(payload) {} // initialization list
+		
 		/**
-			@brief Operatore di assegnamento
-			
-			Operatore di assegnamento per l'iteratore costante.
-			Permette la copia tra iteratori costanti.
-			
-			@param other iteratore costante come sorgente da copiare
-				   (operando di destra)
+			@brief Rilascio del nodo
 			
-			@return reference a this
+			Funzione privata helper che distrugge il nodo posseduto.
 		*/
-		const_iterator &operator=(const const_iterator &other) {
-			_n = other._n;
-			return *this;
+		void release() {
+			if(_payload.n == nullptr)
+				return;
+			if(_payload.block) {
+				_payload.n->~node();
+				--_payload.block->live;
+				_payload.block.reset();
+			}
+			else
+				delete _payload.n;
+			_payload.n = nullptr;
 		}
-
-		/**
-			@brief Distruttore
-			
-			Distruttore per l'iteratore costante.
-			Rimuove la memoria allocata da un iteratore costante.
-		*/
-		~const_iterator() {}
-
+		
+	public:
+		
 		/**
-			@brief Operatore di dereferenziamento
-			
-			Operatore di dereferenziamento per l'accesso in lettura dei dati.
+			@brief Costruttore di default
 			
-			@return dato riferito dall'iteratore costante
+			Costruttore di default per istanziare un node_handle vuoto.
 		*/
-		reference operator*() const {
-			return _n->value;
+		node_handle() {
+			_payload.n = nullptr;
 		}
-
+		
 		/**
-			@brief Operatore di accesso ai dati
-			
-			Operatore di accesso in lettura ai dati.
+			@brief Costruttore di spostamento
 			
-			@return puntatore al dato riferito dall'iteratore
+			@param other node_handle da cui prendere il nodo (resta vuoto)
 		*/
-		pointer operator->() const {
-			return &(_n->value);
+		node_handle(node_handle &&other) : _payload(other._payload) { // initialization list
+			other._payload.n = nullptr;
+			other._payload.block.reset();
 		}
 		
 		/**
-			@brief Operatore di iterazione pre-incremento
-			
-			Operatore di iterazione pre-incremento per l'iteratore costante.
+			@brief Operatore di assegnamento per spostamento
 			
-			@return reference all'iteratore incrementato
-		*/
-		const_iterator &operator++() {
-			// ha figli
-			if(_n->left != nullptr) // ha un figlio sinistro
-				_n = _n->left;
-			else // non ha un figlio sinistro
-				if(_n->right != nullptr) // ha un figlio destro
-					_n = _n->right;
-				else { // non ha un figlio destro
-					// non ha figli
-					while(_n->parent != nullptr) // ha un padre
-						if(_n == _n->parent->left) { // e' figlio sinistro
-							_n = _n->parent;
-							if(_n->right != nullptr) { // ha un figlio destro
-								_n = _n->right;
-								return *this;
-							}
-						}
-						else //  figlio destro
-							_n = _n->parent;
-					
-					// se si esce dal corpo del ciclo while,
-					// l'iteratore ora punta alla radice e ha visitato tutti i nodi
-					
-					_n = nullptr;
-				}
+			Dealloca il nodo posseduto e prende quello di other.
 			
-			// se non si entra nel corpo dell'else,
-			// l'iteratore ora punta a un figlio sinistro o destro da visitare
+			@param other node_handle da cui prendere il nodo (resta vuoto)
 			
+			@return reference a this
+		*/
+		node_handle &operator=(node_handle &&other) {
+			if(this != &other) {
+				release();
+				_payload = other._payload;
+				other._payload.n = nullptr;
+				other._payload.block.reset();
+			}
 			return *this;
 		}
 		
+		node_handle(const node_handle &other) = delete;
+		node_handle &operator=(const node_handle &other) = delete;
+		
 		/**
-			@brief Operatore di iterazione post-incremento
-			
-			Operatore di iterazione post-incremento per l'iteratore costante.
-			
-			@param int parametro fittizio per distinguere l'operatore
-				   di post-incremento da quello di pre-incremento
+			@brief Distruttore
 			
-			@return copia dell'iteratore prima di essere incrementato
+			Distruttore. Dealloca il nodo posseduto, se presente.
 		*/
-		const_iterator operator++(int) {
-			const_iterator tmp(*this);
-			++this;
-			return tmp;
+		~node_handle() {
+			release();
 		}
-
+		
 		/**
-			@brief Operatore di uguaglianza
-			
-			Operatore di uguaglianza per l'iteratore costante.
-			
-			@param other iteratore da confrontare con this
+			@brief node_handle vuoto
 			
-			@return true se gli iteratori this e other puntano allo stesso nodo,
-					false altrimenti
+			@return true se il node_handle non possiede nessun nodo
 		*/
-		bool operator==(const const_iterator &other) const {
-			return (_n == other._n);
+		bool empty() const {
+			return _payload.n == nullptr;
 		}
 		
 		/**
-			@brief Operatore di diversit
-			
-			Operatore di diversit per l'iteratore costante.
+			@brief Valore del nodo
 			
-			@param other iteratore da confrontare con this
+			@pre Il node_handle non dev'essere vuoto
 			
-			@return true se gli iteratori this e other puntano a nodi diversi,
-					false altrimenti
+			@return reference al valore del nodo posseduto
 		*/
-		bool operator!=(const const_iterator &other) const {
-			return (_n != other._n);
+		T &value() {
+			return _payload.n->value;
 		}
-
-	private:
 		
-		// Dati membro
-
-		// La classe container (binary_search_tree) dev'essere dichiarata friend
-		// dell'iteratore per concederle l'accesso al costruttore privato
-		// di inizializzazione nei metodi begin ed end.
-		friend class binary_search_tree; 
-
 		/**
-			@brief Costruttore privato
+			@brief Valore del nodo
 			
-			Costruttore privato di inizializzazione utilizzato
-			dalla classe container (binary_search_tree) nei metodi begin ed end.
+			@pre Il node_handle non dev'essere vuoto
 			
-			@param n puntatore a un nodo dell'albero
+			@return reference costante al valore del nodo posseduto
 		*/
-		const_iterator(const node *n) : _n(n) {} // initialization list
-		
-	}; // class const_iterator
-	
-	// Funzioni membro per l'utilizzo degli iteratori
-	// da parte della classe container (binary_search_tree)
+		const T &value() const {
+			return _payload.n->value;
+		}
+	}; // class node_handle
 	
 	/**
-		@brief Iteratore che punta all'inizio dell'albero
+		@brief Estrazione di un nodo
 		
-		Funzione membro che ritorna un iteratore
-		che punta all'inizio dell'albero (alla sua radice).
-	
-		@return iteratore che punta all'inizio dell'albero
+		Scollega dall'albero il nodo con un certo valore e ne affida
+		la proprieta' a un node_handle, senza copiare il valore
+		e senza allocare o deallocare memoria. Costa quanto erase.
+		
+		@param value valore da estrarre
+		
+		@return node_handle con il nodo estratto (vuoto se il valore
+				non e' presente)
 	*/
-	const_iterator begin() const {
-		return const_iterator(_root);
+	node_handle extract(const T &value) {
+		node *n = search(value);
+		if(n == nullptr)
+			return node_handle();
+		return node_handle(detach(n));
 	}
 	
 	/**
-		@brief Iteratore che punta alla fine dell'albero
+		@brief Inserimento di un nodo estratto
 		
-		Funzione membro che ritorna un iteratore
-		che punta alla fine dell'albero.
+		Inserisce nell'albero il nodo posseduto da un node_handle,
+		senza copiarne il valore, se il valore non e' gia' presente.
+		Costa quanto try_insert. Se il nodo proviene da un blocco
+		contiguo (compact), l'albero ne condivide la proprieta'.
+		
+		@param handle node_handle con il nodo da inserire: resta vuoto
+			   se il nodo viene inserito, altrimenti lo conserva
+		
+		@return coppia formata dall'iteratore all'elemento con il valore
+				(end() se handle e' vuoto) e da true se il nodo e' stato
+				inserito, false se il valore era gia' presente
+		
+		@throw eccezione di allocazione di memoria (solo per condividere
+			   un nuovo blocco; handle conserva il nodo)
+	*/
+	std::pair<const_iterator, bool> insert(node_handle &&handle) {
+		if(handle.empty())
+			return std::make_pair(end(), false);
+		
+		std::pair<node *, bool> result = attach_node(handle._payload);
+		if(result.second) {
+			handle._payload.n = nullptr;
+			handle._payload.block.reset();
+		}
+		return std::make_pair(const_iterator(result.first), result.second);
+	}
 	
-		@return iteratore che punta alla fine dell'albero
+	/**
+		@brief Divisione dell'albero
+		
+		Divide l'albero in due spostando i nodi, senza copiare valori
+		e senza allocare memoria: nell'albero restano i valori minori
+		di key, in greater passano quelli maggiori o uguali.
+		Il contenuto precedente di greater viene eliminato.
+		Il taglio segue il cammino di ricerca di key (tempo proporzionale
+		all'altezza); poiche' i nodi non memorizzano la dimensione del
+		proprio sottoalbero, il numero di elementi delle due parti viene
+		calcolato visitando solo la parte piu' piccola.
+		
+		@param key valore di divisione
+		@param greater albero che riceve i valori maggiori o uguali a key
+		
+		@throw std::invalid_argument se greater e' l'albero stesso
 	*/
-	const_iterator end() const {
-		return const_iterator(nullptr);
+	void split(const T &key, binary_search_tree &greater) {
+		if(&greater == this)
+			throw std::invalid_argument("binary_search_tree: divisione di un albero in se stesso");
+		
+		greater.clear();
+		
+		// Ultimo nodo di ogni parte sul cammino: il suo figlio verso key
+		// e' il punto in cui viene collegato il nodo successivo della parte
+		node *less_root = nullptr;
+		node *greater_root = nullptr;
+		node *less_last = nullptr;
+		node *greater_last = nullptr;
+		
+		for(node *current = _root; current != nullptr; ) {
+			node *next;
+			if(_order(current->value, key)) {
+				next = current->right;
+				if(less_last == nullptr)
+					less_root = current;
+				else
+					less_last->right = current;
+				current->parent = less_last;
+				less_last = current;
+			}
+			else {
+				next = current->left;
+				if(greater_last == nullptr)
+					greater_root = current;
+				else
+					greater_last->left = current;
+				current->parent = greater_last;
+				greater_last = current;
+			}
+			current = next;
+		}
+		if(less_last != nullptr)
+			less_last->right = nullptr;
+		if(greater_last != nullptr)
+			greater_last->left = nullptr;
+		
+		// Conteggio alternato: si ferma alla fine della parte piu' piccola
+		node *less_leftmost = (less_root != nullptr) ? _leftmost : nullptr;
+		const node *a = less_leftmost;
+		const node *b = greater_last;
+		size_type counted = 0;
+		while(a != nullptr && b != nullptr) {
+			a = successor(a);
+			b = successor(b);
+			counted++;
+		}
+		size_type less_size = (a == nullptr) ? counted : _size - counted;
+		
+		greater._root = greater_root;
+		greater._leftmost = greater_last;
+		greater._rightmost = (greater_root != nullptr) ? _rightmost : nullptr;
+		greater._size = _size - less_size;
+		if(greater_root != nullptr)
+			greater._blocks = _blocks;
+		
+		_root = less_root;
+		_leftmost = less_leftmost;
+		_rightmost = less_last;
+		_size = less_size;
+		if(less_root == nullptr)
+			_blocks.clear();
 	}
 	
-	// Fine funzioni membro per l'utilizzo degli iteratori
+	/**
+		@brief Unione di due alberi
+		
+		Sposta nell'albero tutti i nodi di greater, i cui valori devono
+		essere tutti maggiori di quelli dell'albero, senza copiare valori
+		e senza allocare memoria (salvo condividere i blocchi contigui
+		di greater). Il nodo massimo dell'albero diventa la radice,
+		con i due alberi come sottoalberi: l'altezza cresce al piu' di uno.
+		Tempo proporzionale all'altezza dell'albero. greater resta vuoto.
+		
+		@pre I valori di greater devono essere maggiori di quelli dell'albero
+		
+		@param greater albero da unire
+		
+		@throw std::invalid_argument se i valori dei due alberi non sono
+			   separati (gli alberi non cambiano)
+		@throw eccezione di allocazione di memoria (gli alberi non cambiano)
+	*/
+	void join(binary_search_tree &greater) {
+		if(&greater == this || greater._root == nullptr)
+			return;
+		if(_root == nullptr) {
+			swap(greater);
+			return;
+		}
+		if(!_order(_rightmost->value, greater._leftmost->value))
+			throw std::invalid_argument("binary_search_tree: unione di alberi con valori non separati");
+		
+		std::vector<std::shared_ptr<node_block> > blocks(_blocks);
+		for(size_type i = 0; i < greater._blocks.size(); ++i)
+			if(std::find(blocks.begin(), blocks.end(), greater._blocks[i]) == blocks.end())
+				blocks.push_back(greater._blocks[i]);
+		
+		size_type size = _size + greater._size;
+		node *middle = _rightmost;
+		unlink(middle);
+		
+		middle->left = _root;
+		if(_root != nullptr)
+			_root->parent = middle;
+		middle->right = greater._root;
+		greater._root->parent = middle;
+		
+		_root = middle;
+		if(_leftmost == nullptr)
+			_leftmost = middle;
+		_rightmost = greater._rightmost;
+		_size = size;
+		_blocks.swap(blocks);
+		
+		greater._root = nullptr;
+		greater._leftmost = nullptr;
+		greater._rightmost = nullptr;
+		greater._size = 0;
+		greater._blocks.clear();
+	}
 	
 	// Fine ulteriori metodi pubblici
 
@@ -0,0 +1,582 @@
+/**
+	@file bstbloom.h
+
+	@brief Dichiarazione e definizione della classe
+	filtered_binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTBLOOM_H
+#define BSTBLOOM_H
+
+// Direttive per il pre-compilatore
+
+#include <vector> // std::vector
+#include <cstddef> // std::size_t
+#include <cmath> // std::log, std::ceil
+#include <utility> // std::pair, std::forward, std::swap
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Statistiche del filtro di appartenenza
+
+	Struttura che raccoglie i contatori delle ricerche eseguite
+	su un filtered_binary_search_tree.
+*/
+struct bst_filter_stats {
+	unsigned long queries; ///< numero di ricerche eseguite
+	unsigned long filtered; ///< ricerche concluse dal filtro senza accedere all'albero
+	unsigned long false_positives; ///< ricerche non filtrate di valori non presenti
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default che azzera i contatori.
+	*/
+	bst_filter_stats() : queries(0), filtered(0), false_positives(0) {} // initialization list
+};
+
+/**
+	@brief Albero binario di ricerca con filtro di Bloom
+
+	Classe che implementa un albero binario di ricerca di dati generici T
+	affiancato da un filtro di Bloom, una struttura probabilistica
+	di appartenenza: se il filtro esclude un valore, il valore non e'
+	sicuramente presente e la ricerca termina dopo pochi accessi
+	a bit calcolati con il funtore di hash H, senza visitare l'albero.
+	Se il filtro non lo esclude, la ricerca prosegue nell'albero
+	(con probabilita' di falso positivo pari a circa fp_rate).
+
+	Il filtro viene aggiornato da ogni inserimento. Una rimozione non
+	puo' togliere bit dal filtro (resta corretto, ma meno selettivo):
+	il filtro viene ricostruito quando i valori rimossi o quelli inseriti
+	oltre la capacita' per cui e' stato dimensionato ne degradano
+	il tasso di falsi positivi.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param H funtore di hash di un dato (ritorna std::size_t); dati uguali
+		   secondo E devono avere lo stesso hash
+*/
+template <typename T, typename O, typename E, typename H>
+class filtered_binary_search_tree : public binary_search_tree<T, O, E> {
+
+	typedef binary_search_tree<T, O, E> base; ///< tipo dell'albero di base
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+
+	static const size_type min_capacity = 64; ///< capacita' minima del filtro
+
+	std::vector<unsigned long long> _bits; ///< bit del filtro
+	std::size_t _mask; ///< numero di bit del filtro (potenza di 2) meno uno
+	unsigned int _hash_count; ///< numero di bit impostati per ogni valore
+	size_type _capacity; ///< numero di valori per cui il filtro e' dimensionato
+	size_type _stale; ///< valori rimossi dall'ultima ricostruzione del filtro
+	double _fp_rate; ///< tasso di falsi positivi richiesto
+	mutable bst_filter_stats _stats; ///< statistiche delle ricerche
+	H _hash; ///< oggetto funtore di hash
+
+	/**
+		@brief Dimensionamento del filtro
+
+		Funzione privata helper che azzera il filtro e lo dimensiona
+		per capacity valori con il tasso di falsi positivi richiesto:
+		m = -n ln(p) / ln(2)^2 bit (arrotondati alla potenza di 2 successiva,
+		per calcolare le posizioni con una maschera invece che con il modulo)
+		e k = m / n ln(2) hash per valore.
+
+		@param capacity numero di valori previsti
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void resize_filter(size_type capacity) {
+		if(capacity < min_capacity)
+			capacity = min_capacity;
+
+		const double ln2 = std::log(2.0);
+		double bits = std::ceil(-static_cast<double>(capacity) * std::log(_fp_rate) / (ln2 * ln2));
+		std::size_t bit_count = 64;
+		while(bit_count < bits)
+			bit_count *= 2;
+		unsigned int hash_count = static_cast<unsigned int>(bits / capacity * ln2 + 0.5);
+
+		_bits.assign(bit_count / 64, 0);
+		_mask = bit_count - 1;
+		_hash_count = (hash_count == 0) ? 1 : hash_count;
+		_capacity = capacity;
+		_stale = 0;
+	}
+
+	/**
+		@brief Ricostruzione del filtro
+
+		Funzione privata helper che dimensiona il filtro per il doppio
+		dei valori presenti nell'albero e vi inserisce tutti i valori.
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void rebuild_filter() {
+		resize_filter(2 * this->size());
+
+		typename base::const_iterator i, ie;
+		for(i = this->begin(), ie = this->end(); i != ie; ++i)
+			add(*i);
+	}
+
+	/**
+		@brief Hash secondario
+
+		Funzione privata helper che rimescola i bit di un hash per ottenere
+		il passo del double hashing (sempre dispari).
+
+		@param h hash primario
+
+		@return hash secondario
+	*/
+	static std::size_t remix(std::size_t h) {
+		unsigned long long x = h;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		return static_cast<std::size_t>(x) | 1;
+	}
+
+	/**
+		@brief Inserimento di un valore nel filtro
+
+		Funzione privata helper che imposta i bit del filtro
+		corrispondenti a un valore.
+
+		@param value valore da inserire nel filtro
+	*/
+	void add(const T &value) {
+		std::size_t h = _hash(value);
+		std::size_t step = remix(h);
+		for(unsigned int i = 0; i < _hash_count; ++i, h += step) {
+			std::size_t bit = h & _mask;
+			_bits[bit / 64] |= 1ULL << (bit % 64);
+		}
+	}
+
+	/**
+		@brief Controllo di un valore nel filtro
+
+		Funzione privata helper che controlla i bit del filtro
+		corrispondenti a un valore.
+
+		@param value valore da controllare
+
+		@return false se il valore non e' sicuramente presente,
+				true se potrebbe essere presente
+	*/
+	bool may_contain(const T &value) const {
+		std::size_t h = _hash(value);
+		std::size_t step = remix(h);
+		for(unsigned int i = 0; i < _hash_count; ++i, h += step) {
+			std::size_t bit = h & _mask;
+			if((_bits[bit / 64] & (1ULL << (bit % 64))) == 0)
+				return false;
+		}
+		return true;
+	}
+
+	/**
+		@brief Aggiornamento del filtro dopo un inserimento
+
+		Funzione privata helper che inserisce un valore nel filtro,
+		ricostruendolo se l'albero ha superato la capacita' del filtro.
+
+		@param value valore inserito nell'albero
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void added(const T &value) {
+		if(this->size() > _capacity)
+			rebuild_filter();
+		else
+			add(value);
+	}
+
+	/**
+		@brief Ricerca filtrata
+
+		Funzione privata helper che consulta il filtro e, se il valore
+		potrebbe essere presente, lo cerca nell'albero, aggiornando
+		le statistiche.
+
+		@param value valore da cercare
+
+		@return iteratore che punta all'elemento cercato,
+				end() se l'elemento non e' presente nell'albero
+	*/
+	typename base::const_iterator filtered_find(const T &value) const {
+		_stats.queries++;
+		if(!may_contain(value)) {
+			_stats.filtered++;
+			return this->end();
+		}
+
+		typename base::const_iterator i = base::find(value);
+		if(i == this->end())
+			_stats.false_positives++;
+		return i;
+	}
+
+public:
+
+	typedef typename base::const_iterator const_iterator; ///< iteratore costante dell'albero
+	typedef typename base::node_handle node_handle; ///< nodo estratto dall'albero
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore per istanziare un albero vuoto con un filtro
+		con il tasso di falsi positivi indicato.
+
+		@param fp_rate tasso di falsi positivi del filtro (tra 0 e 1)
+
+		@throw eccezione di allocazione di memoria
+	*/
+	explicit filtered_binary_search_tree(double fp_rate = 0.01) : _fp_rate(fp_rate) { // initialization list
+		resize_filter(min_capacity);
+	}
+
+	// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+	// coincidono con quelli di default
+
+	/**
+		@brief Scambio del contenuto di due alberi
+
+		Scambia in tempo costante i nodi, il filtro e le statistiche
+		dell'albero con quelli di un altro albero.
+
+		@param other albero con cui scambiare il contenuto
+	*/
+	void swap(filtered_binary_search_tree &other) {
+		base::swap(other);
+		_bits.swap(other._bits);
+		std::swap(_mask, other._mask);
+		std::swap(_hash_count, other._hash_count);
+		std::swap(_capacity, other._capacity);
+		std::swap(_stale, other._stale);
+		std::swap(_fp_rate, other._fp_rate);
+		std::swap(_stats, other._stats);
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Inserisce un elemento nell'albero e nel filtro.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		base::insert(value);
+		added(value);
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+
+		Inserisce un elemento nell'albero e nel filtro,
+		se non e' gia' presente.
+
+		@param value valore dell'elemento da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const T &value) {
+		std::pair<const_iterator, bool> result = base::try_insert(value);
+		if(result.second)
+			added(value);
+		return result;
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento costruito sul posto
+
+		Costruisce un valore con gli argomenti passati e lo inserisce
+		nell'albero e nel filtro, se non e' gia' presente.
+
+		@param args argomenti per il costruttore del valore
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename... Args>
+	std::pair<const_iterator, bool> try_emplace(Args&&... args) {
+		return try_insert(T(std::forward<Args>(args)...));
+	}
+
+	/**
+		@brief Inserimento di una sequenza di elementi nell'albero
+
+		Inserisce nell'albero i valori di una sequenza come
+		binary_search_tree::insert_batch e aggiorna il filtro.
+
+		@param first iteratore forward al primo valore da inserire
+		@param last iteratore forward alla fine della sequenza
+
+		@return numero di valori scartati perche' duplicati
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	size_type insert_batch(I first, I last) {
+		size_type rejected = base::insert_batch(first, last);
+
+		if(this->size() > _capacity)
+			rebuild_filter();
+		else
+			for(; first != last; ++first)
+				add(*first);
+
+		return rejected;
+	}
+
+	/**
+		@brief Rimozione di un elemento dall'albero
+
+		Rimuove un elemento dall'albero. Il filtro viene ricostruito
+		quando i valori rimossi superano un quarto della sua capacita'.
+
+		@pre Il valore da rimuovere dev'essere presente all'interno dell'albero
+
+		@param value valore dell'elemento da rimuovere
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void erase(const T &value) {
+		base::erase(value);
+		if(++_stale > _capacity / 4)
+			rebuild_filter();
+	}
+
+	/**
+		@brief Estrazione del valore minimo
+
+		Come binary_search_tree::pop_min, contando il valore rimosso
+		per la ricostruzione del filtro.
+
+		@return valore minimo
+
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+		@throw eccezione di allocazione di memoria
+	*/
+	T pop_min() {
+		T value(base::pop_min());
+		if(++_stale > _capacity / 4)
+			rebuild_filter();
+		return value;
+	}
+
+	/**
+		@brief Estrazione del valore massimo
+
+		Come binary_search_tree::pop_max, contando il valore rimosso
+		per la ricostruzione del filtro.
+
+		@return valore massimo
+
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+		@throw eccezione di allocazione di memoria
+	*/
+	T pop_max() {
+		T value(base::pop_max());
+		if(++_stale > _capacity / 4)
+			rebuild_filter();
+		return value;
+	}
+
+	/**
+		@brief Sostituzione del contenuto con una sequenza ordinata
+
+		Come binary_search_tree::assign_sorted, ricostruendo il filtro.
+
+		@param first iteratore forward al primo valore
+		@param last iteratore forward alla fine della sequenza
+
+		@throw std::invalid_argument se la sequenza non e' strettamente
+			   crescente (l'albero non cambia)
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	void assign_sorted(I first, I last) {
+		base::assign_sorted(first, last);
+		rebuild_filter();
+	}
+
+	/**
+		@brief Estrazione di un nodo
+
+		Come binary_search_tree::extract, contando il valore rimosso
+		per la ricostruzione del filtro.
+
+		@param value valore da estrarre
+
+		@return node_handle con il nodo estratto (vuoto se il valore
+				non e' presente)
+
+		@throw eccezione di allocazione di memoria (il nodo resta nell'albero)
+	*/
+	node_handle extract(const T &value) {
+		node_handle handle(base::extract(value));
+		if(!handle.empty() && ++_stale > _capacity / 4) {
+			try {
+				rebuild_filter();
+			}
+			catch(...) {
+				base::insert(std::move(handle)); // non alloca: il blocco e' gia' dell'albero
+				throw;
+			}
+		}
+		return handle;
+	}
+
+	/**
+		@brief Inserimento di un nodo estratto
+
+		Come binary_search_tree::insert(node_handle &&), aggiungendo
+		il valore al filtro.
+
+		@param handle node_handle con il nodo da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se il nodo e' stato inserito
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> insert(node_handle &&handle) {
+		std::pair<const_iterator, bool> result = base::insert(std::move(handle));
+		if(result.second)
+			added(*result.first);
+		return result;
+	}
+
+	/**
+		@brief Divisione dell'albero
+
+		Come binary_search_tree::split. Il filtro dell'albero resta
+		corretto e conta come rimossi i valori spostati;
+		quello di greater viene ricostruito (tempo proporzionale
+		ai valori spostati).
+
+		@param key valore di divisione
+		@param greater albero che riceve i valori maggiori o uguali a key
+
+		@throw std::invalid_argument se greater e' l'albero stesso
+		@throw eccezione di allocazione di memoria
+	*/
+	void split(const T &key, filtered_binary_search_tree &greater) {
+		base::split(key, greater);
+		greater.rebuild_filter();
+		_stale += greater.size();
+		if(_stale > _capacity / 4)
+			rebuild_filter();
+	}
+
+	/**
+		@brief Unione di due alberi
+
+		Come binary_search_tree::join, aggiungendo al filtro i valori
+		di greater (o ricostruendolo se supera la sua capacita').
+
+		@param greater albero da unire (resta vuoto)
+
+		@throw std::invalid_argument se i valori dei due alberi non sono
+			   separati (gli alberi non cambiano)
+		@throw eccezione di allocazione di memoria
+	*/
+	void join(filtered_binary_search_tree &greater) {
+		if(&greater == this)
+			return;
+		if(this->size() + greater.size() <= _capacity)
+			for(typename base::const_iterator i = greater.begin(), ie = greater.end(); i != ie; ++i)
+				add(*i); // se l'unione fallisce il filtro resta corretto
+		base::join(greater);
+		if(this->size() > _capacity)
+			rebuild_filter();
+		greater.resize_filter(min_capacity);
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Controlla se esiste un elemento di tipo T nell'albero,
+		consultando prima il filtro.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return filtered_find(value) != this->end();
+	}
+
+	/**
+		@brief Ricerca di un elemento nell'albero
+
+		Cerca un elemento di tipo T nell'albero, consultando prima il filtro.
+
+		@param value valore da cercare
+
+		@return iteratore che punta all'elemento cercato,
+				end() se l'elemento non e' presente nell'albero
+	*/
+	const_iterator find(const T &value) const {
+		return filtered_find(value);
+	}
+
+	/**
+		@brief Statistiche del filtro
+
+		Ritorna i contatori delle ricerche eseguite con exists e find.
+
+		@return statistiche del filtro
+	*/
+	bst_filter_stats filter_stats() const {
+		return _stats;
+	}
+
+	/**
+		@brief Azzeramento delle statistiche del filtro
+
+		Azzera i contatori delle ricerche.
+	*/
+	void reset_filter_stats() {
+		_stats = bst_filter_stats();
+	}
+
+	/**
+		@brief Memoria occupata dal filtro
+
+		@return numero di byte occupati dai bit del filtro
+	*/
+	std::size_t filter_memory() const {
+		return _bits.size() * sizeof(unsigned long long);
+	}
+
+}; // class filtered_binary_search_tree
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstbloom.h
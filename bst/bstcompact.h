@@ -0,0 +1,608 @@
+/**
+	@file bstcompact.h
+
+	@brief Dichiarazione e definizione della classe
+	compact_binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTCOMPACT_H
+#define BSTCOMPACT_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <iostream> // std::cout, std::endl
+#include <iterator> // std::forward_iterator_tag
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <vector> // std::vector
+#include <stdexcept> // std::length_error
+#include <type_traits> // std::integral_constant, std::true_type, std::false_type
+#include "bstexceptions.h" // bst_duplicated_value_exception, bst_value_not_found_exception
+
+/**
+	@brief Collegamenti di un nodo compatto con puntatore al padre
+
+	Struttura di supporto interna che contiene gli indici a 32 bit
+	dei nodi figli e del nodo padre.
+
+	@param P true se il nodo mantiene l'indice del nodo padre
+*/
+template <bool P>
+struct compact_links {
+	typedef unsigned int index_type; ///< tipo degli indici dei nodi (32 bit)
+
+	index_type left; ///< indice del nodo figlio sinistro
+	index_type right; ///< indice del nodo figlio destro
+	index_type parent; ///< indice del nodo padre
+
+	/**
+		@brief Costruttore
+
+		Costruttore che inizializza i collegamenti.
+
+		@param l indice del nodo figlio sinistro
+		@param r indice del nodo figlio destro
+		@param p indice del nodo padre
+	*/
+	compact_links(index_type l, index_type r, index_type p) :
+		left(l), right(r), parent(p) {} // initialization list
+};
+
+/**
+	@brief Collegamenti di un nodo compatto senza puntatore al padre
+
+	Specializzazione che contiene solo gli indici a 32 bit dei nodi figli.
+	L'indice del nodo padre viene ignorato.
+*/
+template <>
+struct compact_links<false> {
+	typedef unsigned int index_type; ///< tipo degli indici dei nodi (32 bit)
+
+	index_type left; ///< indice del nodo figlio sinistro
+	index_type right; ///< indice del nodo figlio destro
+
+	/**
+		@brief Costruttore
+
+		Costruttore che inizializza i collegamenti.
+
+		@param l indice del nodo figlio sinistro
+		@param r indice del nodo figlio destro
+	*/
+	compact_links(index_type l, index_type r, index_type) :
+		left(l), right(r) {} // initialization list
+};
+
+/**
+	@brief Albero binario di ricerca compatto
+
+	Classe che implementa un albero binario di ricerca di dati generici T
+	con la stessa interfaccia di binary_search_tree, ma con una
+	rappresentazione compatta dei nodi: i nodi sono memorizzati in un
+	unico array e sono collegati tramite indici a 32 bit invece che
+	tramite puntatori a 64 bit.
+	Con P = false i nodi non mantengono l'indice del nodo padre e
+	l'iteratore usa un proprio stack dei nodi ancora da visitare.
+	L'albero puo' contenere al massimo 2^32 - 1 elementi.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param P true per mantenere l'indice del nodo padre in ogni nodo
+*/
+template <typename T, typename O, typename E, bool P = true>
+class compact_binary_search_tree {
+
+	typedef typename compact_links<P>::index_type index_type; ///< tipo degli indici dei nodi
+
+	static const index_type null_index = static_cast<index_type>(-1); ///< indice che identifica un nodo assente
+
+	/**
+		@brief Nodo dell'albero
+
+		Struttura di supporto interna che implementa un nodo compatto
+		dell'albero.
+	*/
+	struct node : public compact_links<P> {
+		T value; ///< dato inserito nell'albero
+
+		/**
+			@brief Costruttore secondario
+
+			Costruttore secondario che permette di istanziare un nodo foglia,
+			inizializzandolo con il suo valore e con l'indice del nodo padre.
+
+			@param v valore del dato
+			@param p indice del nodo padre
+		*/
+		node(const T &v, index_type p) :
+			compact_links<P>(null_index, null_index, p), value(v) {} // initialization list
+	}; // struct node
+
+	std::vector<node> _nodes; ///< array dei nodi dell'albero
+
+	index_type _root; ///< indice della radice dell'albero
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+
+	O _order; ///< oggetto funtore per il confronto di ordinamento (<) di due dati
+	E _equals; ///< oggetto funtore per il confronto di uguaglianza (==) di due dati
+
+	/**
+		@brief Inserimento degli elementi di un albero in quello corrente
+
+		Inserisce in ordine anticipato gli elementi di un albero compatto
+		in quello corrente, a partire dal nodo di indice root.
+		Usa uno stack esplicito per non dipendere dall'indice del nodo padre.
+
+		@param other albero che contiene gli elementi da inserire
+		@param root indice del nodo radice degli elementi da inserire
+
+		@throw bst_duplicated_value_exception se uno dei valori da inserire
+			   e' gia' presente all'interno dell'albero corrente
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert_tree(const compact_binary_search_tree &other, index_type root) {
+		std::vector<index_type> pending;
+		if(root != null_index)
+			pending.push_back(root);
+
+		while(!pending.empty()) {
+			const node &n = other._nodes[pending.back()];
+			pending.pop_back();
+			insert(n.value);
+			if(n.right != null_index)
+				pending.push_back(n.right);
+			if(n.left != null_index)
+				pending.push_back(n.left);
+		}
+	}
+
+	/**
+		@brief Nodo con un certo valore
+
+		Funzione privata helper che cerca se esiste nell'albero un nodo
+		con un certo valore cercato e, in caso affermativo,
+		ritorna il suo indice.
+
+		@param value valore del nodo da cercare
+
+		@return indice del nodo che ha il valore cercato,
+				null_index se non esiste nessun nodo che ha il valore cercato
+	*/
+	index_type search(const T &value) const {
+		index_type current = _root;
+
+		while(current != null_index && !_equals(_nodes[current].value, value))
+			if(_order(value, _nodes[current].value))
+				current = _nodes[current].left;
+			else
+				current = _nodes[current].right;
+
+		return current;
+	}
+
+public:
+
+	// Metodi fondamentali
+
+	/**
+		@brief Costruttore di default (METODO FONDAMENTALE)
+
+		Costruttore di default per istanziare un albero vuoto.
+	*/
+	compact_binary_search_tree() : _root(null_index) {} // initialization list
+
+	// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+	// coincidono con quelli di default: gli indici restano validi
+	// anche nella copia dell'array dei nodi.
+
+	// Fine metodi fondamentali
+
+	// Ulteriori metodi pubblici
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Inserisce un elemento nell'albero, secondo l'ordinamento definito
+		dal funtore di confronto di ordinamento (<) _order, di tipo O.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw std::length_error se l'albero contiene gia' il numero
+			   massimo di elementi indirizzabili con 32 bit
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		index_type current = _root;
+		index_type previous = null_index;
+
+		while(current != null_index) {
+			previous = current;
+			if(_equals(value, _nodes[current].value))
+				throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+			if(_order(value, _nodes[current].value))
+				current = _nodes[current].left;
+			else
+				current = _nodes[current].right;
+		}
+
+		if(_nodes.size() >= null_index)
+			throw std::length_error("compact_binary_search_tree: indici a 32 bit esauriti");
+
+		index_type tmp = static_cast<index_type>(_nodes.size());
+		_nodes.push_back(node(value, previous));
+
+		if(previous == null_index)
+			_root = tmp;
+		else
+			if(_order(value, _nodes[previous].value))
+				_nodes[previous].left = tmp;
+			else
+				_nodes[previous].right = tmp;
+	}
+
+	/**
+		@brief Riserva dello spazio per i nodi
+
+		Riserva lo spazio per almeno n nodi, evitando le riallocazioni
+		dell'array dei nodi durante gli inserimenti successivi.
+
+		@param n numero di nodi da riservare
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void reserve(size_type n) {
+		_nodes.reserve(n);
+	}
+
+	/**
+		@brief Numero totale di dati inseriti nell'albero
+
+		Ritorna il numero totale di dati inseriti nell'albero
+
+		@return numero totale di dati inseriti nell'albero
+	*/
+	size_type size() const {
+		return static_cast<size_type>(_nodes.size());
+	}
+
+	/**
+		@brief Memoria occupata dai nodi dell'albero
+
+		Ritorna il numero di byte allocati per l'array dei nodi,
+		compreso lo spazio riservato ma non ancora utilizzato.
+
+		@return numero di byte occupati dai nodi dell'albero
+	*/
+	std::size_t memory_usage() const {
+		return _nodes.capacity() * sizeof(node);
+	}
+
+	/**
+		@brief Dimensione di un nodo
+
+		Ritorna il numero di byte occupati da un singolo nodo dell'albero.
+
+		@return numero di byte occupati da un nodo
+	*/
+	static std::size_t node_size() {
+		return sizeof(node);
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Controlla se esiste un elemento di tipo T nell'albero.
+		L'uguaglianza e' definita dal funtore di confronto di uguaglianza (==)
+		_equals, di tipo E.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return search(value) != null_index;
+	}
+
+	/**
+		@brief Sottoalbero
+
+		Metodo che, passato un dato d dello stesso tipo T dei dati contenuti
+		nell'albero, ritorna un nuovo albero, che corrisponde al sottoalbero
+		avente come radice il nodo con il valore d.
+
+		@pre Il valore d dev'essere presente all'interno dell'albero
+
+		@param d valore del nodo radice del sottoalbero
+
+		@return sottoalbero avente come radice il nodo con il valore d
+
+		@throw bst_value_not_found_exception se il valore d non e' presente
+			   all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	compact_binary_search_tree subtree(const T &d) const {
+		compact_binary_search_tree sub_bst;
+
+		index_type sub_root = search(d);
+		if(sub_root == null_index)
+			throw bst_value_not_found_exception<T>("Valore non trovato: ", d);
+
+		sub_bst.insert_tree(*this, sub_root);
+
+		return sub_bst;
+	}
+
+	/**
+		@brief Iteratore costante di tipo forward dell'albero
+
+		Iteratore a sola lettura (costante) di tipo forward
+		per accedere ai dati presenti nell'albero.
+		Visita i nodi nello stesso ordine (anticipato) dell'iteratore
+		di binary_search_tree.
+		Se i nodi non mantengono l'indice del nodo padre, l'iteratore
+		conserva uno stack con gli indici dei figli destri ancora da visitare.
+	*/
+	class const_iterator {
+		const std::vector<node> *_nodes; ///< puntatore all'array dei nodi dell'albero
+		index_type _n; ///< indice di un nodo dell'albero
+		std::vector<index_type> _pending; ///< figli destri ancora da visitare (solo senza padre)
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun nodo.
+		*/
+		const_iterator() : _nodes(nullptr), _n(null_index) {} // initialization list
+
+		// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+		// coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			Operatore di dereferenziamento per l'accesso in lettura dei dati.
+
+			@return dato riferito dall'iteratore costante
+		*/
+		reference operator*() const {
+			return (*_nodes)[_n].value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			Operatore di accesso in lettura ai dati.
+
+			@return puntatore al dato riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &((*_nodes)[_n].value);
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Operatore di iterazione pre-incremento per l'iteratore costante.
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			const node &current = (*_nodes)[_n];
+
+			if(current.left != null_index) { // ha un figlio sinistro
+				if(!P && current.right != null_index)
+					_pending.push_back(current.right);
+				_n = current.left;
+			}
+			else
+				if(current.right != null_index) // ha un figlio destro
+					_n = current.right;
+				else // non ha figli
+					next_pending(std::integral_constant<bool, P>());
+
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			Operatore di iterazione post-incremento per l'iteratore costante.
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			Operatore di uguaglianza per l'iteratore costante.
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano allo stesso nodo,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (_n == other._n);
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			Operatore di diversita' per l'iteratore costante.
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano a nodi diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return (_n != other._n);
+		}
+
+	private:
+
+		// La classe container (compact_binary_search_tree) dev'essere
+		// dichiarata friend dell'iteratore per concederle l'accesso
+		// al costruttore privato di inizializzazione nei metodi begin ed end.
+		friend class compact_binary_search_tree;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato di inizializzazione utilizzato
+			dalla classe container nei metodi begin ed end.
+
+			@param nodes puntatore all'array dei nodi dell'albero
+			@param n indice di un nodo dell'albero
+		*/
+		const_iterator(const std::vector<node> *nodes, index_type n) :
+			_nodes(nodes), _n(n) {} // initialization list
+
+		/**
+			@brief Prossimo nodo da visitare dopo una foglia (con padre)
+
+			Risale gli antenati fino al primo figlio destro non ancora visitato.
+		*/
+		void next_pending(std::true_type) {
+			const std::vector<node> &nodes = *_nodes;
+
+			while(nodes[_n].parent != null_index) { // ha un padre
+				index_type parent = nodes[_n].parent;
+				if(_n == nodes[parent].left && nodes[parent].right != null_index) {
+					_n = nodes[parent].right;
+					return;
+				}
+				_n = parent;
+			}
+
+			_n = null_index;
+		}
+
+		/**
+			@brief Prossimo nodo da visitare dopo una foglia (senza padre)
+
+			Estrae dallo stack il primo figlio destro non ancora visitato.
+		*/
+		void next_pending(std::false_type) {
+			if(_pending.empty())
+				_n = null_index;
+			else {
+				_n = _pending.back();
+				_pending.pop_back();
+			}
+		}
+
+	}; // class const_iterator
+
+	// Funzioni membro per l'utilizzo degli iteratori
+	// da parte della classe container (compact_binary_search_tree)
+
+	/**
+		@brief Iteratore che punta all'inizio dell'albero
+
+		Funzione membro che ritorna un iteratore
+		che punta all'inizio dell'albero (alla sua radice).
+
+		@return iteratore che punta all'inizio dell'albero
+	*/
+	const_iterator begin() const {
+		return const_iterator(&_nodes, _root);
+	}
+
+	/**
+		@brief Iteratore che punta alla fine dell'albero
+
+		Funzione membro che ritorna un iteratore
+		che punta alla fine dell'albero.
+
+		@return iteratore che punta alla fine dell'albero
+	*/
+	const_iterator end() const {
+		return const_iterator(&_nodes, null_index);
+	}
+
+	// Fine funzioni membro per l'utilizzo degli iteratori
+
+	// Fine ulteriori metodi pubblici
+
+}; // class compact_binary_search_tree
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa del contenuto
+	dell'albero compatto.
+
+	@param os oggetto stream di output
+	@param tree albero da stampare
+
+	@return reference allo stream di output
+*/
+template <typename T, typename O, typename E, bool P>
+std::ostream &operator<<(std::ostream &os, const compact_binary_search_tree<T, O, E, P> &tree) {
+	typename compact_binary_search_tree<T, O, E, P>::const_iterator i, ie;
+
+	os << "[";
+	for(i = tree.begin(), ie = tree.end(); i != ie; ++i) {
+		os << *i;
+		typename compact_binary_search_tree<T, O, E, P>::const_iterator i_tmp = i;
+		if(++i_tmp != ie)
+			os << ", ";
+	}
+	os << "]";
+
+	return os;
+}
+
+/**
+	@brief Stampa dei valori che soddisfano un predicato
+
+	Funzione globale che, dato un albero binario compatto di tipo generico T
+	e un predicato P, stampa a schermo tutti i valori contenuti
+	nell'albero che soddisfano il predicato.
+
+	@param tree albero di tipo T in cui cercare i valori da stampare a schermo
+	@param predicate il predicato che i valori dell'albero devono soddisfare
+		   per essere stampati a schermo
+*/
+template <typename T, typename O, typename E, bool P, typename F>
+void printIF(const compact_binary_search_tree<T, O, E, P> &tree, F predicate) {
+	typename compact_binary_search_tree<T, O, E, P>::const_iterator i, ie;
+
+	for(i = tree.begin(), ie = tree.end(); i != ie; ++i)
+		if(predicate(*i))
+			std::cout << *i << " ";
+
+	std::cout << std::endl;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstcompact.h
@@ -113,6 +113,85 @@ public:
 	}
 };
 
+/**
+	@brief Eccezione di errore di lettura o scrittura di un file
+	
+	Classe eccezione custom.
+	Viene lanciata quando un'operazione su un file associato
+	a un albero (giornale, checkpoint, pagine) fallisce o trova dati non validi.
+*/
+class bst_io_exception {
+	
+	std::string message; ///< messaggio di errore
+	
+	std::string _path; ///< percorso del file
+	
+public:
+	
+	/**
+		@brief Costruttore
+		
+		Costruttore che prende un messaggio d'errore e il percorso del file.
+	*/
+	bst_io_exception(const std::string &message, const std::string &path) :
+		message(message), _path(path) {} // initialization list
+	
+	/**
+		@brief Messaggio di errore
+		
+		Ritorna il messaggio di errore.
+		
+		@return messaggio di errore
+	*/
+	std::string what(void) const {
+		return message;
+	}
+
+	/**
+		@brief Percorso del file
+		
+		Ritorna il percorso del file su cui e' avvenuto l'errore.
+		
+		@return percorso del file
+	*/
+	std::string get_path(void) const {
+		return _path;
+	}
+};
+
+/**
+	@brief Eccezione di albero vuoto
+	
+	Classe eccezione custom.
+	Viene lanciata quando si richiede il valore minimo o massimo
+	di un albero vuoto.
+*/
+class bst_empty_tree_exception {
+	
+	std::string message; ///< messaggio di errore
+	
+public:
+	
+	/**
+		@brief Costruttore
+		
+		Costruttore che prende un messaggio d'errore.
+	*/
+	explicit bst_empty_tree_exception(const std::string &message) :
+		message(message) {} // initialization list
+	
+	/**
+		@brief Messaggio di errore
+		
+		Ritorna il messaggio di errore.
+		
+		@return messaggio di errore
+	*/
+	std::string what(void) const {
+		return message;
+	}
+};
+
 #endif
 
 // Fine guardie del file header
@@ -0,0 +1,475 @@
+/**
+	@file bsthash.h
+
+	@brief Dichiarazione e definizione della classe
+	hashed_binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTHASH_H
+#define BSTHASH_H
+
+// Direttive per il pre-compilatore
+
+#include <vector> // std::vector
+#include <utility> // std::pair, std::forward, std::swap
+#include <iterator> // std::back_inserter
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Albero binario di ricerca con hash del contenuto
+
+	Classe che implementa un albero binario di ricerca di dati generici T
+	che mantiene un hash del proprio contenuto, aggiornato in tempo costante
+	da ogni inserimento e rimozione: l'hash e' la somma (modulo 2^64)
+	degli hash dei valori calcolati con il funtore H e rimescolati.
+	Essendo una somma, non dipende dalla forma dell'albero ne' dall'ordine
+	di inserimento, e una rimozione lo aggiorna con una sottrazione.
+
+	Due alberi con numero di elementi o hash diversi sono sicuramente
+	diversi: il confronto di uguaglianza e quello di ordinamento
+	si concludono in tempo costante. Solo se numero di elementi e hash
+	coincidono (alberi quasi certamente uguali) i valori vengono
+	confrontati in ordine crescente.
+	L'ordinamento tra alberi confronta il numero di elementi, poi l'hash,
+	poi i valori in ordine crescente: e' un ordinamento totale coerente
+	con l'uguaglianza del contenuto, adatto ad alberi di alberi,
+	ma diverso dall'ordine lessicografico dei valori.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param H funtore di hash di un dato (ritorna std::size_t); dati uguali
+		   secondo E devono avere lo stesso hash
+*/
+template <typename T, typename O, typename E, typename H>
+class hashed_binary_search_tree : public binary_search_tree<T, O, E> {
+
+	typedef binary_search_tree<T, O, E> base; ///< tipo dell'albero di base
+	typedef typename base::node node; ///< tipo dei nodi dell'albero
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+
+	unsigned long long _hash; ///< hash del contenuto dell'albero
+	H _hasher; ///< oggetto funtore di hash
+
+	/**
+		@brief Hash rimescolato di un valore
+
+		Funzione privata helper che rimescola i bit dell'hash di un valore,
+		in modo che la somma degli hash non si annulli per valori vicini.
+
+		@param value valore di cui calcolare l'hash
+
+		@return hash rimescolato del valore
+	*/
+	unsigned long long mix(const T &value) const {
+		unsigned long long x = _hasher(value);
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return x;
+	}
+
+public:
+
+	typedef typename base::const_iterator const_iterator; ///< iteratore costante dell'albero
+	typedef typename base::node_handle node_handle; ///< nodo estratto dall'albero
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore per istanziare un albero vuoto.
+	*/
+	hashed_binary_search_tree() : _hash(0) {} // initialization list
+
+	// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+	// coincidono con quelli di default
+
+	/**
+		@brief Scambio del contenuto di due alberi
+
+		Scambia in tempo costante i nodi e l'hash dell'albero
+		con quelli di un altro albero.
+
+		@param other albero con cui scambiare il contenuto
+	*/
+	void swap(hashed_binary_search_tree &other) {
+		base::swap(other);
+		std::swap(_hash, other._hash);
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Inserisce un elemento nell'albero e ne aggiunge l'hash.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		base::insert(value);
+		_hash += mix(value);
+	}
+
+	/**
+		@brief Inserimento con suggerimento di un elemento nell'albero
+
+		Inserisce un elemento come binary_search_tree::insert(hint, value)
+		e ne aggiunge l'hash.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param hint iteratore all'elemento vicino al quale inserire il valore
+		@param value valore dell'elemento da inserire
+
+		@return iteratore all'elemento inserito
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	const_iterator insert(const_iterator hint, const T &value) {
+		const_iterator i = base::insert(hint, value);
+		_hash += mix(value);
+		return i;
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+
+		Inserisce un elemento nell'albero, se non e' gia' presente,
+		e ne aggiunge l'hash.
+
+		@param value valore dell'elemento da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const T &value) {
+		std::pair<const_iterator, bool> result = base::try_insert(value);
+		if(result.second)
+			_hash += mix(value);
+		return result;
+	}
+
+	/**
+		@brief Inserimento senza eccezioni con suggerimento
+
+		Inserisce un elemento come binary_search_tree::try_insert(hint, value)
+		e, se e' stato inserito, ne aggiunge l'hash.
+
+		@param hint iteratore all'elemento vicino al quale inserire il valore
+		@param value valore dell'elemento da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const_iterator hint, const T &value) {
+		std::pair<const_iterator, bool> result = base::try_insert(hint, value);
+		if(result.second)
+			_hash += mix(value);
+		return result;
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento costruito sul posto
+
+		Costruisce un valore con gli argomenti passati e lo inserisce
+		nell'albero, se non e' gia' presente.
+
+		@param args argomenti per il costruttore del valore
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename... Args>
+	std::pair<const_iterator, bool> try_emplace(Args&&... args) {
+		return try_insert(T(std::forward<Args>(args)...));
+	}
+
+	/**
+		@brief Inserimento di una sequenza di elementi nell'albero
+
+		Inserisce nell'albero i valori di una sequenza come
+		binary_search_tree::insert_batch e aggiunge gli hash
+		dei valori inseriti.
+
+		@param first iteratore forward al primo valore da inserire
+		@param last iteratore forward alla fine della sequenza
+
+		@return numero di valori scartati perche' duplicati
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	size_type insert_batch(I first, I last) {
+		std::vector<T> rejected;
+		size_type count = base::insert_batch(first, last, std::back_inserter(rejected));
+
+		for(; first != last; ++first)
+			_hash += mix(*first);
+		for(typename std::vector<T>::const_iterator i = rejected.begin(); i != rejected.end(); ++i)
+			_hash -= mix(*i);
+
+		return count;
+	}
+
+	/**
+		@brief Rimozione di un elemento dall'albero
+
+		Rimuove un elemento dall'albero e ne sottrae l'hash.
+
+		@pre Il valore da rimuovere dev'essere presente all'interno dell'albero
+
+		@param value valore dell'elemento da rimuovere
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+	*/
+	void erase(const T &value) {
+		base::erase(value);
+		_hash -= mix(value);
+	}
+
+	/**
+		@brief Estrazione del valore minimo
+
+		Come binary_search_tree::pop_min, sottraendo l'hash del valore.
+
+		@return valore minimo
+
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	T pop_min() {
+		T value(base::pop_min());
+		_hash -= mix(value);
+		return value;
+	}
+
+	/**
+		@brief Estrazione del valore massimo
+
+		Come binary_search_tree::pop_max, sottraendo l'hash del valore.
+
+		@return valore massimo
+
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	T pop_max() {
+		T value(base::pop_max());
+		_hash -= mix(value);
+		return value;
+	}
+
+	/**
+		@brief Sostituzione del contenuto con una sequenza ordinata
+
+		Come binary_search_tree::assign_sorted, ricalcolando l'hash.
+
+		@param first iteratore forward al primo valore
+		@param last iteratore forward alla fine della sequenza
+
+		@throw std::invalid_argument se la sequenza non e' strettamente
+			   crescente (l'albero non cambia)
+		@throw eccezione di allocazione di memoria (l'albero non cambia)
+	*/
+	template <typename I>
+	void assign_sorted(I first, I last) {
+		base::assign_sorted(first, last);
+		_hash = 0;
+		for(typename base::const_sorted_iterator i = this->sorted_begin(), ie = this->sorted_end(); i != ie; ++i)
+			_hash += mix(*i);
+	}
+
+	/**
+		@brief Estrazione di un nodo
+
+		Come binary_search_tree::extract, sottraendo l'hash del valore.
+
+		@param value valore da estrarre
+
+		@return node_handle con il nodo estratto (vuoto se il valore
+				non e' presente)
+	*/
+	node_handle extract(const T &value) {
+		node_handle handle(base::extract(value));
+		if(!handle.empty())
+			_hash -= mix(handle.value());
+		return handle;
+	}
+
+	/**
+		@brief Inserimento di un nodo estratto
+
+		Come binary_search_tree::insert(node_handle &&), aggiungendo
+		l'hash del valore.
+
+		@param handle node_handle con il nodo da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				e da true se il nodo e' stato inserito
+
+		@throw eccezione di allocazione di memoria (handle conserva il nodo)
+	*/
+	std::pair<const_iterator, bool> insert(node_handle &&handle) {
+		unsigned long long h = handle.empty() ? 0 : mix(handle.value());
+		std::pair<const_iterator, bool> result = base::insert(std::move(handle));
+		if(result.second)
+			_hash += h;
+		return result;
+	}
+
+	/**
+		@brief Divisione dell'albero
+
+		Come binary_search_tree::split, calcolando l'hash della parte
+		piu' piccola (gia' visitata per contarne gli elementi)
+		e ottenendo l'altro per differenza.
+
+		@param key valore di divisione
+		@param greater albero che riceve i valori maggiori o uguali a key
+
+		@throw std::invalid_argument se greater e' l'albero stesso
+	*/
+	void split(const T &key, hashed_binary_search_tree &greater) {
+		base::split(key, greater);
+
+		hashed_binary_search_tree &smaller = (this->size() <= greater.size()) ? *this : greater;
+		unsigned long long total = _hash;
+		smaller._hash = 0;
+		for(typename base::const_sorted_iterator i = smaller.sorted_begin(), ie = smaller.sorted_end(); i != ie; ++i)
+			smaller._hash += mix(*i);
+		(&smaller == this ? greater._hash : _hash) = total - smaller._hash;
+	}
+
+	/**
+		@brief Unione di due alberi
+
+		Come binary_search_tree::join, sommando gli hash.
+
+		@param greater albero da unire (resta vuoto)
+
+		@throw std::invalid_argument se i valori dei due alberi non sono
+			   separati (gli alberi non cambiano)
+		@throw eccezione di allocazione di memoria (gli alberi non cambiano)
+	*/
+	void join(hashed_binary_search_tree &greater) {
+		if(&greater == this)
+			return;
+		base::join(greater);
+		_hash += greater._hash;
+		greater._hash = 0;
+	}
+
+	/**
+		@brief Hash del contenuto dell'albero
+
+		@return hash del contenuto (0 per l'albero vuoto)
+	*/
+	unsigned long long hash() const {
+		return _hash;
+	}
+
+	/**
+		@brief Confronto a tre vie
+
+		Confronta due alberi per numero di elementi, poi per hash,
+		poi per valori in ordine crescente. Solo l'ultimo passo,
+		necessario per alberi con lo stesso contenuto (o in caso di
+		collisione degli hash), visita gli alberi.
+
+		@param other albero da confrontare
+
+		@return valore negativo se l'albero precede other, zero se i due
+				alberi hanno lo stesso contenuto, positivo altrimenti
+	*/
+	int compare(const hashed_binary_search_tree &other) const {
+		if(this->size() != other.size())
+			return (this->size() < other.size()) ? -1 : 1;
+		if(_hash != other._hash)
+			return (_hash < other._hash) ? -1 : 1;
+
+		// Stesso numero di elementi: le visite simmetriche terminano insieme
+		std::vector<const node *> pending1, pending2;
+		const node *n1 = this->_root;
+		const node *n2 = other._root;
+		for(;;) {
+			for(; n1 != nullptr; n1 = n1->left)
+				pending1.push_back(n1);
+			for(; n2 != nullptr; n2 = n2->left)
+				pending2.push_back(n2);
+			if(pending1.empty())
+				return 0;
+
+			n1 = pending1.back();
+			pending1.pop_back();
+			n2 = pending2.back();
+			pending2.pop_back();
+			if(this->_order(n1->value, n2->value))
+				return -1;
+			if(this->_order(n2->value, n1->value))
+				return 1;
+			n1 = n1->right;
+			n2 = n2->right;
+		}
+	}
+
+	/**
+		@brief Operatore di uguaglianza
+
+		@param other albero da confrontare
+
+		@return true se i due alberi hanno lo stesso contenuto
+	*/
+	bool operator==(const hashed_binary_search_tree &other) const {
+		return compare(other) == 0;
+	}
+
+	/**
+		@brief Operatore di disuguaglianza
+
+		@param other albero da confrontare
+
+		@return true se i due alberi hanno contenuto diverso
+	*/
+	bool operator!=(const hashed_binary_search_tree &other) const {
+		return compare(other) != 0;
+	}
+
+	/**
+		@brief Operatore di ordinamento
+
+		@param other albero da confrontare
+
+		@return true se l'albero precede other secondo compare
+	*/
+	bool operator<(const hashed_binary_search_tree &other) const {
+		return compare(other) < 0;
+	}
+
+}; // class hashed_binary_search_tree
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bsthash.h
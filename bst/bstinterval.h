@@ -0,0 +1,569 @@
+/**
+	@file bstinterval.h
+
+	@brief Dichiarazione e definizione delle classi bst_interval
+	e interval_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTINTERVAL_H
+#define BSTINTERVAL_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <stdexcept> // std::invalid_argument
+#include <vector> // std::vector
+#include <utility> // std::pair, std::forward
+#include "bst.h" // binary_search_tree
+
+template <typename K, typename O, typename E>
+class interval_tree;
+
+/**
+	@brief Intervallo chiuso
+
+	Struttura che implementa un intervallo chiuso [low, high] di estremi
+	di tipo K. Contiene anche il massimo estremo superiore del sottoalbero
+	di cui e' radice, mantenuto da interval_tree e non accessibile
+	all'esterno.
+
+	@param K tipo degli estremi
+*/
+template <typename K>
+struct bst_interval {
+	K low; ///< estremo inferiore
+	K high; ///< estremo superiore
+
+	/**
+		@brief Costruttore
+
+		Costruttore che prende gli estremi dell'intervallo.
+
+		@param l estremo inferiore
+		@param h estremo superiore (non minore di l)
+	*/
+	bst_interval(const K &l, const K &h) : low(l), high(h), _max(h) {} // initialization list
+
+private:
+
+	K _max; ///< massimo estremo superiore del sottoalbero (mantenuto da interval_tree)
+
+	template <typename, typename, typename>
+	friend class interval_tree;
+};
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa di un intervallo.
+
+	@param os oggetto stream di output
+	@param i intervallo da stampare
+
+	@return reference allo stream di output
+*/
+template <typename K>
+std::ostream &operator<<(std::ostream &os, const bst_interval<K> &i) {
+	os << "[" << i.low << ", " << i.high << "]";
+	return os;
+}
+
+/**
+	@brief Funtore per il confronto di due intervalli
+
+	Funtore che ordina gli intervalli per estremo inferiore
+	e, a parita', per estremo superiore.
+
+	@param K tipo degli estremi
+	@param O funtore di confronto di ordinamento (<) di due estremi
+*/
+template <typename K, typename O>
+struct compare_interval {
+	bool operator()(const bst_interval<K> &i1, const bst_interval<K> &i2) const {
+		O order;
+		if(order(i1.low, i2.low))
+			return true;
+		if(order(i2.low, i1.low))
+			return false;
+		return order(i1.high, i2.high);
+	}
+};
+
+/**
+	@brief Funtore per il confronto di uguaglianza di due intervalli
+
+	Funtore per il confronto di uguaglianza tra due intervalli:
+	sono uguali se hanno gli stessi estremi.
+
+	@param K tipo degli estremi
+	@param E funtore di confronto di uguaglianza (==) di due estremi
+*/
+template <typename K, typename E>
+struct equal_interval {
+	bool operator()(const bst_interval<K> &i1, const bst_interval<K> &i2) const {
+		E equals;
+		return equals(i1.low, i2.low) && equals(i1.high, i2.high);
+	}
+};
+
+/**
+	@brief Albero di intervalli
+
+	Classe che implementa un albero binario di ricerca di intervalli chiusi
+	ordinati per estremo inferiore, in cui ogni nodo conserva il massimo
+	estremo superiore del proprio sottoalbero. Inserimenti e rimozioni
+	aggiornano il massimo lungo il cammino verso la radice.
+
+	Il massimo permette di scartare interi sottoalberi nelle ricerche
+	per sovrapposizione (overlapping) e per punto (stabbing): vengono
+	visitati solo i nodi sul cammino di ricerca e i sottoalberi che
+	contengono intervalli trovati, invece di tutto l'albero come con printIF.
+	Il costo e' O(h + k) nei casi tipici, con h altezza dell'albero
+	e k numero di intervalli trovati (O(h) per intervallo trovato
+	nel caso peggiore).
+
+	@param K tipo degli estremi
+	@param O funtore di confronto di ordinamento (<) di due estremi
+	@param E funtore di confronto di uguaglianza (==) di due estremi
+*/
+template <typename K, typename O, typename E>
+class interval_tree : public binary_search_tree<bst_interval<K>, compare_interval<K, O>, equal_interval<K, E> > {
+
+	typedef bst_interval<K> interval; ///< tipo degli intervalli
+	typedef binary_search_tree<interval, compare_interval<K, O>, equal_interval<K, E> > base; ///< tipo dell'albero di base
+	typedef typename base::node node; ///< tipo dei nodi dell'albero
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+
+	O _key_order; ///< oggetto funtore per l'ordinamento degli estremi
+
+	/**
+		@brief Aggiornamento del massimo di un nodo
+
+		Funzione privata helper che ricalcola il massimo estremo superiore
+		del sottoalbero di un nodo dai massimi dei figli.
+
+		@param n puntatore al nodo da aggiornare
+	*/
+	void update(node *n) {
+		K max = n->value.high;
+		if(n->left != nullptr && _key_order(max, n->left->value._max))
+			max = n->left->value._max;
+		if(n->right != nullptr && _key_order(max, n->right->value._max))
+			max = n->right->value._max;
+		n->value._max = max;
+	}
+
+	/**
+		@brief Aggiornamento dei massimi verso la radice
+
+		Funzione privata helper che ricalcola il massimo di un nodo
+		e di tutti i suoi antenati.
+
+		@param n puntatore al primo nodo da aggiornare (puo' essere nullptr)
+	*/
+	void update_path(node *n) {
+		for(; n != nullptr; n = n->parent)
+			update(n);
+	}
+
+	/**
+		@brief Aggiornamento di tutti i massimi
+
+		Funzione privata helper che ricalcola il massimo di tutti i nodi,
+		visitando i figli prima dei padri.
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void update_all() {
+		// La visita nodo-destro-sinistro, al contrario, visita i figli prima dei padri
+		std::vector<node *> pending, order;
+		if(this->_root != nullptr)
+			pending.push_back(this->_root);
+		while(!pending.empty()) {
+			node *n = pending.back();
+			pending.pop_back();
+			order.push_back(n);
+			if(n->left != nullptr)
+				pending.push_back(n->left);
+			if(n->right != nullptr)
+				pending.push_back(n->right);
+		}
+
+		for(typename std::vector<node *>::reverse_iterator i = order.rbegin(); i != order.rend(); ++i)
+			update(*i);
+	}
+
+	/**
+		@brief Inserimento di un intervallo
+
+		Funzione privata helper che inserisce un intervallo, se non e'
+		gia' presente, e aggiorna i massimi degli antenati.
+
+		@param value intervallo da inserire
+
+		@return coppia formata dal puntatore al nodo con l'intervallo
+				e da true se l'intervallo e' stato inserito
+
+		@throw std::invalid_argument se l'estremo superiore precede
+			   quello inferiore
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<node *, bool> insert_interval(const interval &value) {
+		if(_key_order(value.high, value.low))
+			throw std::invalid_argument("interval_tree: estremo superiore minore dell'estremo inferiore");
+
+		std::pair<node *, bool> result = this->insert_unique(value);
+		if(result.second) {
+			node *n = result.first;
+			n->value._max = n->value.high;
+			for(node *p = n->parent; p != nullptr && _key_order(p->value._max, n->value.high); p = p->parent)
+				p->value._max = n->value.high;
+		}
+		return result;
+	}
+
+public:
+
+	// Il costruttore di default, il costruttore di copia,
+	// l'operatore di assegnamento e il distruttore coincidono
+	// con quelli di default (e quindi con quelli di binary_search_tree)
+
+	typedef typename base::const_iterator const_iterator; ///< iteratore costante dell'albero
+	typedef typename base::node_handle node_handle; ///< nodo estratto dall'albero
+
+	/**
+		@brief Inserimento di un intervallo nell'albero
+
+		@pre L'intervallo da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value intervallo da inserire
+
+		@throw bst_duplicated_value_exception se l'intervallo da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw std::invalid_argument se gli estremi non sono ordinati
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const interval &value) {
+		if(!insert_interval(value).second)
+			throw bst_duplicated_value_exception<interval>("Valore duplicato: ", value);
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un intervallo nell'albero
+
+		@param value intervallo da inserire
+
+		@return coppia formata dall'iteratore all'intervallo
+				e da true se l'intervallo e' stato inserito,
+				false se era gia' presente
+
+		@throw std::invalid_argument se gli estremi non sono ordinati
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const interval &value) {
+		std::pair<node *, bool> result = insert_interval(value);
+		return std::make_pair(base::iterator_to(result.first), result.second);
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un intervallo costruito sul posto
+
+		@param args argomenti per il costruttore dell'intervallo
+
+		@return coppia formata dall'iteratore all'intervallo
+				e da true se l'intervallo e' stato inserito,
+				false se era gia' presente
+
+		@throw std::invalid_argument se gli estremi non sono ordinati
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename... Args>
+	std::pair<const_iterator, bool> try_emplace(Args&&... args) {
+		return try_insert(interval(std::forward<Args>(args)...));
+	}
+
+	/**
+		@brief Inserimento di una sequenza di intervalli nell'albero
+
+		Inserisce gli intervalli come binary_search_tree::insert_batch
+		e ricalcola i massimi di tutti i nodi.
+
+		@param first iteratore forward al primo intervallo da inserire
+		@param last iteratore forward alla fine della sequenza
+
+		@return numero di intervalli scartati perche' duplicati
+
+		@throw std::invalid_argument se gli estremi di un intervallo
+			   non sono ordinati (l'albero non viene modificato)
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	size_type insert_batch(I first, I last) {
+		for(I i = first; i != last; ++i)
+			if(_key_order(i->high, i->low))
+				throw std::invalid_argument("interval_tree: estremo superiore minore dell'estremo inferiore");
+
+		size_type rejected = base::insert_batch(first, last);
+		update_all();
+		return rejected;
+	}
+
+	/**
+		@brief Rimozione di un intervallo dall'albero
+
+		Rimuove un intervallo e aggiorna i massimi dei nodi
+		il cui sottoalbero e' cambiato.
+
+		@pre L'intervallo da rimuovere dev'essere presente all'interno dell'albero
+
+		@param value intervallo da rimuovere
+
+		@throw bst_value_not_found_exception se l'intervallo non e' presente
+			   all'interno dell'albero
+	*/
+	void erase(const interval &value) {
+		node *n = this->search(value);
+		if(n == nullptr)
+			throw bst_value_not_found_exception<interval>("Valore non trovato: ", value);
+
+		// Nodo piu' in basso il cui sottoalbero cambia con lo scollegamento
+		node *changed = n->parent;
+		if(n->left != nullptr && n->right != nullptr) {
+			node *next = n->right;
+			while(next->left != nullptr)
+				next = next->left;
+			changed = (next->parent == n) ? next : next->parent;
+		}
+
+		this->unlink(n);
+		this->destroy_node(n);
+		update_path(changed);
+	}
+
+	/**
+		@brief Estrazione dell'intervallo minimo
+
+		Come binary_search_tree::pop_min, aggiornando il massimo
+		degli estremi superiori degli antenati.
+
+		@return intervallo con l'estremo inferiore minimo
+
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	interval pop_min() {
+		if(this->_leftmost == nullptr)
+			throw bst_empty_tree_exception("Albero vuoto");
+
+		// Il nodo minimo non ha figlio sinistro: cambia solo il sottoalbero del padre
+		node *changed = this->_leftmost->parent;
+		interval value(this->release_value(this->_leftmost));
+		update_path(changed);
+		return value;
+	}
+
+	/**
+		@brief Estrazione dell'intervallo massimo
+
+		Come binary_search_tree::pop_max, aggiornando il massimo
+		degli estremi superiori degli antenati.
+
+		@return intervallo con l'estremo inferiore massimo
+
+		@throw bst_empty_tree_exception se l'albero e' vuoto
+	*/
+	interval pop_max() {
+		if(this->_rightmost == nullptr)
+			throw bst_empty_tree_exception("Albero vuoto");
+
+		node *changed = this->_rightmost->parent;
+		interval value(this->release_value(this->_rightmost));
+		update_path(changed);
+		return value;
+	}
+
+	/**
+		@brief Sostituzione del contenuto con una sequenza ordinata
+
+		Come binary_search_tree::assign_sorted, ricalcolando i massimi
+		di tutti i nodi.
+
+		@param first iteratore forward al primo intervallo
+		@param last iteratore forward alla fine della sequenza
+
+		@throw std::invalid_argument se la sequenza non e' strettamente
+			   crescente o gli estremi di un intervallo non sono ordinati
+			   (l'albero non cambia)
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	void assign_sorted(I first, I last) {
+		for(I i = first; i != last; ++i)
+			if(_key_order(i->high, i->low))
+				throw std::invalid_argument("interval_tree: estremo superiore minore dell'estremo inferiore");
+
+		base::assign_sorted(first, last);
+		update_all();
+	}
+
+	/**
+		@brief Estrazione di un nodo
+
+		Come binary_search_tree::extract, aggiornando i massimi
+		dei nodi il cui sottoalbero e' cambiato.
+
+		@param value intervallo da estrarre
+
+		@return node_handle con il nodo estratto (vuoto se l'intervallo
+				non e' presente)
+	*/
+	node_handle extract(const interval &value) {
+		node *n = this->search(value);
+		if(n == nullptr)
+			return node_handle();
+
+		node *changed = n->parent;
+		if(n->left != nullptr && n->right != nullptr) {
+			node *next = n->right;
+			while(next->left != nullptr)
+				next = next->left;
+			changed = (next->parent == n) ? next : next->parent;
+		}
+
+		node_handle handle(base::extract(value));
+		update_path(changed);
+		return handle;
+	}
+
+	/**
+		@brief Inserimento di un nodo estratto
+
+		Come binary_search_tree::insert(node_handle &&), aggiornando
+		i massimi degli antenati del nodo inserito.
+
+		@param handle node_handle con il nodo da inserire
+
+		@return coppia formata dall'iteratore all'intervallo
+				e da true se il nodo e' stato inserito
+
+		@throw std::invalid_argument se gli estremi non sono ordinati
+			   (handle conserva il nodo)
+		@throw eccezione di allocazione di memoria (handle conserva il nodo)
+	*/
+	std::pair<const_iterator, bool> insert(node_handle &&handle) {
+		if(!handle.empty() && _key_order(handle.value().high, handle.value().low))
+			throw std::invalid_argument("interval_tree: estremo superiore minore dell'estremo inferiore");
+
+		std::pair<const_iterator, bool> result = base::insert(std::move(handle));
+		if(result.second)
+			update_path(base::node_of(result.first));
+		return result;
+	}
+
+	/**
+		@brief Divisione dell'albero
+
+		Come binary_search_tree::split, aggiornando i massimi dei nodi
+		sul cammino di divisione: in ognuna delle due parti sono gli
+		antenati del nodo piu' vicino a key.
+
+		@param key intervallo di divisione
+		@param greater albero che riceve gli intervalli maggiori o uguali a key
+
+		@throw std::invalid_argument se greater e' l'albero stesso
+	*/
+	void split(const interval &key, interval_tree &greater) {
+		base::split(key, greater);
+		update_path(this->_rightmost);
+		greater.update_path(greater._leftmost);
+	}
+
+	/**
+		@brief Unione di due alberi
+
+		Come binary_search_tree::join, aggiornando i massimi dei nodi
+		il cui sottoalbero e' cambiato.
+
+		@param greater albero da unire (resta vuoto)
+
+		@throw std::invalid_argument se gli intervalli dei due alberi
+			   non sono separati (gli alberi non cambiano)
+		@throw eccezione di allocazione di memoria (gli alberi non cambiano)
+	*/
+	void join(interval_tree &greater) {
+		if(&greater == this || greater._root == nullptr)
+			return;
+
+		// Il massimo diventa la radice: cambia il sottoalbero del suo padre
+		node *changed = (this->_rightmost != nullptr) ? this->_rightmost->parent : nullptr;
+		base::join(greater);
+		update_path(changed != nullptr ? changed : this->_root);
+	}
+
+	/**
+		@brief Ricerca degli intervalli sovrapposti a un intervallo
+
+		Copia in una sequenza di output, in ordine di estremo inferiore,
+		gli intervalli che hanno almeno un punto in comune
+		con l'intervallo [low, high].
+
+		@param low estremo inferiore dell'intervallo cercato
+		@param high estremo superiore dell'intervallo cercato
+		@param out iteratore di output a cui aggiungere gli intervalli
+
+		@return iteratore di output dopo l'ultimo intervallo copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI overlapping(const K &low, const K &high, OI out) const {
+		std::vector<const node *> pending;
+		const node *current = this->_root;
+
+		while(current != nullptr || !pending.empty()) {
+			// Un sottoalbero con massimo minore di low non contiene sovrapposizioni
+			while(current != nullptr && !_key_order(current->value._max, low)) {
+				pending.push_back(current);
+				current = current->left;
+			}
+			if(pending.empty())
+				break;
+			current = pending.back();
+			pending.pop_back();
+			if(_key_order(high, current->value.low))
+				break; // gli intervalli successivi iniziano dopo high
+			if(!_key_order(current->value.high, low))
+				*out++ = current->value;
+			current = current->right;
+		}
+
+		return out;
+	}
+
+	/**
+		@brief Ricerca degli intervalli che contengono un punto
+
+		Copia in una sequenza di output, in ordine di estremo inferiore,
+		gli intervalli che contengono il punto indicato.
+
+		@param point punto cercato
+		@param out iteratore di output a cui aggiungere gli intervalli
+
+		@return iteratore di output dopo l'ultimo intervallo copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI stabbing(const K &point, OI out) const {
+		return overlapping(point, point, out);
+	}
+
+}; // class interval_tree
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstinterval.h
@@ -0,0 +1,827 @@
+/**
+	@file bstjournal.h
+
+	@brief Dichiarazione e definizione della classe journaled_bst
+	e dei codificatori dei valori
+*/
+
+// Guardie del file header
+
+#ifndef BSTJOURNAL_H
+#define BSTJOURNAL_H
+
+// Direttive per il pre-compilatore
+
+#include <cstdio> // std::FILE, std::fopen, std::fwrite, std::fread, std::rename
+#include <cstring> // std::memcpy
+#include <string> // std::string
+#include <vector> // std::vector
+#include <chrono> // std::chrono::steady_clock, std::chrono::microseconds
+#include <stdexcept> // std::invalid_argument
+#include <type_traits> // std::aligned_storage
+#include <iterator> // std::back_inserter
+#include <algorithm> // std::sort, std::unique
+#include "bst.h" // binary_search_tree
+#include "bstexceptions.h" // bst_io_exception
+
+#ifdef _WIN32
+#include <io.h> // _commit, _fileno, _chsize_s
+#else
+#include <unistd.h> // fsync, fileno, ftruncate, close
+#include <fcntl.h> // open, O_RDONLY
+#endif
+
+/**
+	@brief Codificatore binario di dati a dimensione fissa
+
+	Funtore che codifica un dato copiandone i byte, per tipi senza
+	puntatori (int, float, complex, ...). La codifica dipende
+	dalla piattaforma (ordine dei byte, padding).
+
+	@param T tipo dei dati
+*/
+template <typename T>
+struct bst_pod_codec {
+
+	/**
+		@brief Codifica di un dato
+
+		@param value dato da codificare
+		@param out stringa a cui aggiungere i byte del dato
+	*/
+	void encode(const T &value, std::string &out) const {
+		out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	/**
+		@brief Decodifica di un dato
+
+		@param data byte del dato
+		@param length numero di byte
+
+		@return dato decodificato
+
+		@throw std::invalid_argument se il numero di byte non e' sizeof(T)
+	*/
+	T decode(const char *data, std::size_t length) const {
+		if(length != sizeof(T))
+			throw std::invalid_argument("bst_pod_codec: lunghezza non valida");
+
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		std::memcpy(&storage, data, sizeof(T));
+		return *reinterpret_cast<const T *>(&storage);
+	}
+};
+
+/**
+	@brief Codificatore binario di stringhe
+
+	Funtore che codifica una stringa con i suoi byte.
+*/
+struct bst_string_codec {
+
+	/**
+		@brief Codifica di una stringa
+
+		@param value stringa da codificare
+		@param out stringa a cui aggiungere i byte della stringa
+	*/
+	void encode(const std::string &value, std::string &out) const {
+		out.append(value);
+	}
+
+	/**
+		@brief Decodifica di una stringa
+
+		@param data byte della stringa
+		@param length numero di byte
+
+		@return stringa decodificata
+	*/
+	std::string decode(const char *data, std::size_t length) const {
+		return std::string(data, length);
+	}
+};
+
+/**
+	@brief Opzioni del giornale
+
+	Struttura che raccoglie i parametri di un journaled_bst.
+*/
+struct bst_journal_options {
+	unsigned int group_size; ///< operazioni registrate con una sola sincronizzazione del file
+	std::chrono::microseconds max_delay; ///< attesa massima di un'operazione non sincronizzata
+	unsigned long long checkpoint_bytes; ///< dimensione del giornale oltre cui fare un checkpoint (0 = mai)
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore che imposta gruppi di 64 operazioni, un'attesa
+		massima di 10 ms e un checkpoint ogni 64 MB di giornale.
+	*/
+	bst_journal_options() :
+		group_size(64), max_delay(10000), checkpoint_bytes(64ULL << 20) {} // initialization list
+};
+
+/**
+	@brief Albero binario di ricerca persistente con giornale
+
+	Classe che aggiunge la persistenza a un binary_search_tree: ogni
+	inserimento e rimozione viene registrato in coda a un file binario
+	(giornale, path + ".log") prima di essere confermato al chiamante.
+	Periodicamente il contenuto dell'albero viene salvato in un file
+	di checkpoint (path + ".ckpt") e il giornale viene svuotato.
+	Alla costruzione, l'albero viene ricostruito caricando l'ultimo
+	checkpoint con insert_batch e rieseguendo il giornale, raggruppando
+	gli inserimenti consecutivi in blocchi.
+
+	La sincronizzazione del file su disco (fsync) e' costosa: le
+	operazioni vengono raccolte in memoria e scritte con una sola
+	sincronizzazione (group commit) quando sono group_size, oppure
+	alla prima operazione successiva allo scadere di max_delay,
+	oppure con sync(). Un'interruzione improvvisa puo' perdere solo
+	le operazioni non ancora sincronizzate: group_size = 1 rende ogni
+	operazione persistente prima del ritorno, valori maggiori
+	aumentano il throughput.
+
+	Ogni record del giornale ha un checksum: un record incompleto
+	o corrotto in coda (scrittura interrotta) termina il ripristino
+	e viene eliminato con un checkpoint. Rieseguire un'operazione
+	gia' contenuta nel checkpoint non cambia il risultato, quindi
+	un'interruzione durante il checkpoint non perde dati.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param C codificatore dei dati (come bst_pod_codec e bst_string_codec)
+*/
+template <typename T, typename O, typename E, typename C>
+class journaled_bst {
+
+public:
+
+	typedef binary_search_tree<T, O, E> tree_type; ///< tipo dell'albero
+
+private:
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+
+	static const char insert_op = 'I'; ///< codice di un inserimento nel giornale
+	static const char erase_op = 'E'; ///< codice di una rimozione nel giornale
+	static const std::size_t header_size = 5; ///< byte dell'intestazione di un record (codice e lunghezza)
+	static const std::size_t max_record_size = 1U << 30; ///< dimensione massima di un record valido
+
+	tree_type _tree; ///< albero
+	std::string _path; ///< percorso dei file senza estensione
+	bst_journal_options _options; ///< opzioni del giornale
+	std::FILE *_log; ///< file del giornale
+	std::string _pending; ///< record non ancora scritti nel giornale
+	size_type _pending_ops; ///< numero di operazioni non ancora scritte
+	std::chrono::steady_clock::time_point _pending_since; ///< istante della prima operazione non scritta
+	unsigned long long _log_bytes; ///< byte del giornale scritti
+	bool _failed; ///< true se il giornale non e' stato ripristinato dopo un errore di scrittura
+	unsigned long long _syncs; ///< numero di sincronizzazioni del giornale
+	unsigned long long _replayed; ///< record del giornale rieseguiti alla costruzione
+	C _codec; ///< oggetto codificatore dei dati
+
+	/**
+		@brief Checksum di una sequenza di byte
+
+		Funzione privata helper che calcola l'hash FNV-1a a 32 bit
+		di una sequenza di byte.
+
+		@param data byte
+		@param length numero di byte
+		@param h valore iniziale (per continuare un checksum)
+
+		@return checksum dei byte
+	*/
+	static unsigned int checksum(const char *data, std::size_t length, unsigned int h = 2166136261U) {
+		for(std::size_t i = 0; i < length; ++i)
+			h = (h ^ static_cast<unsigned char>(data[i])) * 16777619U;
+		return h;
+	}
+
+	/**
+		@brief Sincronizzazione di un file su disco
+
+		Funzione privata helper che svuota i buffer di un file
+		e ne forza la scrittura su disco.
+
+		@param file file da sincronizzare
+		@param path percorso del file
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	static void sync_file(std::FILE *file, const std::string &path) {
+		bool failed = std::fflush(file) != 0;
+#ifdef _WIN32
+		failed = failed || _commit(_fileno(file)) != 0;
+#else
+		failed = failed || fsync(fileno(file)) != 0;
+#endif
+		if(failed)
+			throw bst_io_exception("Sincronizzazione fallita: ", path);
+	}
+
+	/**
+		@brief Sincronizzazione della directory di un file
+
+		Funzione privata helper che forza la scrittura su disco della
+		directory che contiene un file, rendendo persistenti la sua
+		creazione o rinomina. Su Windows non esiste un equivalente
+		e la funzione non fa nulla.
+
+		@param path percorso del file
+
+		@throw bst_io_exception se la sincronizzazione fallisce
+	*/
+	static void sync_directory(const std::string &path) {
+#ifndef _WIN32
+		std::string::size_type slash = path.find_last_of('/');
+		std::string directory = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+		int fd = open(directory.c_str(), O_RDONLY);
+		bool failed = fd < 0 || fsync(fd) != 0;
+		if(fd >= 0)
+			close(fd);
+		if(failed)
+			throw bst_io_exception("Sincronizzazione fallita: ", directory);
+#endif
+	}
+
+	/**
+		@brief Eliminazione di un record incompleto
+
+		Funzione privata helper chiamata quando la scrittura nel giornale
+		fallisce: riapre il giornale e lo tronca agli ultimi record
+		sincronizzati, perche' un record scritto a meta' interromperebbe
+		il ripristino di tutti i record successivi. Se anche questo
+		fallisce, il giornale viene segnato come non utilizzabile
+		fino al prossimo checkpoint.
+	*/
+	void discard_tail() {
+		std::fclose(_log); // i byte rimasti nel buffer vengono eliminati dal troncamento
+		_log = nullptr;
+		std::string path = _path + ".log";
+		_log = std::fopen(path.c_str(), "ab");
+		bool failed = _log == nullptr;
+#ifdef _WIN32
+		failed = failed || _chsize_s(_fileno(_log), static_cast<long long>(_log_bytes)) != 0;
+#else
+		failed = failed || ftruncate(fileno(_log), static_cast<off_t>(_log_bytes)) != 0;
+#endif
+		try {
+			if(!failed)
+				sync_file(_log, path);
+		}
+		catch(const bst_io_exception &) {
+			failed = true;
+		}
+		_failed = failed;
+	}
+
+	/**
+		@brief Apertura di un file
+
+		@param path percorso del file
+		@param mode modalita' di apertura (come std::fopen)
+
+		@return file aperto
+
+		@throw bst_io_exception se il file non puo' essere aperto
+	*/
+	static std::FILE *open_file(const std::string &path, const char *mode) {
+		std::FILE *file = std::fopen(path.c_str(), mode);
+		if(file == nullptr)
+			throw bst_io_exception("Apertura fallita: ", path);
+		return file;
+	}
+
+	/**
+		@brief Codifica di un record
+
+		Funzione privata helper che aggiunge a out il record
+		di un'operazione. Formato del record: codice (1 byte), lunghezza
+		del dato (4 byte), dato codificato, checksum dei byte
+		precedenti (4 byte). Se la codifica fallisce out non cambia.
+
+		@param op codice dell'operazione
+		@param value dato dell'operazione
+		@param out byte a cui aggiungere il record
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void encode_record(char op, const T &value, std::string &out) {
+		std::size_t start = out.size();
+		try {
+			out.push_back(op);
+			out.append(4, '\0');
+			_codec.encode(value, out);
+			unsigned int length = static_cast<unsigned int>(out.size() - start - header_size);
+			std::memcpy(&out[start + 1], &length, 4);
+			unsigned int sum = checksum(&out[start], out.size() - start);
+			out.append(reinterpret_cast<const char *>(&sum), 4);
+		}
+		catch(...) {
+			out.resize(start);
+			throw;
+		}
+	}
+
+	/**
+		@brief Registrazione di un'operazione
+
+		Funzione privata helper che aggiunge un record ai record
+		non ancora scritti.
+
+		@param op codice dell'operazione
+		@param value dato dell'operazione
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void append(char op, const T &value) {
+		encode_record(op, value, _pending);
+		if(_pending_ops++ == 0)
+			_pending_since = std::chrono::steady_clock::now();
+	}
+
+	/**
+		@brief Scrittura condizionata del giornale
+
+		Funzione privata helper che scrive i record in attesa
+		se sono almeno group_size o se il piu' vecchio attende
+		da piu' di max_delay.
+
+		@throw bst_io_exception se la scrittura del giornale fallisce
+	*/
+	void maybe_commit() {
+		if(_pending_ops >= _options.group_size
+		   || std::chrono::steady_clock::now() - _pending_since >= _options.max_delay)
+			sync();
+	}
+
+	/**
+		@brief Caricamento del checkpoint
+
+		Funzione privata helper che carica nell'albero i valori del file
+		di checkpoint, se esiste. Formato: "BSTCKPT1", numero di valori
+		(8 byte), per ogni valore lunghezza (4 byte) e dato codificato,
+		checksum dei byte dopo l'intestazione (4 byte).
+
+		@throw bst_io_exception se il checkpoint non e' valido
+		@throw eccezione di allocazione di memoria
+	*/
+	void load_checkpoint() {
+		std::string path = _path + ".ckpt";
+		std::FILE *file = std::fopen(path.c_str(), "rb");
+		if(file == nullptr)
+			return;
+
+		std::string data;
+		char buffer[65536];
+		std::size_t read;
+		while((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+			data.append(buffer, read);
+		bool failed = std::ferror(file) != 0;
+		std::fclose(file);
+
+		unsigned long long count = 0;
+		failed = failed || data.size() < 20 || data.compare(0, 8, "BSTCKPT1") != 0;
+		if(!failed) {
+			unsigned int sum;
+			std::memcpy(&sum, &data[data.size() - 4], 4);
+			failed = checksum(&data[8], data.size() - 12) != sum;
+			std::memcpy(&count, &data[8], 8);
+		}
+		if(failed)
+			throw bst_io_exception("Checkpoint non valido: ", path);
+
+		std::vector<T> values;
+		std::size_t offset = 16;
+		for(unsigned long long i = 0; i < count; ++i) {
+			unsigned int length;
+			if(offset + 4 > data.size() - 4)
+				throw bst_io_exception("Checkpoint non valido: ", path);
+			std::memcpy(&length, &data[offset], 4);
+			offset += 4;
+			if(length > data.size() - 4 - offset)
+				throw bst_io_exception("Checkpoint non valido: ", path);
+			values.push_back(_codec.decode(&data[offset], length));
+			offset += length;
+		}
+
+		_tree.insert_batch(values.begin(), values.end());
+	}
+
+	/**
+		@brief Riesecuzione del giornale
+
+		Funzione privata helper che riesegue i record validi del giornale,
+		inserendo in blocco gli inserimenti consecutivi. Gli inserimenti
+		di valori presenti e le rimozioni di valori assenti vengono ignorati.
+
+		@return true se il giornale termina con un record incompleto
+				o corrotto
+
+		@throw eccezione di allocazione di memoria
+	*/
+	bool replay_log() {
+		std::string path = _path + ".log";
+		std::FILE *file = std::fopen(path.c_str(), "rb");
+		if(file == nullptr)
+			return false;
+
+		std::vector<T> batch;
+		std::string record;
+		bool torn = false;
+		for(;;) {
+			record.resize(header_size);
+			std::size_t read = std::fread(&record[0], 1, header_size, file);
+			if(read < header_size) {
+				torn = read > 0;
+				break;
+			}
+
+			unsigned int length;
+			std::memcpy(&length, &record[1], 4);
+			if((record[0] != insert_op && record[0] != erase_op) || length > max_record_size) {
+				torn = true;
+				break;
+			}
+			record.resize(header_size + length + 4);
+			if(std::fread(&record[header_size], 1, length + 4, file) < length + 4) {
+				torn = true;
+				break;
+			}
+			unsigned int sum;
+			std::memcpy(&sum, &record[header_size + length], 4);
+			if(checksum(&record[0], header_size + length) != sum) {
+				torn = true;
+				break;
+			}
+
+			T value = _codec.decode(&record[header_size], length);
+			if(record[0] == insert_op)
+				batch.push_back(value);
+			else {
+				_tree.insert_batch(batch.begin(), batch.end());
+				batch.clear();
+				if(_tree.exists(value))
+					_tree.erase(value);
+			}
+			_log_bytes += record.size();
+			_replayed++;
+		}
+		std::fclose(file);
+
+		_tree.insert_batch(batch.begin(), batch.end());
+		return torn;
+	}
+
+public:
+
+	/**
+		@brief Costruttore
+
+		Ricostruisce l'albero dai file associati al percorso
+		(se esistono) e apre il giornale per registrare le operazioni.
+
+		@param path percorso dei file senza estensione
+		@param options opzioni del giornale
+
+		@throw bst_io_exception se i file non possono essere letti o scritti
+		@throw eccezione di allocazione di memoria
+	*/
+	explicit journaled_bst(const std::string &path, const bst_journal_options &options = bst_journal_options()) :
+		_path(path), _options(options), _log(nullptr), _pending_ops(0),
+		_log_bytes(0), _failed(false), _syncs(0), _replayed(0) { // initialization list
+		load_checkpoint();
+		if(replay_log())
+			checkpoint(); // elimina la coda non valida del giornale
+		else {
+			_log = open_file(_path + ".log", "ab");
+			sync_directory(_path + ".log"); // il giornale potrebbe essere appena stato creato
+		}
+	}
+
+	// L'albero e' associato ai suoi file e non puo' essere copiato
+	journaled_bst(const journaled_bst &other) = delete;
+	journaled_bst &operator=(const journaled_bst &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Scrive nel giornale le operazioni in attesa e chiude il file.
+		Eventuali errori di scrittura vengono ignorati: per gestirli
+		chiamare sync() prima della distruzione.
+	*/
+	~journaled_bst() {
+		try {
+			sync();
+		}
+		catch(...) {}
+		if(_log != nullptr)
+			std::fclose(_log);
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+
+		Inserisce un elemento, se non e' gia' presente, e registra
+		l'inserimento nel giornale.
+
+		@param value valore dell'elemento da inserire
+
+		@return true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw bst_io_exception se la scrittura del giornale fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	bool try_insert(const T &value) {
+		if(!_tree.try_insert(value).second)
+			return false;
+
+		try {
+			append(insert_op, value);
+		}
+		catch(...) {
+			_tree.erase(value);
+			throw;
+		}
+		maybe_commit();
+		return true;
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw bst_io_exception se la scrittura del giornale fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		if(!try_insert(value))
+			throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+	}
+
+	/**
+		@brief Inserimento di una sequenza di elementi nell'albero
+
+		Inserisce i valori come binary_search_tree::insert_batch
+		e registra nel giornale solo i valori effettivamente inseriti.
+		I record vengono codificati prima di modificare l'albero,
+		quindi un errore di allocazione non lascia nell'albero
+		valori non registrati.
+
+		@param first iteratore forward al primo valore da inserire
+		@param last iteratore forward alla fine della sequenza
+
+		@return numero di valori scartati perche' duplicati
+
+		@throw bst_io_exception se la scrittura del giornale fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	size_type insert_batch(I first, I last) {
+		O order;
+		E equals;
+		std::vector<T> batch(first, last);
+		size_type total = static_cast<size_type>(batch.size());
+		std::sort(batch.begin(), batch.end(), order);
+		batch.erase(std::unique(batch.begin(), batch.end(), equals), batch.end());
+
+		// Solo i valori non ancora presenti vengono inseriti e registrati
+		std::vector<char> present;
+		present.reserve(batch.size());
+		_tree.exists_batch(batch.begin(), batch.end(), std::back_inserter(present));
+		std::vector<T> fresh;
+		std::string records;
+		for(std::size_t i = 0; i < batch.size(); ++i)
+			if(!present[i]) {
+				fresh.push_back(batch[i]);
+				encode_record(insert_op, batch[i], records);
+			}
+		if(fresh.empty())
+			return total;
+
+		_pending.reserve(_pending.size() + records.size()); // l'aggiunta dei record non puo' fallire
+		try {
+			_tree.insert_batch(fresh.begin(), fresh.end());
+		}
+		catch(...) {
+			for(std::size_t i = 0; i < fresh.size(); ++i)
+				if(_tree.exists(fresh[i]))
+					_tree.erase(fresh[i]);
+			throw;
+		}
+		_pending.append(records);
+		if(_pending_ops == 0)
+			_pending_since = std::chrono::steady_clock::now();
+		_pending_ops += static_cast<size_type>(fresh.size());
+		maybe_commit();
+		return total - static_cast<size_type>(fresh.size());
+	}
+
+	/**
+		@brief Rimozione di un elemento dall'albero
+
+		Rimuove un elemento e registra la rimozione nel giornale.
+
+		@pre Il valore da rimuovere dev'essere presente all'interno dell'albero
+
+		@param value valore dell'elemento da rimuovere
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+		@throw bst_io_exception se la scrittura del giornale fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	void erase(const T &value) {
+		_tree.erase(value);
+
+		try {
+			append(erase_op, value);
+		}
+		catch(...) {
+			_tree.insert(value);
+			throw;
+		}
+		maybe_commit();
+	}
+
+	/**
+		@brief Sincronizzazione del giornale
+
+		Scrive nel giornale le operazioni in attesa con una sola
+		sincronizzazione su disco e, se il giornale ha superato
+		checkpoint_bytes, esegue un checkpoint.
+		Se la scrittura fallisce, il giornale viene riportato
+		all'ultima sincronizzazione riuscita e le operazioni restano
+		in attesa, per un nuovo tentativo; se non e' possibile,
+		le sincronizzazioni successive falliscono finche' un checkpoint
+		non riscrive il giornale.
+
+		@throw bst_io_exception se la scrittura del giornale fallisce
+	*/
+	void sync() {
+		if(_pending_ops == 0)
+			return;
+		if(_failed)
+			throw bst_io_exception("Giornale non utilizzabile dopo un errore di scrittura: ", _path + ".log");
+
+		try {
+			if(std::fwrite(_pending.data(), 1, _pending.size(), _log) != _pending.size())
+				throw bst_io_exception("Scrittura fallita: ", _path + ".log");
+			sync_file(_log, _path + ".log");
+		}
+		catch(...) {
+			discard_tail();
+			throw;
+		}
+
+		_log_bytes += _pending.size();
+		_pending.clear();
+		_pending_ops = 0;
+		_syncs++;
+
+		if(_options.checkpoint_bytes != 0 && _log_bytes >= _options.checkpoint_bytes)
+			checkpoint();
+	}
+
+	/**
+		@brief Checkpoint
+
+		Salva il contenuto dell'albero in un nuovo file di checkpoint,
+		che sostituisce il precedente solo quando e' completo,
+		e svuota il giornale. Il checkpoint ripristina anche un giornale
+		non utilizzabile dopo un errore di scrittura.
+
+		@throw bst_io_exception se i file non possono essere scritti
+		@throw eccezione di allocazione di memoria
+	*/
+	void checkpoint() {
+		if(_log != nullptr && !_failed)
+			sync();
+
+		std::vector<T> values;
+		values.reserve(_tree.size());
+		_tree.copy_in_order(std::back_inserter(values));
+
+		std::string data("BSTCKPT1");
+		unsigned long long count = values.size();
+		data.append(reinterpret_cast<const char *>(&count), 8);
+		for(size_type i = 0; i < values.size(); ++i) {
+			std::size_t start = data.size();
+			data.append(4, '\0');
+			_codec.encode(values[i], data);
+			unsigned int length = static_cast<unsigned int>(data.size() - start - 4);
+			std::memcpy(&data[start], &length, 4);
+		}
+		unsigned int sum = checksum(&data[8], data.size() - 8);
+		data.append(reinterpret_cast<const char *>(&sum), 4);
+
+		std::string path = _path + ".ckpt";
+		std::string tmp = path + ".tmp";
+		std::FILE *file = open_file(tmp, "wb");
+		bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+		try {
+			if(!written)
+				throw bst_io_exception("Scrittura fallita: ", tmp);
+			sync_file(file, tmp);
+		}
+		catch(...) {
+			std::fclose(file);
+			throw;
+		}
+		std::fclose(file);
+#ifdef _WIN32
+		std::remove(path.c_str());
+#endif
+		if(std::rename(tmp.c_str(), path.c_str()) != 0)
+			throw bst_io_exception("Rinomina fallita: ", tmp);
+		// La rinomina deve essere persistente prima di svuotare il giornale,
+		// altrimenti dopo un crash si perderebbero le operazioni registrate
+		sync_directory(path);
+
+		// Il checkpoint contiene tutte le operazioni: il giornale puo' essere svuotato
+		if(_log != nullptr)
+			std::fclose(_log);
+		_log = nullptr;
+		_log = open_file(_path + ".log", "wb");
+		sync_file(_log, _path + ".log");
+		_log_bytes = 0;
+		_pending.clear();
+		_pending_ops = 0;
+		_failed = false;
+	}
+
+	/**
+		@brief Albero
+
+		@return reference costante all'albero, per le ricerche e le visite
+	*/
+	const tree_type &tree() const {
+		return _tree;
+	}
+
+	/**
+		@brief Numero totale di dati nell'albero
+
+		@return numero totale di dati nell'albero
+	*/
+	size_type size() const {
+		return _tree.size();
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return _tree.exists(value);
+	}
+
+	/**
+		@brief Byte del giornale
+
+		@return numero di byte scritti nel giornale dall'ultimo checkpoint
+	*/
+	unsigned long long journal_bytes() const {
+		return _log_bytes;
+	}
+
+	/**
+		@brief Numero di sincronizzazioni
+
+		@return numero di sincronizzazioni del giornale su disco
+	*/
+	unsigned long long sync_count() const {
+		return _syncs;
+	}
+
+	/**
+		@brief Record rieseguiti
+
+		@return numero di record del giornale rieseguiti alla costruzione
+	*/
+	unsigned long long replayed_records() const {
+		return _replayed;
+	}
+
+}; // class journaled_bst
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstjournal.h
@@ -0,0 +1,596 @@
+/**
+	@file bstkd.h
+
+	@brief Dichiarazione e definizione della classe kd_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTKD_H
+#define BSTKD_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <iterator> // std::forward_iterator_tag
+#include <cstddef> // ptrdiff_t
+#include <vector> // std::vector
+#include <queue> // std::priority_queue
+#include <algorithm> // std::sort, std::nth_element, std::partition
+#include <utility> // std::pair, std::declval
+#include <stdexcept> // std::length_error
+#include "bstexceptions.h" // bst_duplicated_value_exception
+
+/**
+	@brief Albero k-dimensionale (k-d tree)
+
+	Classe che implementa un albero di ricerca di punti generici T
+	a D dimensioni. Ogni livello dell'albero divide lo spazio lungo un asse,
+	a rotazione: i punti con coordinata minore di quella del nodo sull'asse
+	del livello stanno nel sottoalbero sinistro, gli altri nel destro.
+	Le coordinate di un punto sono lette con il funtore A, chiamato
+	con il punto e l'indice dell'asse (da 0 a D - 1).
+	Come binary_search_tree, l'albero non ammette punti duplicati.
+
+	La costruzione in blocco (build) divide ricorsivamente i punti
+	sulla mediana dell'asse del livello e produce un albero bilanciato;
+	gli inserimenti successivi scendono nell'albero senza ribilanciarlo.
+	I nodi sono memorizzati in un vettore e collegati da indici:
+	dopo build i nodi sono disposti in pre-ordine.
+
+	Oltre alla ricerca di un punto, l'albero risponde alle ricerche
+	dei k punti piu' vicini (distanza euclidea) e dei punti contenuti
+	in un box allineato agli assi, visitando solo i sottoalberi
+	che possono contenere risultati.
+
+	@param T tipo dei punti
+	@param D numero di dimensioni
+	@param A funtore di accesso alle coordinate: A()(punto, asse)
+			 ritorna la coordinata del punto sull'asse (convertibile in double)
+	@param E funtore di confronto di uguaglianza (==) di due punti,
+			 coerente con le coordinate
+*/
+template <typename T, unsigned int D, typename A, typename E>
+class kd_tree {
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+	typedef unsigned int index_type; ///< tipo degli indici dei nodi
+	typedef decltype(std::declval<A>()(std::declval<const T &>(), 0u)) coordinate; ///< tipo delle coordinate
+
+	static const index_type null_index = static_cast<index_type>(-1); ///< indice di nessun nodo
+
+	/**
+		@brief Nodo dell'albero
+
+		Struttura di supporto interna che implementa un nodo dell'albero.
+	*/
+	struct node {
+		T value; ///< punto inserito nell'albero
+		index_type left; ///< indice del nodo figlio sinistro
+		index_type right; ///< indice del nodo figlio destro
+
+		/**
+			@brief Costruttore
+
+			Costruttore che inizializza un nodo foglia con il suo punto.
+
+			@param v punto
+		*/
+		explicit node(const T &v) : value(v), left(null_index), right(null_index) {} // initialization list
+	};
+
+	std::vector<node> _nodes; ///< nodi dell'albero (la radice e' il primo)
+	A _axis; ///< oggetto funtore di accesso alle coordinate
+	E _equals; ///< oggetto funtore per l'uguaglianza
+
+	/**
+		@brief Funtore di confronto sulle coordinate di tutti gli assi
+
+		Funtore che ordina i punti lessicograficamente per coordinate,
+		usato per trovare i duplicati durante la costruzione in blocco.
+	*/
+	struct compare_points {
+		A axis; ///< oggetto funtore di accesso alle coordinate
+
+		bool operator()(const T &p1, const T &p2) const {
+			for(unsigned int a = 0; a < D; ++a) {
+				if(axis(p1, a) < axis(p2, a))
+					return true;
+				if(axis(p2, a) < axis(p1, a))
+					return false;
+			}
+			return false;
+		}
+	};
+
+	/**
+		@brief Funtore di confronto su un asse
+
+		Funtore che ordina i punti per coordinata su un asse.
+	*/
+	struct compare_axis {
+		A axis; ///< oggetto funtore di accesso alle coordinate
+		unsigned int a; ///< asse del confronto
+
+		bool operator()(const T &p1, const T &p2) const {
+			return axis(p1, a) < axis(p2, a);
+		}
+	};
+
+	/**
+		@brief Funtore di partizione su un asse
+
+		Funtore che controlla se un punto ha coordinata minore
+		di un valore su un asse.
+	*/
+	struct below_axis {
+		A axis; ///< oggetto funtore di accesso alle coordinate
+		unsigned int a; ///< asse del confronto
+		coordinate split; ///< coordinata di separazione
+
+		bool operator()(const T &p) const {
+			return axis(p, a) < split;
+		}
+	};
+
+	/**
+		@brief Costruzione ricorsiva sulla mediana
+
+		Funzione privata helper che costruisce il sottoalbero dei punti
+		in [first, last) al livello depth: il punto mediano sull'asse
+		del livello diventa la radice, i punti con coordinata minore
+		formano il sottoalbero sinistro e gli altri il destro.
+		I nodi sono aggiunti in pre-ordine.
+
+		@param first iteratore al primo punto
+		@param last iteratore alla fine dei punti
+		@param depth profondita' della radice del sottoalbero
+
+		@return indice della radice del sottoalbero, null_index se vuoto
+	*/
+	index_type build_range(typename std::vector<T>::iterator first,
+						   typename std::vector<T>::iterator last, unsigned int depth) {
+		if(first == last)
+			return null_index;
+
+		unsigned int a = depth % D;
+		typename std::vector<T>::iterator median = first + (last - first) / 2;
+		compare_axis by_axis = {_axis, a};
+		std::nth_element(first, median, last, by_axis);
+
+		// I punti con la stessa coordinata della mediana devono stare a destra:
+		// la radice diventa il primo di essi
+		below_axis below = {_axis, a, _axis(*median, a)};
+		typename std::vector<T>::iterator root = std::partition(first, median, below);
+		std::swap(*root, *median);
+
+		index_type n = static_cast<index_type>(_nodes.size());
+		_nodes.push_back(node(*root));
+		index_type left = build_range(first, root, depth + 1);
+		index_type right = build_range(root + 1, last, depth + 1);
+		_nodes[n].left = left;
+		_nodes[n].right = right;
+		return n;
+	}
+
+	/**
+		@brief Distanza al quadrato tra due punti
+
+		@param p1 primo punto
+		@param p2 secondo punto
+
+		@return quadrato della distanza euclidea tra i due punti
+	*/
+	double distance2(const T &p1, const T &p2) const {
+		double sum = 0;
+		for(unsigned int a = 0; a < D; ++a) {
+			double d = static_cast<double>(_axis(p1, a)) - static_cast<double>(_axis(p2, a));
+			sum += d * d;
+		}
+		return sum;
+	}
+
+public:
+
+	/**
+		@brief Iteratore costante di tipo forward dell'albero
+
+		Iteratore a sola lettura (costante) di tipo forward che visita
+		tutti i punti dell'albero, nell'ordine in cui sono memorizzati
+		i nodi (pre-ordine dopo build, poi i punti inseriti).
+	*/
+	class const_iterator {
+		typename std::vector<node>::const_iterator _n; ///< iteratore al nodo
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun nodo.
+		*/
+		const_iterator() {}
+
+		// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+		// coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return dato riferito dall'iteratore costante
+		*/
+		reference operator*() const {
+			return _n->value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			@return puntatore al dato riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &(_n->value);
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			++_n;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++_n;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano allo stesso nodo,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (_n == other._n);
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano a nodi diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return (_n != other._n);
+		}
+
+	private:
+
+		// La classe container (kd_tree) dev'essere dichiarata friend
+		// dell'iteratore per concederle l'accesso al costruttore privato
+		// di inizializzazione nei metodi begin ed end.
+		friend class kd_tree;
+
+		/**
+			@brief Costruttore privato di inizializzazione
+
+			@param n iteratore al nodo
+		*/
+		explicit const_iterator(typename std::vector<node>::const_iterator n) : _n(n) {} // initialization list
+
+	}; // class const_iterator
+
+	// Il costruttore di default, il costruttore di copia,
+	// l'operatore di assegnamento e il distruttore coincidono
+	// con quelli di default
+
+	/**
+		@brief Costruzione in blocco dell'albero
+
+		Sostituisce il contenuto dell'albero con un albero bilanciato
+		dei punti di una sequenza, diviso ricorsivamente sulle mediane.
+		I punti duplicati vengono scartati (ne resta uno).
+
+		@param first iteratore forward al primo punto
+		@param last iteratore forward alla fine della sequenza
+
+		@return numero di punti scartati perche' duplicati
+
+		@throw std::length_error se la sequenza non e' rappresentabile
+			   con indici a 32 bit (l'albero non cambia)
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	size_type build(I first, I last) {
+		std::vector<T> points(first, last);
+		if(points.size() >= null_index)
+			throw std::length_error("kd_tree: indici a 32 bit esauriti");
+
+		compare_points lexicographic = {_axis};
+		std::sort(points.begin(), points.end(), lexicographic);
+		size_type unique = 0;
+		for(size_type i = 0; i < points.size(); ++i)
+			if(unique == 0 || !_equals(points[unique - 1], points[i]))
+				points[unique++] = points[i];
+		size_type rejected = static_cast<size_type>(points.size()) - unique;
+		points.erase(points.begin() + unique, points.end());
+
+		std::vector<node> nodes;
+		nodes.reserve(points.size());
+		_nodes.swap(nodes);
+		try {
+			build_range(points.begin(), points.end(), 0);
+		}
+		catch(...) {
+			_nodes.swap(nodes);
+			throw;
+		}
+
+		return rejected;
+	}
+
+	/**
+		@brief Inserimento di un punto nell'albero
+
+		Inserisce un punto scendendo nell'albero dalla radice,
+		senza ribilanciarlo.
+
+		@pre Il punto da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value punto da inserire
+
+		@throw bst_duplicated_value_exception se il punto da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw std::length_error se l'albero ha esaurito gli indici a 32 bit
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		index_type n = null_index;
+		index_type current = _nodes.empty() ? null_index : 0;
+		bool left = false;
+
+		for(unsigned int depth = 0; current != null_index; ++depth) {
+			const node &c = _nodes[current];
+			if(_equals(c.value, value))
+				throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+			unsigned int a = depth % D;
+			n = current;
+			left = _axis(value, a) < _axis(c.value, a);
+			current = left ? c.left : c.right;
+		}
+
+		if(_nodes.size() >= null_index)
+			throw std::length_error("kd_tree: indici a 32 bit esauriti");
+
+		_nodes.push_back(node(value));
+		if(n != null_index) {
+			if(left)
+				_nodes[n].left = static_cast<index_type>(_nodes.size() - 1);
+			else
+				_nodes[n].right = static_cast<index_type>(_nodes.size() - 1);
+		}
+	}
+
+	/**
+		@brief Numero totale di dati nell'albero
+
+		@return numero totale di punti nell'albero
+	*/
+	size_type size() const {
+		return static_cast<size_type>(_nodes.size());
+	}
+
+	/**
+		@brief Controllo di esistenza di un punto nell'albero
+
+		@param value punto da cercare
+
+		@return true se esiste il punto, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		index_type current = _nodes.empty() ? null_index : 0;
+		for(unsigned int depth = 0; current != null_index; ++depth) {
+			const node &c = _nodes[current];
+			if(_equals(c.value, value))
+				return true;
+			unsigned int a = depth % D;
+			current = (_axis(value, a) < _axis(c.value, a)) ? c.left : c.right;
+		}
+		return false;
+	}
+
+	/**
+		@brief Ricerca dei k punti piu' vicini
+
+		Copia in una sequenza di output i k punti dell'albero piu' vicini
+		a un punto (che non deve necessariamente essere nell'albero),
+		in ordine di distanza crescente. Un sottoalbero viene visitato
+		solo se il piano di separazione e' piu' vicino del k-esimo
+		punto trovato fino a quel momento.
+
+		@param point punto di riferimento
+		@param k numero di punti da cercare
+		@param out iteratore di output a cui aggiungere i punti
+
+		@return iteratore di output dopo l'ultimo punto copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI nearest(const T &point, size_type k, OI out) const {
+		if(k == 0 || _nodes.empty())
+			return out;
+
+		// Massimo in cima: il peggiore dei k candidati
+		std::priority_queue<std::pair<double, index_type> > best;
+
+		// Nodi da visitare con profondita' e limite inferiore della distanza
+		struct pending_node {
+			index_type n;
+			unsigned int depth;
+			double bound;
+		};
+		std::vector<pending_node> pending;
+		pending_node root = {0, 0, 0.0};
+		pending.push_back(root);
+
+		while(!pending.empty()) {
+			pending_node p = pending.back();
+			pending.pop_back();
+			if(best.size() == k && p.bound >= best.top().first)
+				continue;
+
+			const node &c = _nodes[p.n];
+			double d = distance2(point, c.value);
+			if(best.size() < k)
+				best.push(std::make_pair(d, p.n));
+			else
+				if(d < best.top().first) {
+					best.pop();
+					best.push(std::make_pair(d, p.n));
+				}
+
+			unsigned int a = p.depth % D;
+			double diff = static_cast<double>(_axis(point, a)) - static_cast<double>(_axis(c.value, a));
+			index_type near = (diff < 0) ? c.left : c.right;
+			index_type far = (diff < 0) ? c.right : c.left;
+			// Il lato lontano e' in cima allo stack dopo il vicino
+			if(far != null_index) {
+				pending_node f = {far, p.depth + 1, (p.bound > diff * diff) ? p.bound : diff * diff};
+				pending.push_back(f);
+			}
+			if(near != null_index) {
+				pending_node n = {near, p.depth + 1, p.bound};
+				pending.push_back(n);
+			}
+		}
+
+		std::vector<index_type> result(best.size());
+		for(size_type i = static_cast<size_type>(best.size()); i > 0; --i) {
+			result[i - 1] = best.top().second;
+			best.pop();
+		}
+		for(size_type i = 0; i < result.size(); ++i)
+			*out++ = _nodes[result[i]].value;
+
+		return out;
+	}
+
+	/**
+		@brief Ricerca dei punti in un box
+
+		Copia in una sequenza di output i punti p dell'albero contenuti
+		nel box chiuso allineato agli assi con vertici low e high,
+		cioe' tali che low <= p <= high su ogni asse.
+
+		@param low vertice del box con le coordinate minime
+		@param high vertice del box con le coordinate massime
+		@param out iteratore di output a cui aggiungere i punti
+
+		@return iteratore di output dopo l'ultimo punto copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI range(const T &low, const T &high, OI out) const {
+		if(_nodes.empty())
+			return out;
+
+		std::vector<std::pair<index_type, unsigned int> > pending;
+		pending.push_back(std::make_pair(0u, 0u));
+
+		while(!pending.empty()) {
+			std::pair<index_type, unsigned int> p = pending.back();
+			pending.pop_back();
+			const node &c = _nodes[p.first];
+
+			bool inside = true;
+			for(unsigned int a = 0; a < D && inside; ++a)
+				inside = !(_axis(c.value, a) < _axis(low, a)) && !(_axis(high, a) < _axis(c.value, a));
+			if(inside)
+				*out++ = c.value;
+
+			unsigned int a = p.second % D;
+			if(c.left != null_index && _axis(low, a) < _axis(c.value, a))
+				pending.push_back(std::make_pair(c.left, p.second + 1));
+			if(c.right != null_index && !(_axis(high, a) < _axis(c.value, a)))
+				pending.push_back(std::make_pair(c.right, p.second + 1));
+		}
+
+		return out;
+	}
+
+	/**
+		@brief Iteratore che punta all'inizio dell'albero
+
+		@return iteratore che punta al primo punto
+	*/
+	const_iterator begin() const {
+		return const_iterator(_nodes.begin());
+	}
+
+	/**
+		@brief Iteratore che punta alla fine dell'albero
+
+		@return iteratore che punta alla fine dell'albero
+	*/
+	const_iterator end() const {
+		return const_iterator(_nodes.end());
+	}
+
+}; // class kd_tree
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa del contenuto
+	dell'albero.
+
+	@param os oggetto stream di output
+	@param tree albero da stampare
+
+	@return reference allo stream di output
+*/
+template <typename T, unsigned int D, typename A, typename E>
+std::ostream &operator<<(std::ostream &os, const kd_tree<T, D, A, E> &tree) {
+	typename kd_tree<T, D, A, E>::const_iterator i, ie;
+
+	os << "[";
+	for(i = tree.begin(), ie = tree.end(); i != ie; ++i) {
+		if(i != tree.begin())
+			os << ", ";
+		os << *i;
+	}
+	os << "]";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstkd.h
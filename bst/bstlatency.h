@@ -0,0 +1,683 @@
+/**
+	@file bstlatency.h
+
+	@brief Dichiarazione e definizione delle classi per la misura
+	delle latenze delle operazioni su un bst
+*/
+
+// Guardie del file header
+
+#ifndef BSTLATENCY_H
+#define BSTLATENCY_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <chrono> // std::chrono::steady_clock
+#include <cstddef> // std::size_t
+#include "bst.h" // binary_search_tree
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h> // __rdtsc
+#define BST_LATENCY_RDTSC
+#endif
+
+/**
+	@brief Contatore di cicli
+
+	Funzioni di lettura del contatore di cicli del processore (rdtsc),
+	o di std::chrono::steady_clock in nanosecondi dove non e' disponibile.
+*/
+struct bst_cycle_clock {
+
+	/**
+		@brief Lettura del contatore
+
+		@return valore corrente del contatore (tick)
+	*/
+	static unsigned long long now() {
+#ifdef BST_LATENCY_RDTSC
+		return __rdtsc();
+#else
+		return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	/**
+		@brief Frequenza del contatore
+
+		Tick per nanosecondo, misurati una sola volta confrontando
+		il contatore con std::chrono::steady_clock per 10 ms.
+
+		@return tick per nanosecondo
+	*/
+	static double ticks_per_ns() {
+		static const double ratio = calibrate();
+		return ratio;
+	}
+
+private:
+
+	/**
+		@brief Calibrazione del contatore
+
+		@return tick per nanosecondo
+	*/
+	static double calibrate() {
+#ifdef BST_LATENCY_RDTSC
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		unsigned long long ticks = now();
+		std::chrono::steady_clock::duration elapsed;
+		do
+			elapsed = std::chrono::steady_clock::now() - start;
+		while(elapsed < std::chrono::milliseconds(10));
+		return static_cast<double>(now() - ticks) / std::chrono::duration<double, std::nano>(elapsed).count();
+#else
+		return 1.0;
+#endif
+	}
+};
+
+/**
+	@brief Istogramma di latenze
+
+	Classe che conta le latenze in intervalli di ampiezza logaritmica:
+	valori fino a 15 tick hanno un intervallo ciascuno, ogni potenza
+	di 2 successiva e' divisa in 8 intervalli, quindi un percentile
+	ha un errore relativo di al piu' 12.5%. La registrazione costa
+	un calcolo del bit piu' significativo e un incremento; istogrammi
+	registrati da thread diversi si uniscono con merge.
+*/
+class bst_latency_histogram {
+
+	static const unsigned int linear_buckets = 16; ///< intervalli di ampiezza 1
+	static const unsigned int sub_buckets = 8; ///< intervalli per potenza di 2
+	static const unsigned int bucket_count = linear_buckets + (64 - 4) * sub_buckets; ///< numero di intervalli
+
+	unsigned long long _counts[bucket_count]; ///< conteggi degli intervalli
+	unsigned long long _total; ///< numero di latenze registrate
+	unsigned long long _max; ///< latenza massima registrata
+
+	/**
+		@brief Posizione del bit piu' significativo
+
+		@param value valore non nullo
+
+		@return posizione del bit piu' significativo
+	*/
+	static unsigned int msb(unsigned long long value) {
+#ifdef __GNUC__
+		return 63 - __builtin_clzll(value);
+#else
+		unsigned int bit = 0;
+		while(value >>= 1)
+			++bit;
+		return bit;
+#endif
+	}
+
+	/**
+		@brief Intervallo di una latenza
+
+		@param ticks latenza
+
+		@return indice dell'intervallo
+	*/
+	static unsigned int bucket(unsigned long long ticks) {
+		if(ticks < linear_buckets)
+			return static_cast<unsigned int>(ticks);
+		unsigned int bit = msb(ticks);
+		return linear_buckets + (bit - 4) * sub_buckets + static_cast<unsigned int>((ticks >> (bit - 3)) & 7);
+	}
+
+	/**
+		@brief Estremo superiore di un intervallo
+
+		@param index indice dell'intervallo
+
+		@return latenza massima dell'intervallo
+	*/
+	static unsigned long long upper_bound(unsigned int index) {
+		if(index < linear_buckets)
+			return index;
+		unsigned int bit = (index - linear_buckets) / sub_buckets + 4;
+		unsigned long long low = static_cast<unsigned long long>(sub_buckets + (index - linear_buckets) % sub_buckets) << (bit - 3);
+		return low + (1ULL << (bit - 3)) - 1;
+	}
+
+public:
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore che crea un istogramma vuoto.
+	*/
+	bst_latency_histogram() : _total(0), _max(0) { // initialization list
+		clear();
+	}
+
+	// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+	// coincidono con quelli di default
+
+	/**
+		@brief Registrazione di una latenza
+
+		@param ticks latenza in tick del contatore
+	*/
+	void record(unsigned long long ticks) {
+		_counts[bucket(ticks)]++;
+		_total++;
+		if(ticks > _max)
+			_max = ticks;
+	}
+
+	/**
+		@brief Unione di due istogrammi
+
+		Aggiunge a this le latenze registrate in un altro istogramma.
+
+		@param other istogramma da aggiungere
+	*/
+	void merge(const bst_latency_histogram &other) {
+		for(unsigned int i = 0; i < bucket_count; ++i)
+			_counts[i] += other._counts[i];
+		_total += other._total;
+		if(other._max > _max)
+			_max = other._max;
+	}
+
+	/**
+		@brief Azzeramento dell'istogramma
+	*/
+	void clear() {
+		for(unsigned int i = 0; i < bucket_count; ++i)
+			_counts[i] = 0;
+		_total = 0;
+		_max = 0;
+	}
+
+	/**
+		@brief Numero di latenze registrate
+
+		@return numero di latenze registrate
+	*/
+	unsigned long long count() const {
+		return _total;
+	}
+
+	/**
+		@brief Latenza massima
+
+		@return latenza massima registrata in tick
+	*/
+	unsigned long long max() const {
+		return _max;
+	}
+
+	/**
+		@brief Percentile
+
+		@param p percentile (tra 0 e 100)
+
+		@return latenza in tick non superata dal p% delle latenze
+				registrate (estremo superiore dell'intervallo,
+				al piu' il massimo), 0 se l'istogramma e' vuoto
+	*/
+	unsigned long long percentile(double p) const {
+		if(_total == 0)
+			return 0;
+
+		double rank = p / 100 * _total;
+		unsigned long long cumulative = 0;
+		for(unsigned int i = 0; i < bucket_count; ++i) {
+			cumulative += _counts[i];
+			if(cumulative > 0 && cumulative >= rank) {
+				unsigned long long bound = upper_bound(i);
+				return (bound < _max) ? bound : _max;
+			}
+		}
+		return _max;
+	}
+
+}; // class bst_latency_histogram
+
+/**
+	@brief Operazioni misurate
+
+	Operazioni di un albero di cui viene misurata la latenza.
+*/
+enum bst_operation {
+	bst_op_insert, ///< inserimento
+	bst_op_exists, ///< ricerca
+	bst_op_erase, ///< rimozione
+	bst_op_subtree, ///< copia di un sottoalbero
+	bst_op_iteration, ///< visita completa con l'iteratore
+	bst_op_copy_in_order, ///< copia ordinata dei valori
+	bst_op_copy, ///< copia dell'albero (costruttore di copia e assegnamento)
+	bst_op_count ///< numero di operazioni
+};
+
+/**
+	@brief Registro delle latenze
+
+	Classe che raccoglie un istogramma di latenze per ogni operazione
+	ed esporta i percentili p50, p99, p99.9 e il massimo in nanosecondi,
+	in formato testo o JSON.
+*/
+class bst_latency_recorder {
+
+	bst_latency_histogram _histograms[bst_op_count]; ///< istogrammi delle operazioni
+
+	/**
+		@brief Nome di un'operazione
+
+		@param op operazione
+
+		@return nome dell'operazione
+	*/
+	static const char *name(unsigned int op) {
+		static const char *const names[bst_op_count] = {"insert", "exists", "erase", "subtree", "iteration",
+			"copy_in_order", "copy"};
+		return names[op];
+	}
+
+public:
+
+	// Il costruttore di default, il costruttore di copia,
+	// l'operatore di assegnamento e il distruttore coincidono
+	// con quelli di default
+
+	/**
+		@brief Registrazione di una latenza
+
+		@param op operazione
+		@param ticks latenza in tick del contatore
+	*/
+	void record(bst_operation op, unsigned long long ticks) {
+		_histograms[op].record(ticks);
+	}
+
+	/**
+		@brief Istogramma di un'operazione
+
+		@param op operazione
+
+		@return reference costante all'istogramma dell'operazione
+	*/
+	const bst_latency_histogram &histogram(bst_operation op) const {
+		return _histograms[op];
+	}
+
+	/**
+		@brief Unione di due registri
+
+		Aggiunge a this le latenze di un altro registro,
+		ad esempio quello di un altro thread.
+
+		@param other registro da aggiungere
+	*/
+	void merge(const bst_latency_recorder &other) {
+		for(unsigned int op = 0; op < bst_op_count; ++op)
+			_histograms[op].merge(other._histograms[op]);
+	}
+
+	/**
+		@brief Azzeramento del registro
+	*/
+	void clear() {
+		for(unsigned int op = 0; op < bst_op_count; ++op)
+			_histograms[op].clear();
+	}
+
+	/**
+		@brief Esportazione in formato testo
+
+		Scrive una riga per ogni operazione registrata almeno una volta,
+		con numero di operazioni e percentili in nanosecondi.
+
+		@param os oggetto stream di output
+
+		@return reference allo stream di output
+	*/
+	std::ostream &write_text(std::ostream &os) const {
+		double ratio = bst_cycle_clock::ticks_per_ns();
+		for(unsigned int op = 0; op < bst_op_count; ++op) {
+			const bst_latency_histogram &h = _histograms[op];
+			if(h.count() == 0)
+				continue;
+			os << name(op) << ": n=" << h.count()
+			   << " p50=" << h.percentile(50) / ratio << "ns"
+			   << " p99=" << h.percentile(99) / ratio << "ns"
+			   << " p99.9=" << h.percentile(99.9) / ratio << "ns"
+			   << " max=" << h.max() / ratio << "ns" << std::endl;
+		}
+		return os;
+	}
+
+	/**
+		@brief Esportazione in formato JSON
+
+		Scrive un oggetto JSON con un campo per ogni operazione
+		registrata almeno una volta, con numero di operazioni
+		e percentili in nanosecondi.
+
+		@param os oggetto stream di output
+
+		@return reference allo stream di output
+	*/
+	std::ostream &write_json(std::ostream &os) const {
+		double ratio = bst_cycle_clock::ticks_per_ns();
+		bool first = true;
+		os << "{";
+		for(unsigned int op = 0; op < bst_op_count; ++op) {
+			const bst_latency_histogram &h = _histograms[op];
+			if(h.count() == 0)
+				continue;
+			os << (first ? "" : ", ") << "\"" << name(op) << "\": {\"count\": " << h.count()
+			   << ", \"p50_ns\": " << h.percentile(50) / ratio
+			   << ", \"p99_ns\": " << h.percentile(99) / ratio
+			   << ", \"p999_ns\": " << h.percentile(99.9) / ratio
+			   << ", \"max_ns\": " << h.max() / ratio << "}";
+			first = false;
+		}
+		os << "}";
+		return os;
+	}
+
+}; // class bst_latency_recorder
+
+/**
+	@brief Albero binario di ricerca con misura delle latenze
+
+	Classe che aggiunge a un binary_search_tree la misura della latenza
+	di insert, exists, erase, subtree, copy_in_order, delle visite
+	complete con for_each e delle copie dell'albero (costruttore
+	di copia e assegnamento), registrata in un bst_latency_recorder.
+	Le altre operazioni non sono misurate.
+
+	La misura e' opzionale: si usa questa classe al posto
+	di binary_search_tree solo dove servono le latenze.
+
+	Gli istogrammi non sono sincronizzati: anche le operazioni costanti
+	(exists, subtree, copy_in_order, for_each) scrivono nel registro
+	dell'albero, quindi non possono essere eseguite in parallelo.
+	Per leggere un albero condiviso da piu' thread, ogni thread passa
+	alle operazioni costanti un proprio registro, e alla fine i registri
+	vengono uniti con merge.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, typename O, typename E>
+class timed_binary_search_tree : public binary_search_tree<T, O, E> {
+
+	typedef binary_search_tree<T, O, E> base; ///< tipo dell'albero di base
+
+	mutable bst_latency_recorder _latency; ///< latenze delle operazioni
+
+public:
+
+	// Il costruttore di default e il distruttore coincidono
+	// con quelli di default
+
+	timed_binary_search_tree() {}
+
+	/**
+		@brief Costruttore di copia/Copy Constructor
+
+		Copia l'albero e il registro delle latenze di other,
+		registrando nella copia la latenza della copia dei valori.
+
+		@param other albero da copiare
+
+		@throw eccezione di allocazione di memoria
+	*/
+	timed_binary_search_tree(const timed_binary_search_tree &other) : base(), _latency(other._latency) { // initialization list
+		unsigned long long start = bst_cycle_clock::now();
+		base tmp(other);
+		base::swap(tmp);
+		_latency.record(bst_op_copy, bst_cycle_clock::now() - start);
+	}
+
+	/**
+		@brief Operatore di assegnamento
+
+		Copia l'albero e il registro delle latenze di other,
+		registrando la latenza della copia dei valori.
+
+		@param other albero da copiare
+
+		@return reference all'albero this
+
+		@throw eccezione di allocazione di memoria
+	*/
+	timed_binary_search_tree &operator=(const timed_binary_search_tree &other) {
+		if(this != &other) {
+			unsigned long long start = bst_cycle_clock::now();
+			base::operator=(other);
+			_latency = other._latency;
+			_latency.record(bst_op_copy, bst_cycle_clock::now() - start);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Come binary_search_tree::insert, misurandone la latenza
+		(anche se lancia un'eccezione).
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		unsigned long long start = bst_cycle_clock::now();
+		try {
+			base::insert(value);
+		}
+		catch(...) {
+			_latency.record(bst_op_insert, bst_cycle_clock::now() - start);
+			throw;
+		}
+		_latency.record(bst_op_insert, bst_cycle_clock::now() - start);
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Come binary_search_tree::exists, misurandone la latenza.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return exists(value, _latency);
+	}
+
+	/**
+		@brief Controllo di esistenza con un registro esterno
+
+		Come exists, registrando la latenza in un registro del chiamante:
+		chiamate in parallelo con registri diversi sono sicure.
+
+		@param value valore da cercare
+		@param latency registro in cui registrare la latenza
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value, bst_latency_recorder &latency) const {
+		unsigned long long start = bst_cycle_clock::now();
+		bool found = base::exists(value);
+		latency.record(bst_op_exists, bst_cycle_clock::now() - start);
+		return found;
+	}
+
+	/**
+		@brief Rimozione di un elemento dall'albero
+
+		Come binary_search_tree::erase, misurandone la latenza
+		(anche se lancia un'eccezione).
+
+		@param value valore dell'elemento da rimuovere
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+	*/
+	void erase(const T &value) {
+		unsigned long long start = bst_cycle_clock::now();
+		try {
+			base::erase(value);
+		}
+		catch(...) {
+			_latency.record(bst_op_erase, bst_cycle_clock::now() - start);
+			throw;
+		}
+		_latency.record(bst_op_erase, bst_cycle_clock::now() - start);
+	}
+
+	/**
+		@brief Sottoalbero
+
+		Come binary_search_tree::subtree, misurandone la latenza
+		(anche se lancia un'eccezione).
+
+		@param d valore della radice del sottoalbero
+
+		@return copia del sottoalbero
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	base subtree(const T &d) const {
+		return subtree(d, _latency);
+	}
+
+	/**
+		@brief Sottoalbero con un registro esterno
+
+		Come subtree, registrando la latenza in un registro del chiamante.
+
+		@param d valore della radice del sottoalbero
+		@param latency registro in cui registrare la latenza
+
+		@return copia del sottoalbero
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	base subtree(const T &d, bst_latency_recorder &latency) const {
+		unsigned long long start = bst_cycle_clock::now();
+		try {
+			base result = base::subtree(d);
+			latency.record(bst_op_subtree, bst_cycle_clock::now() - start);
+			return result;
+		}
+		catch(...) {
+			latency.record(bst_op_subtree, bst_cycle_clock::now() - start);
+			throw;
+		}
+	}
+
+	/**
+		@brief Copia ordinata dei valori dell'albero
+
+		Come binary_search_tree::copy_in_order, misurandone la latenza.
+
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		return copy_in_order(out, _latency);
+	}
+
+	/**
+		@brief Copia ordinata con un registro esterno
+
+		Come copy_in_order, registrando la latenza in un registro
+		del chiamante.
+
+		@param out iteratore di output a cui aggiungere i valori
+		@param latency registro in cui registrare la latenza
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out, bst_latency_recorder &latency) const {
+		unsigned long long start = bst_cycle_clock::now();
+		out = base::copy_in_order(out);
+		latency.record(bst_op_copy_in_order, bst_cycle_clock::now() - start);
+		return out;
+	}
+
+	/**
+		@brief Visita completa dell'albero
+
+		Applica un funtore a tutti i valori dell'albero nell'ordine
+		dell'iteratore, misurando la latenza della visita completa.
+
+		@param f funtore da applicare a ogni valore
+
+		@return funtore dopo la visita
+	*/
+	template <typename F>
+	F for_each(F f) const {
+		return for_each(f, _latency);
+	}
+
+	/**
+		@brief Visita completa con un registro esterno
+
+		Come for_each, registrando la latenza in un registro del chiamante.
+
+		@param f funtore da applicare a ogni valore
+		@param latency registro in cui registrare la latenza
+
+		@return funtore dopo la visita
+	*/
+	template <typename F>
+	F for_each(F f, bst_latency_recorder &latency) const {
+		unsigned long long start = bst_cycle_clock::now();
+		typename base::const_iterator i, ie;
+		for(i = this->begin(), ie = this->end(); i != ie; ++i)
+			f(*i);
+		latency.record(bst_op_iteration, bst_cycle_clock::now() - start);
+		return f;
+	}
+
+	/**
+		@brief Latenze registrate
+
+		@return reference costante al registro delle latenze
+	*/
+	const bst_latency_recorder &latency() const {
+		return _latency;
+	}
+
+	/**
+		@brief Azzeramento delle latenze registrate
+	*/
+	void clear_latency() {
+		_latency.clear();
+	}
+
+}; // class timed_binary_search_tree
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstlatency.h
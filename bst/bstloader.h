@@ -0,0 +1,512 @@
+/**
+	@file bstloader.h
+
+	@brief Dichiarazione e definizione della funzione bst_load
+	e dei suoi lettori di formato
+*/
+
+// Guardie del file header
+
+#ifndef BSTLOADER_H
+#define BSTLOADER_H
+
+// Direttive per il pre-compilatore
+
+#include <cstdio> // std::FILE, std::fopen, std::fread, std::ferror, std::fclose
+#include <cstring> // std::memcpy, std::memchr
+#include <cstddef> // std::size_t
+#include <string> // std::string
+#include <vector> // std::vector
+#include <memory> // std::unique_ptr
+#include <thread> // std::thread
+#include <exception> // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <stdexcept> // std::invalid_argument
+#include <algorithm> // std::sort, std::unique, std::merge, std::max
+#include <iterator> // std::make_move_iterator, std::back_inserter
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::is_integral, std::is_signed, std::aligned_storage
+#include "bst.h" // binary_search_tree
+#include "bstexceptions.h" // bst_io_exception
+
+/**
+	@brief Lettore di interi in formato testo
+
+	Funtore che legge interi decimali separati da spazi, tabulazioni
+	o fine riga, con segno opzionale. Non dipende dalla localizzazione
+	e controlla che i valori siano rappresentabili nel tipo T.
+
+	@param T tipo intero dei dati
+*/
+template <typename T>
+struct bst_int_parser {
+
+	/**
+		@brief Separatore
+
+		@param c carattere da controllare
+
+		@return true se il carattere separa due interi
+	*/
+	static bool separator(char c) {
+		return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+	}
+
+	/**
+		@brief Byte di interi completi
+
+		@param data byte letti
+		@param size numero di byte letti
+
+		@return numero di byte iniziali che contengono solo interi completi
+	*/
+	std::size_t complete(const char *data, std::size_t size) const {
+		while(size > 0 && !separator(data[size - 1]))
+			size--;
+		return size;
+	}
+
+	/**
+		@brief Inizio di un intero
+
+		@param data byte da dividere
+		@param size numero di byte
+		@param cut posizione di taglio proposta
+
+		@return prima posizione non precedente a cut in cui inizia un intero
+				(o size)
+	*/
+	std::size_t align(const char *data, std::size_t size, std::size_t cut) const {
+		while(cut > 0 && cut < size && !separator(data[cut - 1]))
+			cut++;
+		return cut;
+	}
+
+	/**
+		@brief Lettura degli interi
+
+		@param begin puntatore al primo byte
+		@param end puntatore alla fine dei byte
+		@param out vettore a cui aggiungere gli interi letti
+
+		@throw std::invalid_argument se un intero non e' valido
+		@throw eccezione di allocazione di memoria
+	*/
+	void parse(const char *begin, const char *end, std::vector<T> &out) const {
+		static_assert(std::is_integral<T>::value, "bst_int_parser: T dev'essere un tipo intero");
+		typedef unsigned long long magnitude;
+
+		const char *p = begin;
+		for(;;) {
+			while(p != end && separator(*p))
+				++p;
+			if(p == end)
+				return;
+
+			bool negative = (*p == '-');
+			if(*p == '-' || *p == '+')
+				++p;
+			if(negative && !std::is_signed<T>::value)
+				throw std::invalid_argument("bst_int_parser: valore negativo");
+			if(p == end || *p < '0' || *p > '9')
+				throw std::invalid_argument("bst_int_parser: carattere non valido");
+
+			magnitude limit = static_cast<magnitude>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+			magnitude value = 0;
+			for(; p != end && *p >= '0' && *p <= '9'; ++p) {
+				unsigned int digit = static_cast<unsigned int>(*p - '0');
+				if(value > (limit - digit) / 10)
+					throw std::invalid_argument("bst_int_parser: valore fuori intervallo");
+				value = value * 10 + digit;
+			}
+			if(p != end && !separator(*p))
+				throw std::invalid_argument("bst_int_parser: carattere non valido");
+
+			out.push_back(negative ? static_cast<T>(~value + 1) : static_cast<T>(value));
+		}
+	}
+};
+
+/**
+	@brief Lettore di stringhe in formato testo
+
+	Funtore che legge una stringa per ogni riga, senza il fine riga
+	("\n" o "\r\n"). Le righe vuote vengono ignorate.
+*/
+struct bst_line_parser {
+
+	/**
+		@brief Byte di righe complete
+
+		@param data byte letti
+		@param size numero di byte letti
+
+		@return numero di byte iniziali che contengono solo righe complete
+	*/
+	std::size_t complete(const char *data, std::size_t size) const {
+		while(size > 0 && data[size - 1] != '\n')
+			size--;
+		return size;
+	}
+
+	/**
+		@brief Inizio di una riga
+
+		@param data byte da dividere
+		@param size numero di byte
+		@param cut posizione di taglio proposta
+
+		@return prima posizione non precedente a cut in cui inizia una riga
+				(o size)
+	*/
+	std::size_t align(const char *data, std::size_t size, std::size_t cut) const {
+		while(cut > 0 && cut < size && data[cut - 1] != '\n')
+			cut++;
+		return cut;
+	}
+
+	/**
+		@brief Lettura delle righe
+
+		@param begin puntatore al primo byte
+		@param end puntatore alla fine dei byte
+		@param out vettore a cui aggiungere le righe lette
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void parse(const char *begin, const char *end, std::vector<std::string> &out) const {
+		while(begin != end) {
+			const char *line_end = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+			const char *next = (line_end == nullptr) ? end : line_end + 1;
+			if(line_end == nullptr)
+				line_end = end;
+			if(line_end != begin && line_end[-1] == '\r')
+				line_end--;
+			if(line_end != begin)
+				out.push_back(std::string(begin, line_end));
+			begin = next;
+		}
+	}
+};
+
+/**
+	@brief Lettore di record binari
+
+	Funtore che legge record di sizeof(T) byte copiandone i byte,
+	per tipi senza puntatori scritti sulla stessa piattaforma
+	(come bst_pod_codec).
+
+	@param T tipo dei dati
+*/
+template <typename T>
+struct bst_record_parser {
+
+	/**
+		@brief Byte di record completi
+
+		@param data byte letti
+		@param size numero di byte letti
+
+		@return numero di byte iniziali che contengono solo record completi
+	*/
+	std::size_t complete(const char *, std::size_t size) const {
+		return size - size % sizeof(T);
+	}
+
+	/**
+		@brief Inizio di un record
+
+		@param data byte da dividere (che iniziano con un record)
+		@param size numero di byte
+		@param cut posizione di taglio proposta
+
+		@return posizione del record che contiene cut
+	*/
+	std::size_t align(const char *, std::size_t, std::size_t cut) const {
+		return cut - cut % sizeof(T);
+	}
+
+	/**
+		@brief Lettura dei record
+
+		@param begin puntatore al primo byte
+		@param end puntatore alla fine dei byte
+		@param out vettore a cui aggiungere i record letti
+
+		@throw std::invalid_argument se l'ultimo record e' incompleto
+		@throw eccezione di allocazione di memoria
+	*/
+	void parse(const char *begin, const char *end, std::vector<T> &out) const {
+		if((end - begin) % sizeof(T) != 0)
+			throw std::invalid_argument("bst_record_parser: record incompleto");
+
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		out.reserve(out.size() + (end - begin) / sizeof(T));
+		for(; begin != end; begin += sizeof(T)) {
+			std::memcpy(&storage, begin, sizeof(T));
+			out.push_back(*reinterpret_cast<const T *>(&storage));
+		}
+	}
+};
+
+/**
+	@brief Opzioni di caricamento
+
+	Struttura che raccoglie i parametri di bst_load.
+*/
+struct bst_load_options {
+	unsigned int threads; ///< thread di lettura e ordinamento (0 = uno per core)
+	std::size_t chunk_bytes; ///< byte letti dal file a ogni passo
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore che imposta un thread per core e blocchi da 64 MB.
+	*/
+	bst_load_options() : threads(0), chunk_bytes(64 << 20) {} // initialization list
+};
+
+/**
+	@brief Esecuzione parallela
+
+	Funzione helper che esegue job(i) per i da 0 a count - 1,
+	ognuno in un thread (l'ultimo nel thread chiamante), e attende
+	la loro fine. La prima eccezione lanciata viene rilanciata.
+
+	@param count numero di esecuzioni
+	@param job funtore da eseguire
+
+	@throw eccezione lanciata da job
+	@throw std::system_error se un thread non puo' essere creato
+*/
+template <typename J>
+void bst_parallel_for(unsigned int count, const J &job) {
+	std::vector<std::exception_ptr> errors(count);
+	std::vector<std::thread> workers;
+	workers.reserve(count);
+
+	auto guarded = [&job, &errors](unsigned int i) {
+		try {
+			job(i);
+		}
+		catch(...) {
+			errors[i] = std::current_exception();
+		}
+	};
+
+	try {
+		for(unsigned int i = 0; i + 1 < count; ++i)
+			workers.push_back(std::thread(guarded, i));
+	}
+	catch(...) {
+		for(unsigned int i = 0; i < workers.size(); ++i)
+			workers[i].join();
+		throw;
+	}
+	if(count > 0)
+		guarded(count - 1);
+	for(unsigned int i = 0; i < workers.size(); ++i)
+		workers[i].join();
+
+	for(unsigned int i = 0; i < count; ++i)
+		if(errors[i])
+			std::rethrow_exception(errors[i]);
+}
+
+/**
+	@brief Tipi di un albero
+
+	Struttura che riporta il tipo dei dati e i funtori
+	di un binary_search_tree.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, typename O, typename E>
+struct bst_tree_types {
+	typedef T value_type; ///< tipo dei dati
+	typedef O order_type; ///< funtore di ordinamento
+	typedef E equals_type; ///< funtore di uguaglianza
+};
+
+/**
+	@brief Tipi di un albero derivato da binary_search_tree
+
+	Funzione solo dichiarata, da usare con decltype: deduce i tipi
+	dalla base binary_search_tree di un albero derivato.
+
+	@param tree albero
+
+	@return tipi dell'albero
+*/
+template <typename T, typename O, typename E>
+bst_tree_types<T, O, E> bst_tree_types_of(const binary_search_tree<T, O, E> &tree);
+
+/**
+	@brief Caricamento di un albero da un file (implementazione)
+
+	Funzione helper di bst_load, con il tipo dei dati e i funtori
+	indicati esplicitamente; l'albero ha il suo tipo effettivo,
+	per chiamarne assign_sorted.
+
+	@param path percorso del file
+	@param tree albero da riempire
+	@param parser lettore del formato del file
+	@param options opzioni di caricamento
+
+	@return numero di valori letti, compresi i duplicati
+*/
+template <typename T, typename O, typename E, typename Tree, typename P>
+std::size_t bst_load_into(const std::string &path, Tree &tree, const P &parser, const bst_load_options &options) {
+	unsigned int threads = options.threads;
+	if(threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	std::size_t chunk = std::max<std::size_t>(options.chunk_bytes, 1);
+
+	std::unique_ptr<std::FILE, int (*)(std::FILE *)> file(std::fopen(path.c_str(), "rb"), &std::fclose);
+	if(!file)
+		throw bst_io_exception("Apertura fallita: ", path);
+
+	std::vector<std::vector<T> > parts(threads);
+	std::vector<char> current(chunk);
+	std::vector<char> next(chunk);
+	std::size_t filled = std::fread(current.data(), 1, current.size(), file.get());
+	bool eof = (filled < current.size());
+
+	try {
+		for(;;) {
+			if(eof && std::ferror(file.get()))
+				throw bst_io_exception("Lettura fallita: ", path);
+
+			std::size_t usable = eof ? filled : parser.complete(current.data(), filled);
+			if(usable == 0 && !eof) { // un valore piu' lungo del blocco
+				current.resize(current.size() * 2);
+				std::size_t got = std::fread(current.data() + filled, 1, current.size() - filled, file.get());
+				filled += got;
+				eof = (filled < current.size());
+				continue;
+			}
+
+			std::vector<std::size_t> cuts(threads + 1, usable);
+			cuts[0] = 0;
+			for(unsigned int t = 1; t < threads; ++t)
+				cuts[t] = std::max(cuts[t - 1], parser.align(current.data(), usable, usable / threads * t));
+
+			// Lettura del blocco successivo durante l'interpretazione
+			std::size_t leftover = filled - usable;
+			if(next.size() < current.size())
+				next.resize(current.size());
+			std::memcpy(next.data(), current.data() + usable, leftover);
+			std::thread reader;
+			std::size_t got = 0;
+			if(!eof)
+				reader = std::thread([&]() {
+					got = std::fread(next.data() + leftover, 1, next.size() - leftover, file.get());
+				});
+
+			try {
+				const char *data = current.data();
+				bst_parallel_for(threads, [&](unsigned int t) {
+					parser.parse(data + cuts[t], data + cuts[t + 1], parts[t]);
+				});
+			}
+			catch(...) {
+				if(reader.joinable())
+					reader.join();
+				throw;
+			}
+			if(eof)
+				break;
+
+			reader.join();
+			filled = leftover + got;
+			eof = (filled < next.size());
+			current.swap(next);
+		}
+	}
+	catch(const std::invalid_argument &e) {
+		throw bst_io_exception(std::string("Formato non valido (") + e.what() + "): ", path);
+	}
+	file.reset();
+
+	std::size_t count = 0;
+	for(unsigned int t = 0; t < threads; ++t)
+		count += parts[t].size();
+
+	O order;
+	E equals;
+	bst_parallel_for(threads, [&](unsigned int t) {
+		std::sort(parts[t].begin(), parts[t].end(), order);
+		parts[t].erase(std::unique(parts[t].begin(), parts[t].end(), equals), parts[t].end());
+	});
+
+	// Fusioni a coppie: a ogni passo le sequenze si dimezzano
+	while(parts.size() > 1) {
+		std::vector<std::vector<T> > merged(parts.size() / 2);
+		bst_parallel_for(static_cast<unsigned int>(merged.size()), [&](unsigned int i) {
+			std::vector<T> &a = parts[2 * i];
+			std::vector<T> &b = parts[2 * i + 1];
+			merged[i].reserve(a.size() + b.size());
+			std::merge(std::make_move_iterator(a.begin()), std::make_move_iterator(a.end()),
+					   std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()),
+					   std::back_inserter(merged[i]), order);
+			std::vector<T>().swap(a);
+			std::vector<T>().swap(b);
+			merged[i].erase(std::unique(merged[i].begin(), merged[i].end(), equals), merged[i].end());
+		});
+		if(parts.size() % 2 != 0)
+			merged.push_back(std::move(parts.back()));
+		parts.swap(merged);
+	}
+
+	tree.assign_sorted(std::make_move_iterator(parts[0].begin()), std::make_move_iterator(parts[0].end()));
+	return count;
+}
+
+/**
+	@brief Caricamento di un albero da un file
+
+	Sostituisce il contenuto di un albero con i valori letti da un file,
+	in tre fasi:
+	- il file viene letto a blocchi di chunk_bytes byte: mentre i thread
+	  interpretano un blocco, diviso in parti con align, il thread
+	  chiamante legge il blocco successivo;
+	- ogni thread ordina i propri valori ed elimina i duplicati, poi
+	  le sequenze vengono fuse a coppie in parallelo;
+	- la sequenza finale viene spostata nell'albero con assign_sorted,
+	  che costruisce in O(n) un albero bilanciato in memoria contigua.
+
+	Il lettore P deve fornire complete, align e parse
+	(vedi bst_int_parser, bst_line_parser, bst_record_parser).
+	Servono in memoria i valori letti e, durante le fusioni,
+	una loro copia.
+
+	L'albero puo' essere un binary_search_tree o una sua classe derivata
+	(ad esempio filtered_binary_search_tree, hashed_binary_search_tree,
+	interval_tree): viene chiamato l'assign_sorted del tipo effettivo,
+	che aggiorna anche le strutture aggiuntive dell'albero.
+
+	@param path percorso del file
+	@param tree albero da riempire
+	@param parser lettore del formato del file
+	@param options opzioni di caricamento
+
+	@return numero di valori letti, compresi i duplicati
+
+	@throw bst_io_exception se il file non puo' essere letto o il suo
+		   contenuto non e' valido (l'albero non cambia)
+	@throw eccezione di allocazione di memoria (l'albero non cambia)
+*/
+template <typename Tree, typename P>
+std::size_t bst_load(const std::string &path, Tree &tree, const P &parser,
+					 const bst_load_options &options = bst_load_options()) {
+	typedef decltype(bst_tree_types_of(tree)) types;
+	return bst_load_into<typename types::value_type, typename types::order_type, typename types::equals_type>(
+		path, tree, parser, options);
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstloader.h
@@ -0,0 +1,735 @@
+/**
+	@file bstlru.h
+
+	@brief Dichiarazione e definizione della classe bst_lru_cache
+*/
+
+// Guardie del file header
+
+#ifndef BSTLRU_H
+#define BSTLRU_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <iterator> // std::forward_iterator_tag
+#include <cstddef> // std::size_t, ptrdiff_t
+#include <utility> // std::pair, std::swap
+#include <functional> // std::function
+#include <stdexcept> // std::invalid_argument
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Funtore di dimensione di default
+
+	Funtore che attribuisce a ogni dato la dimensione del suo tipo.
+	Per i dati che possiedono memoria esterna (ad esempio le stringhe)
+	conviene passare a bst_lru_cache un funtore che la conti.
+*/
+template <typename T>
+struct bst_value_size {
+	std::size_t operator()(const T &) const {
+		return sizeof(T);
+	}
+};
+
+/**
+	@brief Cache ordinata a capacita' limitata con rimozione LRU
+
+	Classe che implementa una cache di valori di tipo T basata su un
+	binary_search_tree, con un limite sul numero di elementi e,
+	opzionalmente, sui byte occupati dai valori. I nodi dell'albero
+	sono collegati anche in una lista doppia, dal valore usato meno
+	di recente a quello usato piu' di recente: i collegamenti sono
+	memorizzati nei nodi, quindi la lista non alloca memoria.
+
+	Inserimenti e ricerche con find spostano il valore in fondo alla
+	lista; un inserimento che supera i limiti rimuove subito i valori
+	in testa alla lista, chiamando per ognuno la funzione di rimozione,
+	se impostata. Non ci sono pulizie periodiche: ogni operazione
+	costa come la corrispondente operazione dell'albero, piu' un
+	numero costante di aggiornamenti della lista per valore rimosso.
+
+	Le visite ordinate (begin, lower_bound, copy_range) e exists non
+	modificano l'ordine di utilizzo.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param S funtore di dimensione in byte di un dato
+*/
+template <typename T, typename O, typename E, typename S = bst_value_size<T> >
+class bst_lru_cache {
+
+public:
+	typedef unsigned int size_type; ///< tipo per identificare il numero di elementi nella cache
+	typedef std::function<void(const T &)> eviction_callback; ///< funzione chiamata per ogni valore rimosso
+
+private:
+
+	/**
+		@brief Elemento dell'albero dei valori
+
+		Struttura di supporto interna che associa a un valore
+		i collegamenti della lista di utilizzo. I collegamenti non
+		partecipano all'ordinamento, quindi possono essere modificati
+		anche attraverso un iteratore costante dell'albero.
+	*/
+	struct entry {
+		T value; ///< valore
+		mutable const entry *older; ///< elemento usato precedentemente (nullptr se e' il primo)
+		mutable const entry *newer; ///< elemento usato successivamente (nullptr se e' l'ultimo)
+
+		/**
+			@brief Costruttore
+
+			Costruttore che prende un valore, non collegato alla lista.
+
+			@param v valore
+		*/
+		explicit entry(const T &v) : value(v), older(nullptr), newer(nullptr) {} // initialization list
+	};
+
+	/**
+		@brief Funtore per il confronto tra elementi
+
+		Confronta due elementi dell'albero sulla base del solo valore,
+		usando il funtore di confronto di ordinamento (<) di tipo O.
+		Un valore puo' essere confrontato direttamente con un elemento,
+		per cercarlo senza costruire un elemento temporaneo.
+	*/
+	struct entry_order {
+		bool operator()(const entry &a, const entry &b) const {
+			O order;
+			return order(a.value, b.value);
+		}
+		bool operator()(const T &a, const entry &b) const {
+			O order;
+			return order(a, b.value);
+		}
+		bool operator()(const entry &a, const T &b) const {
+			O order;
+			return order(a.value, b);
+		}
+	};
+
+	/**
+		@brief Funtore per l'uguaglianza tra elementi
+
+		Confronta due elementi dell'albero sulla base del solo valore,
+		usando il funtore di confronto di uguaglianza (==) di tipo E.
+	*/
+	struct entry_equals {
+		bool operator()(const entry &a, const entry &b) const {
+			E equals;
+			return equals(a.value, b.value);
+		}
+		bool operator()(const entry &a, const T &b) const {
+			E equals;
+			return equals(a.value, b);
+		}
+	};
+
+	/**
+		@brief Albero dei valori
+
+		Albero degli elementi che permette di cercarli e inserirli
+		per valore, senza copiare il valore in un elemento temporaneo,
+		e di rimuoverli senza cercarli di nuovo.
+	*/
+	class value_tree : public binary_search_tree<entry, entry_order, entry_equals> {
+		typedef binary_search_tree<entry, entry_order, entry_equals> base; ///< tipo dell'albero di base
+
+	public:
+		typedef typename base::const_iterator const_iterator; ///< iteratore costante degli elementi
+
+		/**
+			@brief Ricerca di un valore
+
+			@param value valore da cercare
+
+			@return iteratore all'elemento con il valore, end() se non esiste
+		*/
+		const_iterator find_value(const T &value) const {
+			return base::iterator_to(this->search_key(value));
+		}
+
+		/**
+			@brief Primo elemento non minore di un valore
+
+			@param value valore da cercare
+
+			@return iteratore ordinato al primo elemento non minore
+					di value, sorted_end() se non esiste
+		*/
+		typename base::const_sorted_iterator sorted_lower_bound_value(const T &value) const {
+			return base::sorted_iterator_to(this->lower_bound_key(value));
+		}
+
+		/**
+			@brief Inserimento senza eccezioni di un valore
+
+			Inserisce un elemento con il valore, se non e' gia' presente:
+			il valore viene copiato solo quando il nodo viene creato.
+
+			@param value valore da inserire
+
+			@return coppia formata dall'iteratore all'elemento con il valore
+					e da true se l'elemento e' stato inserito,
+					false se il valore era gia' presente
+
+			@throw eccezione di allocazione di memoria
+		*/
+		std::pair<const_iterator, bool> try_insert_value(const T &value) {
+			std::pair<typename base::node *, bool> result = this->emplace_key(value, value);
+			return std::make_pair(base::iterator_to(result.first), result.second);
+		}
+
+		/**
+			@brief Rimozione di un elemento
+
+			Rimuove l'elemento riferito da un iteratore, senza cercarlo.
+
+			@param i iteratore all'elemento da rimuovere (diverso da end())
+		*/
+		void erase_at(const_iterator i) {
+			typename base::node *n = base::node_of(i);
+			this->unlink(n);
+			this->destroy_node(n);
+		}
+	};
+
+	value_tree _values; ///< albero dei valori (i nodi non vengono mai spostati)
+	const entry *_oldest; ///< elemento usato meno di recente
+	const entry *_newest; ///< elemento usato piu' di recente
+	size_type _capacity; ///< numero massimo di elementi
+	std::size_t _byte_capacity; ///< numero massimo di byte (0 se illimitato)
+	std::size_t _bytes; ///< byte occupati dai valori
+	eviction_callback _on_evict; ///< funzione chiamata per ogni valore rimosso
+	S _sizeof; ///< oggetto funtore per la dimensione dei dati
+
+	/**
+		@brief Scollegamento di un elemento dalla lista
+
+		@param e elemento da scollegare
+	*/
+	void detach(const entry *e) {
+		if(e->older != nullptr)
+			e->older->newer = e->newer;
+		else
+			_oldest = e->newer;
+		if(e->newer != nullptr)
+			e->newer->older = e->older;
+		else
+			_newest = e->older;
+		e->older = nullptr;
+		e->newer = nullptr;
+	}
+
+	/**
+		@brief Collegamento di un elemento in fondo alla lista
+
+		@param e elemento da collegare (non collegato)
+	*/
+	void push_newest(const entry *e) {
+		e->older = _newest;
+		if(_newest != nullptr)
+			_newest->newer = e;
+		else
+			_oldest = e;
+		_newest = e;
+	}
+
+	/**
+		@brief Utilizzo di un elemento
+
+		Sposta un elemento in fondo alla lista, in tempo costante.
+
+		@param e elemento usato
+	*/
+	void touch(const entry *e) {
+		if(e == _newest)
+			return;
+		detach(e);
+		push_newest(e);
+	}
+
+	/**
+		@brief Rimozione di un elemento
+
+		Funzione privata helper che scollega un elemento dalla lista
+		e lo rimuove dall'albero.
+
+		@param i iteratore all'elemento da rimuovere
+	*/
+	void remove(typename value_tree::const_iterator i) {
+		detach(&*i);
+		_bytes -= _sizeof(i->value);
+		_values.erase_at(i);
+	}
+
+	/**
+		@brief Rispetto dei limiti
+
+		Funzione privata helper che rimuove i valori usati meno
+		di recente finche' la cache rispetta i limiti, lasciando
+		almeno il valore usato piu' di recente.
+		Se la funzione di rimozione lancia un'eccezione, il valore
+		per cui e' stata chiamata resta nella cache.
+	*/
+	void enforce() {
+		while(_oldest != _newest &&
+			  (_values.size() > _capacity || (_byte_capacity != 0 && _bytes > _byte_capacity))) {
+			const entry *victim = _oldest;
+			if(_on_evict)
+				_on_evict(victim->value);
+			remove(_values.find_value(victim->value)); // cerca il nodo senza copiare il valore
+		}
+	}
+
+public:
+
+	/**
+		@brief Costruttore
+
+		Costruttore per istanziare una cache vuota con i limiti indicati.
+
+		@param capacity numero massimo di elementi
+		@param byte_capacity numero massimo di byte occupati dai valori,
+			   misurati con il funtore S (0 per nessun limite)
+		@param on_evict funzione chiamata con ogni valore rimosso
+			   per rispettare i limiti
+
+		@throw std::invalid_argument se capacity e' 0
+	*/
+	explicit bst_lru_cache(size_type capacity, std::size_t byte_capacity = 0,
+						   const eviction_callback &on_evict = eviction_callback()) :
+		_oldest(nullptr), _newest(nullptr), _capacity(capacity),
+		_byte_capacity(byte_capacity), _bytes(0), _on_evict(on_evict) { // initialization list
+		if(capacity == 0)
+			throw std::invalid_argument("bst_lru_cache: capacita' nulla");
+	}
+
+	/**
+		@brief Costruttore di copia/Copy Constructor
+
+		Copia i valori, i limiti e l'ordine di utilizzo di un'altra
+		cache: l'albero viene ricostruito bilanciato dai valori
+		in ordine, in tempo lineare, e la lista di utilizzo viene
+		ricollegata cercando i valori dal meno al piu' recente,
+		in tempo O(n log n) qualunque sia l'ordine di utilizzo.
+
+		@param other cache da copiare
+
+		@throw eccezione di allocazione di memoria
+	*/
+	bst_lru_cache(const bst_lru_cache &other) :
+		_oldest(nullptr), _newest(nullptr), _capacity(other._capacity),
+		_byte_capacity(other._byte_capacity), _bytes(0), _on_evict(other._on_evict), _sizeof(other._sizeof) { // initialization list
+		_values.assign_sorted(other._values.sorted_begin(), other._values.sorted_end());
+		for(const entry *e = other._oldest; e != nullptr; e = e->newer) {
+			const entry *copy = &*_values.find_value(e->value);
+			copy->older = nullptr; // i collegamenti copiati puntano agli elementi di other
+			copy->newer = nullptr;
+			push_newest(copy);
+			_bytes += _sizeof(copy->value);
+		}
+	}
+
+	/**
+		@brief Operatore di assegnamento
+
+		@param other cache da copiare
+
+		@return reference alla cache this
+
+		@throw eccezione di allocazione di memoria
+	*/
+	bst_lru_cache &operator=(const bst_lru_cache &other) {
+		if(this != &other) {
+			bst_lru_cache tmp(other);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	// Il distruttore coincide con quello di default
+
+	/**
+		@brief Scambio di due cache
+
+		Scambia il contenuto di due cache in tempo costante: i nodi
+		non vengono spostati, quindi la lista di utilizzo resta valida.
+
+		@param other cache da scambiare con this
+	*/
+	void swap(bst_lru_cache &other) {
+		_values.swap(other._values);
+		std::swap(_oldest, other._oldest);
+		std::swap(_newest, other._newest);
+		std::swap(_capacity, other._capacity);
+		std::swap(_byte_capacity, other._byte_capacity);
+		std::swap(_bytes, other._bytes);
+		_on_evict.swap(other._on_evict);
+		std::swap(_sizeof, other._sizeof);
+	}
+
+	/**
+		@brief Numero di elementi nella cache
+
+		@return numero di elementi nella cache
+	*/
+	size_type size() const {
+		return _values.size();
+	}
+
+	/**
+		@brief Byte occupati dai valori
+
+		@return somma delle dimensioni dei valori, misurate con il funtore S
+	*/
+	std::size_t bytes() const {
+		return _bytes;
+	}
+
+	/**
+		@brief Numero massimo di elementi
+
+		@return numero massimo di elementi
+	*/
+	size_type capacity() const {
+		return _capacity;
+	}
+
+	/**
+		@brief Numero massimo di byte
+
+		@return numero massimo di byte (0 se illimitato)
+	*/
+	std::size_t byte_capacity() const {
+		return _byte_capacity;
+	}
+
+	/**
+		@brief Modifica dei limiti
+
+		Imposta nuovi limiti, rimuovendo subito i valori usati meno
+		di recente se la cache non li rispetta.
+
+		@param capacity numero massimo di elementi
+		@param byte_capacity numero massimo di byte (0 per nessun limite)
+
+		@throw std::invalid_argument se capacity e' 0
+	*/
+	void set_capacity(size_type capacity, std::size_t byte_capacity = 0) {
+		if(capacity == 0)
+			throw std::invalid_argument("bst_lru_cache: capacita' nulla");
+		_capacity = capacity;
+		_byte_capacity = byte_capacity;
+		enforce();
+	}
+
+	/**
+		@brief Funzione di rimozione
+
+		Imposta la funzione chiamata con ogni valore rimosso
+		per rispettare i limiti (non con quelli rimossi con erase).
+
+		@param on_evict funzione di rimozione (vuota per nessuna)
+	*/
+	void set_eviction_callback(const eviction_callback &on_evict) {
+		_on_evict = on_evict;
+	}
+
+	/**
+		@brief Inserimento o aggiornamento di un valore
+
+		Se il valore non e' presente lo inserisce, altrimenti sostituisce
+		il valore uguale gia' presente. In entrambi i casi il valore
+		diventa il piu' recente, e poi vengono rimossi i valori usati
+		meno di recente finche' la cache rispetta i limiti (il valore
+		appena inserito non viene mai rimosso).
+
+		@param value valore da inserire
+
+		@return true se il valore e' stato inserito, false se e' stato
+				sostituito
+
+		@throw eccezione di allocazione di memoria
+	*/
+	bool insert(const T &value) {
+		std::pair<typename value_tree::const_iterator, bool> result = _values.try_insert_value(value);
+		const entry *e = &*result.first;
+		if(result.second) {
+			push_newest(e);
+			_bytes += _sizeof(e->value);
+		}
+		else {
+			std::size_t replaced = _sizeof(e->value);
+			const_cast<entry *>(e)->value = value; // uguale al precedente: l'ordinamento non cambia
+			_bytes = _bytes - replaced + _sizeof(e->value); // solo se l'assegnamento non ha lanciato eccezioni
+			touch(e);
+		}
+		enforce();
+		return result.second;
+	}
+
+	/**
+		@brief Ricerca di un valore
+
+		Cerca un valore e, se presente, lo rende il piu' recente.
+
+		@param value valore da cercare
+
+		@return puntatore costante al valore nella cache,
+				nullptr se non e' presente
+	*/
+	const T *find(const T &value) {
+		typename value_tree::const_iterator i = _values.find_value(value);
+		if(i == _values.end())
+			return nullptr;
+		touch(&*i);
+		return &i->value;
+	}
+
+	/**
+		@brief Controllo di esistenza di un valore
+
+		Controlla se un valore e' presente, senza modificare
+		l'ordine di utilizzo.
+
+		@param value valore da cercare
+
+		@return true se il valore e' presente, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return _values.find_value(value) != _values.end();
+	}
+
+	/**
+		@brief Rimozione di un valore
+
+		Rimuove un valore senza chiamare la funzione di rimozione.
+
+		@param value valore da rimuovere
+
+		@return true se il valore era presente, false altrimenti
+	*/
+	bool erase(const T &value) {
+		typename value_tree::const_iterator i = _values.find_value(value);
+		if(i == _values.end())
+			return false;
+		remove(i);
+		return true;
+	}
+
+	/**
+		@brief Valore usato meno di recente
+
+		@return puntatore costante al prossimo valore da rimuovere,
+				nullptr se la cache e' vuota
+	*/
+	const T *least_recent() const {
+		return _oldest == nullptr ? nullptr : &_oldest->value;
+	}
+
+	/**
+		@brief Valore usato piu' di recente
+
+		@return puntatore costante all'ultimo valore usato,
+				nullptr se la cache e' vuota
+	*/
+	const T *most_recent() const {
+		return _newest == nullptr ? nullptr : &_newest->value;
+	}
+
+	/**
+		@brief Iteratore costante di tipo forward della cache
+
+		Iteratore a sola lettura (costante) che visita i valori
+		in ordine crescente, senza modificare l'ordine di utilizzo.
+	*/
+	class const_iterator {
+		typename value_tree::const_sorted_iterator _i; ///< iteratore ordinato dell'albero dei valori
+
+		friend class bst_lru_cache;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato per istanziare un iteratore da un iteratore
+			ordinato dell'albero. Usato dalla classe bst_lru_cache.
+
+			@param i iteratore ordinato dell'albero dei valori
+		*/
+		explicit const_iterator(typename value_tree::const_sorted_iterator i) : _i(i) {} // initialization list
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun elemento.
+		*/
+		const_iterator() {}
+
+		// Il costruttore di copia, l'operatore di assegnamento
+		// e il distruttore coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return valore riferito dall'iteratore
+		*/
+		reference operator*() const {
+			return _i->value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			@return puntatore al valore riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &_i->value;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			++_i;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori puntano allo stesso valore,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return _i == other._i;
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other non sono uguali,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	}; // class const_iterator
+
+	/**
+		@brief Iteratore all'inizio della visita ordinata
+
+		@return iteratore al valore minimo
+	*/
+	const_iterator begin() const {
+		return const_iterator(_values.sorted_begin());
+	}
+
+	/**
+		@brief Iteratore alla fine della visita ordinata
+
+		@return iteratore alla fine della visita
+	*/
+	const_iterator end() const {
+		return const_iterator(_values.sorted_end());
+	}
+
+	/**
+		@brief Primo valore non minore di un valore dato
+
+		@param value valore da cercare
+
+		@return iteratore al primo valore non minore di value,
+				end() se non esiste
+	*/
+	const_iterator lower_bound(const T &value) const {
+		return const_iterator(_values.sorted_lower_bound_value(value));
+	}
+
+	/**
+		@brief Copia dei valori di un intervallo
+
+		Scrive in ordine crescente i valori nell'intervallo [low, high),
+		senza modificare l'ordine di utilizzo.
+
+		@param low estremo inferiore (incluso)
+		@param high estremo superiore (escluso)
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+	*/
+	template <typename OI>
+	OI copy_range(const T &low, const T &high, OI out) const {
+		O order;
+		for(const_iterator i = lower_bound(low), ie = end(); i != ie && order(*i, high); ++i)
+			*out++ = *i;
+		return out;
+	}
+
+}; // class bst_lru_cache
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output i valori della cache
+	in ordine crescente.
+
+	@param os oggetto stream di output
+	@param cache cache da stampare
+
+	@return reference allo stream di output
+*/
+template <typename T, typename O, typename E, typename S>
+std::ostream &operator<<(std::ostream &os, const bst_lru_cache<T, O, E, S> &cache) {
+	typename bst_lru_cache<T, O, E, S>::const_iterator i, ie;
+
+	os << "[";
+	for(i = cache.begin(), ie = cache.end(); i != ie; ++i) {
+		if(i != cache.begin())
+			os << ", ";
+		os << *i;
+	}
+	os << "]";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstlru.h
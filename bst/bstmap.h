@@ -0,0 +1,590 @@
+/**
+	@file bstmap.h
+
+	@brief Dichiarazione e definizione della classe bst_map
+*/
+
+// Guardie del file header
+
+#ifndef BSTMAP_H
+#define BSTMAP_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <vector> // std::vector
+#include <utility> // std::forward, std::swap, std::pair
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Mappa chiave/valore basata su un albero binario di ricerca
+
+	Classe che implementa una mappa da chiavi di tipo K a valori di tipo V
+	usando un binary_search_tree per le chiavi.
+	I nodi dell'albero contengono solo la chiave e l'indice del valore
+	associato: i valori sono memorizzati separatamente, in un contenitore
+	allocato a blocchi di dimensione fissa, che non ne cambia l'indirizzo
+	dopo l'inserimento.
+	In questo modo la discesa nell'albero durante una ricerca accede
+	solo alle chiavi, indipendentemente dalla dimensione dei valori.
+
+	@param K tipo delle chiavi
+	@param V tipo dei valori
+	@param O funtore di confronto di ordinamento (<) di due chiavi
+	@param E funtore di confronto di uguaglianza (==) di due chiavi
+*/
+template <typename K, typename V, typename O, typename E>
+class bst_map {
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di elementi nella mappa
+
+	/**
+		@brief Elemento dell'albero delle chiavi
+
+		Struttura di supporto interna che associa una chiave
+		all'indice del suo valore.
+	*/
+	struct entry {
+		K key; ///< chiave
+		size_type slot; ///< indice del valore associato alla chiave
+
+		/**
+			@brief Costruttore
+
+			Costruttore che prende una chiave e l'indice del suo valore.
+
+			@param k chiave
+			@param s indice del valore associato alla chiave
+		*/
+		entry(const K &k, size_type s) : key(k), slot(s) {} // initialization list
+	};
+
+	/**
+		@brief Funtore per il confronto tra elementi
+
+		Confronta due elementi dell'albero sulla base della sola chiave,
+		usando il funtore di confronto di ordinamento (<) di tipo O.
+		Una chiave puo' essere confrontata direttamente con un elemento,
+		per cercarla senza costruire un elemento temporaneo.
+	*/
+	struct entry_order {
+		bool operator()(const entry &a, const entry &b) const {
+			O order;
+			return order(a.key, b.key);
+		}
+		bool operator()(const K &a, const entry &b) const {
+			O order;
+			return order(a, b.key);
+		}
+	};
+
+	/**
+		@brief Funtore per l'uguaglianza tra elementi
+
+		Confronta due elementi dell'albero sulla base della sola chiave,
+		usando il funtore di confronto di uguaglianza (==) di tipo E.
+	*/
+	struct entry_equals {
+		bool operator()(const entry &a, const entry &b) const {
+			E equals;
+			return equals(a.key, b.key);
+		}
+		bool operator()(const entry &a, const K &b) const {
+			E equals;
+			return equals(a.key, b);
+		}
+	};
+
+	/**
+		@brief Albero delle chiavi
+
+		Albero degli elementi che permette di cercarli e inserirli
+		per chiave con una sola discesa, senza copiare la chiave
+		in un elemento temporaneo.
+	*/
+	class key_tree : public binary_search_tree<entry, entry_order, entry_equals> {
+		typedef binary_search_tree<entry, entry_order, entry_equals> base; ///< tipo dell'albero di base
+
+	public:
+		typedef typename base::const_iterator const_iterator; ///< iteratore costante degli elementi
+
+		/**
+			@brief Ricerca di una chiave
+
+			@param key chiave da cercare
+
+			@return iteratore all'elemento con la chiave, end() se non esiste
+		*/
+		const_iterator find_key(const K &key) const {
+			return base::iterator_to(this->search_key(key));
+		}
+
+		/**
+			@brief Inserimento senza eccezioni di una chiave
+
+			Inserisce un elemento con la chiave e l'indice indicati,
+			se la chiave non e' gia' presente: la chiave viene copiata
+			solo quando il nodo viene creato.
+
+			@param key chiave da inserire
+			@param slot indice del valore del nuovo elemento
+
+			@return coppia formata dall'iteratore all'elemento con la chiave
+					e da true se l'elemento e' stato inserito,
+					false se la chiave era gia' presente
+
+			@throw eccezione di allocazione di memoria
+		*/
+		std::pair<const_iterator, bool> try_insert_key(const K &key, size_type slot) {
+			std::pair<typename base::node *, bool> result = this->emplace_key(key, key, slot);
+			return std::make_pair(base::iterator_to(result.first), result.second);
+		}
+
+		/**
+			@brief Rimozione di un elemento
+
+			Rimuove l'elemento riferito da un iteratore, senza cercarlo.
+
+			@param i iteratore all'elemento da rimuovere (diverso da end())
+		*/
+		void erase_at(const_iterator i) {
+			typename base::node *n = base::node_of(i);
+			this->unlink(n);
+			this->destroy_node(n);
+		}
+	};
+
+	/**
+		@brief Contenitore dei valori
+
+		Struttura di supporto interna che memorizza i valori in blocchi
+		contigui di chunk_size elementi. I blocchi non vengono mai
+		riallocati, quindi l'indirizzo di un valore non cambia
+		dopo il suo inserimento.
+	*/
+	class value_store {
+		static const size_type chunk_size = 1024; ///< numero di valori per blocco
+
+		std::vector<std::vector<V> > _chunks; ///< blocchi di valori
+		size_type _size; ///< numero totale di valori
+
+	public:
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un contenitore vuoto.
+		*/
+		value_store() : _size(0) {} // initialization list
+
+		/**
+			@brief Costruttore di copia/Copy Constructor
+
+			Copia i valori in nuovi blocchi con la stessa capacita'
+			di quelli originali.
+
+			@param other contenitore da copiare
+
+			@throw eccezione di allocazione di memoria
+		*/
+		value_store(const value_store &other) : _size(other._size) { // initialization list
+			_chunks.reserve(other._chunks.size());
+			for(size_type i = 0; i < other._chunks.size(); ++i) {
+				_chunks.push_back(std::vector<V>());
+				_chunks.back().reserve(chunk_size);
+				_chunks.back().insert(_chunks.back().end(), other._chunks[i].begin(), other._chunks[i].end());
+			}
+		}
+
+		/**
+			@brief Operatore di assegnamento
+
+			@param other contenitore come sorgente da copiare
+
+			@return reference a this
+
+			@throw eccezione di allocazione di memoria
+		*/
+		value_store &operator=(const value_store &other) {
+			if(this != &other) {
+				value_store tmp(other);
+				std::swap(_chunks, tmp._chunks);
+				std::swap(_size, tmp._size);
+			}
+			return *this;
+		}
+
+		/**
+			@brief Numero totale di valori
+
+			@return numero totale di valori nel contenitore
+		*/
+		size_type size() const {
+			return _size;
+		}
+
+		/**
+			@brief Operatore di accesso per indice
+
+			@param i indice del valore
+
+			@return reference al valore di indice i
+		*/
+		V &operator[](size_type i) {
+			return _chunks[i / chunk_size][i % chunk_size];
+		}
+
+		/**
+			@brief Operatore di accesso per indice (versione costante)
+
+			@param i indice del valore
+
+			@return reference costante al valore di indice i
+		*/
+		const V &operator[](size_type i) const {
+			return _chunks[i / chunk_size][i % chunk_size];
+		}
+
+		/**
+			@brief Inserimento di un valore costruito sul posto
+
+			Costruisce un nuovo valore in coda al contenitore.
+			Se la costruzione fallisce il contenitore non cambia.
+
+			@param args argomenti per il costruttore del valore
+
+			@throw eccezione di allocazione di memoria
+		*/
+		template <typename... Args>
+		void emplace_back(Args&&... args) {
+			if(_size % chunk_size == 0) {
+				_chunks.push_back(std::vector<V>());
+				try {
+					_chunks.back().reserve(chunk_size);
+					_chunks.back().emplace_back(std::forward<Args>(args)...);
+				}
+				catch(...) {
+					_chunks.pop_back(); // nessun blocco vuoto in coda
+					throw;
+				}
+			}
+			else
+				_chunks.back().emplace_back(std::forward<Args>(args)...);
+			_size++;
+		}
+	}; // class value_store
+
+	key_tree _keys; ///< albero delle chiavi
+	value_store _values; ///< valori associati alle chiavi, indicizzati da entry::slot
+
+	/**
+		@brief Indice del valore associato a una chiave
+
+		Funzione privata helper che cerca una chiave nell'albero
+		e ritorna l'indice del valore associato.
+
+		@param key chiave da cercare
+		@param slot indice del valore associato, se la chiave esiste
+
+		@return true se la chiave esiste, false altrimenti
+	*/
+	bool search(const K &key, size_type &slot) const {
+		typename key_tree::const_iterator i = _keys.find_key(key);
+		if(i == _keys.end())
+			return false;
+		slot = i->slot;
+		return true;
+	}
+
+	/**
+		@brief Inserimento di un valore costruito sul posto
+
+		Funzione privata helper che cerca la chiave con una sola discesa
+		e, se non e' presente, inserisce la chiave e costruisce il valore
+		associato con gli argomenti passati. Se la costruzione del valore
+		fallisce, la chiave viene rimossa.
+
+		@param key chiave
+		@param args argomenti per il costruttore del valore
+
+		@return coppia formata dall'indice del valore associato alla chiave
+				e da true se la coppia e' stata inserita, false altrimenti
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename... Args>
+	std::pair<size_type, bool> emplace_slot(const K &key, Args&&... args) {
+		std::pair<typename key_tree::const_iterator, bool> result =
+			_keys.try_insert_key(key, static_cast<size_type>(_values.size()));
+		if(!result.second)
+			return std::make_pair(result.first->slot, false);
+
+		try {
+			_values.emplace_back(std::forward<Args>(args)...);
+		}
+		catch(...) {
+			_keys.erase_at(result.first);
+			throw;
+		}
+		return std::make_pair(result.first->slot, true);
+	}
+
+public:
+
+	// Il costruttore di default, il costruttore di copia,
+	// l'operatore di assegnamento e il distruttore coincidono
+	// con quelli di default
+
+	/**
+		@brief Numero totale di elementi nella mappa
+
+		Ritorna il numero totale di coppie chiave/valore nella mappa.
+
+		@return numero totale di elementi nella mappa
+	*/
+	size_type size() const {
+		return _keys.size();
+	}
+
+	/**
+		@brief Controllo di esistenza di una chiave
+
+		Controlla se esiste una chiave nella mappa.
+
+		@param key chiave da cercare
+
+		@return true se esiste la chiave, false altrimenti
+	*/
+	bool exists(const K &key) const {
+		return _keys.find_key(key) != _keys.end();
+	}
+
+	/**
+		@brief Ricerca di un valore
+
+		Ritorna il valore associato a una chiave.
+
+		@param key chiave da cercare
+
+		@return puntatore al valore associato alla chiave,
+				nullptr se la chiave non e' presente nella mappa
+	*/
+	V *find(const K &key) {
+		size_type slot;
+		return search(key, slot) ? &_values[slot] : nullptr;
+	}
+
+	/**
+		@brief Ricerca di un valore (versione costante)
+
+		Ritorna il valore associato a una chiave.
+
+		@param key chiave da cercare
+
+		@return puntatore costante al valore associato alla chiave,
+				nullptr se la chiave non e' presente nella mappa
+	*/
+	const V *find(const K &key) const {
+		size_type slot;
+		return search(key, slot) ? &_values[slot] : nullptr;
+	}
+
+	/**
+		@brief Inserimento di un valore costruito sul posto
+
+		Se la chiave non e' presente nella mappa, costruisce il valore
+		associato con gli argomenti passati e inserisce la coppia.
+		Se la chiave e' gia' presente, non costruisce nessun valore
+		e non modifica la mappa.
+
+		@param key chiave
+		@param args argomenti per il costruttore del valore
+
+		@return true se la coppia e' stata inserita, false altrimenti
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename... Args>
+	bool try_emplace(const K &key, Args&&... args) {
+		return emplace_slot(key, std::forward<Args>(args)...).second;
+	}
+
+	/**
+		@brief Inserimento o assegnamento di un valore
+
+		Se la chiave non e' presente nella mappa, inserisce la coppia.
+		Altrimenti assegna il nuovo valore a quello associato alla chiave.
+
+		@param key chiave
+		@param value valore
+
+		@return true se la coppia e' stata inserita,
+				false se il valore e' stato assegnato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	bool insert_or_assign(const K &key, const V &value) {
+		std::pair<size_type, bool> result = emplace_slot(key, value);
+		if(!result.second)
+			_values[result.first] = value;
+		return result.second;
+	}
+
+	/**
+		@brief Operatore di accesso per chiave
+
+		Ritorna il valore associato a una chiave. Se la chiave non e'
+		presente nella mappa, inserisce un valore costruito di default.
+
+		@param key chiave
+
+		@return reference al valore associato alla chiave
+
+		@throw eccezione di allocazione di memoria
+	*/
+	V &operator[](const K &key) {
+		return _values[emplace_slot(key).first];
+	}
+
+	/**
+		@brief Iteratore costante di tipo forward della mappa
+
+		Iteratore a sola lettura (costante) che visita le coppie
+		chiave/valore nello stesso ordine dell'iteratore dell'albero
+		delle chiavi.
+	*/
+	class const_iterator {
+		typename key_tree::const_iterator _i; ///< iteratore dell'albero delle chiavi
+		const value_store *_values; ///< valori della mappa
+
+	public:
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun elemento.
+		*/
+		const_iterator() : _values(nullptr) {} // initialization list
+
+		/**
+			@brief Chiave dell'elemento
+
+			@return chiave dell'elemento riferito dall'iteratore
+		*/
+		const K &key() const {
+			return _i->key;
+		}
+
+		/**
+			@brief Valore dell'elemento
+
+			@return valore dell'elemento riferito dall'iteratore
+		*/
+		const V &value() const {
+			return (*_values)[_i->slot];
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			++_i;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori puntano allo stesso elemento,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (_i == other._i);
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori puntano a elementi diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return (_i != other._i);
+		}
+
+	private:
+
+		friend class bst_map;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato di inizializzazione utilizzato
+			dalla classe container (bst_map) nei metodi begin ed end.
+
+			@param i iteratore dell'albero delle chiavi
+			@param values valori della mappa
+		*/
+		const_iterator(typename key_tree::const_iterator i, const value_store *values) :
+			_i(i), _values(values) {} // initialization list
+
+	}; // class const_iterator
+
+	/**
+		@brief Iteratore che punta all'inizio della mappa
+
+		@return iteratore che punta all'inizio della mappa
+	*/
+	const_iterator begin() const {
+		return const_iterator(_keys.begin(), &_values);
+	}
+
+	/**
+		@brief Iteratore che punta alla fine della mappa
+
+		@return iteratore che punta alla fine della mappa
+	*/
+	const_iterator end() const {
+		return const_iterator(_keys.end(), &_values);
+	}
+
+}; // class bst_map
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa del contenuto
+	della mappa, come sequenza di coppie chiave: valore.
+
+	@param os oggetto stream di output
+	@param map mappa da stampare
+
+	@return reference allo stream di output
+*/
+template <typename K, typename V, typename O, typename E>
+std::ostream &operator<<(std::ostream &os, const bst_map<K, V, O, E> &map) {
+	typename bst_map<K, V, O, E>::const_iterator i, ie;
+
+	os << "{";
+	for(i = map.begin(), ie = map.end(); i != ie; ++i) {
+		if(i != map.begin())
+			os << ", ";
+		os << i.key() << ": " << i.value();
+	}
+	os << "}";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstmap.h
@@ -0,0 +1,312 @@
+/**
+	@file bstmerge.h
+
+	@brief Dichiarazione e definizione della classe merge_iterator
+*/
+
+// Guardie del file header
+
+#ifndef BSTMERGE_H
+#define BSTMERGE_H
+
+// Direttive per il pre-compilatore
+
+#include <vector> // std::vector
+#include <iterator> // std::forward_iterator_tag
+#include <cstddef> // ptrdiff_t
+#include <utility> // std::swap
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Iteratore di fusione ordinata di piu' alberi
+
+	Classe che implementa un iteratore costante di tipo forward che
+	visita in ordine crescente l'unione dei valori di N alberi, senza
+	copiarli: ogni albero viene visitato con il proprio iteratore
+	ordinato e un albero dei perdenti (tournament tree) sceglie
+	a ogni passo il minimo tra i valori correnti con O(log N) confronti.
+	A parita' di valore precede l'albero con indice minore.
+
+	Opzionalmente i valori uguali presenti in piu' alberi vengono
+	restituiti una sola volta, e la visita puo' essere limitata
+	ai valori nell'intervallo [low, high).
+
+	Gli alberi non devono essere modificati durante la visita.
+	Un iteratore costruito di default vale come fine della visita.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, typename O, typename E>
+class merge_iterator {
+
+	typedef binary_search_tree<T, O, E> tree_type; ///< tipo degli alberi
+	typedef typename tree_type::const_sorted_iterator source; ///< iteratore di un albero
+	typedef unsigned int size_type; ///< tipo dell'indice di un albero
+
+	std::vector<source> _current; ///< valore corrente di ogni albero
+	std::vector<source> _end; ///< fine di ogni albero
+	std::vector<const T *> _heads; ///< valore corrente di ogni albero (nullptr se esaurito)
+	std::vector<size_type> _losers; ///< albero dei perdenti (_losers[0] e' il vincitore)
+	bool _unique; ///< true per restituire una sola volta i valori uguali
+	bool _bounded; ///< true se la visita e' limitata da _high
+	T _high; ///< estremo superiore escluso della visita
+	O _order; ///< oggetto funtore per l'ordinamento dei dati
+	E _equals; ///< oggetto funtore per l'uguaglianza dei dati
+
+	/**
+		@brief Aggiornamento del valore corrente di un albero
+
+		@param i indice dell'albero
+	*/
+	void load(size_type i) {
+		bool exhausted = _current[i] == _end[i] || (_bounded && !_order(*_current[i], _high));
+		_heads[i] = exhausted ? nullptr : &*_current[i];
+	}
+
+	/**
+		@brief Confronto tra i valori correnti di due alberi
+
+		@param a indice del primo albero
+		@param b indice del secondo albero
+
+		@return true se il valore corrente di a precede quello di b
+				(un albero esaurito segue tutti gli altri)
+	*/
+	bool less(size_type a, size_type b) const {
+		const T *x = _heads[a];
+		const T *y = _heads[b];
+		if(x == nullptr)
+			return false;
+		if(y == nullptr)
+			return true;
+		if(_order(*x, *y))
+			return true;
+		if(_order(*y, *x))
+			return false;
+		return a < b;
+	}
+
+	/**
+		@brief Costruzione dell'albero dei perdenti
+
+		Funzione privata helper che calcola ricorsivamente il vincitore
+		di un sottoalbero del torneo, memorizzando i perdenti.
+		Le foglie sono le posizioni da N a 2N - 1.
+
+		@param position posizione nel torneo
+
+		@return indice dell'albero vincitore
+	*/
+	size_type play(size_type position) {
+		size_type n = static_cast<size_type>(_current.size());
+		if(position >= n)
+			return position - n;
+
+		size_type left = play(2 * position);
+		size_type right = play(2 * position + 1);
+		if(less(left, right)) {
+			_losers[position] = right;
+			return left;
+		}
+		_losers[position] = left;
+		return right;
+	}
+
+	/**
+		@brief Avanzamento del vincitore
+
+		Funzione privata helper che avanza l'albero vincitore
+		e ripete le sfide dalla sua foglia alla radice del torneo.
+	*/
+	void advance() {
+		size_type n = static_cast<size_type>(_current.size());
+		size_type winner = _losers[0];
+		++_current[winner];
+		load(winner);
+
+		for(size_type position = (winner + n) / 2; position > 0; position /= 2)
+			if(less(_losers[position], winner))
+				std::swap(_losers[position], winner);
+		_losers[0] = winner;
+	}
+
+	/**
+		@brief Inizializzazione
+
+		Funzione privata helper che prepara i valori iniziali
+		degli alberi e gioca il torneo.
+
+		@param first iteratore al primo puntatore ad albero
+		@param last iteratore alla fine della sequenza di puntatori
+		@param low puntatore all'estremo inferiore (nullptr se assente)
+	*/
+	template <typename I>
+	void init(I first, I last, const T *low) {
+		for(; first != last; ++first) {
+			const tree_type &tree = **first;
+			_current.push_back(low == nullptr ? tree.sorted_begin() : tree.sorted_lower_bound(*low));
+			_end.push_back(tree.sorted_end());
+			_heads.push_back(nullptr);
+			load(static_cast<size_type>(_current.size() - 1));
+		}
+		_losers.assign(_current.size() == 0 ? 1 : _current.size(), 0);
+		if(!_current.empty())
+			_losers[0] = play(1);
+	}
+
+public:
+	typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+	typedef T                         value_type; ///< tipo dei dati puntati: T
+	typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+	typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+	typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un iteratore
+		alla fine della visita.
+	*/
+	merge_iterator() : _unique(false), _bounded(false), _high() {} // initialization list
+
+	/**
+		@brief Costruttore
+
+		Costruttore che prepara la visita ordinata di tutti i valori
+		di una sequenza di alberi.
+
+		@param first iteratore al primo puntatore (costante) ad albero
+		@param last iteratore alla fine della sequenza di puntatori
+		@param unique true per restituire una sola volta i valori uguali
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	merge_iterator(I first, I last, bool unique = false) :
+		_unique(unique), _bounded(false), _high() { // initialization list
+		init(first, last, nullptr);
+	}
+
+	/**
+		@brief Costruttore per un intervallo
+
+		Costruttore che prepara la visita ordinata dei valori
+		nell'intervallo [low, high) di una sequenza di alberi.
+		Ogni albero viene posizionato sul primo valore non minore di low
+		con una ricerca, senza visitare i valori precedenti.
+
+		@param first iteratore al primo puntatore (costante) ad albero
+		@param last iteratore alla fine della sequenza di puntatori
+		@param low estremo inferiore (incluso)
+		@param high estremo superiore (escluso)
+		@param unique true per restituire una sola volta i valori uguali
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	merge_iterator(I first, I last, const T &low, const T &high, bool unique = false) :
+		_unique(unique), _bounded(true), _high(high) { // initialization list
+		init(first, last, &low);
+	}
+
+	// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+	// coincidono con quelli di default
+
+	/**
+		@brief Operatore di dereferenziamento
+
+		@return valore riferito dall'iteratore (nel suo albero)
+	*/
+	reference operator*() const {
+		return *_heads[_losers[0]];
+	}
+
+	/**
+		@brief Operatore di accesso ai dati
+
+		@return puntatore al valore riferito dall'iteratore
+	*/
+	pointer operator->() const {
+		return _heads[_losers[0]];
+	}
+
+	/**
+		@brief Operatore di iterazione pre-incremento
+
+		Passa al valore successivo nell'ordine globale, saltando
+		i valori uguali a quello corrente se richiesto.
+
+		@return reference all'iteratore incrementato
+	*/
+	merge_iterator &operator++() {
+		if(!_unique) {
+			advance();
+			return *this;
+		}
+
+		const T *previous = &**this; // resta valido: i valori non vengono copiati
+		do
+			advance();
+		while(_heads[_losers[0]] != nullptr && _equals(**this, *previous));
+		return *this;
+	}
+
+	/**
+		@brief Operatore di iterazione post-incremento
+
+		@param int parametro fittizio per distinguere l'operatore
+			   di post-incremento da quello di pre-incremento
+
+		@return copia dell'iteratore prima di essere incrementato
+	*/
+	merge_iterator operator++(int) {
+		merge_iterator tmp(*this);
+		++*this;
+		return tmp;
+	}
+
+	/**
+		@brief Fine della visita
+
+		@return true se non ci sono altri valori da visitare
+	*/
+	bool at_end() const {
+		return _current.empty() || _heads[_losers[0]] == nullptr;
+	}
+
+	/**
+		@brief Operatore di uguaglianza
+
+		@param other iteratore da confrontare con this
+
+		@return true se entrambi gli iteratori sono alla fine
+				o puntano allo stesso valore dello stesso albero,
+				false altrimenti
+	*/
+	bool operator==(const merge_iterator &other) const {
+		if(at_end() || other.at_end())
+			return at_end() == other.at_end();
+		return &**this == &*other;
+	}
+
+	/**
+		@brief Operatore di diversita'
+
+		@param other iteratore da confrontare con this
+
+		@return true se gli iteratori this e other non sono uguali,
+				false altrimenti
+	*/
+	bool operator!=(const merge_iterator &other) const {
+		return !(*this == other);
+	}
+
+}; // class merge_iterator
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstmerge.h
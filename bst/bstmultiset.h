@@ -0,0 +1,487 @@
+/**
+	@file bstmultiset.h
+
+	@brief Dichiarazione e definizione della classe bst_multiset
+*/
+
+// Guardie del file header
+
+#ifndef BSTMULTISET_H
+#define BSTMULTISET_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <iterator> // std::forward_iterator_tag
+#include <cstddef> // ptrdiff_t
+#include <utility> // std::pair
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Multiinsieme con conteggio basato su un albero binario di ricerca
+
+	Classe che implementa un multiinsieme di valori di tipo T usando
+	un binary_search_tree in cui ogni nodo contiene un valore distinto
+	e il numero delle sue occorrenze.
+	Inserire un valore gia' presente ne incrementa il conteggio
+	e rimuoverlo lo decrementa: i valori ripetuti non sono un errore,
+	non lanciano eccezioni e non allocano memoria, e l'albero ha un solo
+	nodo per valore distinto.
+
+	I valori possono essere visitati in ordine crescente una sola volta,
+	con il relativo conteggio, oppure ripetuti tante volte quante sono
+	le loro occorrenze.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, typename O, typename E>
+class bst_multiset {
+
+public:
+	typedef unsigned int size_type; ///< tipo per identificare il numero di occorrenze
+
+private:
+
+	/**
+		@brief Elemento dell'albero dei valori
+
+		Struttura di supporto interna che associa un valore
+		al numero delle sue occorrenze. Il conteggio non partecipa
+		all'ordinamento, quindi puo' essere modificato anche
+		attraverso un iteratore costante dell'albero.
+	*/
+	struct entry {
+		T value; ///< valore
+		mutable size_type count; ///< numero di occorrenze del valore
+
+		/**
+			@brief Costruttore
+
+			Costruttore che prende un valore e il numero delle sue occorrenze.
+
+			@param v valore
+			@param c numero di occorrenze
+		*/
+		entry(const T &v, size_type c) : value(v), count(c) {} // initialization list
+	};
+
+	/**
+		@brief Funtore per il confronto tra elementi
+
+		Confronta due elementi dell'albero sulla base del solo valore,
+		usando il funtore di confronto di ordinamento (<) di tipo O.
+		Un valore puo' essere confrontato direttamente con un elemento,
+		per cercarlo senza costruire un elemento temporaneo.
+	*/
+	struct entry_order {
+		bool operator()(const entry &a, const entry &b) const {
+			O order;
+			return order(a.value, b.value);
+		}
+		bool operator()(const T &a, const entry &b) const {
+			O order;
+			return order(a, b.value);
+		}
+	};
+
+	/**
+		@brief Funtore per l'uguaglianza tra elementi
+
+		Confronta due elementi dell'albero sulla base del solo valore,
+		usando il funtore di confronto di uguaglianza (==) di tipo E.
+	*/
+	struct entry_equals {
+		bool operator()(const entry &a, const entry &b) const {
+			E equals;
+			return equals(a.value, b.value);
+		}
+		bool operator()(const entry &a, const T &b) const {
+			E equals;
+			return equals(a.value, b);
+		}
+	};
+
+	/**
+		@brief Albero dei valori
+
+		Albero degli elementi che permette di cercarli, inserirli
+		e rimuoverli per valore, senza copiare il valore
+		in un elemento temporaneo.
+	*/
+	class value_tree : public binary_search_tree<entry, entry_order, entry_equals> {
+		typedef binary_search_tree<entry, entry_order, entry_equals> base; ///< tipo dell'albero di base
+
+	public:
+		typedef typename base::const_iterator const_iterator; ///< iteratore costante degli elementi
+
+		/**
+			@brief Ricerca di un valore
+
+			@param value valore da cercare
+
+			@return iteratore all'elemento con il valore, end() se non esiste
+		*/
+		const_iterator find_value(const T &value) const {
+			return base::iterator_to(this->search_key(value));
+		}
+
+		/**
+			@brief Inserimento senza eccezioni di un valore
+
+			Inserisce un elemento con il valore e il conteggio indicati,
+			se il valore non e' gia' presente: il valore viene copiato
+			solo quando il nodo viene creato.
+
+			@param value valore da inserire
+			@param count numero di occorrenze del nuovo elemento
+
+			@return coppia formata dall'iteratore all'elemento con il valore
+					e da true se l'elemento e' stato inserito,
+					false se il valore era gia' presente
+
+			@throw eccezione di allocazione di memoria
+		*/
+		std::pair<const_iterator, bool> try_insert_value(const T &value, size_type count) {
+			std::pair<typename base::node *, bool> result = this->emplace_key(value, value, count);
+			return std::make_pair(base::iterator_to(result.first), result.second);
+		}
+
+		/**
+			@brief Rimozione di un elemento
+
+			Rimuove l'elemento riferito da un iteratore, senza cercarlo.
+
+			@param i iteratore all'elemento da rimuovere (diverso da end())
+		*/
+		void erase_at(const_iterator i) {
+			typename base::node *n = base::node_of(i);
+			this->unlink(n);
+			this->destroy_node(n);
+		}
+	};
+
+	value_tree _values; ///< albero dei valori distinti
+	size_type _size; ///< numero totale di occorrenze
+
+public:
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un multiinsieme vuoto.
+	*/
+	bst_multiset() : _size(0) {} // initialization list
+
+	// Il costruttore di copia, l'operatore di assegnamento
+	// e il distruttore coincidono con quelli di default
+
+	/**
+		@brief Numero totale di occorrenze
+
+		Ritorna il numero totale di valori nel multiinsieme,
+		contando ogni occorrenza.
+
+		@return numero totale di occorrenze
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di valori distinti
+
+		Ritorna il numero di valori distinti nel multiinsieme,
+		cioe' il numero di nodi dell'albero.
+
+		@return numero di valori distinti
+	*/
+	size_type distinct() const {
+		return _values.size();
+	}
+
+	/**
+		@brief Inserimento di occorrenze di un valore
+
+		Aggiunge times occorrenze di un valore: se il valore e' gia'
+		presente ne incrementa il conteggio con una sola ricerca,
+		altrimenti inserisce un nuovo nodo.
+
+		@param value valore da inserire
+		@param times numero di occorrenze da aggiungere
+
+		@return numero di occorrenze del valore dopo l'inserimento
+
+		@throw eccezione di allocazione di memoria
+	*/
+	size_type insert(const T &value, size_type times = 1) {
+		if(times == 0)
+			return count(value);
+
+		std::pair<typename value_tree::const_iterator, bool> result = _values.try_insert_value(value, times);
+		if(!result.second)
+			result.first->count += times;
+		_size += times;
+		return result.first->count;
+	}
+
+	/**
+		@brief Numero di occorrenze di un valore
+
+		@param value valore da cercare
+
+		@return numero di occorrenze del valore, 0 se non e' presente
+	*/
+	size_type count(const T &value) const {
+		typename value_tree::const_iterator i = _values.find_value(value);
+		return i == _values.end() ? 0 : i->count;
+	}
+
+	/**
+		@brief Controllo di esistenza di un valore
+
+		@param value valore da cercare
+
+		@return true se il valore ha almeno un'occorrenza, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		return _values.find_value(value) != _values.end();
+	}
+
+	/**
+		@brief Rimozione di occorrenze di un valore
+
+		Toglie fino a times occorrenze di un valore, rimuovendone
+		il nodo quando il conteggio arriva a zero. Un valore
+		non presente non e' un errore.
+
+		@param value valore da rimuovere
+		@param times numero massimo di occorrenze da togliere
+
+		@return numero di occorrenze tolte
+	*/
+	size_type erase(const T &value, size_type times = 1) {
+		typename value_tree::const_iterator i = _values.find_value(value);
+		if(i == _values.end())
+			return 0;
+
+		size_type removed = times < i->count ? times : i->count;
+		i->count -= removed;
+		_size -= removed;
+		if(i->count == 0)
+			_values.erase_at(i);
+		return removed;
+	}
+
+	/**
+		@brief Rimozione di tutte le occorrenze di un valore
+
+		@param value valore da rimuovere
+
+		@return numero di occorrenze tolte
+	*/
+	size_type erase_all(const T &value) {
+		return erase(value, static_cast<size_type>(-1));
+	}
+
+	/**
+		@brief Iteratore costante di tipo forward del multiinsieme
+
+		Iteratore a sola lettura (costante) che visita i valori
+		in ordine crescente, ognuno una sola volta oppure ripetuto
+		tante volte quante sono le sue occorrenze.
+	*/
+	class const_iterator {
+		typename value_tree::const_sorted_iterator _i; ///< iteratore ordinato dell'albero dei valori
+		size_type _repeat; ///< occorrenza corrente del valore
+		bool _multiplicity; ///< true per ripetere i valori
+
+		friend class bst_multiset;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato per istanziare un iteratore da un iteratore
+			ordinato dell'albero. Usato dalla classe bst_multiset.
+
+			@param i iteratore ordinato dell'albero dei valori
+			@param multiplicity true per ripetere i valori
+		*/
+		const_iterator(typename value_tree::const_sorted_iterator i, bool multiplicity) :
+			_i(i), _repeat(0), _multiplicity(multiplicity) {} // initialization list
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun elemento.
+		*/
+		const_iterator() : _repeat(0), _multiplicity(false) {} // initialization list
+
+		// Il costruttore di copia, l'operatore di assegnamento
+		// e il distruttore coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return valore riferito dall'iteratore
+		*/
+		reference operator*() const {
+			return _i->value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			@return puntatore al valore riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &_i->value;
+		}
+
+		/**
+			@brief Numero di occorrenze
+
+			@return numero di occorrenze del valore riferito dall'iteratore
+		*/
+		size_type count() const {
+			return _i->count;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Passa all'occorrenza successiva dello stesso valore,
+			se le occorrenze vengono ripetute e non sono finite,
+			altrimenti al valore successivo.
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			if(_multiplicity && ++_repeat < _i->count)
+				return *this;
+			_repeat = 0;
+			++_i;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori puntano alla stessa occorrenza
+					dello stesso valore, false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return _i == other._i && _repeat == other._repeat;
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other non sono uguali,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	}; // class const_iterator
+
+	/**
+		@brief Iteratore all'inizio dei valori distinti
+
+		@return iteratore al valore minimo, visitato una sola volta
+	*/
+	const_iterator begin() const {
+		return const_iterator(_values.sorted_begin(), false);
+	}
+
+	/**
+		@brief Iteratore alla fine dei valori distinti
+
+		@return iteratore alla fine della visita
+	*/
+	const_iterator end() const {
+		return const_iterator(_values.sorted_end(), false);
+	}
+
+	/**
+		@brief Iteratore all'inizio delle occorrenze
+
+		@return iteratore alla prima occorrenza del valore minimo,
+				che visita ogni valore tante volte quante sono
+				le sue occorrenze
+	*/
+	const_iterator multiplicity_begin() const {
+		return const_iterator(_values.sorted_begin(), true);
+	}
+
+	/**
+		@brief Iteratore alla fine delle occorrenze
+
+		@return iteratore alla fine della visita
+	*/
+	const_iterator multiplicity_end() const {
+		return const_iterator(_values.sorted_end(), true);
+	}
+
+}; // class bst_multiset
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto
+	del multiinsieme, in ordine crescente, come sequenza di coppie
+	valore: numero di occorrenze.
+
+	@param os oggetto stream di output
+	@param set multiinsieme da stampare
+
+	@return reference allo stream di output
+*/
+template <typename T, typename O, typename E>
+std::ostream &operator<<(std::ostream &os, const bst_multiset<T, O, E> &set) {
+	typename bst_multiset<T, O, E>::const_iterator i, ie;
+
+	os << "{";
+	for(i = set.begin(), ie = set.end(); i != ie; ++i) {
+		if(i != set.begin())
+			os << ", ";
+		os << *i << ": " << i.count();
+	}
+	os << "}";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstmultiset.h
@@ -0,0 +1,1094 @@
+/**
+	@file bstpaged.h
+
+	@brief Dichiarazione e definizione delle classi bst_page_pool
+	e paged_binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTPAGED_H
+#define BSTPAGED_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <cstdio> // std::FILE, std::fopen, std::fread, std::fwrite
+#include <cstring> // std::memcpy, std::memset
+#include <cstddef> // std::size_t, ptrdiff_t
+#include <string> // std::string
+#include <vector> // std::vector
+#include <unordered_map> // std::unordered_map
+#include <algorithm> // std::upper_bound, std::lower_bound, std::copy
+#include <iterator> // std::forward_iterator_tag
+#include <stdexcept> // std::invalid_argument, std::length_error
+#include <type_traits> // std::is_trivially_copyable
+#include "bstexceptions.h" // bst_duplicated_value_exception, bst_io_exception
+
+#ifndef _WIN32
+#include <sys/types.h> // off_t
+#endif
+
+/**
+	@brief Buffer pool di pagine di un file
+
+	Classe che mantiene in memoria un numero limitato di pagine
+	di dimensione fissa di un file. Una pagina viene letta dal file
+	solo se non e' gia' presente; quando il pool e' pieno viene
+	sostituita una pagina non in uso scelta con l'algoritmo CLOCK
+	(approssimazione di LRU con un bit di riferimento per pagina),
+	scrivendola nel file se e' stata modificata.
+
+	Le pagine in uso (pin) non vengono mai sostituite: il dato
+	di una pagina resta valido fino al corrispondente unpin.
+*/
+class bst_page_pool {
+
+public:
+
+	typedef unsigned int page_id; ///< tipo dell'indice di una pagina nel file
+	typedef unsigned int frame_id; ///< tipo dell'indice di una pagina nel pool
+
+private:
+
+	static const page_id null_page = static_cast<page_id>(-1); ///< nessuna pagina
+
+	/**
+		@brief Pagina del pool
+
+		Struttura di supporto interna con lo stato di una pagina del pool.
+	*/
+	struct frame {
+		page_id id; ///< pagina del file contenuta (null_page se libera)
+		unsigned int pins; ///< numero di utilizzi in corso
+		bool dirty; ///< true se modificata rispetto al file
+		bool referenced; ///< bit di riferimento dell'algoritmo CLOCK
+	};
+
+	std::FILE *_file; ///< file delle pagine
+	std::string _path; ///< percorso del file
+	std::size_t _page_size; ///< byte di una pagina
+	bool _created; ///< true se il file e' stato creato dal pool
+	std::vector<frame> _frames; ///< stato delle pagine del pool
+	std::vector<unsigned long long> _data; ///< dati delle pagine del pool (allineati a 8 byte)
+	std::unordered_map<page_id, frame_id> _table; ///< pagine del file presenti nel pool
+	frame_id _hand; ///< lancetta dell'algoritmo CLOCK
+	unsigned long long _reads; ///< pagine lette dal file
+	unsigned long long _writes; ///< pagine scritte nel file
+
+	/**
+		@brief Posizionamento nel file
+
+		@param id pagina del file
+
+		@throw bst_io_exception se il posizionamento fallisce
+	*/
+	void seek(page_id id) {
+		unsigned long long offset = static_cast<unsigned long long>(id) * _page_size;
+#ifdef _WIN32
+		bool failed = _fseeki64(_file, static_cast<long long>(offset), SEEK_SET) != 0;
+#else
+		bool failed = fseeko(_file, static_cast<off_t>(offset), SEEK_SET) != 0;
+#endif
+		if(failed)
+			throw bst_io_exception("Posizionamento fallito: ", _path);
+	}
+
+	/**
+		@brief Scrittura di una pagina del pool nel file
+
+		@param f pagina del pool
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	void write_frame(frame_id f) {
+		seek(_frames[f].id);
+		if(std::fwrite(data(f), 1, _page_size, _file) != _page_size)
+			throw bst_io_exception("Scrittura fallita: ", _path);
+		_frames[f].dirty = false;
+		_writes++;
+	}
+
+	/**
+		@brief Scelta di una pagina del pool da sostituire
+
+		Funzione privata helper che fa avanzare la lancetta dell'algoritmo
+		CLOCK fino a una pagina non in uso con il bit di riferimento
+		azzerato, azzerando i bit delle pagine superate, e la libera.
+
+		@return pagina del pool libera
+
+		@throw std::length_error se tutte le pagine del pool sono in uso
+		@throw bst_io_exception se la scrittura della pagina sostituita fallisce
+	*/
+	frame_id victim() {
+		for(std::size_t step = 0; step < 2 * _frames.size(); ++step) {
+			frame_id f = _hand;
+			_hand = (_hand + 1) % _frames.size();
+
+			frame &current = _frames[f];
+			if(current.pins > 0)
+				continue;
+			if(current.referenced) {
+				current.referenced = false;
+				continue;
+			}
+			if(current.id != null_page) {
+				if(current.dirty)
+					write_frame(f);
+				_table.erase(current.id);
+				current.id = null_page;
+			}
+			return f;
+		}
+
+		throw std::length_error("bst_page_pool: tutte le pagine sono in uso");
+	}
+
+	/**
+		@brief Assegnamento di una pagina del pool
+
+		@param f pagina del pool libera
+		@param id pagina del file
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void assign(frame_id f, page_id id) {
+		_table[id] = f;
+		_frames[f].id = id;
+		_frames[f].pins = 1;
+		_frames[f].referenced = true;
+	}
+
+public:
+
+	/**
+		@brief Costruttore
+
+		Apre il file delle pagine, creandolo se non esiste.
+
+		@param path percorso del file
+		@param page_size byte di una pagina (multiplo di 8)
+		@param frames numero di pagine del pool
+
+		@throw std::invalid_argument se i parametri non sono validi
+		@throw bst_io_exception se il file non puo' essere aperto
+		@throw eccezione di allocazione di memoria
+	*/
+	bst_page_pool(const std::string &path, std::size_t page_size, frame_id frames) :
+		_file(nullptr), _path(path), _page_size(page_size), _created(false),
+		_hand(0), _reads(0), _writes(0) { // initialization list
+		if(page_size == 0 || page_size % 8 != 0 || frames == 0)
+			throw std::invalid_argument("bst_page_pool: parametri non validi");
+
+		frame empty = {null_page, 0, false, false};
+		_frames.assign(frames, empty);
+		_data.assign(frames * (page_size / 8), 0);
+
+		_file = std::fopen(path.c_str(), "r+b");
+		if(_file == nullptr) {
+			_file = std::fopen(path.c_str(), "w+b");
+			_created = true;
+		}
+		if(_file == nullptr)
+			throw bst_io_exception("Apertura fallita: ", path);
+	}
+
+	// Il pool e' associato al suo file e non puo' essere copiato
+	bst_page_pool(const bst_page_pool &other) = delete;
+	bst_page_pool &operator=(const bst_page_pool &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Scrive nel file le pagine modificate e chiude il file.
+		Eventuali errori di scrittura vengono ignorati: per gestirli
+		chiamare flush() prima della distruzione.
+	*/
+	~bst_page_pool() {
+		try {
+			flush();
+		}
+		catch(...) {}
+		std::fclose(_file);
+	}
+
+	/**
+		@brief Utilizzo di una pagina del file
+
+		Rende disponibile una pagina del file, leggendola se non
+		e' presente nel pool, e la segna in uso.
+
+		@param id pagina del file
+
+		@return pagina del pool che contiene la pagina del file
+
+		@throw bst_io_exception se la lettura fallisce
+		@throw std::length_error se tutte le pagine del pool sono in uso
+		@throw eccezione di allocazione di memoria
+	*/
+	frame_id pin(page_id id) {
+		std::unordered_map<page_id, frame_id>::const_iterator found = _table.find(id);
+		if(found != _table.end()) {
+			frame &current = _frames[found->second];
+			current.pins++;
+			current.referenced = true;
+			return found->second;
+		}
+
+		frame_id f = victim();
+		seek(id);
+		if(std::fread(data(f), 1, _page_size, _file) != _page_size)
+			throw bst_io_exception("Lettura fallita: ", _path);
+		_reads++;
+		assign(f, id);
+		return f;
+	}
+
+	/**
+		@brief Utilizzo di una nuova pagina del file
+
+		Rende disponibile una pagina del file non ancora scritta,
+		azzerata e senza leggerla, e la segna in uso.
+
+		@param id pagina del file
+
+		@return pagina del pool che contiene la pagina del file
+
+		@throw std::length_error se tutte le pagine del pool sono in uso
+		@throw eccezione di allocazione di memoria
+	*/
+	frame_id pin_new(page_id id) {
+		frame_id f = victim();
+		std::memset(data(f), 0, _page_size);
+		assign(f, id);
+		_frames[f].dirty = true;
+		return f;
+	}
+
+	/**
+		@brief Fine dell'utilizzo di una pagina
+
+		@param f pagina del pool
+		@param dirty true se la pagina e' stata modificata
+	*/
+	void unpin(frame_id f, bool dirty) {
+		_frames[f].pins--;
+		_frames[f].dirty = _frames[f].dirty || dirty;
+	}
+
+	/**
+		@brief Dati di una pagina del pool
+
+		@param f pagina del pool
+
+		@return puntatore ai byte della pagina (allineati a 8 byte)
+	*/
+	char *data(frame_id f) {
+		return reinterpret_cast<char *>(&_data[f * (_page_size / 8)]);
+	}
+
+	/**
+		@brief Scrittura delle pagine modificate
+
+		Scrive nel file tutte le pagine modificate del pool.
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	void flush() {
+		for(frame_id f = 0; f < _frames.size(); ++f)
+			if(_frames[f].id != null_page && _frames[f].dirty)
+				write_frame(f);
+		if(std::fflush(_file) != 0)
+			throw bst_io_exception("Scrittura fallita: ", _path);
+	}
+
+	/**
+		@brief File creato
+
+		@return true se il file non esisteva ed e' stato creato dal pool
+	*/
+	bool created() const {
+		return _created;
+	}
+
+	/**
+		@brief Percorso del file
+
+		@return percorso del file delle pagine
+	*/
+	const std::string &path() const {
+		return _path;
+	}
+
+	/**
+		@brief Numero di pagine del pool
+
+		@return numero di pagine che il pool mantiene in memoria
+	*/
+	frame_id capacity() const {
+		return static_cast<frame_id>(_frames.size());
+	}
+
+	/**
+		@brief Pagine lette
+
+		@return numero di pagine lette dal file
+	*/
+	unsigned long long reads() const {
+		return _reads;
+	}
+
+	/**
+		@brief Pagine scritte
+
+		@return numero di pagine scritte nel file
+	*/
+	unsigned long long writes() const {
+		return _writes;
+	}
+
+}; // class bst_page_pool
+
+/**
+	@brief Albero di ricerca paginato su file
+
+	Classe che implementa un albero di ricerca di dati a dimensione
+	fissa memorizzato in pagine di P byte di un file, per insiemi
+	di dati piu' grandi della memoria disponibile. Le pagine vengono
+	lette e scritte attraverso un bst_page_pool di dimensione limitata.
+
+	Per ridurre le pagine lette a ogni ricerca, ogni pagina contiene
+	molti dati ordinati (B+ tree): le pagine interne contengono
+	le chiavi di separazione e gli indici delle pagine figlie,
+	le pagine foglia contengono i dati e l'indice della foglia
+	successiva, per la visita ordinata e le ricerche per intervallo.
+	Una ricerca legge una pagina per livello: con pagine di 4 KB
+	e dati int, tre livelli contengono centinaia di milioni di dati.
+
+	La pagina 0 del file contiene i metadati dell'albero, che
+	vengono aggiornati da flush() e alla distruzione: riaprendo
+	lo stesso file si ritrova il contenuto dell'albero.
+	La pagina 0 non e' mai una foglia, quindi vale anche come
+	indice di nessuna pagina.
+
+	Come compact_binary_search_tree, l'albero supporta l'inserimento
+	e la ricerca ma non la rimozione. L'iteratore visita i dati
+	in ordine crescente e ne mantiene una copia, perche' le pagine
+	possono essere sostituite nel pool durante la visita.
+
+	@param T tipo dei dati (copiabile byte per byte, allineamento al piu' 8)
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param P byte di una pagina (multiplo di 8)
+*/
+template <typename T, typename O, typename E, unsigned int P = 4096>
+class paged_binary_search_tree {
+
+	typedef unsigned long long size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+	typedef bst_page_pool::page_id page_id; ///< tipo dell'indice di una pagina
+	typedef unsigned int slot_type; ///< tipo della posizione di un dato in una pagina
+
+	/**
+		@brief Intestazione di una pagina
+
+		Struttura di supporto interna all'inizio di ogni pagina dell'albero.
+	*/
+	struct page_header {
+		unsigned short leaf; ///< 1 se la pagina e' una foglia, 0 altrimenti
+		unsigned short count; ///< numero di dati (foglia) o di chiavi (pagina interna)
+		page_id next; ///< foglia successiva (0 se e' l'ultima)
+	};
+
+	/**
+		@brief Metadati dell'albero
+
+		Struttura di supporto interna memorizzata nella pagina 0.
+	*/
+	struct meta {
+		char magic[8]; ///< "BSTPAGE1"
+		unsigned int page_size; ///< byte di una pagina
+		unsigned int value_size; ///< byte di un dato
+		page_id root; ///< pagina radice
+		page_id pages; ///< numero di pagine del file
+		size_type size; ///< numero di dati
+	};
+
+	static const slot_type leaf_capacity = (P - sizeof(page_header)) / sizeof(T); ///< dati in una foglia
+	static const slot_type internal_capacity = (P - sizeof(page_header) - sizeof(page_id) - 8)
+											   / (sizeof(T) + sizeof(page_id)); ///< chiavi in una pagina interna
+	static const std::size_t keys_offset = (sizeof(page_header) + (internal_capacity + 1) * sizeof(page_id) + 7)
+										   / 8 * 8; ///< posizione delle chiavi in una pagina interna
+
+	static_assert(std::is_trivially_copyable<T>::value, "paged_binary_search_tree: T dev'essere copiabile byte per byte");
+	static_assert(alignof(T) <= 8, "paged_binary_search_tree: allineamento di T non supportato");
+	static_assert(P % 8 == 0 && P >= sizeof(meta), "paged_binary_search_tree: dimensione di pagina non valida");
+	static_assert(leaf_capacity >= 2 && internal_capacity >= 3, "paged_binary_search_tree: pagina troppo piccola per T");
+	static_assert(leaf_capacity < 65536, "paged_binary_search_tree: pagina troppo grande per T");
+
+	/**
+		@brief Pagina in uso
+
+		Classe di supporto interna che segna in uso una pagina
+		del pool per la durata della sua vita (RAII).
+	*/
+	class page_ref {
+		bst_page_pool &_pool; ///< pool delle pagine
+		bst_page_pool::frame_id _frame; ///< pagina del pool
+		bool _dirty; ///< true se la pagina e' stata modificata
+
+	public:
+
+		/**
+			@brief Costruttore per una pagina esistente
+
+			@param pool pool delle pagine
+			@param id pagina del file
+		*/
+		page_ref(bst_page_pool &pool, page_id id) :
+			_pool(pool), _frame(pool.pin(id)), _dirty(false) {} // initialization list
+
+		/**
+			@brief Costruttore per una nuova pagina
+
+			@param pool pool delle pagine
+			@param id pagina del file
+			@param leaf true se la pagina e' una foglia
+		*/
+		page_ref(bst_page_pool &pool, page_id id, bool leaf) :
+			_pool(pool), _frame(pool.pin_new(id)), _dirty(true) { // initialization list
+			header().leaf = leaf ? 1 : 0;
+		}
+
+		page_ref(const page_ref &other) = delete;
+		page_ref &operator=(const page_ref &other) = delete;
+
+		/**
+			@brief Distruttore
+
+			Termina l'utilizzo della pagina.
+		*/
+		~page_ref() {
+			_pool.unpin(_frame, _dirty);
+		}
+
+		/**
+			@brief Segna la pagina come modificata
+		*/
+		void touch() {
+			_dirty = true;
+		}
+
+		/**
+			@return intestazione della pagina
+		*/
+		page_header &header() {
+			return *reinterpret_cast<page_header *>(_pool.data(_frame));
+		}
+
+		/**
+			@return primo dato (foglia) o prima chiave (pagina interna)
+		*/
+		T *keys() {
+			char *data = _pool.data(_frame);
+			return reinterpret_cast<T *>(data + (header().leaf ? sizeof(page_header) : keys_offset));
+		}
+
+		/**
+			@return prima pagina figlia (solo pagina interna)
+		*/
+		page_id *children() {
+			return reinterpret_cast<page_id *>(_pool.data(_frame) + sizeof(page_header));
+		}
+
+		/**
+			@return metadati (solo pagina 0)
+		*/
+		meta &metadata() {
+			return *reinterpret_cast<meta *>(_pool.data(_frame));
+		}
+	};
+
+	mutable bst_page_pool _pool; ///< pool delle pagine del file
+	page_id _root; ///< pagina radice
+	page_id _pages; ///< numero di pagine del file
+	size_type _size; ///< numero di dati nell'albero
+	O _order; ///< oggetto funtore per l'ordinamento dei dati
+	E _equals; ///< oggetto funtore per l'uguaglianza dei dati
+
+	/**
+		@brief Pagina piena
+
+		@param p pagina
+
+		@return true se la pagina non puo' ricevere altri dati o chiavi
+	*/
+	static bool full(page_ref &p) {
+		return p.header().count == (p.header().leaf ? leaf_capacity : internal_capacity);
+	}
+
+	/**
+		@brief Figlio di una pagina interna in cui cercare un valore
+
+		Le chiavi di separazione sono i minimi dei figli destri:
+		un valore uguale a una chiave si trova a destra.
+
+		@param p pagina interna
+		@param value valore da cercare
+
+		@return posizione del figlio
+	*/
+	slot_type child_index(page_ref &p, const T &value) const {
+		T *keys = p.keys();
+		return static_cast<slot_type>(std::upper_bound(keys, keys + p.header().count, value, _order) - keys);
+	}
+
+	/**
+		@brief Divisione di una pagina piena
+
+		Funzione privata helper che sposta la meta' superiore
+		di una pagina piena in una nuova pagina e aggiunge
+		la chiave di separazione alla pagina padre (non piena).
+
+		@param parent pagina padre
+		@param i posizione della pagina piena tra i figli del padre
+		@param child pagina piena
+
+		@throw bst_io_exception se l'accesso al file fallisce
+	*/
+	void split_child(page_ref &parent, slot_type i, page_ref &child) {
+		page_id sibling_id = _pages++;
+		page_ref sibling(_pool, sibling_id, child.header().leaf != 0);
+		page_header &c = child.header();
+		page_header &s = sibling.header();
+
+		const T *separator;
+		slot_type mid = c.count / 2;
+		if(c.leaf) {
+			std::copy(child.keys() + mid, child.keys() + c.count, sibling.keys());
+			s.count = static_cast<unsigned short>(c.count - mid);
+			s.next = c.next;
+			c.next = sibling_id;
+			separator = sibling.keys();
+		}
+		else {
+			std::copy(child.keys() + mid + 1, child.keys() + c.count, sibling.keys());
+			std::copy(child.children() + mid + 1, child.children() + c.count + 1, sibling.children());
+			s.count = static_cast<unsigned short>(c.count - mid - 1);
+			separator = child.keys() + mid; // resta nella pagina, oltre i dati validi
+		}
+		c.count = static_cast<unsigned short>(mid);
+
+		page_header &p = parent.header();
+		std::copy_backward(parent.keys() + i, parent.keys() + p.count, parent.keys() + p.count + 1);
+		std::copy_backward(parent.children() + i + 1, parent.children() + p.count + 1, parent.children() + p.count + 2);
+		parent.keys()[i] = *separator;
+		parent.children()[i + 1] = sibling_id;
+		p.count++;
+
+		parent.touch();
+		child.touch();
+	}
+
+	/**
+		@brief Scrittura dei metadati
+
+		@throw bst_io_exception se l'accesso al file fallisce
+	*/
+	void write_meta() {
+		page_ref m(_pool, 0);
+		meta &data = m.metadata();
+		std::memcpy(data.magic, "BSTPAGE1", 8);
+		data.page_size = P;
+		data.value_size = sizeof(T);
+		data.root = _root;
+		data.pages = _pages;
+		data.size = _size;
+		m.touch();
+	}
+
+	/**
+		@brief Foglia piu' a sinistra
+
+		@return foglia che contiene il dato minimo
+	*/
+	page_id leftmost_leaf() const {
+		page_id id = _root;
+		for(;;) {
+			page_ref p(_pool, id);
+			if(p.header().leaf)
+				return id;
+			id = p.children()[0];
+		}
+	}
+
+public:
+
+	/**
+		@brief Iteratore costante dell'albero
+
+		Classe che implementa un iteratore costante di tipo forward
+		che visita i dati dell'albero in ordine crescente.
+	*/
+	class const_iterator {
+		const paged_binary_search_tree *_tree; ///< puntatore all'albero
+		page_id _page; ///< foglia corrente (0 alla fine)
+		slot_type _slot; ///< posizione del dato nella foglia
+		T _value; ///< copia del dato corrente
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun dato.
+		*/
+		const_iterator() : _tree(nullptr), _page(0), _slot(0), _value() {} // initialization list
+
+		// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+		// coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			Operatore di dereferenziamento per l'accesso in lettura dei dati.
+
+			@return dato riferito dall'iteratore costante
+		*/
+		reference operator*() const {
+			return _value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			Operatore di accesso in lettura ai dati.
+
+			@return puntatore al dato riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &_value;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Operatore di iterazione pre-incremento per l'iteratore costante.
+
+			@return reference all'iteratore incrementato
+
+			@throw bst_io_exception se la lettura della foglia fallisce
+		*/
+		const_iterator &operator++() {
+			++_slot;
+			load();
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			Operatore di iterazione post-incremento per l'iteratore costante.
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			Operatore di uguaglianza per l'iteratore costante.
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano allo stesso dato,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (_page == other._page && _slot == other._slot);
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			Operatore di diversita' per l'iteratore costante.
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano a dati diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	private:
+
+		// La classe container (paged_binary_search_tree) dev'essere
+		// dichiarata friend dell'iteratore per concederle l'accesso
+		// al costruttore privato di inizializzazione
+		friend class paged_binary_search_tree;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato di inizializzazione utilizzato
+			dalla classe container.
+
+			@param tree puntatore all'albero
+			@param page foglia (0 per la fine)
+			@param slot posizione del dato nella foglia
+		*/
+		const_iterator(const paged_binary_search_tree *tree, page_id page, slot_type slot) :
+			_tree(tree), _page(page), _slot(slot), _value() { // initialization list
+			load();
+		}
+
+		/**
+			@brief Lettura del dato corrente
+
+			Copia il dato alla posizione corrente, passando alle foglie
+			successive se la posizione e' oltre la fine della foglia.
+		*/
+		void load() {
+			while(_page != 0) {
+				page_ref p(_tree->_pool, _page);
+				if(_slot < p.header().count) {
+					_value = p.keys()[_slot];
+					return;
+				}
+				_page = p.header().next;
+				_slot = 0;
+			}
+		}
+
+	}; // class const_iterator
+
+	/**
+		@brief Costruttore
+
+		Apre l'albero memorizzato in un file, creandolo vuoto
+		se il file non esiste.
+
+		@param path percorso del file
+		@param pool_pages numero di pagine del buffer pool (almeno 4)
+
+		@throw std::invalid_argument se il pool ha meno di 4 pagine
+		@throw bst_io_exception se il file non e' valido o non puo' essere
+			   letto o scritto
+		@throw eccezione di allocazione di memoria
+	*/
+	explicit paged_binary_search_tree(const std::string &path, bst_page_pool::frame_id pool_pages = 1024) :
+		_pool(path, P, pool_pages < 4 ? 0 : pool_pages), _root(1), _pages(2), _size(0) { // initialization list
+		if(_pool.created()) {
+			{ page_ref m(_pool, 0, false); }
+			{ page_ref root(_pool, _root, true); }
+			write_meta();
+			return;
+		}
+
+		page_ref m(_pool, 0);
+		const meta &data = m.metadata();
+		if(std::memcmp(data.magic, "BSTPAGE1", 8) != 0 || data.page_size != P || data.value_size != sizeof(T))
+			throw bst_io_exception("File non valido: ", path);
+		_root = data.root;
+		_pages = data.pages;
+		_size = data.size;
+	}
+
+	// L'albero e' associato al suo file e non puo' essere copiato
+	paged_binary_search_tree(const paged_binary_search_tree &other) = delete;
+	paged_binary_search_tree &operator=(const paged_binary_search_tree &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Scrive nel file i metadati e le pagine modificate.
+		Eventuali errori di scrittura vengono ignorati: per gestirli
+		chiamare flush() prima della distruzione.
+	*/
+	~paged_binary_search_tree() {
+		try {
+			write_meta();
+		}
+		catch(...) {}
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+
+		Inserisce un elemento, se non e' gia' presente, con una sola
+		discesa: un duplicato viene riconosciuto nella foglia. Le pagine
+		piene incontrate durante la discesa vengono divise (anche
+		se il valore e' un duplicato, senza conseguenze sul contenuto),
+		quindi al piu' tre pagine sono in uso contemporaneamente.
+
+		@param value valore dell'elemento da inserire
+
+		@return true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw bst_io_exception se l'accesso al file fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	bool try_insert(const T &value) {
+		{
+			page_ref root(_pool, _root);
+			if(full(root)) {
+				page_id new_root = _pages++;
+				page_ref parent(_pool, new_root, false);
+				parent.children()[0] = _root;
+				split_child(parent, 0, root);
+				_root = new_root;
+			}
+		}
+
+		page_id id = _root;
+		for(;;) {
+			page_ref p(_pool, id);
+			if(p.header().leaf) {
+				T *keys = p.keys();
+				slot_type count = p.header().count;
+				T *position = std::lower_bound(keys, keys + count, value, _order);
+				if(position != keys + count && _equals(*position, value))
+					return false;
+				std::copy_backward(position, keys + count, keys + count + 1);
+				*position = value;
+				p.header().count++;
+				p.touch();
+				break;
+			}
+
+			slot_type i = child_index(p, value);
+			{
+				page_ref child(_pool, p.children()[i]);
+				if(full(child)) {
+					split_child(p, i, child);
+					if(!_order(value, p.keys()[i]))
+						++i;
+				}
+			}
+			id = p.children()[i];
+		}
+
+		_size++;
+		return true;
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw bst_io_exception se l'accesso al file fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		if(!try_insert(value))
+			throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+
+		@throw bst_io_exception se la lettura del file fallisce
+	*/
+	bool exists(const T &value) const {
+		page_id id = _root;
+		for(;;) {
+			page_ref p(_pool, id);
+			if(p.header().leaf) {
+				T *keys = p.keys();
+				T *last = keys + p.header().count;
+				T *position = std::lower_bound(keys, last, value, _order);
+				return position != last && _equals(*position, value);
+			}
+			id = p.children()[child_index(p, value)];
+		}
+	}
+
+	/**
+		@brief Primo elemento non minore di un valore
+
+		@param value valore da cercare
+
+		@return iteratore al primo elemento non minore del valore,
+				end() se non esiste
+
+		@throw bst_io_exception se la lettura del file fallisce
+	*/
+	const_iterator lower_bound(const T &value) const {
+		page_id id = _root;
+		for(;;) {
+			page_ref p(_pool, id);
+			if(p.header().leaf) {
+				T *keys = p.keys();
+				slot_type slot = static_cast<slot_type>(std::lower_bound(keys, keys + p.header().count, value, _order) - keys);
+				return const_iterator(this, id, slot);
+			}
+			id = p.children()[child_index(p, value)];
+		}
+	}
+
+	/**
+		@brief Copia ordinata di un intervallo di valori
+
+		Copia in ordine crescente i valori dell'albero compresi
+		nell'intervallo [low, high) in una sequenza di output,
+		leggendo solo le foglie che lo contengono.
+
+		@param low estremo inferiore (incluso)
+		@param high estremo superiore (escluso)
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw bst_io_exception se la lettura del file fallisce
+	*/
+	template <typename OI>
+	OI copy_range(const T &low, const T &high, OI out) const {
+		for(const_iterator i = lower_bound(low), last = end(); i != last && _order(*i, high); ++i)
+			*out++ = *i;
+		return out;
+	}
+
+	/**
+		@brief Copia ordinata dei valori dell'albero
+
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw bst_io_exception se la lettura del file fallisce
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		for(const_iterator i = begin(), last = end(); i != last; ++i)
+			*out++ = *i;
+		return out;
+	}
+
+	/**
+		@brief Scrittura dell'albero nel file
+
+		Scrive nel file i metadati e tutte le pagine modificate.
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	void flush() {
+		write_meta();
+		_pool.flush();
+	}
+
+	/**
+		@brief Numero totale di dati nell'albero
+
+		@return numero totale di dati nell'albero
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di pagine del file
+
+		@return numero di pagine del file, inclusi i metadati
+	*/
+	page_id page_count() const {
+		return _pages;
+	}
+
+	/**
+		@brief Pagine lette
+
+		@return numero di pagine lette dal file (pagine mancanti nel pool)
+	*/
+	unsigned long long page_reads() const {
+		return _pool.reads();
+	}
+
+	/**
+		@brief Pagine scritte
+
+		@return numero di pagine scritte nel file
+	*/
+	unsigned long long page_writes() const {
+		return _pool.writes();
+	}
+
+	/**
+		@brief Iteratore che punta al dato minimo
+
+		@return iteratore che punta al dato minimo dell'albero
+
+		@throw bst_io_exception se la lettura del file fallisce
+	*/
+	const_iterator begin() const {
+		return const_iterator(this, leftmost_leaf(), 0);
+	}
+
+	/**
+		@brief Iteratore che punta alla fine dell'albero
+
+		@return iteratore che punta alla fine dell'albero
+	*/
+	const_iterator end() const {
+		return const_iterator(this, 0, 0);
+	}
+
+}; // class paged_binary_search_tree
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa
+	in ordine crescente del contenuto dell'albero.
+
+	@param os oggetto stream di output
+	@param tree albero da stampare
+
+	@return reference allo stream di output
+*/
+template <typename T, typename O, typename E, unsigned int P>
+std::ostream &operator<<(std::ostream &os, const paged_binary_search_tree<T, O, E, P> &tree) {
+	os << "[";
+	bool first = true;
+	typename paged_binary_search_tree<T, O, E, P>::const_iterator i, last;
+	for(i = tree.begin(), last = tree.end(); i != last; ++i) {
+		if(!first)
+			os << ", ";
+		os << *i;
+		first = false;
+	}
+	os << "]";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstpaged.h
@@ -0,0 +1,560 @@
+/**
+	@file bstsharded.h
+
+	@brief Dichiarazione e definizione della classe sharded_bst
+*/
+
+// Guardie del file header
+
+#ifndef BSTSHARDED_H
+#define BSTSHARDED_H
+
+// Direttive per il pre-compilatore
+
+#include <vector> // std::vector
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::unique_lock, std::lock_guard
+#include <atomic> // std::atomic
+#include <algorithm> // std::upper_bound
+#include <iterator> // std::back_inserter, std::forward_iterator_tag
+#include <cstddef> // ptrdiff_t
+#include <utility> // std::move
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Albero binario di ricerca partizionato per intervalli di chiavi
+
+	Classe che implementa un insieme di dati generici T accessibile
+	da piu' thread contemporaneamente. Lo spazio dei valori e' diviso
+	da punti di separazione ordinati in intervalli, ognuno gestito da un
+	binary_search_tree indipendente (shard) protetto dal proprio mutex:
+	thread che lavorano su intervalli diversi non si contendono ne'
+	i nodi alti di un'unica radice ne' un unico lock.
+
+	I punti di separazione vengono ricalcolati automaticamente
+	(ribilanciamento) quando uno shard supera il doppio della dimensione
+	media degli shard all'ultimo ribilanciamento: i valori vengono
+	ridistribuiti in shard di uguale dimensione. Il costo del
+	ribilanciamento, lineare nel numero di valori, e' ammortizzato
+	sugli inserimenti che lo hanno causato. Durante il ribilanciamento
+	tutti gli shard sono bloccati.
+
+	Le tabelle dei punti di separazione sono immutabili e vengono
+	pubblicate con un puntatore atomico, quindi l'instradamento di una
+	ricerca non richiede lock condivisi; le tabelle sostituite restano
+	allocate (sono piccole) fino alla distruzione dell'albero.
+
+	La visita ordinata e le ricerche per intervallo bloccano uno shard
+	alla volta: ogni shard viene visto in uno stato consistente e
+	nessun ribilanciamento puo' avvenire durante la visita, ma
+	gli inserimenti concorrenti negli shard non ancora visitati
+	possono essere inclusi. Per una visita con iteratori si usa
+	sorted_view, che blocca tutti gli shard finche' esiste.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, typename O, typename E>
+class sharded_bst {
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+	typedef binary_search_tree<T, O, E> tree_type; ///< tipo degli alberi degli shard
+
+	static const size_type min_shard_limit = 256; ///< dimensione minima che provoca un ribilanciamento
+
+	/**
+		@brief Shard dell'albero
+
+		Struttura che contiene un albero e il mutex che lo protegge.
+		Il riempimento separa shard consecutivi su linee di cache
+		diverse, per evitare false condivisioni tra i thread.
+	*/
+	struct shard {
+		std::mutex lock; ///< mutex dello shard
+		tree_type tree; ///< albero dello shard
+		char padding[64]; ///< riempimento fino alla linea di cache successiva
+	};
+
+	/**
+		@brief Tabella di instradamento
+
+		Struttura immutabile con i punti di separazione degli shard:
+		lo shard i contiene i valori v tali che !(v < splits[i - 1])
+		e v < splits[i].
+	*/
+	struct routing {
+		std::vector<T> splits; ///< punti di separazione ordinati
+		size_type limit; ///< dimensione di uno shard che provoca un ribilanciamento
+	};
+
+	std::unique_ptr<shard[]> _shards; ///< shard dell'albero
+	size_type _shard_count; ///< numero di shard
+	std::atomic<const routing *> _routing; ///< tabella di instradamento corrente
+	std::vector<std::unique_ptr<routing> > _tables; ///< tabelle di instradamento allocate
+	mutable std::mutex _rebalance_lock; ///< mutex che esclude i ribilanciamenti
+	O _order; ///< oggetto funtore per l'ordinamento
+
+	/**
+		@brief Blocco dello shard di un valore
+
+		Funzione privata helper che individua lo shard a cui appartiene
+		un valore e ne acquisisce il lock. Se nel frattempo un
+		ribilanciamento ha cambiato la tabella di instradamento,
+		il lock viene rilasciato e l'instradamento ripetuto.
+
+		@param value valore da instradare
+		@param guard lock da associare al mutex dello shard
+		@param index indice dello shard bloccato
+
+		@return tabella di instradamento valida finche' il lock e' tenuto
+	*/
+	const routing *lock_owner(const T &value, std::unique_lock<std::mutex> &guard, size_type &index) const {
+		for(;;) {
+			const routing *r = _routing.load(std::memory_order_acquire);
+			index = std::upper_bound(r->splits.begin(), r->splits.end(), value, _order) - r->splits.begin();
+			guard = std::unique_lock<std::mutex>(_shards[index].lock);
+			if(_routing.load(std::memory_order_acquire) == r)
+				return r;
+			guard.unlock();
+		}
+	}
+
+	/**
+		@brief Ribilanciamento degli shard
+
+		Funzione privata helper che, se uno shard supera ancora il limite
+		della tabella corrente, ricalcola i punti di separazione ai quantili
+		dei valori e ridistribuisce i valori in alberi bilanciati.
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void rebalance() {
+		std::lock_guard<std::mutex> rebalancing(_rebalance_lock);
+		std::vector<std::unique_lock<std::mutex> > guards;
+		for(size_type i = 0; i < _shard_count; ++i)
+			guards.push_back(std::unique_lock<std::mutex>(_shards[i].lock));
+
+		const routing *current = _routing.load(std::memory_order_relaxed);
+		bool skewed = false;
+		size_type total = 0;
+		for(size_type i = 0; i < _shard_count; ++i) {
+			skewed = skewed || _shards[i].tree.size() > current->limit;
+			total += _shards[i].tree.size();
+		}
+		if(!skewed)
+			return; // gia' ribilanciato da un altro thread
+
+		// Gli shard sono ordinati, quindi la concatenazione e' ordinata
+		std::vector<T> values;
+		values.reserve(total);
+		for(size_type i = 0; i < _shard_count; ++i)
+			_shards[i].tree.copy_in_order(std::back_inserter(values));
+
+		std::unique_ptr<routing> next(new routing);
+		for(size_type i = 1; i < _shard_count; ++i)
+			next->splits.push_back(values[static_cast<unsigned long long>(total) * i / _shard_count]);
+		next->limit = 2 * total / _shard_count;
+		if(next->limit < min_shard_limit)
+			next->limit = min_shard_limit;
+
+		std::vector<tree_type> trees(_shard_count);
+		for(size_type i = 0; i < _shard_count; ++i)
+			trees[i].insert_batch(values.begin() + static_cast<unsigned long long>(total) * i / _shard_count,
+								  values.begin() + static_cast<unsigned long long>(total) * (i + 1) / _shard_count);
+
+		_tables.push_back(std::move(next));
+		for(size_type i = 0; i < _shard_count; ++i)
+			_shards[i].tree.swap(trees[i]);
+		_routing.store(_tables.back().get(), std::memory_order_release);
+	}
+
+public:
+
+	/**
+		@brief Costruttore
+
+		Costruttore per istanziare un albero vuoto con il numero di shard
+		indicato. Fino al primo ribilanciamento tutti i valori vengono
+		inseriti nel primo shard.
+
+		@param shards numero di shard (almeno 1)
+
+		@throw eccezione di allocazione di memoria
+	*/
+	explicit sharded_bst(size_type shards = 16) :
+		_shards(new shard[shards == 0 ? 1 : shards]), _shard_count(shards == 0 ? 1 : shards),
+		_routing(nullptr) { // initialization list
+		_tables.push_back(std::unique_ptr<routing>(new routing));
+		_tables.back()->limit = min_shard_limit;
+		_routing.store(_tables.back().get());
+	}
+
+	// L'albero contiene dei mutex e non puo' essere copiato
+	sharded_bst(const sharded_bst &other) = delete;
+	sharded_bst &operator=(const sharded_bst &other) = delete;
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Inserisce un elemento nello shard a cui appartiene.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		if(!try_insert(value))
+			throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+
+		Inserisce un elemento nello shard a cui appartiene, se non e' gia'
+		presente, e ribilancia gli shard se lo shard e' diventato troppo grande.
+
+		@param value valore dell'elemento da inserire
+
+		@return true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	bool try_insert(const T &value) {
+		std::unique_lock<std::mutex> guard;
+		size_type index;
+		const routing *r = lock_owner(value, guard, index);
+
+		bool inserted = _shards[index].tree.try_insert(value).second;
+		bool skewed = _shards[index].tree.size() > r->limit;
+		guard.unlock();
+
+		if(skewed)
+			rebalance();
+		return inserted;
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Controlla se esiste un elemento di tipo T nello shard
+		a cui appartiene.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) const {
+		std::unique_lock<std::mutex> guard;
+		size_type index;
+		lock_owner(value, guard, index);
+		return _shards[index].tree.exists(value);
+	}
+
+	/**
+		@brief Numero totale di dati nell'albero
+
+		@return numero totale di dati nell'albero
+	*/
+	size_type size() const {
+		size_type total = 0;
+		for(size_type i = 0; i < _shard_count; ++i) {
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			total += _shards[i].tree.size();
+		}
+		return total;
+	}
+
+	/**
+		@brief Numero di shard
+
+		@return numero di shard dell'albero
+	*/
+	size_type shard_count() const {
+		return _shard_count;
+	}
+
+	/**
+		@brief Numero di dati in uno shard
+
+		@param index indice dello shard (minore di shard_count())
+
+		@return numero di dati nello shard
+	*/
+	size_type shard_size(size_type index) const {
+		std::lock_guard<std::mutex> guard(_shards[index].lock);
+		return _shards[index].tree.size();
+	}
+
+	/**
+		@brief Copia ordinata dei valori dell'albero
+
+		Copia i valori di tutti gli shard in ordine crescente
+		in una sequenza di output.
+
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		std::lock_guard<std::mutex> rebalancing(_rebalance_lock);
+		for(size_type i = 0; i < _shard_count; ++i) {
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			out = _shards[i].tree.copy_in_order(out);
+		}
+		return out;
+	}
+
+	/**
+		@brief Iteratore costante di tipo forward dei valori in ordine
+
+		Iteratore a sola lettura (costante) che concatena le visite
+		ordinate degli shard: gli shard partizionano lo spazio dei valori
+		in intervalli ordinati, quindi la concatenazione e' ordinata.
+		E' valido solo finche' esiste la vista che lo ha creato.
+	*/
+	class const_iterator {
+		const shard *_shards; ///< shard dell'albero
+		size_type _index; ///< indice dello shard corrente (_count alla fine)
+		size_type _count; ///< numero di shard
+		typename tree_type::const_sorted_iterator _i; ///< iteratore ordinato dello shard corrente
+
+		friend class sharded_bst;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato per istanziare un iteratore al primo valore
+			di uno shard, o del primo shard successivo non vuoto.
+			Usato dalla classe sharded_bst.
+
+			@param shards shard dell'albero
+			@param index indice dello shard
+			@param count numero di shard
+		*/
+		const_iterator(const shard *shards, size_type index, size_type count) :
+			_shards(shards), _index(index), _count(count) { // initialization list
+			if(_index < _count) {
+				_i = _shards[_index].tree.sorted_begin();
+				skip_empty();
+			}
+		}
+
+		/**
+			@brief Salto degli shard esauriti
+
+			Funzione privata helper che passa al primo valore del primo
+			shard successivo non vuoto, se lo shard corrente e' esaurito.
+		*/
+		void skip_empty() {
+			while(_i == _shards[_index].tree.sorted_end() && ++_index < _count)
+				_i = _shards[_index].tree.sorted_begin();
+		}
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef T                         value_type; ///< tipo dei dati puntati: T
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const T*                  pointer; ///< tipo di puntatore (costante) ai dati: const T*
+		typedef const T&                  reference; ///< tipo di riferimento (costante) dei dati: const T&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun elemento.
+		*/
+		const_iterator() : _shards(nullptr), _index(0), _count(0) {} // initialization list
+
+		// Il costruttore di copia, l'operatore di assegnamento
+		// e il distruttore coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return dato riferito dall'iteratore
+		*/
+		reference operator*() const {
+			return *_i;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			@return puntatore al dato riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &*_i;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			++_i;
+			skip_empty();
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori puntano allo stesso dato,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return _index == other._index && _i == other._i;
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other non sono uguali,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	}; // class const_iterator
+
+	/**
+		@brief Vista ordinata dell'albero
+
+		Classe che blocca il ribilanciamento e tutti gli shard
+		(nello stesso ordine di rebalance, quindi senza stalli)
+		finche' esiste, e permette di visitare i valori in ordine
+		crescente con un const_iterator. Mentre la vista esiste
+		gli altri thread non possono modificare l'albero, e il thread
+		che la possiede non deve chiamare altri metodi dell'albero.
+	*/
+	class view {
+		const sharded_bst *_tree; ///< albero visitato
+		std::unique_lock<std::mutex> _rebalancing; ///< lock del ribilanciamento
+		std::vector<std::unique_lock<std::mutex> > _guards; ///< lock degli shard
+
+		friend class sharded_bst;
+
+		/**
+			@brief Costruttore privato
+
+			Costruttore privato che blocca l'albero.
+			Usato dalla classe sharded_bst.
+
+			@param tree albero da visitare
+
+			@throw eccezione di allocazione di memoria
+		*/
+		explicit view(const sharded_bst &tree) : _tree(&tree), _rebalancing(tree._rebalance_lock) { // initialization list
+			_guards.reserve(tree._shard_count);
+			for(size_type i = 0; i < tree._shard_count; ++i)
+				_guards.push_back(std::unique_lock<std::mutex>(tree._shards[i].lock));
+		}
+
+	public:
+
+		// La vista puo' essere spostata ma non copiata:
+		// il costruttore di spostamento e il distruttore
+		// coincidono con quelli di default
+
+		/**
+			@brief Iteratore all'inizio della visita
+
+			@return iteratore al valore minimo dell'albero
+		*/
+		const_iterator begin() const {
+			return const_iterator(_tree->_shards.get(), 0, _tree->_shard_count);
+		}
+
+		/**
+			@brief Iteratore alla fine della visita
+
+			@return iteratore alla fine della visita
+		*/
+		const_iterator end() const {
+			return const_iterator(_tree->_shards.get(), _tree->_shard_count, _tree->_shard_count);
+		}
+
+	}; // class view
+
+	/**
+		@brief Vista ordinata dei valori dell'albero
+
+		Blocca l'albero e ne restituisce una vista, da cui ottenere
+		gli iteratori della visita ordinata. L'albero resta bloccato
+		finche' la vista non viene distrutta.
+
+		@return vista ordinata dell'albero
+
+		@throw eccezione di allocazione di memoria
+	*/
+	view sorted_view() const {
+		return view(*this);
+	}
+
+	/**
+		@brief Copia ordinata dei valori di un intervallo
+
+		Copia in ordine crescente in una sequenza di output i valori
+		compresi nell'intervallo [low, high), visitando solo gli shard
+		che si sovrappongono all'intervallo.
+
+		@param low estremo inferiore dell'intervallo (incluso)
+		@param high estremo superiore dell'intervallo (escluso)
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_range(const T &low, const T &high, OI out) const {
+		std::lock_guard<std::mutex> rebalancing(_rebalance_lock);
+		const routing *r = _routing.load(std::memory_order_acquire);
+
+		size_type first = std::upper_bound(r->splits.begin(), r->splits.end(), low, _order) - r->splits.begin();
+		for(size_type i = first; i <= r->splits.size(); ++i) {
+			if(i > first && !_order(r->splits[i - 1], high))
+				break; // shard successivi oltre l'intervallo
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			out = _shards[i].tree.copy_range(low, high, out);
+		}
+		return out;
+	}
+
+}; // class sharded_bst
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstsharded.h
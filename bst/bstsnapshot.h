@@ -0,0 +1,536 @@
+/**
+	@file bstsnapshot.h
+
+	@brief Dichiarazione e definizione della classe compressed_int_snapshot
+*/
+
+// Guardie del file header
+
+#ifndef BSTSNAPSHOT_H
+#define BSTSNAPSHOT_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <cstddef> // std::size_t, ptrdiff_t
+#include <vector> // std::vector
+#include <algorithm> // std::upper_bound, std::lower_bound, std::fill
+#include <iterator> // std::forward_iterator_tag, std::back_inserter
+#include <stdexcept> // std::invalid_argument
+#include "bst.h" // binary_search_tree
+
+#ifdef __SSE2__
+#include <emmintrin.h> // _mm_add_epi32, _mm_slli_si128, _mm_shuffle_epi32
+#endif
+
+/**
+	@brief Istantanea compressa di un insieme di interi
+
+	Classe immutabile che memorizza in forma compressa un insieme
+	ordinato di int, ad esempio il contenuto di un bst_int usato solo
+	per ricerche occasionali.
+
+	I valori ordinati sono divisi in blocchi di 128: per ogni blocco
+	vengono memorizzati il primo valore e le 127 differenze tra valori
+	consecutivi (meno 1), impacchettate con il numero minimo di bit
+	sufficiente per la differenza maggiore del blocco (frame of reference
+	con bit-packing). I primi valori dei blocchi formano l'indice
+	in cui una ricerca binaria trova l'unico blocco da decodificare.
+	Con chiavi dense servono pochi bit per valore, con chiavi casuali
+	sull'intero intervallo degli int circa 32 - log2(n) + 1.
+
+	La decodifica di un blocco (lower_bound, copy_in_order) estrae
+	le differenze e ne calcola le somme prefisse, quattro alla volta
+	con istruzioni SSE2 quando sono disponibili; exists somma invece
+	le differenze solo fino al valore cercato.
+*/
+class compressed_int_snapshot {
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati nell'istantanea
+
+	static const size_type block_size = 128; ///< valori in un blocco
+
+	std::vector<unsigned int> _firsts; ///< primo valore (traslato) di ogni blocco
+	std::vector<unsigned int> _offsets; ///< posizione in _words delle differenze di ogni blocco
+	std::vector<unsigned char> _widths; ///< bit per differenza di ogni blocco
+	std::vector<unsigned int> _words; ///< differenze impacchettate (con una parola di margine)
+	size_type _size; ///< numero di valori
+
+	/**
+		@brief Traslazione di un int
+
+		Trasforma un int in un unsigned con lo stesso ordinamento.
+
+		@param value valore
+
+		@return valore traslato
+	*/
+	static unsigned int shift(int value) {
+		return static_cast<unsigned int>(value) ^ 0x80000000U;
+	}
+
+	/**
+		@brief Traslazione inversa
+
+		@param value valore traslato
+
+		@return int corrispondente
+	*/
+	static int unshift(unsigned int value) {
+		return static_cast<int>(value ^ 0x80000000U);
+	}
+
+	/**
+		@brief Numero di valori di un blocco
+
+		@param block indice del blocco
+
+		@return numero di valori del blocco
+	*/
+	size_type block_count(size_type block) const {
+		size_type remaining = _size - block * block_size;
+		return remaining < block_size ? remaining : block_size;
+	}
+
+	/**
+		@brief Differenza tra due valori consecutivi di un blocco
+
+		@param block indice del blocco
+		@param i posizione della differenza (tra il valore i e il valore i + 1)
+
+		@return differenza meno 1
+	*/
+	unsigned int delta(size_type block, size_type i) const {
+		unsigned int width = _widths[block];
+		if(width == 0)
+			return 0;
+		unsigned long long bit = static_cast<unsigned long long>(i) * width;
+		const unsigned int *words = &_words[_offsets[block] + (bit >> 5)];
+		unsigned long long pair = words[0] | (static_cast<unsigned long long>(words[1]) << 32);
+		return static_cast<unsigned int>((pair >> (bit & 31)) & ((1ULL << width) - 1));
+	}
+
+	/**
+		@brief Decodifica di un blocco
+
+		Funzione privata helper che ricostruisce i valori (traslati)
+		di un blocco sommando le differenze al primo valore.
+
+		@param block indice del blocco
+		@param out array di almeno block_size valori
+
+		@return numero di valori del blocco
+	*/
+	size_type decode(size_type block, unsigned int *out) const {
+		size_type count = block_count(block);
+		out[0] = _firsts[block];
+
+		unsigned int width = _widths[block];
+		if(width == 0) // valori consecutivi, nessuna parola memorizzata
+			std::fill(out + 1, out + count, 1U);
+		else {
+			const unsigned int *words = &_words[_offsets[block]];
+			unsigned long long mask = (1ULL << width) - 1;
+			unsigned int bit = 0;
+			for(size_type i = 1; i < count; ++i, bit += width) {
+				unsigned long long pair = words[bit >> 5] | (static_cast<unsigned long long>(words[(bit >> 5) + 1]) << 32);
+				out[i] = static_cast<unsigned int>((pair >> (bit & 31)) & mask) + 1;
+			}
+		}
+
+		size_type i = 1;
+#ifdef __SSE2__
+		// Somme prefisse di quattro differenze per volta, piu' il valore precedente
+		__m128i carry = _mm_set1_epi32(static_cast<int>(out[0]));
+		for(; i + 4 <= count; i += 4) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(out + i));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi32(x, carry);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), x);
+			carry = _mm_shuffle_epi32(x, 0xff);
+		}
+#endif
+		for(; i < count; ++i)
+			out[i] += out[i - 1];
+
+		return count;
+	}
+
+	/**
+		@brief Blocco che puo' contenere un valore
+
+		@param value valore traslato
+
+		@return indice dell'ultimo blocco con primo valore non maggiore
+				del valore, oppure 0 se il valore precede tutti i blocchi
+	*/
+	size_type find_block(unsigned int value) const {
+		std::vector<unsigned int>::const_iterator i = std::upper_bound(_firsts.begin(), _firsts.end(), value);
+		return (i == _firsts.begin()) ? 0 : static_cast<size_type>(i - _firsts.begin() - 1);
+	}
+
+	/**
+		@brief Costruzione dell'istantanea
+
+		Funzione privata helper che comprime una sequenza ordinata di valori.
+
+		@param values valori in ordine strettamente crescente
+
+		@throw std::invalid_argument se i valori non sono in ordine
+			   strettamente crescente
+		@throw eccezione di allocazione di memoria
+	*/
+	void build(const std::vector<int> &values) {
+		for(std::size_t i = 1; i < values.size(); ++i)
+			if(!(values[i - 1] < values[i]))
+				throw std::invalid_argument("compressed_int_snapshot: valori non in ordine strettamente crescente");
+
+		_size = static_cast<size_type>(values.size());
+		for(std::size_t start = 0; start < values.size(); start += block_size) {
+			std::size_t end = std::min(start + block_size, values.size());
+			unsigned int max_delta = 0;
+			for(std::size_t i = start + 1; i < end; ++i)
+				max_delta = std::max(max_delta, shift(values[i]) - shift(values[i - 1]) - 1);
+			unsigned int width = 0;
+			while(width < 32 && (max_delta >> width) != 0)
+				++width;
+
+			_firsts.push_back(shift(values[start]));
+			_offsets.push_back(static_cast<unsigned int>(_words.size()));
+			_widths.push_back(static_cast<unsigned char>(width));
+
+			unsigned long long buffer = 0; // bit non ancora scritti
+			unsigned int bits = 0;
+			for(std::size_t i = start + 1; i < end && width > 0; ++i) {
+				buffer |= static_cast<unsigned long long>(shift(values[i]) - shift(values[i - 1]) - 1) << bits;
+				bits += width;
+				if(bits >= 32) {
+					_words.push_back(static_cast<unsigned int>(buffer));
+					buffer >>= 32;
+					bits -= 32;
+				}
+			}
+			if(bits > 0)
+				_words.push_back(static_cast<unsigned int>(buffer));
+		}
+		_words.push_back(0); // margine per la lettura di due parole in delta()
+
+		_firsts.shrink_to_fit();
+		_offsets.shrink_to_fit();
+		_widths.shrink_to_fit();
+		_words.shrink_to_fit();
+	}
+
+public:
+
+	/**
+		@brief Iteratore costante dell'istantanea
+
+		Classe che implementa un iteratore costante di tipo forward
+		che visita i valori in ordine crescente, decodificando
+		una differenza per passo.
+	*/
+	class const_iterator {
+		const compressed_int_snapshot *_snapshot; ///< puntatore all'istantanea
+		size_type _block; ///< blocco corrente
+		size_type _slot; ///< posizione nel blocco
+		int _value; ///< valore corrente
+
+	public:
+		typedef std::forward_iterator_tag iterator_category; ///< categoria dell'iteratore: forward
+		typedef int                       value_type; ///< tipo dei dati puntati: int
+		typedef ptrdiff_t                 difference_type; ///< tipo della differenza tra iteratori: ptrdiff_t
+		typedef const int*                pointer; ///< tipo di puntatore (costante) ai dati: const int*
+		typedef const int&                reference; ///< tipo di riferimento (costante) dei dati: const int&
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un iteratore costante
+			che non punta a nessun valore.
+		*/
+		const_iterator() : _snapshot(nullptr), _block(0), _slot(0), _value(0) {} // initialization list
+
+		// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+		// coincidono con quelli di default
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return valore riferito dall'iteratore costante
+		*/
+		reference operator*() const {
+			return _value;
+		}
+
+		/**
+			@brief Operatore di accesso ai dati
+
+			@return puntatore al valore riferito dall'iteratore
+		*/
+		pointer operator->() const {
+			return &_value;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return reference all'iteratore incrementato
+		*/
+		const_iterator &operator++() {
+			if(++_slot < _snapshot->block_count(_block))
+				_value = unshift(shift(_value) + _snapshot->delta(_block, _slot - 1) + 1);
+			else {
+				++_block;
+				_slot = 0;
+				if(_block < _snapshot->_firsts.size())
+					_value = unshift(_snapshot->_firsts[_block]);
+			}
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@param int parametro fittizio per distinguere l'operatore
+				   di post-incremento da quello di pre-incremento
+
+			@return copia dell'iteratore prima di essere incrementato
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano allo stesso valore,
+					false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (_block == other._block && _slot == other._slot);
+		}
+
+		/**
+			@brief Operatore di diversita'
+
+			@param other iteratore da confrontare con this
+
+			@return true se gli iteratori this e other puntano a valori diversi,
+					false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	private:
+
+		// La classe container (compressed_int_snapshot) dev'essere
+		// dichiarata friend dell'iteratore per concederle l'accesso
+		// al costruttore privato di inizializzazione
+		friend class compressed_int_snapshot;
+
+		/**
+			@brief Costruttore privato
+
+			@param snapshot puntatore all'istantanea
+			@param block blocco
+			@param slot posizione nel blocco
+			@param value valore alla posizione
+		*/
+		const_iterator(const compressed_int_snapshot *snapshot, size_type block, size_type slot, int value) :
+			_snapshot(snapshot), _block(block), _slot(slot), _value(value) {} // initialization list
+
+	}; // class const_iterator
+
+	/**
+		@brief Costruttore da una sequenza ordinata
+
+		@param first iteratore input al primo valore
+		@param last iteratore input alla fine della sequenza
+
+		@throw std::invalid_argument se i valori non sono in ordine
+			   strettamente crescente
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename I>
+	compressed_int_snapshot(I first, I last) : _size(0) { // initialization list
+		build(std::vector<int>(first, last));
+	}
+
+	/**
+		@brief Costruttore da un albero
+
+		Comprime il contenuto di un albero di int, che dev'essere
+		ordinato secondo l'operatore < degli int (come bst_int).
+
+		@param tree albero da comprimere
+
+		@throw std::invalid_argument se l'ordinamento dell'albero non e'
+			   quello crescente degli int
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename O, typename E>
+	explicit compressed_int_snapshot(const binary_search_tree<int, O, E> &tree) : _size(0) { // initialization list
+		std::vector<int> values;
+		values.reserve(tree.size());
+		tree.copy_in_order(std::back_inserter(values));
+		build(values);
+	}
+
+	// Il costruttore di copia, l'operatore di assegnamento e il distruttore
+	// coincidono con quelli di default
+
+	/**
+		@brief Numero totale di valori
+
+		@return numero totale di valori nell'istantanea
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Memoria occupata
+
+		@return numero di byte dell'istantanea, inclusi indice e oggetto
+	*/
+	std::size_t memory_usage() const {
+		return sizeof(*this) + (_firsts.capacity() + _offsets.capacity() + _words.capacity()) * sizeof(unsigned int)
+			   + _widths.capacity();
+	}
+
+	/**
+		@brief Controllo di esistenza di un valore
+
+		Scorre il solo blocco che puo' contenere il valore,
+		fermandosi al primo valore non minore.
+
+		@param value valore da cercare
+
+		@return true se esiste il valore, false altrimenti
+	*/
+	bool exists(int value) const {
+		if(_size == 0)
+			return false;
+
+		unsigned int key = shift(value);
+		size_type block = find_block(key);
+		if(key < _firsts[block])
+			return false;
+
+		// Somma le differenze solo fino al valore cercato
+		size_type count = block_count(block);
+		unsigned int width = _widths[block];
+		unsigned int current = _firsts[block];
+		if(width == 0) // valori consecutivi
+			return key - current < count;
+		const unsigned int *words = &_words[_offsets[block]];
+		unsigned long long mask = (1ULL << width) - 1;
+		unsigned int bit = 0;
+		for(size_type i = 1; i < count && current < key; ++i, bit += width) {
+			unsigned long long pair = words[bit >> 5] | (static_cast<unsigned long long>(words[(bit >> 5) + 1]) << 32);
+			current += static_cast<unsigned int>((pair >> (bit & 31)) & mask) + 1;
+		}
+		return current == key;
+	}
+
+	/**
+		@brief Primo valore non minore di un valore
+
+		@param value valore da cercare
+
+		@return iteratore al primo valore non minore di value,
+				end() se non esiste
+	*/
+	const_iterator lower_bound(int value) const {
+		if(_size == 0)
+			return end();
+
+		unsigned int key = shift(value);
+		size_type block = find_block(key);
+		unsigned int values[block_size];
+		size_type count = decode(block, values);
+		size_type slot = static_cast<size_type>(std::lower_bound(values, values + count, key) - values);
+
+		if(slot < count)
+			return const_iterator(this, block, slot, unshift(values[slot]));
+		if(block + 1 < _firsts.size())
+			return const_iterator(this, block + 1, 0, unshift(_firsts[block + 1]));
+		return end();
+	}
+
+	/**
+		@brief Copia ordinata dei valori
+
+		Copia i valori in ordine crescente in una sequenza di output,
+		decodificando un blocco alla volta.
+
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		unsigned int values[block_size];
+		for(size_type block = 0; block < _firsts.size(); ++block) {
+			size_type count = decode(block, values);
+			for(size_type i = 0; i < count; ++i)
+				*out++ = unshift(values[i]);
+		}
+		return out;
+	}
+
+	/**
+		@brief Iteratore che punta al valore minimo
+
+		@return iteratore che punta al valore minimo
+	*/
+	const_iterator begin() const {
+		return _size == 0 ? end() : const_iterator(this, 0, 0, unshift(_firsts[0]));
+	}
+
+	/**
+		@brief Iteratore che punta alla fine dell'istantanea
+
+		@return iteratore che punta alla fine dell'istantanea
+	*/
+	const_iterator end() const {
+		return const_iterator(this, static_cast<size_type>(_firsts.size()), 0, 0);
+	}
+
+}; // class compressed_int_snapshot
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa
+	in ordine crescente del contenuto dell'istantanea.
+
+	@param os oggetto stream di output
+	@param snapshot istantanea da stampare
+
+	@return reference allo stream di output
+*/
+inline std::ostream &operator<<(std::ostream &os, const compressed_int_snapshot &snapshot) {
+	os << "[";
+	for(compressed_int_snapshot::const_iterator i = snapshot.begin(), last = snapshot.end(); i != last; ++i) {
+		if(i != snapshot.begin())
+			os << ", ";
+		os << *i;
+	}
+	os << "]";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstsnapshot.h
@@ -0,0 +1,219 @@
+/**
+	@file bstsplay.h
+
+	@brief Dichiarazione e definizione della classe splay_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTSPLAY_H
+#define BSTSPLAY_H
+
+// Direttive per il pre-compilatore
+
+#include "bst.h" // binary_search_tree
+
+/**
+	@brief Albero binario di ricerca auto-aggiustante (splay tree)
+
+	Classe che implementa un albero binario di ricerca di dati generici T
+	che, dopo ogni accesso, sposta il nodo acceduto alla radice tramite
+	una sequenza di rotazioni (splay). Gli elementi acceduti di recente
+	restano vicini alla radice: con accessi molto sbilanciati verso pochi
+	valori, questi vengono trovati in tempo quasi costante, mentre il costo
+	ammortizzato di ogni operazione resta O(log n).
+
+	ATTENZIONE: le ricerche (exists, find) modificano la struttura
+	dell'albero e per questo non sono metodi const. Su uno splay_tree
+	costante sono disponibili solo gli iteratori e size.
+	Le rotazioni non cambiano l'ordine dei valori, ma cambiano l'ordine
+	di visita dell'iteratore (che parte dalla radice).
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, typename O, typename E>
+class splay_tree : public binary_search_tree<T, O, E> {
+
+	typedef binary_search_tree<T, O, E> base; ///< tipo dell'albero di base
+	typedef typename base::node node; ///< tipo dei nodi dell'albero
+
+	/**
+		@brief Rotazione di un nodo
+
+		Funzione privata helper che ruota un nodo sopra suo padre,
+		mantenendo l'ordinamento dei valori.
+
+		@param n puntatore al nodo da ruotare (deve avere un padre)
+	*/
+	void rotate(node *n) {
+		node *parent = n->parent;
+		node *grandparent = parent->parent;
+
+		if(n == parent->left) {
+			parent->left = n->right;
+			if(n->right != nullptr)
+				n->right->parent = parent;
+			n->right = parent;
+		}
+		else {
+			parent->right = n->left;
+			if(n->left != nullptr)
+				n->left->parent = parent;
+			n->left = parent;
+		}
+
+		parent->parent = n;
+		n->parent = grandparent;
+
+		if(grandparent == nullptr)
+			this->_root = n;
+		else
+			if(grandparent->left == parent)
+				grandparent->left = n;
+			else
+				grandparent->right = n;
+	}
+
+	/**
+		@brief Spostamento di un nodo alla radice
+
+		Funzione privata helper che porta un nodo alla radice
+		con i passi zig, zig-zig e zig-zag.
+
+		@param n puntatore al nodo da spostare alla radice
+	*/
+	void splay(node *n) {
+		while(n->parent != nullptr) {
+			node *parent = n->parent;
+			node *grandparent = parent->parent;
+
+			if(grandparent != nullptr) {
+				if((n == parent->left) == (parent == grandparent->left))
+					rotate(parent); // zig-zig
+				else
+					rotate(n); // zig-zag
+			}
+			rotate(n); // zig
+		}
+	}
+
+	/**
+		@brief Ricerca con spostamento alla radice
+
+		Funzione privata helper che cerca un valore e porta alla radice
+		il nodo trovato o, se il valore non e' presente, l'ultimo nodo
+		visitato durante la ricerca.
+
+		@param value valore da cercare
+
+		@return puntatore al nodo con il valore cercato (ora radice),
+				nullptr se il valore non e' presente
+	*/
+	node *access(const T &value) {
+		node *current = this->_root;
+		node *last = nullptr;
+
+		while(current != nullptr && !this->_equals(current->value, value)) {
+			last = current;
+			if(this->_order(value, current->value))
+				current = current->left;
+			else
+				current = current->right;
+		}
+
+		if(current != nullptr)
+			splay(current);
+		else
+			if(last != nullptr)
+				splay(last);
+
+		return current;
+	}
+
+public:
+
+	// Il costruttore di default, il costruttore di copia,
+	// l'operatore di assegnamento e il distruttore coincidono
+	// con quelli di default (e quindi con quelli di binary_search_tree)
+
+	typedef typename base::const_iterator const_iterator; ///< iteratore costante dell'albero
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Inserisce un elemento nell'albero e lo porta alla radice.
+
+		@pre Il valore da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		std::pair<node *, bool> result = this->insert_unique(value);
+		splay(result.first);
+		if(!result.second)
+			throw bst_duplicated_value_exception<T>("Valore duplicato: ", value);
+	}
+
+	/**
+		@brief Inserimento senza eccezioni di un elemento nell'albero
+
+		Inserisce un elemento nell'albero, se non e' gia' presente,
+		e porta alla radice il nodo con il valore.
+
+		@param value valore dell'elemento da inserire
+
+		@return coppia formata dall'iteratore all'elemento con il valore
+				(la radice) e da true se l'elemento e' stato inserito,
+				false se il valore era gia' presente
+
+		@throw eccezione di allocazione di memoria
+	*/
+	std::pair<const_iterator, bool> try_insert(const T &value) {
+		std::pair<node *, bool> result = this->insert_unique(value);
+		splay(result.first);
+		return std::make_pair(base::iterator_to(result.first), result.second);
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Controlla se esiste un elemento di tipo T nell'albero
+		e porta alla radice il nodo acceduto (metodo NON const).
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	bool exists(const T &value) {
+		return access(value) != nullptr;
+	}
+
+	/**
+		@brief Ricerca di un elemento nell'albero
+
+		Cerca un elemento di tipo T nell'albero e porta alla radice
+		il nodo acceduto (metodo NON const).
+
+		@param value valore da cercare
+
+		@return iteratore che punta all'elemento cercato (la radice),
+				end() se l'elemento non e' presente nell'albero
+	*/
+	const_iterator find(const T &value) {
+		return (access(value) != nullptr) ? this->begin() : this->end();
+	}
+
+}; // class splay_tree
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bstsplay.h
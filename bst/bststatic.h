@@ -0,0 +1,277 @@
+/**
+	@file bststatic.h
+
+	@brief Dichiarazione e definizione della classe
+	static_binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTSTATIC_H
+#define BSTSTATIC_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <stdexcept> // std::invalid_argument
+#include "bstexceptions.h" // bst_duplicated_value_exception
+
+/**
+	@brief Sequenza di indici
+
+	Struttura vuota che trasporta a tempo di compilazione
+	la sequenza di indici I.
+*/
+template <unsigned int... I>
+struct bst_indices {};
+
+/**
+	@brief Concatenazione di due sequenze di indici
+
+	Struttura che definisce il tipo della sequenza A seguita
+	dalla sequenza B traslata della lunghezza di A.
+*/
+template <typename A, typename B>
+struct bst_concat_indices;
+
+/**
+	@brief Concatenazione di due sequenze di indici
+
+	Specializzazione che espande le due sequenze.
+*/
+template <unsigned int... I, unsigned int... J>
+struct bst_concat_indices<bst_indices<I...>, bst_indices<J...> > {
+	typedef bst_indices<I..., (sizeof...(I) + J)...> type; ///< sequenza concatenata
+};
+
+/**
+	@brief Costruzione della sequenza di indici 0, ..., N - 1
+
+	Struttura che definisce il tipo bst_indices<0, ..., N - 1>
+	concatenando le sequenze delle due meta': la profondita' delle
+	istanziazioni e' logaritmica in N, quindi anche tabelle di
+	migliaia di valori non superano il limite del compilatore.
+*/
+template <unsigned int N>
+struct bst_make_indices :
+	bst_concat_indices<typename bst_make_indices<N / 2>::type, typename bst_make_indices<N - N / 2>::type> {};
+
+/**
+	@brief Costruzione della sequenza di indici (caso base vuoto)
+*/
+template <>
+struct bst_make_indices<0> {
+	typedef bst_indices<> type; ///< sequenza vuota
+};
+
+/**
+	@brief Costruzione della sequenza di indici (caso base di un indice)
+*/
+template <>
+struct bst_make_indices<1> {
+	typedef bst_indices<0> type; ///< sequenza con il solo indice 0
+};
+
+/**
+	@brief Albero binario di ricerca statico costruibile a tempo di compilazione
+
+	Classe che implementa un albero binario di ricerca immutabile di N dati
+	generici T, costruibile come espressione costante (constexpr) a partire
+	da un array ordinato: un albero dichiarato constexpr viene disposto
+	dal compilatore nei dati a sola lettura del programma, senza nessuna
+	allocazione e nessun costo di inizializzazione all'avvio.
+
+	L'albero e' bilanciato e implicito: i valori sono memorizzati in ordine
+	in un array e la radice di ogni sottoalbero e' l'elemento centrale
+	del suo intervallo, quindi non servono puntatori ai figli.
+	Le ricerche (exists, find) e l'accesso agli elementi sono constexpr
+	se lo sono anche gli operatori dei funtori O ed E (come compare_int
+	ed equal_int); con funtori non constexpr restano utilizzabili
+	a tempo di esecuzione.
+	L'iteratore visita i valori in ordine crescente.
+
+	@param T tipo dei dati
+	@param N numero di dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+*/
+template <typename T, unsigned int N, typename O, typename E>
+class static_binary_search_tree {
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati nell'albero
+
+	T _values[N]; ///< valori dell'albero in ordine crescente
+
+	/**
+		@brief Controllo di un valore dell'array di costruzione
+
+		Funzione privata helper che ritorna l'i-esimo valore dell'array
+		di costruzione dopo aver controllato che sia strettamente maggiore
+		del precedente. In un'espressione costante un controllo fallito
+		produce un errore di compilazione.
+
+		@param values array ordinato dei valori
+		@param i indice del valore da controllare
+
+		@return i-esimo valore dell'array
+
+		@throw bst_duplicated_value_exception se il valore e' uguale
+			   al precedente
+		@throw std::invalid_argument se il valore e' minore del precedente
+	*/
+	static constexpr const T &checked(const T (&values)[N], size_type i) {
+		return (i == 0 || O()(values[i - 1], values[i])) ? values[i]
+			: (E()(values[i - 1], values[i])
+				? throw bst_duplicated_value_exception<T>("Valore duplicato: ", values[i])
+				: throw std::invalid_argument("static_binary_search_tree: valori non ordinati"),
+			   values[i]);
+	}
+
+	/**
+		@brief Costruttore privato
+
+		Costruttore privato che copia i valori dell'array
+		espandendo la sequenza di indici I.
+
+		@param values array ordinato dei valori
+	*/
+	template <unsigned int... I>
+	constexpr static_binary_search_tree(const T (&values)[N], bst_indices<I...>) :
+		_values{checked(values, I)...} {} // initialization list
+
+	/**
+		@brief Ricerca di un valore in un sottoalbero
+
+		Funzione privata helper che cerca un valore nel sottoalbero
+		formato dagli elementi di indice compreso in [first, last),
+		la cui radice e' l'elemento centrale.
+
+		@param value valore da cercare
+		@param first indice del primo elemento del sottoalbero
+		@param last indice successivo all'ultimo elemento del sottoalbero
+
+		@return indice dell'elemento con il valore cercato,
+				N se il valore non e' presente
+	*/
+	constexpr size_type search(const T &value, size_type first, size_type last) const {
+		return (first >= last) ? N
+			: E()(_values[first + (last - first) / 2], value) ? first + (last - first) / 2
+			: O()(value, _values[first + (last - first) / 2])
+				? search(value, first, first + (last - first) / 2)
+				: search(value, first + (last - first) / 2 + 1, last);
+	}
+
+public:
+
+	typedef const T *const_iterator; ///< iteratore costante (in ordine crescente)
+
+	/**
+		@brief Costruttore
+
+		Costruisce l'albero con i valori di un array ordinato in modo
+		strettamente crescente secondo il funtore O.
+		Se l'albero e' dichiarato constexpr, un array non ordinato
+		o con duplicati produce un errore di compilazione.
+
+		@param values array ordinato dei valori
+
+		@throw bst_duplicated_value_exception se l'array contiene duplicati
+		@throw std::invalid_argument se l'array non e' ordinato
+	*/
+	constexpr static_binary_search_tree(const T (&values)[N]) :
+		static_binary_search_tree(values, typename bst_make_indices<N>::type()) {} // initialization list
+
+	/**
+		@brief Numero totale di dati nell'albero
+
+		@return numero totale di dati nell'albero
+	*/
+	constexpr size_type size() const {
+		return N;
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Controlla se esiste un elemento di tipo T nell'albero.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+	*/
+	constexpr bool exists(const T &value) const {
+		return search(value, 0, N) != N;
+	}
+
+	/**
+		@brief Ricerca di un elemento nell'albero
+
+		@param value valore da cercare
+
+		@return iteratore che punta all'elemento cercato,
+				end() se l'elemento non e' presente nell'albero
+	*/
+	constexpr const_iterator find(const T &value) const {
+		return _values + search(value, 0, N);
+	}
+
+	/**
+		@brief Operatore di accesso per posizione
+
+		@param i posizione dell'elemento in ordine crescente (minore di N)
+
+		@return reference costante all'i-esimo elemento
+	*/
+	constexpr const T &operator[](size_type i) const {
+		return _values[i];
+	}
+
+	/**
+		@brief Iteratore che punta all'inizio dell'albero
+
+		@return iteratore che punta al valore minimo
+	*/
+	constexpr const_iterator begin() const {
+		return _values;
+	}
+
+	/**
+		@brief Iteratore che punta alla fine dell'albero
+
+		@return iteratore che punta alla fine dell'albero
+	*/
+	constexpr const_iterator end() const {
+		return _values + N;
+	}
+
+}; // class static_binary_search_tree
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa del contenuto
+	dell'albero statico.
+
+	@param os oggetto stream di output
+	@param tree albero da stampare
+
+	@return reference allo stream di output
+*/
+template <typename T, unsigned int N, typename O, typename E>
+std::ostream &operator<<(std::ostream &os, const static_binary_search_tree<T, N, O, E> &tree) {
+	os << "[";
+	for(unsigned int i = 0; i < N; ++i) {
+		if(i > 0)
+			os << ", ";
+		os << tree[i];
+	}
+	os << "]";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bststatic.h
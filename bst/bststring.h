@@ -0,0 +1,354 @@
+/**
+	@file bststring.h
+
+	@brief Dichiarazione e definizione della classe
+	string_binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTSTRING_H
+#define BSTSTRING_H
+
+// Direttive per il pre-compilatore
+
+#include <ostream> // std::ostream
+#include <string> // std::string
+#include <vector> // std::vector
+#include <iterator> // std::back_inserter
+#include <cstring> // std::memcmp
+#include <cstddef> // std::size_t
+#include <stdexcept> // std::length_error
+#include "bstexceptions.h" // bst_duplicated_value_exception
+
+/**
+	@brief Albero binario di ricerca di stringhe
+
+	Classe che implementa un albero binario di ricerca di stringhe
+	ordinate lessicograficamente byte per byte (come gli operatori
+	di confronto di std::string), ottimizzato per la memoria
+	e per i confronti.
+
+	Ogni nodo contiene, al posto di una std::string, i primi 8 byte
+	della chiave come intero big-endian (completato con zeri):
+	confrontare due prefissi costa un solo confronto tra interi e ha
+	lo stesso risultato del confronto lessicografico dei primi 8 byte.
+	La maggior parte dei confronti durante una discesa termina qui,
+	senza accedere ad altra memoria.
+	I byte successivi all'ottavo sono memorizzati in un'arena contigua
+	condivisa da tutti i nodi e vengono letti solo a parita' di prefisso;
+	le chiavi di al piu' 8 byte non occupano spazio nell'arena.
+	I nodi sono memorizzati in un vettore e collegati da indici
+	a 32 bit, come in compact_binary_search_tree.
+
+	Come compact_binary_search_tree, l'albero supporta l'inserimento
+	e la ricerca ma non la rimozione.
+
+	L'iteratore non e' disponibile, perche' le chiavi non sono
+	memorizzate come std::string: copy_in_order ricostruisce le chiavi
+	in ordine crescente.
+*/
+class string_binary_search_tree {
+
+	typedef unsigned int size_type; ///< tipo per identificare il numero di dati inseriti nell'albero
+	typedef unsigned int index_type; ///< tipo degli indici dei nodi e dell'arena
+
+	static const index_type null_index = static_cast<index_type>(-1); ///< indice di nessun nodo
+	static const size_type prefix_size = 8; ///< byte della chiave memorizzati nel nodo
+
+	/**
+		@brief Nodo dell'albero
+
+		Struttura di supporto interna che implementa un nodo dell'albero.
+	*/
+	struct node {
+		unsigned long long prefix; ///< primi 8 byte della chiave, big-endian
+		index_type suffix; ///< indice nell'arena dei byte successivi all'ottavo
+		index_type length; ///< lunghezza della chiave
+		index_type left; ///< indice del nodo figlio sinistro
+		index_type right; ///< indice del nodo figlio destro
+	};
+
+	/**
+		@brief Chiave da cercare
+
+		Struttura di supporto interna con una chiave in forma
+		confrontabile con i nodi.
+	*/
+	struct key {
+		unsigned long long prefix; ///< primi 8 byte della chiave, big-endian
+		const char *data; ///< byte della chiave
+		index_type length; ///< lunghezza della chiave
+
+		/**
+			@brief Costruttore
+
+			Costruttore che calcola il prefisso di una stringa.
+
+			@param s stringa
+		*/
+		explicit key(const std::string &s) :
+			prefix(0), data(s.data()), length(static_cast<index_type>(s.size())) { // initialization list
+			for(size_type i = 0; i < prefix_size; ++i)
+				prefix = (prefix << 8) | (i < length ? static_cast<unsigned char>(data[i]) : 0);
+		}
+	};
+
+	std::vector<node> _nodes; ///< nodi dell'albero (la radice e' il primo)
+	std::vector<char> _arena; ///< byte delle chiavi successivi all'ottavo
+
+	/**
+		@brief Confronto di una chiave con un nodo
+
+		Funzione privata helper che confronta lessicograficamente
+		una chiave con la chiave di un nodo: prima i prefissi,
+		poi, solo se uguali, i byte nell'arena e le lunghezze.
+
+		@param k chiave
+		@param n nodo
+
+		@return valore negativo se la chiave precede quella del nodo,
+				zero se sono uguali, positivo altrimenti
+	*/
+	int compare(const key &k, const node &n) const {
+		if(k.prefix != n.prefix)
+			return (k.prefix < n.prefix) ? -1 : 1;
+
+		index_type k_suffix = (k.length > prefix_size) ? k.length - prefix_size : 0;
+		index_type n_suffix = (n.length > prefix_size) ? n.length - prefix_size : 0;
+		index_type common = (k_suffix < n_suffix) ? k_suffix : n_suffix;
+		if(common > 0) {
+			int c = std::memcmp(k.data + prefix_size, &_arena[n.suffix], common);
+			if(c != 0)
+				return c;
+		}
+
+		return (k.length < n.length) ? -1 : (k.length > n.length) ? 1 : 0;
+	}
+
+	/**
+		@brief Ricerca di una chiave
+
+		Funzione privata helper che cerca una chiave nell'albero.
+
+		@param k chiave da cercare
+		@param parent indice dell'ultimo nodo visitato (null_index se vuoto)
+		@param side risultato dell'ultimo confronto
+
+		@return indice del nodo con la chiave, null_index se non e' presente
+	*/
+	index_type search(const key &k, index_type &parent, int &side) const {
+		index_type current = _nodes.empty() ? null_index : 0;
+		parent = null_index;
+		side = 0;
+
+		while(current != null_index) {
+			const node &n = _nodes[current];
+			side = compare(k, n);
+			if(side == 0)
+				return current;
+			parent = current;
+			current = (side < 0) ? n.left : n.right;
+		}
+
+		return null_index;
+	}
+
+	/**
+		@brief Ricostruzione di una chiave
+
+		@param n nodo
+
+		@return chiave del nodo
+	*/
+	std::string value(const node &n) const {
+		std::string s;
+		s.reserve(n.length);
+		for(size_type i = 0; i < prefix_size && i < n.length; ++i)
+			s.push_back(static_cast<char>((n.prefix >> (8 * (prefix_size - 1 - i))) & 0xff));
+		if(n.length > prefix_size)
+			s.append(&_arena[n.suffix], n.length - prefix_size);
+		return s;
+	}
+
+public:
+
+	// Il costruttore di default, il costruttore di copia,
+	// l'operatore di assegnamento e il distruttore coincidono
+	// con quelli di default
+
+	/**
+		@brief Inserimento senza eccezioni di una stringa nell'albero
+
+		Inserisce una stringa nell'albero, se non e' gia' presente.
+
+		@param value stringa da inserire
+
+		@return true se la stringa e' stata inserita,
+				false se era gia' presente
+
+		@throw std::length_error se la stringa, l'arena o il numero
+			   di nodi non sono rappresentabili con indici a 32 bit
+		@throw eccezione di allocazione di memoria
+	*/
+	bool try_insert(const std::string &value) {
+		if(value.size() >= null_index)
+			throw std::length_error("string_binary_search_tree: stringa troppo lunga per indici a 32 bit");
+		key k(value);
+		index_type parent;
+		int side;
+		if(search(k, parent, side) != null_index)
+			return false;
+
+		if(_nodes.size() >= null_index)
+			throw std::length_error("string_binary_search_tree: indici a 32 bit esauriti");
+		if(k.length > prefix_size && _arena.size() + (k.length - prefix_size) >= null_index)
+			throw std::length_error("string_binary_search_tree: arena oltre gli indici a 32 bit");
+
+		node n;
+		n.prefix = k.prefix;
+		n.suffix = static_cast<index_type>(_arena.size());
+		n.length = k.length;
+		n.left = null_index;
+		n.right = null_index;
+		if(k.length > prefix_size)
+			_arena.insert(_arena.end(), value.begin() + prefix_size, value.end());
+		_nodes.push_back(n);
+
+		if(parent != null_index) {
+			if(side < 0)
+				_nodes[parent].left = static_cast<index_type>(_nodes.size() - 1);
+			else
+				_nodes[parent].right = static_cast<index_type>(_nodes.size() - 1);
+		}
+		return true;
+	}
+
+	/**
+		@brief Inserimento di una stringa nell'albero
+
+		@pre La stringa da inserire non dev'essere gia' presente
+			 all'interno dell'albero
+
+		@param value stringa da inserire
+
+		@throw bst_duplicated_value_exception se la stringa da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const std::string &value) {
+		if(!try_insert(value))
+			throw bst_duplicated_value_exception<std::string>("Valore duplicato: ", value);
+	}
+
+	/**
+		@brief Riserva di memoria
+
+		Riserva la memoria per n stringhe con bytes byte complessivi,
+		evitando riallocazioni durante gli inserimenti.
+
+		@param n numero di stringhe previsto
+		@param bytes numero complessivo di byte delle stringhe previsto
+
+		@throw eccezione di allocazione di memoria
+	*/
+	void reserve(size_type n, std::size_t bytes) {
+		_nodes.reserve(n);
+		_arena.reserve(bytes);
+	}
+
+	/**
+		@brief Numero totale di dati nell'albero
+
+		@return numero totale di stringhe nell'albero
+	*/
+	size_type size() const {
+		return static_cast<size_type>(_nodes.size());
+	}
+
+	/**
+		@brief Memoria occupata dall'albero
+
+		@return numero di byte allocati per i nodi e per l'arena
+	*/
+	std::size_t memory_usage() const {
+		return _nodes.capacity() * sizeof(node) + _arena.capacity();
+	}
+
+	/**
+		@brief Controllo di esistenza di una stringa nell'albero
+
+		@param value stringa da cercare
+
+		@return true se esiste la stringa, false altrimenti
+	*/
+	bool exists(const std::string &value) const {
+		index_type parent;
+		int side;
+		return search(key(value), parent, side) != null_index;
+	}
+
+	/**
+		@brief Copia ordinata delle stringhe dell'albero
+
+		Copia le stringhe dell'albero in ordine crescente
+		in una sequenza di output.
+
+		@param out iteratore di output a cui aggiungere le stringhe
+
+		@return iteratore di output dopo l'ultima stringa copiata
+
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		std::vector<index_type> pending;
+		index_type current = _nodes.empty() ? null_index : 0;
+
+		while(current != null_index || !pending.empty()) {
+			while(current != null_index) {
+				pending.push_back(current);
+				current = _nodes[current].left;
+			}
+			current = pending.back();
+			pending.pop_back();
+			*out++ = value(_nodes[current]);
+			current = _nodes[current].right;
+		}
+
+		return out;
+	}
+
+}; // class string_binary_search_tree
+
+/**
+	@brief Ridefinizione operatore di stream <<
+
+	Ridefinizione dell'operatore di stream << per la stampa
+	in ordine crescente del contenuto dell'albero.
+
+	@param os oggetto stream di output
+	@param tree albero da stampare
+
+	@return reference allo stream di output
+*/
+inline std::ostream &operator<<(std::ostream &os, const string_binary_search_tree &tree) {
+	std::vector<std::string> values;
+	tree.copy_in_order(std::back_inserter(values));
+
+	os << "[";
+	for(std::size_t i = 0; i < values.size(); ++i) {
+		if(i > 0)
+			os << ", ";
+		os << values[i];
+	}
+	os << "]";
+
+	return os;
+}
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bststring.h
@@ -0,0 +1,567 @@
+/**
+	@file bsttrace.h
+
+	@brief Dichiarazione e definizione delle classi per la registrazione
+	e la rilettura di tracce di operazioni su un bst
+*/
+
+// Guardie del file header
+
+#ifndef BSTTRACE_H
+#define BSTTRACE_H
+
+// Direttive per il pre-compilatore
+
+#include <cstdio> // std::FILE, std::fopen, std::fwrite, std::fread, std::fclose
+#include <cstring> // std::memcmp
+#include <cstddef> // std::size_t
+#include <string> // std::string
+#include "bst.h" // binary_search_tree
+#include "bstexceptions.h" // bst_io_exception
+#include "bstjournal.h" // bst_pod_codec, bst_string_codec
+#include "bstlatency.h" // bst_operation
+
+/**
+	@brief Dimensione delle chiavi di un codificatore
+
+	Struttura che indica il numero di byte di ogni chiave codificata:
+	0 per i codificatori a dimensione variabile.
+
+	@param C codificatore delle chiavi
+*/
+template <typename C>
+struct bst_codec_size {
+	static const std::size_t value = 0; ///< dimensione variabile
+};
+
+/**
+	@brief Dimensione delle chiavi di bst_pod_codec
+
+	Specializzazione per i dati a dimensione fissa.
+
+	@param T tipo dei dati
+*/
+template <typename T>
+struct bst_codec_size<bst_pod_codec<T> > {
+	static const std::size_t value = sizeof(T); ///< dimensione di un dato
+};
+
+/**
+	@brief Formato delle tracce
+
+	Costanti del formato binario delle tracce: un'intestazione di
+	8 byte ("BSTTRCE1") seguita dalla dimensione delle chiavi (4 byte,
+	0 se variabile), poi un record per operazione: 1 byte con
+	l'operazione e, per insert, exists, erase e subtree, la chiave
+	codificata, preceduta dalla sua lunghezza (varint) se variabile.
+*/
+struct bst_trace_format {
+	static const char *magic() {
+		return "BSTTRCE1";
+	}
+	static const std::size_t magic_size = 8; ///< byte dell'intestazione
+	static const std::size_t buffer_size = 1 << 20; ///< byte accumulati prima di una scrittura
+
+	/**
+		@brief Operazione con chiave
+
+		@param op operazione
+
+		@return true se il record dell'operazione contiene una chiave
+	*/
+	static bool keyed(unsigned int op) {
+		return op == bst_op_insert || op == bst_op_exists || op == bst_op_erase || op == bst_op_subtree;
+	}
+};
+
+/**
+	@brief Scrittore di tracce
+
+	Classe che scrive una traccia di operazioni in un file, accumulando
+	i record in memoria e scrivendoli a blocchi di 1 MB, senza
+	sincronizzare il file: registrare un'operazione costa la codifica
+	della chiave e una copia in memoria.
+
+	@param T tipo delle chiavi
+	@param C codificatore delle chiavi (come in journaled_bst)
+*/
+template <typename T, typename C>
+class bst_trace_writer {
+
+	std::string _path; ///< percorso del file
+	std::FILE *_file; ///< file della traccia
+	std::string _buffer; ///< record non ancora scritti
+	unsigned long long _records; ///< numero di record registrati
+	unsigned long long _bytes; ///< byte registrati (intestazione compresa)
+	C _codec; ///< oggetto codificatore delle chiavi
+
+public:
+
+	/**
+		@brief Costruttore
+
+		Costruttore che crea (o svuota) il file della traccia
+		e ne scrive l'intestazione.
+
+		@param path percorso del file
+
+		@throw bst_io_exception se il file non puo' essere creato
+	*/
+	explicit bst_trace_writer(const std::string &path) :
+		_path(path), _file(std::fopen(path.c_str(), "wb")), _records(0), _bytes(0) { // initialization list
+		if(_file == nullptr)
+			throw bst_io_exception("Apertura fallita: ", path);
+
+		unsigned int size = static_cast<unsigned int>(bst_codec_size<C>::value);
+		_buffer.append(bst_trace_format::magic(), bst_trace_format::magic_size);
+		for(unsigned int i = 0; i < 4; ++i)
+			_buffer.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+		_bytes = _buffer.size();
+	}
+
+	bst_trace_writer(const bst_trace_writer &other) = delete;
+	bst_trace_writer &operator=(const bst_trace_writer &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distruttore. Scrive i record accumulati e chiude il file
+		(ignorando gli errori: per rilevarli si usa flush).
+	*/
+	~bst_trace_writer() {
+		if(!_buffer.empty())
+			std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+		std::fclose(_file);
+	}
+
+	/**
+		@brief Registrazione di un'operazione senza chiave
+
+		@param op operazione (bst_op_iteration o bst_op_copy_in_order)
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	void record(bst_operation op) {
+		_buffer.push_back(static_cast<char>(op));
+		_records++;
+		_bytes++;
+		if(_buffer.size() >= bst_trace_format::buffer_size)
+			flush();
+	}
+
+	/**
+		@brief Registrazione di un'operazione con chiave
+
+		@param op operazione (bst_op_insert, bst_op_exists, bst_op_erase
+			   o bst_op_subtree)
+		@param key chiave dell'operazione
+
+		@throw bst_io_exception se la scrittura fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	void record(bst_operation op, const T &key) {
+		std::size_t start = _buffer.size();
+		_buffer.push_back(static_cast<char>(op));
+		if(bst_codec_size<C>::value == 0) {
+			std::string payload;
+			_codec.encode(key, payload);
+			for(std::size_t length = payload.size(); ; length >>= 7) {
+				_buffer.push_back(static_cast<char>((length & 0x7f) | (length >= 0x80 ? 0x80 : 0)));
+				if(length < 0x80)
+					break;
+			}
+			_buffer.append(payload);
+		}
+		else
+			_codec.encode(key, _buffer);
+		_records++;
+		_bytes += _buffer.size() - start;
+		if(_buffer.size() >= bst_trace_format::buffer_size)
+			flush();
+	}
+
+	/**
+		@brief Scrittura dei record accumulati
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	void flush() {
+		if(std::fwrite(_buffer.data(), 1, _buffer.size(), _file) != _buffer.size() || std::fflush(_file) != 0)
+			throw bst_io_exception("Scrittura fallita: ", _path);
+		_buffer.clear();
+	}
+
+	/**
+		@brief Numero di record registrati
+
+		@return numero di record
+	*/
+	unsigned long long records() const {
+		return _records;
+	}
+
+	/**
+		@brief Dimensione della traccia
+
+		@return byte registrati, intestazione compresa
+	*/
+	unsigned long long bytes() const {
+		return _bytes;
+	}
+
+}; // class bst_trace_writer
+
+/**
+	@brief Lettore di tracce
+
+	Classe che legge in sequenza i record di una traccia scritta
+	da bst_trace_writer, a blocchi di 1 MB.
+
+	@param T tipo delle chiavi
+	@param C codificatore delle chiavi (lo stesso usato per scrivere)
+*/
+template <typename T, typename C>
+class bst_trace_reader {
+
+	std::string _path; ///< percorso del file
+	std::FILE *_file; ///< file della traccia
+	std::string _buffer; ///< byte letti e non ancora interpretati
+	std::size_t _position; ///< posizione del prossimo record in _buffer
+	bool _eof; ///< true se il file e' stato letto tutto
+	C _codec; ///< oggetto codificatore delle chiavi
+
+	/**
+		@brief Disponibilita' di byte
+
+		Funzione privata helper che legge dal file finche' nel buffer
+		ci sono almeno count byte non interpretati, o il file e' finito.
+
+		@param count numero di byte richiesti
+
+		@return true se i byte sono disponibili
+	*/
+	bool available(std::size_t count) {
+		while(_buffer.size() - _position < count && !_eof) {
+			_buffer.erase(0, _position);
+			_position = 0;
+			std::size_t size = _buffer.size();
+			_buffer.resize(size + bst_trace_format::buffer_size);
+			std::size_t got = std::fread(&_buffer[size], 1, bst_trace_format::buffer_size, _file);
+			_buffer.resize(size + got);
+			if(got < bst_trace_format::buffer_size) {
+				if(std::ferror(_file))
+					throw bst_io_exception("Lettura fallita: ", _path);
+				_eof = true;
+			}
+		}
+		return _buffer.size() - _position >= count;
+	}
+
+	/**
+		@brief Traccia non valida
+
+		@throw bst_io_exception sempre
+	*/
+	void corrupted() const {
+		throw bst_io_exception("Traccia non valida: ", _path);
+	}
+
+public:
+
+	/**
+		@brief Costruttore
+
+		Costruttore che apre il file della traccia e ne controlla
+		l'intestazione.
+
+		@param path percorso del file
+
+		@throw bst_io_exception se il file non puo' essere aperto,
+			   non e' una traccia o la dimensione delle chiavi
+			   non corrisponde al codificatore C
+	*/
+	explicit bst_trace_reader(const std::string &path) :
+		_path(path), _file(std::fopen(path.c_str(), "rb")), _position(0), _eof(false) { // initialization list
+		if(_file == nullptr)
+			throw bst_io_exception("Apertura fallita: ", path);
+
+		try {
+			if(!available(bst_trace_format::magic_size + 4) ||
+			   std::memcmp(_buffer.data(), bst_trace_format::magic(), bst_trace_format::magic_size) != 0 ||
+			   key_size(path) != bst_codec_size<C>::value)
+				corrupted();
+		}
+		catch(...) {
+			std::fclose(_file);
+			throw;
+		}
+		_position = bst_trace_format::magic_size + 4;
+	}
+
+	bst_trace_reader(const bst_trace_reader &other) = delete;
+	bst_trace_reader &operator=(const bst_trace_reader &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distruttore. Chiude il file.
+	*/
+	~bst_trace_reader() {
+		std::fclose(_file);
+	}
+
+	/**
+		@brief Dimensione delle chiavi di una traccia
+
+		Legge dall'intestazione di una traccia la dimensione
+		delle chiavi, per scegliere il tipo con cui rileggerla.
+
+		@param path percorso del file
+
+		@return dimensione delle chiavi (0 se variabile)
+
+		@throw bst_io_exception se il file non puo' essere letto
+			   o non e' una traccia
+	*/
+	static std::size_t key_size(const std::string &path) {
+		unsigned char header[bst_trace_format::magic_size + 4];
+		std::FILE *file = std::fopen(path.c_str(), "rb");
+		if(file == nullptr)
+			throw bst_io_exception("Apertura fallita: ", path);
+		std::size_t got = std::fread(header, 1, sizeof(header), file);
+		std::fclose(file);
+		if(got != sizeof(header) || std::memcmp(header, bst_trace_format::magic(), bst_trace_format::magic_size) != 0)
+			throw bst_io_exception("Traccia non valida: ", path);
+
+		std::size_t size = 0;
+		for(unsigned int i = 0; i < 4; ++i)
+			size |= static_cast<std::size_t>(header[bst_trace_format::magic_size + i]) << (8 * i);
+		return size;
+	}
+
+	/**
+		@brief Lettura del record successivo
+
+		@param op operazione letta
+		@param key chiave letta (invariata per le operazioni senza chiave)
+
+		@return true se e' stato letto un record, false alla fine della traccia
+
+		@throw bst_io_exception se la traccia e' troncata o non valida
+	*/
+	bool next(bst_operation &op, T &key) {
+		if(!available(1))
+			return false;
+
+		unsigned char code = static_cast<unsigned char>(_buffer[_position++]);
+		if(code >= bst_op_count)
+			corrupted();
+		op = static_cast<bst_operation>(code);
+		if(!bst_trace_format::keyed(code))
+			return true;
+
+		std::size_t length = bst_codec_size<C>::value;
+		if(length == 0)
+			for(unsigned int shift = 0; ; shift += 7) {
+				if(shift > 56 || !available(1))
+					corrupted();
+				unsigned char byte = static_cast<unsigned char>(_buffer[_position++]);
+				length |= static_cast<std::size_t>(byte & 0x7f) << shift;
+				if((byte & 0x80) == 0)
+					break;
+			}
+		if(!available(length))
+			corrupted();
+		key = _codec.decode(_buffer.data() + _position, length);
+		_position += length;
+		return true;
+	}
+
+}; // class bst_trace_reader
+
+/**
+	@brief Albero binario di ricerca con registrazione delle operazioni
+
+	Classe che aggiunge a un binary_search_tree la registrazione
+	in una traccia di insert, exists, erase, subtree, copy_in_order
+	e delle visite complete con for_each (le stesse operazioni misurate
+	da timed_binary_search_tree), con le loro chiavi. Le operazioni
+	vengono registrate anche se lanciano un'eccezione.
+	La traccia puo' essere rieseguita con il programma replay su
+	configurazioni diverse dell'albero.
+
+	Per non far divergere la traccia dal carico reale, l'albero deriva
+	privatamente da binary_search_tree ed espone solo le operazioni
+	registrate, oltre a size, min e max (in tempo costante): le altre
+	operazioni che modificano l'albero (try_insert, insert_batch,
+	pop_min, split, compact, ...) o lo visitano non sono disponibili.
+	L'albero non puo' essere copiato, perche' possiede il file
+	della traccia.
+
+	@param T tipo dei dati
+	@param O funtore di confronto di ordinamento (<) di due dati
+	@param E funtore di confronto di uguaglianza (==) di due dati
+	@param C codificatore dei dati (bst_pod_codec o bst_string_codec)
+*/
+template <typename T, typename O, typename E, typename C>
+class recording_binary_search_tree : private binary_search_tree<T, O, E> {
+
+	typedef binary_search_tree<T, O, E> base; ///< tipo dell'albero di base
+
+	mutable bst_trace_writer<T, C> _trace; ///< traccia delle operazioni
+
+public:
+
+	using base::size;
+	using base::min;
+	using base::max;
+
+	/**
+		@brief Costruttore
+
+		Costruttore per istanziare un albero vuoto che registra
+		le operazioni in un nuovo file.
+
+		@param path percorso del file della traccia
+
+		@throw bst_io_exception se il file non puo' essere creato
+	*/
+	explicit recording_binary_search_tree(const std::string &path) : _trace(path) {} // initialization list
+
+	recording_binary_search_tree(const recording_binary_search_tree &other) = delete;
+	recording_binary_search_tree &operator=(const recording_binary_search_tree &other) = delete;
+
+	/**
+		@brief Inserimento di un elemento nell'albero
+
+		Come binary_search_tree::insert, registrando l'operazione.
+
+		@param value valore dell'elemento da inserire
+
+		@throw bst_duplicated_value_exception se il valore da inserire
+			   e' gia' presente all'interno dell'albero
+		@throw bst_io_exception se la scrittura della traccia fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	void insert(const T &value) {
+		_trace.record(bst_op_insert, value);
+		base::insert(value);
+	}
+
+	/**
+		@brief Controllo di esistenza di un elemento nell'albero
+
+		Come binary_search_tree::exists, registrando l'operazione.
+
+		@param value valore da cercare
+
+		@return true se esiste l'elemento, false altrimenti
+
+		@throw bst_io_exception se la scrittura della traccia fallisce
+	*/
+	bool exists(const T &value) const {
+		_trace.record(bst_op_exists, value);
+		return base::exists(value);
+	}
+
+	/**
+		@brief Rimozione di un elemento dall'albero
+
+		Come binary_search_tree::erase, registrando l'operazione.
+
+		@param value valore dell'elemento da rimuovere
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+		@throw bst_io_exception se la scrittura della traccia fallisce
+	*/
+	void erase(const T &value) {
+		_trace.record(bst_op_erase, value);
+		base::erase(value);
+	}
+
+	/**
+		@brief Sottoalbero
+
+		Come binary_search_tree::subtree, registrando l'operazione.
+
+		@param d valore della radice del sottoalbero
+
+		@return copia del sottoalbero
+
+		@throw bst_value_not_found_exception se il valore non e' presente
+			   all'interno dell'albero
+		@throw bst_io_exception se la scrittura della traccia fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	base subtree(const T &d) const {
+		_trace.record(bst_op_subtree, d);
+		return base::subtree(d);
+	}
+
+	/**
+		@brief Copia ordinata dei valori dell'albero
+
+		Come binary_search_tree::copy_in_order, registrando l'operazione.
+
+		@param out iteratore di output a cui aggiungere i valori
+
+		@return iteratore di output dopo l'ultimo valore copiato
+
+		@throw bst_io_exception se la scrittura della traccia fallisce
+		@throw eccezione di allocazione di memoria
+	*/
+	template <typename OI>
+	OI copy_in_order(OI out) const {
+		_trace.record(bst_op_copy_in_order);
+		return base::copy_in_order(out);
+	}
+
+	/**
+		@brief Visita completa dell'albero
+
+		Applica un funtore a tutti i valori dell'albero nell'ordine
+		dell'iteratore, registrando l'operazione.
+
+		@param f funtore da applicare a ogni valore
+
+		@return funtore dopo la visita
+
+		@throw bst_io_exception se la scrittura della traccia fallisce
+	*/
+	template <typename F>
+	F for_each(F f) const {
+		_trace.record(bst_op_iteration);
+		typename base::const_iterator i, ie;
+		for(i = this->begin(), ie = this->end(); i != ie; ++i)
+			f(*i);
+		return f;
+	}
+
+	/**
+		@brief Scrittura della traccia
+
+		Scrive su file le operazioni registrate ma non ancora scritte.
+
+		@throw bst_io_exception se la scrittura fallisce
+	*/
+	void flush_trace() {
+		_trace.flush();
+	}
+
+	/**
+		@brief Traccia delle operazioni
+
+		@return reference costante allo scrittore della traccia
+	*/
+	const bst_trace_writer<T, C> &trace() const {
+		return _trace;
+	}
+
+}; // class recording_binary_search_tree
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bsttrace.h
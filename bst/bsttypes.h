@@ -0,0 +1,368 @@
+/**
+	@file bsttypes.h
+	
+	@brief Tipi di dato e funtori di confronto condivisi dai test
+	e dai benchmark della classe binary_search_tree
+*/
+
+// Guardie del file header
+
+#ifndef BSTTYPES_H
+#define BSTTYPES_H
+
+// Direttive per il pre-compilatore
+
+#include <iostream> // std::cout
+#include <string> // std::string
+#include <cstddef> // std::size_t
+#include "bst.h" // binary_search_tree
+#include "bsthash.h" // hashed_binary_search_tree
+
+/**
+	@brief Funtore per il confronto tra interi
+	
+	Funtore per il confronto tra interi.
+*/
+struct compare_int {
+	constexpr bool operator()(int a, int b) const {
+		return a < b;
+	}
+};
+
+/**
+	@brief Funtore per l'uguaglianza tra interi
+	
+	Funtore per l'uguaglianza tra interi.
+*/
+struct equal_int {
+	constexpr bool operator()(int a, int b) const {
+		return a == b;
+	}
+};
+
+/**
+	@brief Funtore di hash per interi
+	
+	Funtore di hash per interi, coerente con equal_int.
+*/
+struct hash_int {
+	std::size_t operator()(int a) const {
+		return static_cast<std::size_t>(static_cast<unsigned int>(a)) * 0x9e3779b97f4a7c15ULL;
+	}
+};
+
+/**
+	@brief Funtore per il confronto tra float
+	
+	Funtore per il confronto tra float.
+*/
+struct compare_float {
+	constexpr bool operator()(float a, float b) const {
+		return a < b;
+	}
+};
+
+/**
+	@brief Funtore per l'uguaglianza tra float
+	
+	Funtore per l'uguaglianza tra float.
+*/
+struct equal_float {
+	constexpr bool operator()(float a, float b) const {
+		return a == b;
+	}
+};
+
+/**
+	@brief Funtore per il confronto tra booleani
+	
+	Funtore per il confronto tra booleani.
+*/
+struct compare_bool {
+	constexpr bool operator()(bool a, bool b) const {
+		return a < b;
+	}
+};
+
+/**
+	@brief Funtore per l'uguaglianza tra booleani
+	
+	Funtore per l'uguaglianza tra booleani.
+*/
+struct equal_bool {
+	constexpr bool operator()(bool a, bool b) const {
+		return a == b;
+	}
+};
+
+/**
+	@brief Funtore per il confronto tra stringhe
+	
+	Funtore per il confronto tra stringhe. La valutazione e' fatta
+	sulla lunghezza. Ritorna true se la prima stringa e' piu' corta
+	della seconda.
+*/
+struct compare_string {
+	bool operator()(const std::string &a, const std::string &b) const {
+		return (a.size() < b.size());
+	} 
+};
+
+/**
+	@brief Funtore per l'uguaglianza tra stringhe
+	
+	Funtore per l'uguaglianza tra stringhe. La valutazione e' fatta
+	sulla lunghezza. Ritorna true se le due stringhe hanno la stessa
+	lunghezza.
+*/
+struct equal_string {
+	bool operator()(const std::string &a, const std::string &b) const {
+		return (a.size() == b.size());
+	} 
+};
+
+/**
+	@brief Funtore per il confronto lessicografico tra stringhe
+	
+	Funtore per il confronto lessicografico tra stringhe, byte per byte,
+	con lo stesso ordinamento di string_binary_search_tree.
+*/
+struct compare_string_lexicographic {
+	bool operator()(const std::string &a, const std::string &b) const {
+		return a < b;
+	} 
+};
+
+/**
+	@brief Funtore per l'uguaglianza del contenuto di due stringhe
+	
+	Funtore per l'uguaglianza tra stringhe. Ritorna true se le due
+	stringhe contengono gli stessi byte.
+*/
+struct equal_string_content {
+	bool operator()(const std::string &a, const std::string &b) const {
+		return a == b;
+	} 
+};
+
+/**
+	@brief Struct complex che implementa un numero complesso
+	
+	Struct complex che implementa un numero complesso.
+*/
+struct complex {
+	int re; ///< parte reale del numero
+	int im; ///< parte immaginaria del numero
+
+	/**
+		@brief Costruttore
+		
+		Costruttore che prende una parte reale e una immaginaria.
+	*/
+	constexpr complex(int real, int imaginary) : re(real), im(imaginary) {} // initialization list
+};
+
+/**
+	@brief Funtore per il confronto di due numeri complessi
+	
+	Funtore per il confronto di due numeri complessi.
+*/
+struct compare_complex {
+	constexpr bool operator()(const complex &c1, const complex &c2) const {
+		return (c1.re != c2.re) ? (c1.re < c2.re) : (c1.im < c2.im);
+	} 
+};
+
+/**
+	@brief Funtore per il confronto di uguaglianza di due numeri complessi
+	
+	Funtore per il confronto di uguaglianza tra due numeri complessi.
+*/
+struct equal_complex {
+	constexpr bool operator()(const complex &c1, const complex &c2) const {
+		return (c1.re == c2.re) && (c1.im == c2.im);
+	} 
+};
+
+/**
+	@brief Funtore di accesso alle coordinate di un numero complesso
+	
+	Funtore che ritorna la parte reale (asse 0) o immaginaria (asse 1)
+	di un numero complesso, per usarlo come punto di un kd_tree.
+*/
+struct complex_axis {
+	constexpr int operator()(const complex &c, unsigned int axis) const {
+		return (axis == 0) ? c.re : c.im;
+	}
+};
+
+/**
+	@brief Ridefinizione dell'operatore di stream << per un numero complesso
+	
+	Necessaria per l'operatore di stream << della classe binary_search_tree.
+*/
+inline std::ostream &operator<<(std::ostream &os, const complex &c) {
+	std::cout << "(" << c.re << ", " << c.im << ")";
+	return os;
+}
+
+/**
+	@brief Struct employee che implementa un impiegato
+	
+	Struct employee che implementa un impiegato.
+*/
+struct employee {
+	std::string name; ///< nome dell'impiegato
+	std::string surname; ///< cognome dell'impiegato
+	unsigned int salary; ///< salario dell'impiegato
+
+	/**
+		@brief Costruttore
+		
+		Costruttore che prende un nome, un cognome e un salario.
+	*/
+	employee(std::string n, std::string sur, unsigned int sal) :
+		name(n), surname(sur), salary(sal) {} // initialization list
+};
+
+/**
+	@brief Funtore per il confronto di due impiegati.
+	
+	Funtore per il confronto di due impiegati.
+	Il confronto avviene, in ordine, su salario, cognome e nome.
+*/
+struct compare_employee {
+	bool operator()(const employee &e1, const employee &e2) const {
+		if(e1.salary != e2.salary)
+			return (e1.salary < e2.salary);
+		
+		if(e1.surname.compare(e2.surname) != 0) {
+			if(e1.surname.compare(e2.surname) < 0)
+				return true;
+			return false;
+		}
+		
+		if(e1.name.compare(e2.name) < 0)
+			return true;
+		return false;
+	} 
+};
+
+/**
+	@brief Funtore per il confronto di uguaglianza di due impiegati.
+	
+	Funtore per il confronto di uguaglianza tra due impiegati.
+	Il confronto avviene su nome e cognome.
+*/
+struct equal_employee {
+	bool operator()(const employee &e1, const employee &e2) const {
+		return (e1.name.compare(e2.name) == 0 && e1.surname.compare(e2.surname) == 0);
+	} 
+};
+
+/**
+	@brief Ridefinizione dell'operatore di stream << per un impiegato
+	
+	Necessaria per l'operatore di stream << della classe binary_search_tree.
+*/
+inline std::ostream &operator<<(std::ostream &os, const employee &e) {
+	std::cout << "[" << e.name << " " << e.surname << ": " << e.salary << "]";
+	return os;
+}
+
+/**
+	@brief Definizione di un tipo di dato per alberi di interi
+	
+	Definizione di un tipo di dato per alberi di interi.
+*/
+typedef binary_search_tree<int, compare_int, equal_int> bst_int;
+
+/**
+	@brief Definizione di un tipo di dato per alberi di interi con hash
+	
+	Definizione di un tipo di dato per alberi di interi che mantengono
+	l'hash del proprio contenuto.
+*/
+typedef hashed_binary_search_tree<int, compare_int, equal_int, hash_int> hashed_bst_int;
+
+/**
+	@brief Funtore per il confronto di due alberi di interi.
+	
+	Funtore per il confronto di due alberi di interi.
+	Il confronto avviene nell'ordine degli iteratori.
+	Per alberi con hash il confronto usa hashed_binary_search_tree::compare,
+	che distingue in tempo costante alberi con contenuto diverso.
+*/
+struct compare_bst_int {
+	bool operator()(const hashed_bst_int &bst1, const hashed_bst_int &bst2) const {
+		return bst1 < bst2;
+	}
+	
+	bool operator()(const bst_int &bst1, const bst_int &bst2) const {
+		
+		bst_int::const_iterator i1, ie1;
+		i1 = bst1.begin();
+		ie1 = bst1.end();
+		
+		bst_int::const_iterator i2, ie2;
+		i2 = bst2.begin();
+		ie2 = bst2.end();
+		
+		while(i1 != ie1 && i2 != ie2) {
+			if(*i1 != *i2)
+				return *i1 < *i2;
+			
+			++i1;
+			++i2;
+		}
+		
+		if(i1 == ie1 && i2 != ie2)
+			return true;
+		
+		return false;
+	} 
+};
+
+/**
+	@brief Funtore per il confronto di uguaglianza di due alberi di interi.
+	
+	Funtore per il confronto di uguaglianza tra due alberi di interi.
+	Il confronto avviene nell'ordine degli iteratori.
+	Per alberi con hash il confronto usa hashed_binary_search_tree::compare,
+	che distingue in tempo costante alberi con contenuto diverso.
+*/
+struct equal_bst_int {
+	bool operator()(const hashed_bst_int &bst1, const hashed_bst_int &bst2) const {
+		return bst1 == bst2;
+	}
+	
+	bool operator()(const bst_int &bst1, const bst_int &bst2) const {
+		
+		if(bst1.size() != bst2.size())
+			return false;
+		
+		bst_int::const_iterator i1, ie1;
+		i1 = bst1.begin();
+		ie1 = bst1.end();
+		
+		bst_int::const_iterator i2, ie2;
+		i2 = bst2.begin();
+		ie2 = bst2.end();
+		
+		while(i1 != ie1 && i2 != ie2) {
+			if(*i1 != *i2)
+				return false;
+			
+			++i1;
+			++i2;
+		}
+		
+		return true;
+	}
+};
+
+#endif
+
+// Fine guardie del file header
+
+// Fine file header bsttypes.h
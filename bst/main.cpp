@@ -8,287 +8,41 @@
 
 #include <iostream> // std::cout, std::endl
 #include "bst.h" // binary_search_tree
+#include "bsttypes.h" // funtori di confronto, complex, employee, bst_int
 #include <cassert> // assert
 #include <string> // std::string
 #include <list> // std::list
-
-/**
-	@brief Funtore per il confronto tra interi
-	
-	Funtore per il confronto tra interi.
-*/
-struct compare_int {
-	bool operator()(int a, int b) const {
-		return a < b;
-	}
-};
-
-/**
-	@brief Funtore per l'uguaglianza tra interi
-	
-	Funtore per l'uguaglianza tra interi.
-*/
-struct equal_int {
-	bool operator()(int a, int b) const {
-		return a == b;
-	}
-};
-
-/**
-	@brief Funtore per il confronto tra float
-	
-	Funtore per il confronto tra float.
-*/
-struct compare_float {
-	bool operator()(float a, float b) const {
-		return a < b;
-	}
-};
-
-/**
-	@brief Funtore per l'uguaglianza tra float
-	
-	Funtore per l'uguaglianza tra float.
-*/
-struct equal_float {
-	bool operator()(float a, float b) const {
-		return a == b;
-	}
-};
-
-/**
-	@brief Funtore per il confronto tra booleani
-	
-	Funtore per il confronto tra booleani.
-*/
-struct compare_bool {
-	bool operator()(bool a, bool b) const {
-		return a < b;
-	}
-};
-
-/**
-	@brief Funtore per l'uguaglianza tra booleani
-	
-	Funtore per l'uguaglianza tra booleani.
-*/
-struct equal_bool {
-	bool operator()(bool a, bool b) const {
-		return a == b;
-	}
-};
-
-/**
-	@brief Funtore per il confronto tra stringhe
-	
-	Funtore per il confronto tra stringhe. La valutazione e' fatta
-	sulla lunghezza. Ritorna true se la prima stringa e' piu' corta
-	della seconda.
-*/
-struct compare_string {
-	bool operator()(const std::string &a, const std::string &b) const {
-		return (a.size() < b.size());
-	} 
-};
-
-/**
-	@brief Funtore per l'uguaglianza tra stringhe
-	
-	Funtore per l'uguaglianza tra stringhe. La valutazione e' fatta
-	sulla lunghezza. Ritorna true se le due stringhe hanno la stessa
-	lunghezza.
-*/
-struct equal_string {
-	bool operator()(const std::string &a, const std::string &b) const {
-		return (a.size() == b.size());
-	} 
-};
-
-/**
-	@brief Struct complex che implementa un numero complesso
-	
-	Struct complex che implementa un numero complesso.
-*/
-struct complex {
-	int re; ///< parte reale del numero
-	int im; ///< parte immaginaria del numero
-
-	/**
-		@brief Costruttore
-		
-		Costruttore che prende una parte reale e una immaginaria.
-	*/
-	complex(int real, int imaginary) : re(real), im(imaginary) {} // initialization list
-};
-
-/**
-	@brief Funtore per il confronto di due numeri complessi
-	
-	Funtore per il confronto di due numeri complessi.
-*/
-struct compare_complex {
-	bool operator()(const complex &c1, const complex &c2) const {
-		if(c1.re != c2.re)
-			return (c1.re < c2.re);
-		return (c1.im < c2.im);
-	} 
-};
-
-/**
-	@brief Funtore per il confronto di uguaglianza di due numeri complessi
-	
-	Funtore per il confronto di uguaglianza tra due numeri complessi.
-*/
-struct equal_complex {
-	bool operator()(const complex &c1, const complex &c2) const {
-		return (c1.re == c2.re) && (c1.im == c2.im);
-	} 
-};
-
-/**
-	@brief Ridefinizione dell'operatore di stream << per un numero complesso
-	
-	Necessaria per l'operatore di stream << della classe binary_search_tree.
-*/
-std::ostream &operator<<(std::ostream &os, const complex &c) {
-	std::cout << "(" << c.re << ", " << c.im << ")";
-	return os;
-}
-
-/**
-	@brief Struct employee che implementa un impiegato
-	
-	Struct employee che implementa un impiegato.
-*/
-struct employee {
-	std::string name; ///< nome dell'impiegato
-	std::string surname; ///< cognome dell'impiegato
-	unsigned int salary; ///< salario dell'impiegato
-
-	/**
-		@brief Costruttore
-		
-		Costruttore che prende un nome, un cognome e un salario.
-	*/
-	employee(std::string n, std::string sur, unsigned int sal) :
-		name(n), surname(sur), salary(sal) {} // initialization list
-};
-
-/**
-	@brief Funtore per il confronto di due impiegati.
-	
-	Funtore per il confronto di due impiegati.
-	Il confronto avviene, in ordine, su salario, cognome e nome.
-*/
-struct compare_employee {
-	bool operator()(const employee &e1, const employee &e2) const {
-		if(e1.salary != e2.salary)
-			return (e1.salary < e2.salary);
-		
-		if(e1.surname.compare(e2.surname) != 0) {
-			if(e1.surname.compare(e2.surname) < 0)
-				return true;
-			return false;
-		}
-		
-		if(e1.name.compare(e2.name) < 0)
-			return true;
-		return false;
-	} 
-};
-
-/**
-	@brief Funtore per il confronto di uguaglianza di due impiegati.
-	
-	Funtore per il confronto di uguaglianza tra due impiegati.
-	Il confronto avviene su nome e cognome.
-*/
-struct equal_employee {
-	bool operator()(const employee &e1, const employee &e2) const {
-		return (e1.name.compare(e2.name) == 0 && e1.surname.compare(e2.surname) == 0);
-	} 
-};
-
-/**
-	@brief Ridefinizione dell'operatore di stream << per un impiegato
-	
-	Necessaria per l'operatore di stream << della classe binary_search_tree.
-*/
-std::ostream &operator<<(std::ostream &os, const employee &e) {
-	std::cout << "[" << e.name << " " << e.surname << ": " << e.salary << "]";
-	return os;
-}
-
-/**
-	@brief Definizione di un tipo di dato per alberi di interi
-	
-	Definizione di un tipo di dato per alberi di interi.
-*/
-typedef binary_search_tree<int, compare_int, equal_int> bst_int;
-
-/**
-	@brief Funtore per il confronto di due alberi di interi.
-	
-	Funtore per il confronto di due alberi di interi.
-	Il confronto avviene nell'ordine degli iteratori.
-*/
-struct compare_bst_int {
-	bool operator()(const bst_int &bst1, const bst_int &bst2) const {
-		
-		bst_int::const_iterator i1, ie1;
-		i1 = bst1.begin();
-		ie1 = bst1.end();
-		
-		bst_int::const_iterator i2, ie2;
-		i2 = bst2.begin();
-		ie2 = bst2.end();
-		
-		while(i1 != ie1 && i2 != ie2) {
-			if(*i1 != *i2)
-				return *i1 < *i2;
-			
-			++i1;
-			++i2;
-		}
-		
-		if(i1 == ie1 && i2 != ie2)
-			return true;
-		
-		return false;
-	} 
-};
-
-/**
-	@brief Funtore per il confronto di uguaglianza di due alberi di interi.
-	
-	Funtore per il confronto di uguaglianza tra due alberi di interi.
-	Il confronto avviene nell'ordine degli iteratori.
-*/
-struct equal_bst_int {
-	bool operator()(const bst_int &bst1, const bst_int &bst2) const {
-		
-		if(bst1.size() != bst2.size())
-			return false;
-		
-		bst_int::const_iterator i1, ie1;
-		i1 = bst1.begin();
-		ie1 = bst1.end();
-		
-		bst_int::const_iterator i2, ie2;
-		i2 = bst2.begin();
-		ie2 = bst2.end();
-		
-		while(i1 != ie1 && i2 != ie2) {
-			if(*i1 != *i2)
-				return false;
-			
-			++i1;
-			++i2;
-		}
-		
-		return true;
-	}
-};
+#include <iterator> // std::back_inserter
+#include "bstcompact.h" // compact_binary_search_tree
+#include "bstmap.h" // bst_map
+#include "bstsplay.h" // splay_tree
+#include "bstbloom.h" // filtered_binary_search_tree
+#include "bststatic.h" // static_binary_search_tree
+#include "bstsharded.h" // sharded_bst
+#include <thread> // std::thread
+#include "bstinterval.h" // interval_tree
+#include "bstkd.h" // kd_tree
+#include "bststring.h" // string_binary_search_tree
+#include <vector> // std::vector
+#include <algorithm> // std::sort
+#include "bstjournal.h" // journaled_bst
+#include <cstdio> // std::remove, std::fopen
+#include "bstpaged.h" // paged_binary_search_tree
+#include "bstsnapshot.h" // compressed_int_snapshot
+#include <climits> // INT_MIN, INT_MAX
+#include "bstlatency.h" // timed_binary_search_tree, bst_latency_histogram
+#include <sstream> // std::ostringstream
+#include <set> // std::set
+#include "bstmerge.h" // merge_iterator
+#include "bstloader.h" // bst_load, bst_int_parser, bst_line_parser, bst_record_parser
+#include <stdexcept> // std::invalid_argument
+#include "bsttrace.h" // recording_binary_search_tree, bst_trace_reader
+#include "bstmultiset.h" // bst_multiset
+#include "bstlru.h" // bst_lru_cache
+#ifndef _WIN32
+#include <sys/resource.h> // setrlimit, RLIMIT_FSIZE
+#include <csignal> // std::signal, SIGXFSZ
+#endif
 
 template <typename T, typename C>
 struct less_than {
@@ -356,15 +110,18 @@ bool even (const bst_int &value) {
 	return *value.begin() % 2 == 0;
 }
 
+template <>
+bool even (const hashed_bst_int &value) {
+	return value.size() % 2 == 0;
+}
+
 template <typename T>
 bool odd (const T &value) {
 	return !even<T>(value);
 }
 
-template <typename C, typename E, typename T>
-void test_bst(const T *values, unsigned int size) {
-	
-	typedef binary_search_tree<T, C, E> bst;
+template <typename bst, typename C, typename T>
+void test_tree(const T *values, unsigned int size) {
 	
 	std::cout << "******** Test dei metodi fondamentali ********" << std::endl;
 	std::cout << std::endl;
@@ -569,6 +326,11 @@ void test_bst(const T *values, unsigned int size) {
 	printIF(const_tree, odd<T>);
 }
 
+template <typename C, typename E, typename T>
+void test_bst(const T *values, unsigned int size) {
+	test_tree<binary_search_tree<T, C, E>, C>(values, size);
+}
+
 void test_bst_int(void) {
 	
 	std::cout << std::endl;
@@ -689,30 +451,2353 @@ void test_continue(void) {
 	std::cout << "******** Fine test precedente ********" << std::endl;
 }
 
-void test(void) {
+template <typename C, typename E, typename T, bool P>
+void test_compact_bst(const T *values, unsigned int size) {
 	
-	std::cout << "**************** INIZIO TEST ****************" << std::endl << std::endl;
+	typedef compact_binary_search_tree<T, C, E, P> compact_bst;
 	
-	std::cout << "Premere Invio per avviare il primo test..." << std::endl;
-	test_bst_int();
+	test_tree<compact_bst, C>(values, size);
 	
-	test_continue();
-	test_bst_float();
+	std::cout << std::endl;
+	std::cout << "******** Test di coerenza con binary_search_tree ********" << std::endl;
+	std::cout << std::endl;
 	
-	test_continue();
-	test_bst_bool();
+	binary_search_tree<T, C, E> tree;
+	compact_bst compact_tree;
+	for(unsigned int i = 0; i < size; ++i) {
+		tree.insert(values[i]);
+		compact_tree.insert(values[i]);
+	}
 	
-	test_continue();
-	test_bst_string();
+	typename binary_search_tree<T, C, E>::const_iterator i = tree.begin(), ie = tree.end();
+	typename compact_bst::const_iterator ci = compact_tree.begin(), cie = compact_tree.end();
+	while(i != ie && ci != cie) {
+		E equals;
+		assert(equals(*i, *ci));
+		++i;
+		++ci;
+	}
+	assert(i == ie && ci == cie);
+	std::cout << "Stesso ordine di visita di binary_search_tree: " << compact_tree << std::endl;
+	std::cout << "Byte per nodo: " << compact_bst::node_size() << std::endl;
+}
+
+void test_compact_bst_int(void) {
 	
-	test_continue();
-	test_bst_complex();
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero compatto di interi ********" << std::endl;
+	std::cout << std::endl;
 	
-	test_continue();
-	test_bst_employee();
+	int values[8] = {42, 17, 50, 23, 90, -10, 69, 45};
+	
+	test_compact_bst<compare_int, equal_int, int, true>(values, 8);
 	
 	test_continue();
-	test_bst_bst_int();
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero compatto di interi senza padre ********" << std::endl;
+	std::cout << std::endl;
+	
+	test_compact_bst<compare_int, equal_int, int, false>(values, 8);
+}
+
+void test_compact_bst_complex(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero compatto di numeri complessi senza padre ********" << std::endl;
+	std::cout << std::endl;
+	
+	complex values[6] = {complex(2, 3), complex(-3, 6), complex(5, 7), complex(-5, -7), complex(0, -1), complex(4, 4)};
+	
+	test_compact_bst<compare_complex, equal_complex, complex, false>(values, 6);
+}
+
+void test_bst_batch(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test delle ricerche a gruppi su un albero di interi ********" << std::endl;
+	std::cout << std::endl;
+	
+	bst_int tree;
+	for(int i = 0; i < 100; ++i)
+		tree.insert((i * 37) % 100 * 2);
+	
+	std::list<int> keys;
+	for(int i = -5; i < 205; ++i)
+		keys.push_back(i);
+	
+	std::cout << "exists_batch:" << std::endl;
+	std::list<bool> found;
+	tree.exists_batch(keys.begin(), keys.end(), std::back_inserter(found));
+	assert(found.size() == keys.size());
+	std::list<int>::const_iterator k = keys.begin();
+	std::list<bool>::const_iterator f = found.begin();
+	unsigned int found_count = 0;
+	for(; k != keys.end(); ++k, ++f) {
+		assert(*f == tree.exists(*k));
+		found_count += *f;
+	}
+	std::cout << "Valori trovati: " << found_count << " su " << keys.size() << std::endl;
+	assert(found_count == 100);
+	std::cout << std::endl;
+	
+	std::cout << "find_batch:" << std::endl;
+	std::list<bst_int::const_iterator> iterators;
+	tree.find_batch(keys.begin(), keys.end(), std::back_inserter(iterators));
+	assert(iterators.size() == keys.size());
+	std::list<bst_int::const_iterator>::const_iterator it = iterators.begin();
+	for(k = keys.begin(); k != keys.end(); ++k, ++it) {
+		assert(*it == tree.find(*k));
+		if(*it != tree.end())
+			assert(**it == *k);
+	}
+	std::cout << "Iteratori coerenti con find" << std::endl;
+	
+	bst_int empty_tree;
+	found.clear();
+	empty_tree.exists_batch(keys.begin(), keys.end(), std::back_inserter(found));
+	assert(found.size() == keys.size());
+}
+
+void test_bst_insert_batch(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test degli inserimenti a gruppi su un albero di interi ********" << std::endl;
+	std::cout << std::endl;
+	
+	bst_int tree;
+	tree.insert(10);
+	tree.insert(5);
+	tree.insert(20);
+	
+	std::cout << "insert_batch con fusione:" << std::endl;
+	int values[8] = {7, 20, 1, 7, 30, 5, 15, 3};
+	std::list<int> rejected;
+	unsigned int count = tree.insert_batch(values, values + 8, std::back_inserter(rejected));
+	std::cout << tree << std::endl;
+	std::cout << "Valori scartati: " << count << std::endl;
+	assert(count == 3);
+	assert(rejected.size() == 3);
+	assert(rejected.front() == 5 && rejected.back() == 20);
+	assert(tree.size() == 8);
+	for(unsigned int i = 0; i < 8; ++i)
+		assert(tree.exists(values[i]));
+	std::cout << std::endl;
+	
+	std::cout << "insert_batch su albero grande:" << std::endl;
+	bst_int big_tree;
+	std::list<int> keys;
+	for(int i = 0; i < 200; ++i)
+		keys.push_back((i * 37) % 200 * 2);
+	assert(big_tree.insert_batch(keys.begin(), keys.end()) == 0);
+	assert(big_tree.size() == 200);
+	int few[4] = {1, 2, 3, 1};
+	count = big_tree.insert_batch(few, few + 4);
+	assert(count == 2);
+	assert(big_tree.size() == 202);
+	assert(big_tree.exists(1) && big_tree.exists(3) && !big_tree.exists(5));
+	std::cout << "Valori scartati: " << count << std::endl;
+	
+	std::cout << std::endl;
+	std::cout << "insert_batch di stringhe:" << std::endl;
+	binary_search_tree<std::string, compare_string, equal_string> strings;
+	std::string words[5] = {"C++", "ciao", "il", "c++", "narvalo"};
+	count = strings.insert_batch(words, words + 5);
+	std::cout << strings << std::endl;
+	assert(count == 1);
+	assert(strings.size() == 4);
+}
+
+void test_bst_try_insert(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test degli inserimenti senza eccezioni e con suggerimento ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "try_insert:" << std::endl;
+	bst_int tree;
+	std::pair<bst_int::const_iterator, bool> result = tree.try_insert(42);
+	assert(result.second && *result.first == 42);
+	result = tree.try_insert(17);
+	assert(result.second && *result.first == 17);
+	result = tree.try_insert(42);
+	assert(!result.second && *result.first == 42);
+	assert(tree.size() == 2);
+	std::cout << tree << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "try_insert con suggerimento:" << std::endl;
+	bst_int hinted;
+	bst_int::const_iterator hint = hinted.end();
+	int stream[12] = {10, 12, 11, 14, 14, 13, 20, 18, 19, 12, 25, 21};
+	unsigned int duplicates = 0;
+	for(unsigned int i = 0; i < 12; ++i) {
+		result = hinted.try_insert(hint, stream[i]);
+		assert(*result.first == stream[i]);
+		duplicates += !result.second;
+		hint = result.first;
+	}
+	std::cout << hinted << std::endl;
+	assert(duplicates == 2);
+	assert(hinted.size() == 10);
+	for(unsigned int i = 0; i < 12; ++i)
+		assert(hinted.exists(stream[i]));
+	assert(!hinted.exists(15) && !hinted.exists(9) && !hinted.exists(26));
+	
+	hint = hinted.find(20);
+	result = hinted.try_insert(hint, 15);
+	assert(result.second);
+	result = hinted.try_insert(hinted.find(10), 5);
+	assert(result.second);
+	result = hinted.try_insert(hinted.find(10), 30);
+	assert(result.second);
+	result = hinted.try_insert(hinted.end(), 1);
+	assert(result.second);
+	assert(hinted.exists(15) && hinted.exists(5) && hinted.exists(30) && hinted.exists(1));
+	std::cout << hinted << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "insert con suggerimento:" << std::endl;
+	bst_int::const_iterator inserted = hinted.insert(hinted.end(), 40);
+	assert(*inserted == 40);
+	try {
+		hinted.insert(inserted, 40);
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<int> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	std::cout << std::endl;
+	
+	std::cout << "try_emplace:" << std::endl;
+	binary_search_tree<complex, compare_complex, equal_complex> complexes;
+	assert(complexes.try_emplace(2, 3).second);
+	assert(complexes.try_emplace(1, 5).second);
+	assert(!complexes.try_emplace(2, 3).second);
+	assert(complexes.size() == 2);
+	std::cout << complexes << std::endl;
+}
+
+void test_splay_tree(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su uno splay tree di interi ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef splay_tree<int, compare_int, equal_int> splay_int;
+	
+	int values[8] = {42, 17, 50, 23, 90, -10, 69, 45};
+	
+	std::cout << "insert:" << std::endl;
+	splay_int tree;
+	for(unsigned int i = 0; i < 8; ++i) {
+		tree.insert(values[i]);
+		assert(*tree.begin() == values[i]);
+	}
+	std::cout << tree << std::endl;
+	assert(tree.size() == 8);
+	try {
+		tree.insert(23);
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<int> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	assert(*tree.begin() == 23);
+	std::pair<splay_int::const_iterator, bool> result = tree.try_insert(50);
+	assert(!result.second && *result.first == 50 && result.first == tree.begin());
+	result = tree.try_insert(60);
+	assert(result.second && *result.first == 60 && result.first == tree.begin());
+	assert(tree.size() == 9);
+	std::cout << std::endl;
+	
+	std::cout << "exists (sposta il valore cercato alla radice):" << std::endl;
+	for(unsigned int i = 0; i < 8; ++i) {
+		assert(tree.exists(values[i]));
+		assert(*tree.begin() == values[i]);
+		std::cout << tree << std::endl;
+	}
+	assert(!tree.exists(0));
+	assert(!tree.exists(100));
+	assert(*tree.begin() == 90);
+	assert(tree.size() == 9);
+	std::cout << std::endl;
+	
+	std::cout << "find:" << std::endl;
+	assert(*tree.find(-10) == -10);
+	assert(tree.find(1000) == tree.end());
+	std::cout << tree << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Copy Constructor su uno splay tree costante:" << std::endl;
+	const splay_int const_tree(tree);
+	std::cout << const_tree << std::endl;
+	assert(const_tree.size() == tree.size());
+	splay_int copy(const_tree);
+	for(unsigned int i = 0; i < 8; ++i)
+		assert(copy.exists(values[i]));
+}
+
+void test_bst_erase(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test delle rimozioni su un albero di interi ********" << std::endl;
+	std::cout << std::endl;
+	
+	int values[10] = {42, 17, 50, 23, 90, -10, 69, 45, 20, 95};
+	
+	bst_int tree;
+	for(unsigned int i = 0; i < 10; ++i)
+		tree.insert(values[i]);
+	std::cout << tree << std::endl;
+	
+	std::cout << "erase:" << std::endl;
+	int erased[5] = {17, 95, 42, -10, 90}; // due figli, massimo, radice, foglia, massimo
+	for(unsigned int i = 0; i < 5; ++i) {
+		tree.erase(erased[i]);
+		std::cout << "Rimosso " << erased[i] << ": " << tree << std::endl;
+		assert(!tree.exists(erased[i]));
+		assert(tree.size() == 9 - i);
+	}
+	for(unsigned int i = 0; i < 10; ++i) {
+		bool removed = false;
+		for(unsigned int j = 0; j < 5; ++j)
+			removed = removed || values[i] == erased[j];
+		assert(tree.exists(values[i]) != removed);
+	}
+	
+	tree.insert(100);
+	tree.insert(99);
+	assert(tree.try_insert(tree.end(), 101).second);
+	assert(tree.exists(100) && tree.exists(99) && tree.exists(101));
+	
+	try {
+		tree.erase(17);
+		assert(false);
+	}
+	catch(bst_value_not_found_exception<int> &e) {
+		std::cout << e.what() << e.get_not_found_value() << std::endl;
+	}
+	
+	unsigned int size = tree.size();
+	for(unsigned int i = 0; i < size; ++i)
+		tree.erase(*tree.begin());
+	assert(tree.size() == 0);
+	assert(tree.begin() == tree.end());
+	tree.insert(1);
+	assert(tree.try_insert(tree.end(), 2).second);
+	std::cout << tree << std::endl;
+}
+
+void test_filtered_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero di interi con filtro di Bloom ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef filtered_binary_search_tree<int, compare_int, equal_int, hash_int> filtered_bst;
+	
+	filtered_bst tree(0.01);
+	for(int i = 0; i < 1000; ++i)
+		tree.insert(i * 3);
+	assert(tree.size() == 1000);
+	assert(!tree.try_insert(3).second);
+	assert(tree.try_emplace(1).second);
+	int batch[3] = {2, 4, 3};
+	assert(tree.insert_batch(batch, batch + 3) == 1);
+	
+	std::cout << "exists:" << std::endl;
+	for(int i = 0; i < 1000; ++i)
+		assert(tree.exists(i * 3));
+	assert(tree.exists(1) && tree.exists(2) && tree.exists(4));
+	unsigned int misses = 0;
+	for(int i = 3000; i < 13000; ++i)
+		misses += !tree.exists(i);
+	assert(misses == 10000);
+	
+	bst_filter_stats stats = tree.filter_stats();
+	std::cout << "Ricerche: " << stats.queries << ", filtrate: " << stats.filtered
+			  << ", falsi positivi: " << stats.false_positives << std::endl;
+	assert(stats.queries == 11003);
+	assert(stats.filtered + stats.false_positives == 10000);
+	assert(stats.false_positives < 500);
+	std::cout << std::endl;
+	
+	std::cout << "erase:" << std::endl;
+	for(int i = 0; i < 500; ++i)
+		tree.erase(i * 3);
+	for(int i = 0; i < 1000; ++i)
+		assert(tree.exists(i * 3) == (i >= 500));
+	assert(tree.find(2997) != tree.end() && *tree.find(2997) == 2997);
+	assert(tree.find(0) == tree.end());
+	tree.reset_filter_stats();
+	assert(tree.filter_stats().queries == 0);
+	std::cout << "Byte del filtro: " << tree.filter_memory() << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "swap:" << std::endl;
+	filtered_bst other(0.01);
+	for(int i = 0; i < 100; ++i)
+		other.insert(-1 - i);
+	other.exists(0);
+	tree.swap(other); // il filtro segue i nodi
+	assert(tree.size() == 100 && other.size() == 503);
+	for(int i = 0; i < 100; ++i)
+		assert(tree.exists(-1 - i) && !other.exists(-1 - i));
+	for(int i = 500; i < 1000; ++i)
+		assert(other.exists(i * 3) && !tree.exists(i * 3));
+	assert(tree.filter_stats().queries == 601 && other.filter_stats().queries == 600);
+	std::cout << "Dimensioni dopo lo scambio: " << tree.size() << ", " << other.size() << std::endl;
+}
+
+void test_bst_map(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su una mappa da interi a impiegati ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef bst_map<int, employee, compare_int, equal_int> map;
+	
+	map employees;
+	std::cout << "try_emplace:" << std::endl;
+	assert(employees.try_emplace(300, "Andrea", "Tassi", 300));
+	assert(employees.try_emplace(200, "a", "b", 200));
+	assert(employees.try_emplace(401, "a", "f", 401));
+	assert(!employees.try_emplace(200, "b", "b", 200));
+	std::cout << employees << std::endl;
+	assert(employees.size() == 3);
+	assert(employees.find(200)->name == "a");
+	std::cout << std::endl;
+	
+	std::cout << "insert_or_assign:" << std::endl;
+	assert(!employees.insert_or_assign(200, employee("b", "b", 200)));
+	assert(employees.insert_or_assign(100, employee("Andrea", "Sassi", 100)));
+	std::cout << employees << std::endl;
+	assert(employees.size() == 4);
+	assert(employees.find(200)->name == "b");
+	std::cout << std::endl;
+	
+	std::cout << "find:" << std::endl;
+	const map const_employees(employees);
+	assert(const_employees.find(100) != nullptr);
+	assert(const_employees.find(500) == nullptr);
+	assert(const_employees.exists(401));
+	assert(!const_employees.exists(500));
+	std::cout << "Impiegato con chiave 100: " << *const_employees.find(100) << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "operator[]:" << std::endl;
+	bst_map<int, std::string, compare_int, equal_int> names;
+	names[2] = "due";
+	names[1] = "uno";
+	names[2] += "!";
+	assert(names.size() == 2);
+	assert(names[2] == "due!");
+	assert(names[3].empty());
+	assert(names.size() == 3);
+	std::cout << names << std::endl;
+}
+
+constexpr int static_ints[] = {-3, 1, 4, 7, 10, 15, 22};
+constexpr static_binary_search_tree<int, 7, compare_int, equal_int> static_int_tree(static_ints);
+
+constexpr complex static_complexes[] = {complex(-1, 2), complex(0, 0), complex(0, 5), complex(3, -1)};
+constexpr static_binary_search_tree<complex, 4, compare_complex, equal_complex>
+	static_complex_tree(static_complexes);
+
+/**
+	@brief Tabella di interi pari
+
+	Array di N interi pari 0, 2, ..., 2(N - 1), costruito
+	a tempo di compilazione.
+*/
+template <unsigned int N>
+struct even_table {
+	int values[N]; ///< valori della tabella
+};
+
+template <unsigned int N, unsigned int... I>
+constexpr even_table<N> make_even_table(bst_indices<I...>) {
+	return even_table<N>{{static_cast<int>(2 * I)...}};
+}
+
+constexpr even_table<2000> static_evens = make_even_table<2000>(bst_make_indices<2000>::type());
+constexpr static_binary_search_tree<int, 2000, compare_int, equal_int> static_large_tree(static_evens.values);
+
+// Controlli a tempo di compilazione
+static_assert(static_large_tree.size() == 2000, "size large");
+static_assert(static_large_tree.exists(0) && static_large_tree.exists(1998) && static_large_tree.exists(3998), "exists large");
+static_assert(!static_large_tree.exists(1999) && !static_large_tree.exists(4000), "!exists large");
+static_assert(static_int_tree.size() == 7, "size");
+static_assert(static_int_tree.exists(-3) && static_int_tree.exists(10) && static_int_tree.exists(22), "exists");
+static_assert(!static_int_tree.exists(0) && !static_int_tree.exists(23) && !static_int_tree.exists(-4), "!exists");
+static_assert(*static_int_tree.find(15) == 15, "find");
+static_assert(static_int_tree.find(5) == static_int_tree.end(), "find end");
+static_assert(static_complex_tree.exists(complex(0, 5)), "exists complex");
+static_assert(!static_complex_tree.exists(complex(0, 4)), "!exists complex");
+
+void test_static_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su alberi statici di interi e numeri complessi ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Stampa con operatore <<:" << std::endl;
+	std::cout << static_int_tree << std::endl;
+	std::cout << static_complex_tree << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Iterazione:" << std::endl;
+	int previous = -4;
+	unsigned int count = 0;
+	for(static_binary_search_tree<int, 7, compare_int, equal_int>::const_iterator
+		i = static_int_tree.begin(); i != static_int_tree.end(); ++i, ++count) {
+		assert(previous < *i);
+		previous = *i;
+	}
+	assert(count == static_int_tree.size());
+	std::cout << std::endl;
+	
+	std::cout << "Costruzione a tempo di esecuzione:" << std::endl;
+	std::string names[3] = {"Ugo", "Luca", "Andrea"};
+	static_binary_search_tree<std::string, 3, compare_string, equal_string> string_tree(names);
+	assert(string_tree.exists("Luca"));
+	assert(!string_tree.exists("Mario"));
+	std::cout << string_tree << std::endl;
+	
+	int duplicated[3] = {1, 2, 2};
+	try {
+		static_binary_search_tree<int, 3, compare_int, equal_int> tree(duplicated);
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<int> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	
+	int unsorted[3] = {1, 3, 2};
+	try {
+		static_binary_search_tree<int, 3, compare_int, equal_int> tree(unsorted);
+		assert(false);
+	}
+	catch(std::invalid_argument &e) {
+		std::cout << e.what() << std::endl;
+	}
+}
+
+typedef sharded_bst<int, compare_int, equal_int> sharded_bst_int;
+
+/**
+	@brief Inserimento concorrente in un albero partizionato
+
+	Inserisce i valori i * step + offset, con i in [0, count).
+*/
+void sharded_insert(sharded_bst_int *tree, int offset, int step, int count) {
+	for(int i = 0; i < count; ++i)
+		tree->insert(i * step + offset);
+}
+
+void test_sharded_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero di interi partizionato ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Inserimento da 4 thread:" << std::endl;
+	sharded_bst_int tree(8);
+	std::vector<std::thread> threads;
+	for(int t = 0; t < 4; ++t)
+		threads.push_back(std::thread(sharded_insert, &tree, t, 4, 5000));
+	for(unsigned int t = 0; t < threads.size(); ++t)
+		threads[t].join();
+	assert(tree.size() == 20000);
+	for(int i = 0; i < 20000; ++i)
+		assert(tree.exists(i));
+	assert(!tree.exists(-1) && !tree.exists(20000));
+	assert(!tree.try_insert(42));
+	try {
+		tree.insert(42);
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<int> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	for(unsigned int i = 0; i < tree.shard_count(); ++i) {
+		std::cout << "Shard " << i << ": " << tree.shard_size(i) << " valori" << std::endl;
+		assert(tree.shard_size(i) <= 20000 / 2);
+	}
+	std::cout << std::endl;
+	
+	std::cout << "copy_in_order, sorted_view e copy_range:" << std::endl;
+	std::vector<int> values;
+	tree.copy_in_order(std::back_inserter(values));
+	assert(values.size() == 20000);
+	for(int i = 0; i < 20000; ++i)
+		assert(values[i] == i);
+	{
+		sharded_bst_int::view view = tree.sorted_view();
+		sharded_bst_int::const_iterator i = view.begin(), ie = view.end();
+		for(int expected = 0; expected < 20000; ++expected, ++i)
+			assert(i != ie && *i == expected);
+		assert(i == ie);
+	}
+	sharded_bst_int empty(4);
+	sharded_bst_int::view empty_view = empty.sorted_view();
+	assert(empty_view.begin() == empty_view.end());
+	values.clear();
+	tree.copy_range(4990, 15010, std::back_inserter(values));
+	assert(values.size() == 10020);
+	for(unsigned int i = 0; i < values.size(); ++i)
+		assert(values[i] == static_cast<int>(4990 + i));
+	values.clear();
+	tree.copy_range(-10, 3, std::back_inserter(values));
+	assert(values.size() == 3 && values[0] == 0 && values[2] == 2);
+	
+	binary_search_tree<int, compare_int, equal_int> small;
+	int small_values[6] = {5, 1, 9, 3, 7, 11};
+	small.insert_batch(small_values, small_values + 6);
+	values.clear();
+	small.copy_range(3, 9, std::back_inserter(values));
+	assert(values.size() == 3 && values[0] == 3 && values[1] == 5 && values[2] == 7);
+	std::cout << "Intervallo [3, 9) di " << small << ": ";
+	for(unsigned int i = 0; i < values.size(); ++i)
+		std::cout << values[i] << " ";
+	std::cout << std::endl;
+}
+
+void test_hashed_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su alberi di interi con hash del contenuto ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "hash:" << std::endl;
+	hashed_bst_int tree1;
+	tree1.insert(0);
+	tree1.insert(1);
+	tree1.insert(-1);
+	
+	hashed_bst_int tree2;
+	int values[3] = {1, -1, 0};
+	assert(tree2.insert_batch(values, values + 3) == 0);
+	std::cout << tree1 << " hash " << tree1.hash() << std::endl;
+	std::cout << tree2 << " hash " << tree2.hash() << std::endl;
+	assert(tree1.hash() == tree2.hash());
+	assert(tree1 == tree2 && tree1.compare(tree2) == 0);
+	assert(!(tree1 < tree2) && !(tree2 < tree1));
+	
+	hashed_bst_int tree3(tree1);
+	tree3.insert(5);
+	assert(tree3 != tree1 && tree3.hash() != tree1.hash());
+	assert((tree1 < tree3) && tree1.compare(tree3) < 0 && tree3.compare(tree1) > 0);
+	tree3.erase(5);
+	assert(tree3 == tree1 && tree3.hash() == tree1.hash());
+	
+	int batch[4] = {7, 0, 8, 7};
+	assert(tree3.insert_batch(batch, batch + 4) == 2);
+	assert(!tree3.try_insert(8).second);
+	assert(tree3.try_emplace(9).second);
+	hashed_bst_int tree4;
+	int expected[6] = {-1, 0, 1, 7, 8, 9};
+	for(int i = 5; i >= 0; --i)
+		tree4.insert(expected[i]);
+	assert(tree3 == tree4);
+	std::cout << tree3 << " == " << tree4 << std::endl;
+	
+	hashed_bst_int empty;
+	assert(empty.hash() == 0 && empty < tree1);
+	
+	hashed_bst_int swapped(tree4);
+	swapped.swap(empty); // l'hash segue i nodi
+	assert(empty == tree3 && empty.hash() == tree3.hash());
+	assert(swapped.hash() == 0 && swapped.size() == 0 && swapped < tree1);
+	empty.swap(swapped);
+	assert(empty.hash() == 0 && swapped == tree4);
+	std::cout << std::endl;
+	
+	hashed_bst_int tree5;
+	tree5.insert(1);
+	tree5.insert(-2);
+	
+	hashed_bst_int trees[4] = {tree1, tree3, tree5, empty};
+	
+	test_bst<compare_bst_int, equal_bst_int>(trees, 4);
+}
+
+/**
+	@brief Ricerca per sovrapposizione con una visita completa
+
+	Ritorna, in ordine, gli intervalli di un vettore ordinato
+	che si sovrappongono a [low, high].
+*/
+std::vector<bst_interval<int> > overlapping_scan(const std::vector<bst_interval<int> > &intervals, int low, int high) {
+	std::vector<bst_interval<int> > result;
+	for(unsigned int i = 0; i < intervals.size(); ++i)
+		if(intervals[i].low <= high && intervals[i].high >= low)
+			result.push_back(intervals[i]);
+	return result;
+}
+
+void test_interval_tree(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero di intervalli di interi ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef bst_interval<int> interval;
+	typedef interval_tree<int, compare_int, equal_int> tree_type;
+	typedef compare_interval<int, compare_int> compare;
+	typedef equal_interval<int, equal_int> equal;
+	
+	std::cout << "overlapping e stabbing:" << std::endl;
+	tree_type tree;
+	tree.insert(interval(15, 20));
+	tree.insert(interval(10, 30));
+	tree.insert(interval(17, 19));
+	tree.insert(interval(5, 20));
+	tree.insert(interval(12, 15));
+	tree.insert(interval(30, 40));
+	std::cout << tree << std::endl;
+	
+	std::vector<interval> found;
+	tree.overlapping(6, 7, std::back_inserter(found));
+	assert(found.size() == 1 && equal()(found[0], interval(5, 20)));
+	found.clear();
+	tree.stabbing(30, std::back_inserter(found));
+	assert(found.size() == 2 && equal()(found[0], interval(10, 30)) && equal()(found[1], interval(30, 40)));
+	found.clear();
+	tree.overlapping(41, 50, std::back_inserter(found));
+	assert(found.empty());
+	found.clear();
+	tree.overlapping(16, 18, std::back_inserter(found));
+	std::cout << "Intervalli sovrapposti a [16, 18]: ";
+	for(unsigned int i = 0; i < found.size(); ++i)
+		std::cout << found[i] << " ";
+	std::cout << std::endl;
+	assert(found.size() == 4);
+	
+	assert(!tree.try_insert(interval(10, 30)).second);
+	try {
+		tree.insert(interval(3, 2));
+		assert(false);
+	}
+	catch(std::invalid_argument &e) {
+		std::cout << e.what() << std::endl;
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Confronto con una visita completa dopo inserimenti e rimozioni:" << std::endl;
+	tree_type random_tree;
+	std::vector<interval> intervals;
+	unsigned int seed = 12345;
+	for(unsigned int i = 0; i < 500; ++i) {
+		seed = seed * 1103515245 + 12345;
+		int low = static_cast<int>((seed >> 8) % 1000);
+		int length = static_cast<int>((seed >> 20) % 50);
+		if(random_tree.try_emplace(low, low + length).second)
+			intervals.push_back(interval(low, low + length));
+	}
+	for(unsigned int i = 0; i < intervals.size(); i += 3)
+		random_tree.erase(intervals[i]);
+	std::vector<interval> remaining;
+	for(unsigned int i = 0; i < intervals.size(); ++i)
+		if(i % 3 != 0)
+			remaining.push_back(intervals[i]);
+	std::vector<interval> batch;
+	batch.push_back(interval(2000, 2100));
+	batch.push_back(interval(-50, 2050));
+	batch.push_back(remaining[0]);
+	assert(random_tree.insert_batch(batch.begin(), batch.end()) == 1);
+	remaining.push_back(batch[0]);
+	remaining.push_back(batch[1]);
+	std::sort(remaining.begin(), remaining.end(), compare());
+	assert(random_tree.size() == remaining.size());
+	
+	for(int low = -60; low < 2200; low += 7) {
+		std::vector<interval> expected = overlapping_scan(remaining, low, low + 5);
+		found.clear();
+		random_tree.overlapping(low, low + 5, std::back_inserter(found));
+		assert(found.size() == expected.size());
+		for(unsigned int i = 0; i < found.size(); ++i)
+			assert(equal()(found[i], expected[i]));
+	}
+	std::cout << "Intervalli: " << random_tree.size() << ", ricerche verificate" << std::endl;
+}
+
+/**
+	@brief Distanza al quadrato tra due numeri complessi
+*/
+int complex_distance2(const complex &c1, const complex &c2) {
+	return (c1.re - c2.re) * (c1.re - c2.re) + (c1.im - c2.im) * (c1.im - c2.im);
+}
+
+void test_kd_tree(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un k-d tree di numeri complessi ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef kd_tree<complex, 2, complex_axis, equal_complex> kd_complex;
+	
+	std::cout << "build e insert:" << std::endl;
+	complex points[7] = {complex(2, 3), complex(5, 4), complex(9, 6), complex(4, 7),
+						 complex(8, 1), complex(7, 2), complex(5, 4)};
+	kd_complex tree;
+	assert(tree.build(points, points + 7) == 1);
+	assert(tree.size() == 6);
+	std::cout << tree << std::endl;
+	tree.insert(complex(6, 6));
+	assert(tree.size() == 7);
+	try {
+		tree.insert(complex(9, 6));
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<complex> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	for(unsigned int i = 0; i < 6; ++i)
+		assert(tree.exists(points[i]));
+	assert(tree.exists(complex(6, 6)));
+	assert(!tree.exists(complex(6, 5)));
+	std::cout << std::endl;
+	
+	std::cout << "nearest e range:" << std::endl;
+	std::vector<complex> found;
+	tree.nearest(complex(9, 2), 2, std::back_inserter(found));
+	assert(found.size() == 2);
+	assert(equal_complex()(found[0], complex(8, 1)) && equal_complex()(found[1], complex(7, 2)));
+	std::cout << "2 punti piu' vicini a (9, 2): " << found[0] << " " << found[1] << std::endl;
+	found.clear();
+	tree.range(complex(4, 2), complex(7, 6), std::back_inserter(found));
+	assert(found.size() == 3);
+	std::cout << "Punti nel box [(4, 2), (7, 6)]: ";
+	for(unsigned int i = 0; i < found.size(); ++i)
+		std::cout << found[i] << " ";
+	std::cout << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Confronto con una ricerca esaustiva:" << std::endl;
+	std::vector<complex> random_points;
+	unsigned int seed = 54321;
+	for(unsigned int i = 0; i < 1000; ++i) {
+		seed = seed * 1103515245 + 12345;
+		random_points.push_back(complex(static_cast<int>((seed >> 8) % 100), static_cast<int>((seed >> 18) % 100)));
+	}
+	kd_complex random_tree;
+	unsigned int rejected = random_tree.build(random_points.begin(), random_points.begin() + 800);
+	for(unsigned int i = 800; i < 1000; ++i)
+		if(!random_tree.exists(random_points[i]))
+			random_tree.insert(random_points[i]);
+		else
+			rejected++;
+	assert(random_tree.size() + rejected == 1000);
+	
+	for(int q = 0; q < 100; q += 3) {
+		complex query(q, 99 - q);
+		found.clear();
+		random_tree.nearest(query, 5, std::back_inserter(found));
+		assert(found.size() == 5);
+		int worst = complex_distance2(query, found[4]);
+		for(unsigned int i = 1; i < 5; ++i)
+			assert(complex_distance2(query, found[i - 1]) <= complex_distance2(query, found[i]));
+		unsigned int closer = 0;
+		kd_complex::const_iterator i, ie;
+		for(i = random_tree.begin(), ie = random_tree.end(); i != ie; ++i)
+			closer += complex_distance2(query, *i) < worst;
+		assert(closer < 5);
+		
+		found.clear();
+		random_tree.range(complex(q - 10, q - 20), complex(q + 10, q), std::back_inserter(found));
+		unsigned int inside = 0;
+		for(i = random_tree.begin(), ie = random_tree.end(); i != ie; ++i)
+			inside += i->re >= q - 10 && i->re <= q + 10 && i->im >= q - 20 && i->im <= q;
+		assert(found.size() == inside);
+	}
+	std::cout << "Punti: " << random_tree.size() << ", ricerche verificate" << std::endl;
+}
+
+void test_string_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero di stringhe con prefissi nei nodi ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "insert ed exists:" << std::endl;
+	std::string values[9] = {"mela", "melanzana", "melanzane", "", "a",
+							 std::string("abc\0", 4), "abc", "abcdefgh", "abcdefghi"};
+	string_binary_search_tree tree;
+	for(unsigned int i = 0; i < 9; ++i)
+		tree.insert(values[i]);
+	assert(tree.size() == 9);
+	assert(!tree.try_insert("melanzana"));
+	try {
+		tree.insert("abc");
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<std::string> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	for(unsigned int i = 0; i < 9; ++i)
+		assert(tree.exists(values[i]));
+	assert(!tree.exists("ab"));
+	assert(!tree.exists("abcdefghij"));
+	assert(!tree.exists("melanzan"));
+	assert(!tree.exists(std::string("abc\0\0", 5)));
+	std::cout << std::endl;
+	
+	std::cout << "copy_in_order:" << std::endl;
+	std::vector<std::string> ordered;
+	tree.copy_in_order(std::back_inserter(ordered));
+	std::vector<std::string> expected(values, values + 9);
+	std::sort(expected.begin(), expected.end(), compare_string_lexicographic());
+	assert(ordered == expected);
+	std::cout << tree << std::endl;
+	std::cout << "Byte occupati: " << tree.memory_usage() << std::endl;
+}
+
+void test_journaled_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero con giornale ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef journaled_bst<int, compare_int, equal_int, bst_pod_codec<int> > journaled_bst_int;
+	const std::string path = "test_journal";
+	std::remove((path + ".log").c_str());
+	std::remove((path + ".ckpt").c_str());
+	
+	bst_journal_options options;
+	options.group_size = 4;
+	options.max_delay = std::chrono::hours(1);
+	options.checkpoint_bytes = 0;
+	
+	std::cout << "Ripristino dal giornale:" << std::endl;
+	{
+		journaled_bst_int tree(path, options);
+		assert(tree.size() == 0);
+		int values[8] = {5, 3, 8, 1, 4, 7, 3, 5};
+		assert(tree.insert_batch(values, values + 8) == 2); // i duplicati non vengono registrati
+		assert(tree.insert_batch(values, values + 2) == 2);
+		tree.insert(9);
+		assert(!tree.try_insert(3));
+		tree.erase(8);
+		try {
+			tree.insert(5);
+			assert(false);
+		}
+		catch(bst_duplicated_value_exception<int> &e) {
+			std::cout << e.what() << e.get_duplicated_value() << std::endl;
+		}
+		tree.insert(8);
+		tree.erase(1);
+		assert(tree.sync_count() == 2);
+	}
+	{
+		journaled_bst_int tree(path, options);
+		assert(tree.replayed_records() == 10);
+		assert(tree.size() == 6);
+		assert(!tree.exists(1));
+		assert(tree.exists(8) && tree.exists(9));
+		std::cout << tree.tree() << std::endl;
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Record incompleto in coda al giornale:" << std::endl;
+	{
+		std::FILE *log = std::fopen((path + ".log").c_str(), "ab");
+		assert(log != nullptr);
+		const char torn[7] = {'I', 4, 0, 0, 0, 42, 0};
+		std::fwrite(torn, 1, sizeof(torn), log);
+		std::fclose(log);
+	}
+	{
+		journaled_bst_int tree(path, options);
+		assert(tree.replayed_records() == 10);
+		assert(tree.size() == 6);
+		assert(!tree.exists(42));
+		assert(tree.journal_bytes() == 0); // coda eliminata con un checkpoint
+		tree.insert(42);
+		std::cout << tree.tree() << std::endl;
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Checkpoint:" << std::endl;
+	{
+		journaled_bst_int tree(path, options);
+		assert(tree.replayed_records() == 1);
+		assert(tree.size() == 7 && tree.exists(42));
+		tree.checkpoint();
+		assert(tree.journal_bytes() == 0);
+		tree.erase(42);
+	}
+	{
+		journaled_bst_int tree(path, options);
+		assert(tree.replayed_records() == 1);
+		assert(tree.size() == 6 && !tree.exists(42));
+		std::cout << tree.tree() << std::endl;
+	}
+	std::cout << std::endl;
+	
+#ifndef _WIN32
+	std::cout << "Errore di scrittura del giornale:" << std::endl;
+	std::cout.flush(); // nessuna scrittura su file finche' vale il limite
+	{
+		journaled_bst_int tree(path, options);
+		unsigned long long bytes = tree.journal_bytes();
+		struct rlimit saved;
+		getrlimit(RLIMIT_FSIZE, &saved);
+		struct rlimit limit = saved;
+		limit.rlim_cur = bytes + 20; // il primo record del gruppo viene scritto a meta'
+		void (*handler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+		setrlimit(RLIMIT_FSIZE, &limit);
+		bool thrown = false;
+		try {
+			for(int i = 100; i < 104; ++i)
+				tree.insert(i); // il quarto inserimento sincronizza il gruppo
+		}
+		catch(bst_io_exception &e) {
+			thrown = true;
+		}
+		setrlimit(RLIMIT_FSIZE, &saved);
+		std::signal(SIGXFSZ, handler);
+		assert(thrown && tree.journal_bytes() == bytes && tree.exists(103));
+		tree.sync(); // nuovo tentativo dopo il troncamento del record incompleto
+		assert(tree.journal_bytes() == bytes + 4 * 13);
+	}
+	{
+		journaled_bst_int tree(path, options);
+		assert(tree.replayed_records() == 5); // nessun record perso dopo quello incompleto
+		assert(tree.size() == 10 && tree.exists(100) && tree.exists(103));
+		std::cout << tree.tree() << std::endl;
+	}
+	std::cout << std::endl;
+#endif
+	
+	std::cout << "Giornale di stringhe:" << std::endl;
+	{
+		journaled_bst<std::string, compare_string_lexicographic, equal_string_content, bst_string_codec> tree(path + "_string");
+		tree.insert("giornale");
+		tree.insert("");
+		tree.insert("checkpoint");
+	}
+	{
+		journaled_bst<std::string, compare_string_lexicographic, equal_string_content, bst_string_codec> tree(path + "_string");
+		assert(tree.size() == 3 && tree.exists("") && tree.exists("giornale"));
+		std::cout << tree.tree() << std::endl;
+	}
+	
+	std::remove((path + ".log").c_str());
+	std::remove((path + ".ckpt").c_str());
+	std::remove((path + "_string.log").c_str());
+	std::remove((path + "_string.ckpt").c_str());
+}
+
+void test_paged_bst(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un albero paginato su file ********" << std::endl;
+	std::cout << std::endl;
+	
+	// Pagine da 64 byte: 14 int per foglia, 5 chiavi per pagina interna
+	typedef paged_binary_search_tree<int, compare_int, equal_int, 64> paged_bst_int;
+	const std::string path = "test_paged.db";
+	std::remove(path.c_str());
+	
+	std::cout << "insert ed exists con un pool di 4 pagine:" << std::endl;
+	std::vector<int> values;
+	for(int i = 0; i < 2000; ++i)
+		values.push_back((i * 7919) % 2000 * 2); // numeri pari in ordine sparso
+	{
+		paged_bst_int tree(path, 4);
+		for(unsigned int i = 0; i < values.size(); ++i)
+			tree.insert(values[i]);
+		assert(tree.size() == 2000);
+		assert(!tree.try_insert(values[10]));
+		try {
+			tree.insert(42);
+			assert(false);
+		}
+		catch(bst_duplicated_value_exception<int> &e) {
+			std::cout << e.what() << e.get_duplicated_value() << std::endl;
+		}
+		for(int v = -1; v <= 4000; ++v)
+			assert(tree.exists(v) == (v >= 0 && v < 4000 && v % 2 == 0));
+		std::cout << "Pagine: " << tree.page_count() << ", lette: " << tree.page_reads()
+				  << ", scritte: " << tree.page_writes() << std::endl;
+		assert(tree.page_reads() > 0);
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Riapertura, iteratore e copy_range:" << std::endl;
+	{
+		paged_bst_int tree(path, 16);
+		assert(tree.size() == 2000);
+		std::vector<int> ordered;
+		tree.copy_in_order(std::back_inserter(ordered));
+		std::vector<int> expected(values);
+		std::sort(expected.begin(), expected.end());
+		assert(ordered == expected);
+		
+		int count = 0;
+		for(paged_bst_int::const_iterator i = tree.begin(), last = tree.end(); i != last; ++i)
+			assert(*i == 2 * count++);
+		assert(count == 2000);
+		
+		std::vector<int> range;
+		tree.copy_range(11, 31, std::back_inserter(range));
+		int expected_range[10] = {12, 14, 16, 18, 20, 22, 24, 26, 28, 30};
+		assert(range == std::vector<int>(expected_range, expected_range + 10));
+		assert(*tree.lower_bound(3997) == 3998);
+		assert(tree.lower_bound(3999) == tree.end());
+		tree.insert(4001);
+		for(unsigned int i = 0; i < range.size(); ++i)
+			std::cout << range[i] << " ";
+		std::cout << std::endl;
+	}
+	{
+		paged_bst_int tree(path, 4);
+		assert(tree.size() == 2001 && tree.exists(4001));
+	}
+	std::cout << std::endl;
+	
+	std::cout << "File non valido e pool troppo piccolo:" << std::endl;
+	try {
+		paged_binary_search_tree<double, compare_float, equal_float, 64> tree(path);
+		assert(false);
+	}
+	catch(bst_io_exception &e) {
+		std::cout << e.what() << e.get_path() << std::endl;
+	}
+	try {
+		paged_bst_int tree(path, 3);
+		assert(false);
+	}
+	catch(std::invalid_argument &e) {
+		std::cout << e.what() << std::endl;
+	}
+	
+	std::remove(path.c_str());
+	std::cout << std::endl;
+	
+	std::cout << "Stampa:" << std::endl;
+	{
+		paged_bst_int tree(path, 4);
+		tree.insert(3);
+		tree.insert(1);
+		tree.insert(2);
+		std::cout << tree << std::endl;
+	}
+	std::remove(path.c_str());
+}
+
+void test_compressed_snapshot(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su un'istantanea compressa di interi ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Istantanea di un bst_int:" << std::endl;
+	int small_values[8] = {7, -3, 12, INT_MIN, 0, INT_MAX, 8, 9};
+	bst_int tree;
+	for(unsigned int i = 0; i < 8; ++i)
+		tree.insert(small_values[i]);
+	compressed_int_snapshot small(tree);
+	assert(small.size() == 8);
+	for(unsigned int i = 0; i < 8; ++i)
+		assert(small.exists(small_values[i]));
+	assert(!small.exists(1) && !small.exists(INT_MIN + 1) && !small.exists(INT_MAX - 1));
+	assert(*small.lower_bound(1) == 7);
+	assert(*small.lower_bound(INT_MIN) == INT_MIN);
+	assert(small.lower_bound(INT_MAX) != small.end());
+	std::cout << small << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Piu' blocchi con differenze di ampiezza variabile:" << std::endl;
+	std::vector<int> values;
+	int v = -100000;
+	for(int i = 0; i < 1000; ++i) {
+		values.push_back(v);
+		v += (i < 300) ? 1 : (i < 600) ? 1 + i % 17 : 1 + (i * 7919) % 100000;
+	}
+	compressed_int_snapshot snapshot(values.begin(), values.end());
+	assert(snapshot.size() == 1000);
+	for(unsigned int i = 0; i < values.size(); ++i) {
+		assert(snapshot.exists(values[i]));
+		assert(!snapshot.exists(values[i] - 1) || (i > 0 && values[i - 1] == values[i] - 1));
+		assert(*snapshot.lower_bound(values[i]) == values[i]);
+		if(i + 1 < values.size())
+			assert(*snapshot.lower_bound(values[i] + 1) == values[i + 1]);
+	}
+	assert(snapshot.lower_bound(values.back() + 1) == snapshot.end());
+	
+	std::vector<int> ordered;
+	snapshot.copy_in_order(std::back_inserter(ordered));
+	assert(ordered == values);
+	unsigned int count = 0;
+	for(compressed_int_snapshot::const_iterator i = snapshot.begin(), last = snapshot.end(); i != last; ++i)
+		assert(*i == values[count++]);
+	assert(count == values.size());
+	std::cout << "Byte occupati: " << snapshot.memory_usage() << " per " << snapshot.size() << " valori" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Istantanea vuota e valori non ordinati:" << std::endl;
+	bst_int empty_tree;
+	compressed_int_snapshot empty(empty_tree);
+	assert(empty.size() == 0 && !empty.exists(0) && empty.begin() == empty.end());
+	assert(empty.lower_bound(0) == empty.end());
+	try {
+		int unordered[3] = {1, 3, 2};
+		compressed_int_snapshot invalid(unordered, unordered + 3);
+		assert(false);
+	}
+	catch(std::invalid_argument &e) {
+		std::cout << e.what() << std::endl;
+	}
+}
+
+struct sum_int {
+	
+	long long total; ///< somma dei valori visitati
+	
+	/**
+		@brief Costruttore di default
+		
+		Costruttore che azzera la somma.
+	*/
+	sum_int() : total(0) {} // initialization list
+	
+	void operator()(int value) {
+		total += value;
+	}
+};
+
+void test_latency(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sulla misura delle latenze ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Percentili di un istogramma:" << std::endl;
+	bst_latency_histogram histogram;
+	assert(histogram.count() == 0 && histogram.percentile(50) == 0);
+	for(unsigned long long ticks = 1; ticks <= 1000; ++ticks)
+		histogram.record(ticks);
+	assert(histogram.count() == 1000 && histogram.max() == 1000);
+	unsigned long long p50 = histogram.percentile(50);
+	assert(p50 >= 500 && p50 <= 500 * 1.125);
+	unsigned long long p99 = histogram.percentile(99);
+	assert(p99 >= 990 && p99 <= 1000);
+	assert(histogram.percentile(100) == 1000);
+	assert(histogram.percentile(0) <= 1);
+	for(unsigned long long ticks = 0; ticks < 16; ++ticks) { // valori piccoli esatti
+		bst_latency_histogram exact;
+		exact.record(ticks);
+		assert(exact.percentile(50) == ticks);
+	}
+	bst_latency_histogram other;
+	other.record(1ULL << 40);
+	histogram.merge(other);
+	assert(histogram.count() == 1001 && histogram.max() == (1ULL << 40));
+	assert(histogram.percentile(50) == p50);
+	std::cout << "p50 = " << p50 << ", p99 = " << p99 << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Operazioni misurate:" << std::endl;
+	timed_binary_search_tree<int, compare_int, equal_int> tree;
+	int values[7] = {4, 2, 6, 1, 3, 5, 7};
+	for(unsigned int i = 0; i < 7; ++i)
+		tree.insert(values[i]);
+	try {
+		tree.insert(4);
+		assert(false);
+	}
+	catch(bst_duplicated_value_exception<int> &e) {
+		std::cout << e.what() << e.get_duplicated_value() << std::endl;
+	}
+	assert(tree.exists(3) && !tree.exists(8));
+	bst_int sub = tree.subtree(6);
+	assert(sub.size() == 3);
+	std::vector<int> ordered;
+	tree.copy_in_order(std::back_inserter(ordered));
+	assert(ordered.size() == 7);
+	assert(tree.for_each(sum_int()).total == 28);
+	tree.erase(7);
+	
+	const bst_latency_recorder &latency = tree.latency();
+	assert(latency.histogram(bst_op_insert).count() == 8);
+	assert(latency.histogram(bst_op_exists).count() == 2);
+	assert(latency.histogram(bst_op_subtree).count() == 1);
+	assert(latency.histogram(bst_op_copy_in_order).count() == 1);
+	assert(latency.histogram(bst_op_iteration).count() == 1);
+	assert(latency.histogram(bst_op_erase).count() == 1);
+	assert(latency.histogram(bst_op_copy).count() == 0);
+	
+	timed_binary_search_tree<int, compare_int, equal_int> copy(tree);
+	assert(copy.latency().histogram(bst_op_copy).count() == 1);
+	assert(copy.size() == 6 && copy.exists(6) && !copy.exists(7));
+	copy = tree;
+	assert(copy.latency().histogram(bst_op_copy).count() == 1);
+	assert(copy.latency().histogram(bst_op_insert).count() == 8); // registro copiato da tree
+	
+	bst_latency_recorder total;
+	total.merge(latency);
+	total.merge(latency);
+	assert(total.histogram(bst_op_insert).count() == 16);
+	
+	std::ostringstream json;
+	total.write_json(json);
+	assert(json.str().find("\"insert\": {\"count\": 16") != std::string::npos);
+	assert(json.str().find("\"p999_ns\"") != std::string::npos);
+	total.write_text(std::cout);
+	
+	tree.clear_latency();
+	assert(tree.latency().histogram(bst_op_insert).count() == 0);
+	
+	// letture in parallelo di un albero condiviso, con un registro per thread
+	const timed_binary_search_tree<int, compare_int, equal_int> &shared = tree;
+	bst_latency_recorder recorders[4];
+	std::vector<std::thread> readers;
+	for(unsigned int t = 0; t < 4; ++t)
+		readers.push_back(std::thread([&shared, &recorders, t]() {
+			for(int i = 0; i < 1000; ++i)
+				shared.exists(i % 10, recorders[t]);
+			std::vector<int> copy;
+			shared.copy_in_order(std::back_inserter(copy), recorders[t]);
+			shared.for_each(sum_int(), recorders[t]);
+			shared.subtree(6, recorders[t]);
+		}));
+	for(unsigned int t = 0; t < 4; ++t)
+		readers[t].join();
+	bst_latency_recorder readers_total;
+	for(unsigned int t = 0; t < 4; ++t)
+		readers_total.merge(recorders[t]);
+	assert(readers_total.histogram(bst_op_exists).count() == 4000);
+	assert(readers_total.histogram(bst_op_copy_in_order).count() == 4 && readers_total.histogram(bst_op_subtree).count() == 4);
+	assert(readers_total.histogram(bst_op_iteration).count() == 4);
+	assert(tree.latency().histogram(bst_op_exists).count() == 0); // il registro dell'albero non cambia
+}
+
+void test_bst_min_max(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su minimo, massimo, pop_min e pop_max ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Albero vuoto:" << std::endl;
+	bst_int empty;
+	try {
+		empty.min();
+		assert(false);
+	}
+	catch(bst_empty_tree_exception &e) {
+		std::cout << e.what() << std::endl;
+	}
+	try {
+		empty.pop_max();
+		assert(false);
+	}
+	catch(bst_empty_tree_exception &e) {
+		std::cout << e.what() << std::endl;
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Operazioni casuali confrontate con std::set:" << std::endl;
+	bst_int tree;
+	std::set<int> reference;
+	unsigned int seed = 12345;
+	for(unsigned int step = 0; step < 5000; ++step) {
+		seed = seed * 1103515245 + 12345;
+		int value = static_cast<int>((seed >> 8) % 200);
+		switch((seed >> 20) % 7) {
+			case 0:
+				tree.try_insert(value);
+				reference.insert(value);
+				break;
+			case 1:
+				tree.try_insert(tree.begin(), value);
+				reference.insert(value);
+				break;
+			case 2: {
+				int batch[3] = {value, value + 1, -value};
+				tree.insert_batch(batch, batch + 3);
+				reference.insert(batch, batch + 3);
+				break;
+			}
+			case 3:
+				if(tree.exists(value)) {
+					tree.erase(value);
+					reference.erase(value);
+				}
+				break;
+			case 4:
+				if(!reference.empty()) {
+					assert(tree.pop_min() == *reference.begin());
+					reference.erase(reference.begin());
+				}
+				break;
+			case 5:
+				if(!reference.empty()) {
+					assert(tree.pop_max() == *reference.rbegin());
+					reference.erase(--reference.end());
+				}
+				break;
+			default: {
+				bst_int copy(tree);
+				tree.swap(copy);
+				break;
+			}
+		}
+		assert(tree.size() == reference.size());
+		if(!reference.empty())
+			assert(tree.min() == *reference.begin() && tree.max() == *reference.rbegin());
+	}
+	std::cout << "Dimensione finale: " << tree.size() << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "pop_min di stringhe (coda di priorita'):" << std::endl;
+	binary_search_tree<std::string, compare_string_lexicographic, equal_string_content> queue;
+	queue.insert("c");
+	queue.insert("a");
+	queue.insert("d");
+	queue.insert("b");
+	std::string popped;
+	while(queue.size() > 0)
+		popped += queue.pop_min();
+	assert(popped == "abcd");
+	std::cout << popped << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Alberi derivati:" << std::endl;
+	hashed_bst_int hashed;
+	hashed_bst_int expected;
+	for(int i = 0; i < 10; ++i)
+		hashed.insert(i);
+	for(int i = 1; i < 9; ++i)
+		expected.insert(i);
+	assert(hashed.pop_min() == 0 && hashed.pop_max() == 9);
+	assert(hashed == expected);
+	
+	typedef bst_interval<int> interval;
+	interval_tree<int, compare_int, equal_int> intervals;
+	intervals.insert(interval(1, 100));
+	intervals.insert(interval(5, 6));
+	intervals.insert(interval(10, 50));
+	assert(intervals.pop_min().high == 100);
+	std::vector<interval> found;
+	intervals.stabbing(70, std::back_inserter(found));
+	assert(found.empty());
+	intervals.stabbing(20, std::back_inserter(found));
+	assert(found.size() == 1 && found[0].low == 10);
+	assert(intervals.pop_max().low == 10);
+	std::cout << intervals << std::endl;
+}
+
+void test_merge_iterator(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sulla visita ordinata di piu' alberi ********" << std::endl;
+	std::cout << std::endl;
+	
+	typedef merge_iterator<int, compare_int, equal_int> merged;
+	
+	std::cout << "Iteratore ordinato di un albero:" << std::endl;
+	bst_int single;
+	int single_values[7] = {4, 2, 6, 1, 3, 5, 7};
+	for(unsigned int i = 0; i < 7; ++i)
+		single.insert(single_values[i]);
+	int expected = 1;
+	for(bst_int::const_sorted_iterator i = single.sorted_begin(), ie = single.sorted_end(); i != ie; ++i)
+		assert(*i == expected++);
+	assert(expected == 8);
+	assert(*single.sorted_lower_bound(0) == 1 && *single.sorted_lower_bound(5) == 5);
+	assert(single.sorted_lower_bound(8) == single.sorted_end());
+	std::cout << std::endl;
+	
+	std::cout << "Fusione di 12 alberi:" << std::endl;
+	std::vector<bst_int> trees(12);
+	std::multiset<int> all;
+	unsigned int seed = 777;
+	for(unsigned int t = 0; t < trees.size(); ++t)
+		for(unsigned int k = 0; k < 10 * t; ++k) { // il primo albero e' vuoto
+			seed = seed * 1103515245 + 12345;
+			int value = static_cast<int>((seed >> 8) % 300);
+			if(trees[t].try_insert(value).second)
+				all.insert(value);
+		}
+	std::vector<const bst_int *> pointers;
+	for(unsigned int t = 0; t < trees.size(); ++t)
+		pointers.push_back(&trees[t]);
+	
+	std::vector<int> result(merged(pointers.begin(), pointers.end()), merged());
+	assert(result == std::vector<int>(all.begin(), all.end()));
+	
+	std::set<int> distinct(all.begin(), all.end());
+	result.assign(merged(pointers.begin(), pointers.end(), true), merged());
+	assert(result == std::vector<int>(distinct.begin(), distinct.end()));
+	
+	result.assign(merged(pointers.begin(), pointers.end(), 100, 120, true), merged());
+	assert(result == std::vector<int>(distinct.lower_bound(100), distinct.lower_bound(120)));
+	result.assign(merged(pointers.begin(), pointers.end(), 100, 120), merged());
+	assert(result == std::vector<int>(all.lower_bound(100), all.lower_bound(120)));
+	for(unsigned int i = 0; i < result.size(); ++i)
+		std::cout << result[i] << " ";
+	std::cout << std::endl;
+	
+	assert(merged(pointers.begin(), pointers.begin()) == merged());
+	assert(merged(pointers.begin(), pointers.begin() + 1) == merged());
+	assert(merged(pointers.begin(), pointers.end(), 500, 600) == merged());
+	std::cout << std::endl;
+	
+	std::cout << "Fusione degli alberi di un albero di alberi:" << std::endl;
+	binary_search_tree<bst_int, compare_bst_int, equal_bst_int> forest;
+	for(unsigned int t = 1; t < 5; ++t)
+		forest.insert(trees[t]);
+	std::vector<const bst_int *> members;
+	for(binary_search_tree<bst_int, compare_bst_int, equal_bst_int>::const_iterator i = forest.begin(), ie = forest.end(); i != ie; ++i)
+		members.push_back(&*i);
+	unsigned int count = 0;
+	int previous = -1;
+	for(merged i(members.begin(), members.end(), true), ie; i != ie; ++i, ++count) {
+		assert(*i > previous);
+		previous = *i;
+	}
+	std::cout << "Valori distinti: " << count << std::endl;
+}
+
+void test_bst_relayout(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sulla compattazione dei nodi in memoria ********" << std::endl;
+	std::cout << std::endl;
+	
+	bst_layout layouts[3] = {bst_layout_in_order, bst_layout_breadth_first, bst_layout_van_emde_boas};
+	const char *names[3] = {"in ordine", "per livelli", "van Emde Boas"};
+	
+	for(unsigned int l = 0; l < 3; ++l) {
+		std::cout << "Disposizione " << names[l] << ":" << std::endl;
+		bst_int tree;
+		std::set<int> reference;
+		unsigned int seed = 4242 + l;
+		for(unsigned int i = 0; i < 2000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			int value = static_cast<int>((seed >> 8) % 5000);
+			tree.try_insert(value);
+			reference.insert(value);
+		}
+		
+		std::vector<int> pre_order(tree.begin(), tree.end());
+		tree.compact(layouts[l]);
+		assert(std::vector<int>(tree.begin(), tree.end()) == pre_order); // stessa forma
+		assert(std::vector<int>(tree.sorted_begin(), tree.sorted_end()) == std::vector<int>(reference.begin(), reference.end()));
+		assert(tree.min() == *reference.begin() && tree.max() == *reference.rbegin());
+		
+		// L'albero resta modificabile, anche dopo una seconda compattazione
+		for(unsigned int i = 0; i < 3000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			int value = static_cast<int>((seed >> 8) % 5000);
+			if(reference.count(value) != 0) {
+				tree.erase(value);
+				reference.erase(value);
+			}
+			else {
+				tree.insert(value);
+				reference.insert(value);
+			}
+			if(i == 1500)
+				tree.compact(layouts[(l + 1) % 3]);
+		}
+		assert(tree.size() == reference.size());
+		assert(std::vector<int>(tree.sorted_begin(), tree.sorted_end()) == std::vector<int>(reference.begin(), reference.end()));
+		
+		bst_int copy(tree);
+		while(tree.size() > 0) // il blocco viene deallocato con l'ultimo nodo
+			tree.pop_min();
+		tree.compact(layouts[l]);
+		assert(copy.size() == reference.size());
+		std::cout << "Dimensione: " << copy.size() << std::endl;
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Albero degenere (inserimenti ordinati):" << std::endl;
+	bst_int chain;
+	for(int i = 0; i < 20000; ++i)
+		chain.insert(i);
+	chain.compact(bst_layout_van_emde_boas);
+	for(int i = 0; i < 20000; i += 997)
+		assert(chain.exists(i));
+	assert(!chain.exists(20000));
+	chain.compact(bst_layout_breadth_first);
+	assert(chain.max() == 19999 && chain.size() == 20000);
+	std::cout << "Dimensione: " << chain.size() << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Albero di stringhe:" << std::endl;
+	binary_search_tree<std::string, compare_string_lexicographic, equal_string_content> words;
+	words.insert("delta");
+	words.insert("alfa");
+	words.insert("eco");
+	words.insert("bravo");
+	words.compact(bst_layout_van_emde_boas);
+	words.erase("alfa");
+	words.insert("charlie");
+	std::cout << words << std::endl;
+	assert(words.min() == "bravo" && words.exists("charlie"));
+	
+	std::cout << "Albero di intervalli:" << std::endl;
+	typedef bst_interval<int> interval;
+	interval_tree<int, compare_int, equal_int> intervals;
+	intervals.insert(interval(1, 100));
+	intervals.insert(interval(5, 6));
+	intervals.insert(interval(10, 50));
+	intervals.compact(bst_layout_breadth_first);
+	intervals.erase(interval(1, 100));
+	std::vector<interval> found;
+	intervals.stabbing(70, std::back_inserter(found));
+	assert(found.empty());
+	intervals.stabbing(20, std::back_inserter(found));
+	assert(found.size() == 1 && found[0].low == 10);
+	std::cout << intervals << std::endl;
+}
+
+void test_bst_loader(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sul caricamento parallelo da file ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "assign_sorted:" << std::endl;
+	int sorted[5] = {1, 3, 5, 7, 9};
+	bst_int tree;
+	tree.insert(4);
+	tree.assign_sorted(sorted, sorted + 5);
+	assert(tree.size() == 5 && !tree.exists(4) && tree.min() == 1 && tree.max() == 9);
+	std::cout << tree << std::endl; // bilanciato: la radice e' il valore centrale
+	assert(*tree.begin() == 5);
+	int unsorted[3] = {1, 3, 3};
+	bool thrown = false;
+	try {
+		tree.assign_sorted(unsorted, unsorted + 3);
+	}
+	catch(const std::invalid_argument &) {
+		thrown = true;
+	}
+	assert(thrown && tree.size() == 5);
+	tree.insert(4); // resta modificabile
+	tree.erase(5);
+	assert(std::vector<int>(tree.sorted_begin(), tree.sorted_end()) == std::vector<int>({1, 3, 4, 7, 9}));
+	std::cout << std::endl;
+	
+	const std::string path = "test_loader";
+	bst_load_options options;
+	options.threads = 3;
+	options.chunk_bytes = 7; // blocchi piu' piccoli di alcuni valori
+	
+	std::cout << "Interi in formato testo:" << std::endl;
+	std::set<int> reference;
+	std::ostringstream text;
+	unsigned int seed = 99;
+	for(unsigned int i = 0; i < 500; ++i) {
+		seed = seed * 1103515245 + 12345;
+		int value = static_cast<int>((seed >> 8) % 2000) - 1000;
+		reference.insert(value);
+		text << value << (i % 7 == 0 ? "\r\n" : (i % 3 == 0 ? "  \t" : "\n"));
+	}
+	text << INT_MIN << " +" << INT_MAX; // l'ultimo valore non ha fine riga
+	reference.insert(INT_MIN);
+	reference.insert(INT_MAX);
+	std::FILE *file = std::fopen(path.c_str(), "wb");
+	std::fputs(text.str().c_str(), file);
+	std::fclose(file);
+	
+	bst_int loaded;
+	assert(bst_load(path, loaded, bst_int_parser<int>(), options) == 502);
+	assert(std::vector<int>(loaded.sorted_begin(), loaded.sorted_end()) == std::vector<int>(reference.begin(), reference.end()));
+	std::cout << "Valori distinti: " << loaded.size() << std::endl;
+	
+	bst_int defaults;
+	bst_load(path, defaults, bst_int_parser<int>());
+	assert(defaults.size() == reference.size());
+	
+	// gli alberi derivati aggiornano le proprie strutture
+	filtered_binary_search_tree<int, compare_int, equal_int, hash_int> filtered;
+	bst_load(path, filtered, bst_int_parser<int>(), options);
+	assert(filtered.size() == reference.size());
+	for(std::set<int>::const_iterator r = reference.begin(); r != reference.end(); ++r)
+		assert(filtered.exists(*r));
+	assert(filtered.filter_stats().false_positives == 0 && filtered.filter_stats().filtered == 0);
+	hashed_bst_int hashed;
+	bst_load(path, hashed, bst_int_parser<int>(), options);
+	hashed_bst_int inserted;
+	inserted.insert_batch(reference.begin(), reference.end());
+	assert(hashed.hash() != 0 && hashed.hash() == inserted.hash() && hashed == inserted);
+	
+	const char *invalid[3] = {"1 2 x3\n", "1 2147483648\n", "1 2-\n"};
+	for(unsigned int i = 0; i < 3; ++i) {
+		file = std::fopen(path.c_str(), "wb");
+		std::fputs(invalid[i], file);
+		std::fclose(file);
+		thrown = false;
+		try {
+			bst_load(path, loaded, bst_int_parser<int>(), options);
+		}
+		catch(const bst_io_exception &e) {
+			std::cout << e.what() << e.get_path() << std::endl;
+			thrown = true;
+		}
+		assert(thrown && loaded.size() == reference.size()); // l'albero non cambia
+	}
+	std::cout << std::endl;
+	
+	std::cout << "Stringhe, una per riga:" << std::endl;
+	file = std::fopen(path.c_str(), "wb");
+	std::fputs("pera\nmela\r\n\nbanana\nmela\nalbicocca", file);
+	std::fclose(file);
+	binary_search_tree<std::string, compare_string_lexicographic, equal_string_content> words;
+	assert(bst_load(path, words, bst_line_parser(), options) == 5);
+	std::cout << words << std::endl;
+	assert(words.size() == 4 && words.min() == "albicocca" && words.exists("mela"));
+	std::cout << std::endl;
+	
+	std::cout << "Record binari:" << std::endl;
+	std::vector<int> records;
+	for(int i = 0; i < 1000; ++i)
+		records.push_back((i * 7919) % 1000);
+	file = std::fopen(path.c_str(), "wb");
+	std::fwrite(records.data(), sizeof(int), records.size(), file);
+	std::fclose(file);
+	bst_int binary;
+	assert(bst_load(path, binary, bst_record_parser<int>(), options) == 1000);
+	assert(binary.size() == 1000 && binary.min() == 0 && binary.max() == 999);
+	
+	file = std::fopen(path.c_str(), "ab");
+	std::fputc(0, file); // record incompleto
+	std::fclose(file);
+	thrown = false;
+	try {
+		bst_load(path, binary, bst_record_parser<int>(), options);
+	}
+	catch(const bst_io_exception &e) {
+		std::cout << e.what() << e.get_path() << std::endl;
+		thrown = true;
+	}
+	assert(thrown);
+	std::remove(path.c_str());
+	
+	thrown = false;
+	try {
+		bst_load(path, binary, bst_record_parser<int>());
+	}
+	catch(const bst_io_exception &e) {
+		std::cout << e.what() << e.get_path() << std::endl;
+		thrown = true;
+	}
+	assert(thrown && binary.size() == 1000);
+}
+
+void test_bst_split_join(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test su divisione, unione ed estrazione ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Divisione e unione:" << std::endl;
+	bst_int tree;
+	int values[9] = {50, 20, 80, 10, 30, 60, 90, 25, 35};
+	for(unsigned int i = 0; i < 9; ++i)
+		tree.insert(values[i]);
+	const int *address = &*tree.find(30);
+	
+	bst_int greater;
+	greater.insert(1000); // viene eliminato
+	tree.split(30, greater);
+	std::cout << tree << " " << greater << std::endl;
+	assert(std::vector<int>(tree.sorted_begin(), tree.sorted_end()) == std::vector<int>({10, 20, 25}));
+	assert(std::vector<int>(greater.sorted_begin(), greater.sorted_end()) == std::vector<int>({30, 35, 50, 60, 80, 90}));
+	assert(tree.size() == 3 && greater.size() == 6);
+	assert(tree.max() == 25 && greater.min() == 30 && greater.max() == 90);
+	assert(&*greater.find(30) == address); // nessuna copia
+	
+	bool thrown = false;
+	try {
+		greater.join(tree); // valori non separati
+	}
+	catch(const std::invalid_argument &) {
+		thrown = true;
+	}
+	assert(thrown && tree.size() == 3 && greater.size() == 6);
+	
+	tree.join(greater);
+	std::cout << tree << std::endl;
+	assert(greater.size() == 0 && tree.size() == 9 && tree.min() == 10 && tree.max() == 90);
+	assert(&*tree.find(30) == address);
+	
+	bst_int empty;
+	tree.split(0, greater); // tutto in greater
+	assert(tree.size() == 0 && greater.size() == 9);
+	greater.split(100, empty); // niente in empty
+	assert(greater.size() == 9 && empty.size() == 0);
+	tree.join(greater);
+	assert(tree.size() == 9 && greater.size() == 0);
+	std::cout << std::endl;
+	
+	std::cout << "Estrazione e inserimento di nodi:" << std::endl;
+	bst_int other;
+	bst_int::node_handle handle = tree.extract(30);
+	assert(!handle.empty() && handle.value() == 30 && !tree.exists(30) && tree.size() == 8);
+	assert(&handle.value() == address);
+	handle.value() = 40;
+	assert(other.insert(std::move(handle)).second && handle.empty());
+	assert(&*other.find(40) == address);
+	assert(tree.extract(30).empty());
+	assert(!other.insert(bst_int::node_handle()).second);
+	
+	handle = tree.extract(50);
+	handle.value() = 40;
+	assert(!other.insert(std::move(handle)).second && !handle.empty()); // duplicato: il nodo resta
+	handle = tree.extract(10); // il nodo precedente viene deallocato
+	std::cout << tree << " " << other << std::endl;
+	assert(tree.size() == 6 && other.size() == 1);
+	std::cout << std::endl;
+	
+	std::cout << "Confronto con std::set, con nodi compattati:" << std::endl;
+	bst_int left;
+	bst_int right;
+	std::set<int> left_reference;
+	std::set<int> right_reference;
+	unsigned int seed = 2024;
+	for(unsigned int i = 0; i < 3000; ++i) {
+		seed = seed * 1103515245 + 12345;
+		int value = static_cast<int>((seed >> 8) % 4000);
+		left.try_insert(value);
+		left_reference.insert(value);
+	}
+	left.compact(bst_layout_breadth_first);
+	std::vector<bst_int::node_handle> handles;
+	for(unsigned int round = 0; round < 200; ++round) {
+		seed = seed * 1103515245 + 12345;
+		int key = static_cast<int>((seed >> 8) % 4000);
+		switch(round % 4) {
+			case 0: { // divisione e riunione
+				left.join(right);
+				left_reference.insert(right_reference.begin(), right_reference.end());
+				right_reference.clear();
+				left.split(key, right);
+				right_reference.insert(left_reference.lower_bound(key), left_reference.end());
+				left_reference.erase(left_reference.lower_bound(key), left_reference.end());
+				break;
+			}
+			case 1: { // spostamento del massimo di left in right
+				if(left_reference.empty())
+					break;
+				int value = *left_reference.rbegin();
+				bst_int::node_handle moved = left.extract(value);
+				assert(!moved.empty());
+				left_reference.erase(value);
+				if(right.insert(std::move(moved)).second)
+					right_reference.insert(value);
+				break;
+			}
+			case 2: // nodi tenuti fuori dagli alberi
+				handles.push_back(right.extract(key));
+				if(!handles.back().empty())
+					right_reference.erase(key);
+				break;
+			default:
+				if(round % 8 == 3)
+					right.compact(bst_layout_van_emde_boas);
+				else
+					handles.clear(); // deallocazione di nodi estratti
+		}
+		assert(left.size() == left_reference.size() && right.size() == right_reference.size());
+	}
+	assert(std::vector<int>(left.sorted_begin(), left.sorted_end()) == std::vector<int>(left_reference.begin(), left_reference.end()));
+	assert(std::vector<int>(right.sorted_begin(), right.sorted_end()) == std::vector<int>(right_reference.begin(), right_reference.end()));
+	if(!left_reference.empty() && !right_reference.empty())
+		assert(left.max() == *left_reference.rbegin() && right.min() == *right_reference.begin());
+	std::cout << "Dimensioni: " << left.size() << ", " << right.size() << std::endl;
+	std::cout << std::endl;
+	
+	std::cout << "Alberi derivati:" << std::endl;
+	hashed_bst_int hashed;
+	hashed_bst_int hashed_greater;
+	hashed_bst_int expected_less;
+	hashed_bst_int expected_greater;
+	for(int i = 0; i < 50; ++i) {
+		hashed.insert(i);
+		(i < 20 ? expected_less : expected_greater).insert(i);
+	}
+	hashed.split(20, hashed_greater);
+	assert(hashed == expected_less && hashed_greater == expected_greater);
+	hashed_bst_int::node_handle moved = hashed_greater.extract(49);
+	expected_greater.erase(49);
+	assert(hashed_greater == expected_greater);
+	hashed.join(hashed_greater);
+	assert(hashed.hash() == expected_less.hash() + expected_greater.hash());
+	hashed.insert(std::move(moved));
+	hashed_bst_int all;
+	int sequence[50];
+	for(int i = 0; i < 50; ++i)
+		sequence[i] = i;
+	all.assign_sorted(sequence, sequence + 50);
+	assert(hashed == all);
+	
+	typedef filtered_binary_search_tree<int, compare_int, equal_int, hash_int> filtered_bst;
+	filtered_bst filtered;
+	filtered_bst filtered_greater;
+	for(int i = 0; i < 100; ++i)
+		filtered.insert(i);
+	filtered.split(60, filtered_greater);
+	assert(filtered.exists(59) && !filtered.exists(60) && filtered_greater.exists(60) && !filtered_greater.exists(59));
+	filtered.insert(filtered_greater.extract(99));
+	assert(filtered.exists(99) && !filtered_greater.exists(99));
+	filtered.erase(99);
+	filtered.join(filtered_greater);
+	assert(filtered.exists(98) && filtered.size() == 99);
+	filtered.assign_sorted(sequence, sequence + 10);
+	assert(filtered.exists(9) && !filtered.exists(10));
+	
+	typedef bst_interval<int> interval;
+	interval_tree<int, compare_int, equal_int> intervals;
+	interval_tree<int, compare_int, equal_int> later;
+	for(int i = 0; i < 20; ++i)
+		intervals.insert(interval(i * 10, i * 10 + (i == 3 ? 500 : 5)));
+	intervals.split(interval(100, 0), later);
+	std::vector<interval> found;
+	intervals.stabbing(300, std::back_inserter(found)); // [30, 530] resta a sinistra
+	assert(found.size() == 1 && found[0].low == 30);
+	found.clear();
+	later.stabbing(32, std::back_inserter(found));
+	assert(found.empty());
+	interval_tree<int, compare_int, equal_int>::node_handle wide = intervals.extract(interval(30, 530));
+	assert(!wide.empty());
+	found.clear();
+	intervals.stabbing(300, std::back_inserter(found));
+	assert(found.empty());
+	later.insert(std::move(wide));
+	later.stabbing(300, std::back_inserter(found));
+	assert(found.size() == 1 && later.size() == 11);
+	intervals.insert(later.extract(interval(30, 530)));
+	intervals.join(later);
+	found.clear();
+	intervals.stabbing(300, std::back_inserter(found));
+	assert(found.size() == 1 && intervals.size() == 20 && later.size() == 0);
+	std::cout << intervals << std::endl;
+}
+
+void test_bst_trace(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sulla registrazione di tracce ********" << std::endl;
+	std::cout << std::endl;
+	
+	const std::string path = "test_trace";
+	std::cout << "Registrazione di un albero di interi:" << std::endl;
+	unsigned long long bytes = 0;
+	{
+		recording_binary_search_tree<int, compare_int, equal_int, bst_pod_codec<int> > tree(path);
+		bst_int plain;
+		int values[6] = {5, 2, 8, -1, 3, 8};
+		for(unsigned int i = 0; i < 6; ++i) {
+			bool duplicated = false;
+			try {
+				tree.insert(values[i]);
+			}
+			catch(bst_duplicated_value_exception<int> &e) {
+				duplicated = true;
+			}
+			assert(duplicated == (i == 5)); // registrata anche se lancia
+			if(!duplicated)
+				plain.insert(values[i]);
+		}
+		assert(tree.exists(3) && !tree.exists(4));
+		tree.erase(2);
+		plain.erase(2);
+		assert(tree.subtree(8).size() == 1);
+		std::vector<int> copy;
+		tree.copy_in_order(std::back_inserter(copy));
+		assert(copy == std::vector<int>(plain.sorted_begin(), plain.sorted_end()));
+		int sum = 0;
+		tree.for_each([&sum](int value) { sum += value; });
+		assert(sum == 15);
+		for(unsigned int i = 0; i < copy.size(); ++i)
+			std::cout << copy[i] << " ";
+		std::cout << std::endl;
+		assert(tree.size() == 4 && tree.min() == -1 && tree.max() == 8);
+		assert(tree.trace().records() == 12);
+		bytes = tree.trace().bytes();
+		assert(bytes == 12 + 12 + 10 * sizeof(int)); // intestazione, operazioni, chiavi
+		tree.flush_trace();
+	}
+	
+	std::cout << "Rilettura:" << std::endl;
+	assert((bst_trace_reader<int, bst_pod_codec<int> >::key_size(path) == sizeof(int)));
+	{
+		bst_trace_reader<int, bst_pod_codec<int> > reader(path);
+		bst_operation ops[12] = {bst_op_insert, bst_op_insert, bst_op_insert, bst_op_insert, bst_op_insert, bst_op_insert,
+			bst_op_exists, bst_op_exists, bst_op_erase, bst_op_subtree, bst_op_copy_in_order, bst_op_iteration};
+		int keys[10] = {5, 2, 8, -1, 3, 8, 3, 4, 2, 8};
+		bst_operation op;
+		int key = 0;
+		for(unsigned int i = 0; i < 12; ++i) {
+			assert(reader.next(op, key) && op == ops[i]);
+			if(i < 10)
+				assert(key == keys[i]);
+		}
+		assert(!reader.next(op, key));
+		std::cout << "12 operazioni rilette" << std::endl;
+	}
+	
+	std::cout << "Chiavi a dimensione variabile:" << std::endl;
+	{
+		recording_binary_search_tree<std::string, compare_string_lexicographic, equal_string_content, bst_string_codec> strings(path);
+		strings.insert("");
+		strings.insert(std::string(200, 'x')); // lunghezza su due byte
+		strings.insert("albero");
+		assert(strings.exists("albero"));
+	}
+	assert((bst_trace_reader<std::string, bst_string_codec>::key_size(path) == 0));
+	{
+		bst_trace_reader<std::string, bst_string_codec> reader(path);
+		bst_operation op;
+		std::string key;
+		assert(reader.next(op, key) && op == bst_op_insert && key.empty());
+		assert(reader.next(op, key) && op == bst_op_insert && key == std::string(200, 'x'));
+		assert(reader.next(op, key) && key == "albero");
+		assert(reader.next(op, key) && op == bst_op_exists && key == "albero");
+		assert(!reader.next(op, key));
+	}
+	
+	std::cout << "Tracce non valide:" << std::endl;
+	bool thrown = false;
+	try {
+		bst_trace_reader<int, bst_pod_codec<int> > wrong(path); // chiavi di tipo diverso
+	}
+	catch(bst_io_exception &e) {
+		thrown = true;
+	}
+	assert(thrown);
+	std::FILE *file = std::fopen(path.c_str(), "wb");
+	std::fputs("BSTTRCE1", file);
+	std::fputc(4, file);
+	std::fputc(0, file);
+	std::fputc(0, file);
+	std::fputc(0, file);
+	std::fputc(bst_op_insert, file);
+	std::fputc(1, file); // chiave troncata
+	std::fclose(file);
+	thrown = false;
+	{
+		bst_trace_reader<int, bst_pod_codec<int> > truncated(path);
+		bst_operation op;
+		int key;
+		try {
+			truncated.next(op, key);
+		}
+		catch(bst_io_exception &e) {
+			thrown = true;
+			std::cout << e.what() << e.get_path() << std::endl;
+		}
+	}
+	assert(thrown);
+	std::remove(path.c_str());
+}
+
+void test_bst_multiset(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sul multiinsieme con conteggio ********" << std::endl;
+	std::cout << std::endl;
+	
+	bst_multiset<int, compare_int, equal_int> events;
+	assert(events.size() == 0 && events.distinct() == 0 && events.begin() == events.end());
+	
+	std::cout << "Inserimento di valori ripetuti:" << std::endl;
+	int values[9] = {5, 3, 5, 8, 3, 5, -2, 8, 5};
+	for(unsigned int i = 0; i < 9; ++i)
+		events.insert(values[i]); // nessuna eccezione per i duplicati
+	assert(events.insert(3, 2) == 4);
+	assert(events.insert(7, 0) == 0 && !events.exists(7));
+	std::cout << events << std::endl;
+	assert(events.size() == 11 && events.distinct() == 4);
+	assert(events.count(5) == 4 && events.count(3) == 4 && events.count(8) == 2 && events.count(-2) == 1);
+	assert(events.count(4) == 0 && events.exists(-2) && !events.exists(4));
+	
+	std::cout << "Valori distinti: ";
+	std::vector<int> once(events.begin(), events.end());
+	assert(once == std::vector<int>({-2, 3, 5, 8}));
+	bst_multiset<int, compare_int, equal_int>::const_iterator i, ie;
+	for(i = events.begin(), ie = events.end(); i != ie; ++i)
+		std::cout << *i << "x" << i.count() << " ";
+	std::cout << std::endl;
+	
+	std::cout << "Valori con molteplicita': ";
+	std::vector<int> all(events.multiplicity_begin(), events.multiplicity_end());
+	assert(all == std::vector<int>({-2, 3, 3, 3, 3, 5, 5, 5, 5, 8, 8}));
+	for(i = events.multiplicity_begin(), ie = events.multiplicity_end(); i != ie; i++)
+		std::cout << *i << " ";
+	std::cout << std::endl;
+	
+	std::cout << "Rimozione:" << std::endl;
+	assert(events.erase(5) == 1 && events.count(5) == 3);
+	assert(events.erase(8, 5) == 2 && !events.exists(8)); // il nodo viene rimosso
+	assert(events.erase(8) == 0 && events.erase(42) == 0); // valori assenti: nessuna eccezione
+	assert(events.erase_all(3) == 4 && events.count(3) == 0);
+	std::cout << events << std::endl;
+	assert(events.size() == 4 && events.distinct() == 2);
+	
+	bst_multiset<int, compare_int, equal_int> copy(events);
+	copy.insert(-2);
+	assert(copy.count(-2) == 2 && events.count(-2) == 1);
+	events.erase(-2);
+	events.erase_all(5);
+	assert(events.size() == 0 && events.distinct() == 0 && events.multiplicity_begin() == events.multiplicity_end());
+	
+	std::cout << "Confronto con std::multiset:" << std::endl;
+	bst_multiset<std::string, compare_string_lexicographic, equal_string_content> words;
+	std::multiset<std::string> reference;
+	unsigned int seed = 49;
+	for(unsigned int k = 0; k < 2000; ++k) {
+		seed = seed * 1103515245 + 12345;
+		std::string word(1, static_cast<char>('a' + (seed >> 16) % 20));
+		if((seed >> 8) % 3 == 0) {
+			std::multiset<std::string>::iterator found = reference.find(word);
+			assert(words.erase(word) == (found == reference.end() ? 0 : 1));
+			if(found != reference.end())
+				reference.erase(found);
+		}
+		else {
+			words.insert(word);
+			reference.insert(word);
+		}
+	}
+	assert(words.size() == reference.size());
+	assert(std::vector<std::string>(words.multiplicity_begin(), words.multiplicity_end()) ==
+		std::vector<std::string>(reference.begin(), reference.end()));
+	std::cout << words << std::endl;
+}
+
+/**
+	@brief Funtore di dimensione delle stringhe
+
+	Funtore che attribuisce a una stringa il numero dei suoi caratteri.
+*/
+struct string_length {
+	std::size_t operator()(const std::string &s) const {
+		return s.size();
+	}
+};
+
+void test_bst_lru_cache(void) {
+	
+	std::cout << std::endl;
+	std::cout << "******** Test sulla cache con rimozione LRU ********" << std::endl;
+	std::cout << std::endl;
+	
+	std::vector<int> evicted;
+	bst_lru_cache<int, compare_int, equal_int> cache(4, 0, [&evicted](int value) { evicted.push_back(value); });
+	
+	std::cout << "Inserimento oltre la capacita':" << std::endl;
+	int values[4] = {50, 20, 80, 10};
+	for(unsigned int i = 0; i < 4; ++i)
+		assert(cache.insert(values[i]));
+	assert(cache.size() == 4 && evicted.empty() && *cache.least_recent() == 50 && *cache.most_recent() == 10);
+	assert(cache.find(50) != nullptr && *cache.find(50) == 50); // 50 diventa il piu' recente
+	assert(cache.exists(20)); // exists non modifica l'ordine
+	assert(cache.insert(30));
+	assert(evicted == std::vector<int>({20}) && !cache.exists(20) && cache.size() == 4);
+	assert(!cache.insert(80)); // aggiornamento: 80 diventa il piu' recente
+	assert(cache.insert(90) && cache.insert(60));
+	assert(evicted == std::vector<int>({20, 10, 50}));
+	std::cout << cache << std::endl;
+	assert(std::vector<int>(cache.begin(), cache.end()) == std::vector<int>({30, 60, 80, 90}));
+	
+	std::cout << "Intervalli ordinati:" << std::endl;
+	std::vector<int> range;
+	cache.copy_range(40, 90, std::back_inserter(range));
+	assert(range == std::vector<int>({60, 80}));
+	assert(*cache.lower_bound(61) == 80 && cache.lower_bound(91) == cache.end());
+	assert(*cache.least_recent() == 30); // le visite non modificano l'ordine
+	
+	std::cout << "Rimozione e modifica dei limiti:" << std::endl;
+	assert(cache.erase(30) && !cache.erase(30));
+	assert(evicted.size() == 3 && *cache.least_recent() == 80);
+	cache.set_capacity(2);
+	assert(evicted == std::vector<int>({20, 10, 50, 80}) && cache.size() == 2);
+	std::cout << cache << std::endl;
+	
+	bst_lru_cache<int, compare_int, equal_int> copy(cache);
+	copy.set_eviction_callback(bst_lru_cache<int, compare_int, equal_int>::eviction_callback());
+	copy.insert(1);
+	assert(*copy.least_recent() == 60 && copy.size() == 2 && cache.exists(90) && evicted.size() == 4);
+	copy = cache;
+	assert(std::vector<int>(copy.begin(), copy.end()) == std::vector<int>({60, 90}) && *copy.most_recent() == 60);
+	
+	bool thrown = false;
+	try {
+		bst_lru_cache<int, compare_int, equal_int> empty(0);
+	}
+	catch(const std::invalid_argument &) {
+		thrown = true;
+	}
+	assert(thrown);
+	
+	std::cout << "Limite in byte:" << std::endl;
+	std::vector<std::string> dropped;
+	bst_lru_cache<std::string, compare_string_lexicographic, equal_string_content, string_length>
+		strings(100, 10, [&dropped](const std::string &s) { dropped.push_back(s); });
+	strings.insert("alfa");
+	strings.insert("beta");
+	assert(strings.bytes() == 8 && dropped.empty());
+	strings.insert("gamma");
+	assert(strings.bytes() == 9 && dropped == std::vector<std::string>({"alfa"}));
+	strings.insert("un valore lungo"); // resta anche se supera il limite da solo
+	assert(strings.size() == 1 && strings.bytes() == 15 && dropped.size() == 3);
+	std::cout << strings << std::endl;
+	
+	std::cout << "Confronto con un modello:" << std::endl;
+	bst_lru_cache<int, compare_int, equal_int> lru(50);
+	std::vector<int> model; // dal meno al piu' recente
+	unsigned int seed = 50;
+	for(unsigned int k = 0; k < 5000; ++k) {
+		seed = seed * 1103515245 + 12345;
+		int value = static_cast<int>((seed >> 8) % 200);
+		std::vector<int>::iterator position = std::find(model.begin(), model.end(), value);
+		if((seed >> 20) % 2 == 0) {
+			assert((lru.find(value) != nullptr) == (position != model.end()));
+			if(position != model.end()) {
+				model.erase(position);
+				model.push_back(value);
+			}
+		}
+		else {
+			assert(lru.insert(value) == (position == model.end()));
+			if(position != model.end())
+				model.erase(position);
+			model.push_back(value);
+			if(model.size() > 50)
+				model.erase(model.begin());
+		}
+		assert(lru.size() == model.size() && *lru.least_recent() == model.front() && *lru.most_recent() == model.back());
+	}
+	std::vector<int> sorted(model);
+	std::sort(sorted.begin(), sorted.end());
+	assert(std::vector<int>(lru.begin(), lru.end()) == sorted);
+	bst_lru_cache<int, compare_int, equal_int> lru_copy(lru); // stesso ordine di utilizzo
+	assert(lru_copy.bytes() == lru.bytes());
+	std::vector<int> in_range;
+	lru_copy.copy_range(50, 150, std::back_inserter(in_range));
+	assert(in_range == std::vector<int>(std::lower_bound(sorted.begin(), sorted.end(), 50),
+										std::lower_bound(sorted.begin(), sorted.end(), 150)));
+	for(unsigned int i = 0; i < model.size(); ++i) {
+		assert(*lru_copy.least_recent() == model[i]);
+		lru_copy.erase(model[i]);
+	}
+	std::cout << lru.size() << " valori, come il modello" << std::endl;
+}
+
+void test(void) {
+	
+	std::cout << "**************** INIZIO TEST ****************" << std::endl << std::endl;
+	
+	std::cout << "Premere Invio per avviare il primo test..." << std::endl;
+	test_bst_int();
+	
+	test_continue();
+	test_bst_float();
+	
+	test_continue();
+	test_bst_bool();
+	
+	test_continue();
+	test_bst_string();
+	
+	test_continue();
+	test_bst_complex();
+	
+	test_continue();
+	test_bst_employee();
+	
+	test_continue();
+	test_bst_bst_int();
+	
+	test_continue();
+	test_compact_bst_int();
+	
+	test_continue();
+	test_compact_bst_complex();
+	
+	test_continue();
+	test_bst_batch();
+	
+	test_continue();
+	test_bst_insert_batch();
+	
+	test_continue();
+	test_bst_try_insert();
+	
+	test_continue();
+	test_splay_tree();
+	
+	test_continue();
+	test_bst_erase();
+	
+	test_continue();
+	test_filtered_bst();
+	
+	test_continue();
+	test_bst_map();
+	
+	test_continue();
+	test_static_bst();
+	
+	test_continue();
+	test_sharded_bst();
+	
+	test_continue();
+	test_hashed_bst();
+	
+	test_continue();
+	test_interval_tree();
+	
+	test_continue();
+	test_kd_tree();
+	
+	test_continue();
+	test_string_bst();
+	
+	test_continue();
+	test_journaled_bst();
+	
+	test_continue();
+	test_paged_bst();
+	
+	test_continue();
+	test_compressed_snapshot();
+	
+	test_continue();
+	test_latency();
+	
+	test_continue();
+	test_bst_min_max();
+	
+	test_continue();
+	test_merge_iterator();
+	
+	test_continue();
+	test_bst_relayout();
+	
+	test_continue();
+	test_bst_loader();
+	
+	test_continue();
+	test_bst_split_join();
+	
+	test_continue();
+	test_bst_trace();
+	
+	test_continue();
+	test_bst_multiset();
+	
+	test_continue();
+	test_bst_lru_cache();
 	
 	std::cout << std::endl << "**************** FINE TEST ****************" << std::endl;
 }
@@ -0,0 +1,304 @@
+/**
+	@file replay.cpp
+
+	@brief Riesecuzione di una traccia di operazioni su diverse
+	configurazioni di albero binario di ricerca
+
+	Uso: replay traccia [--json]
+
+	La traccia, registrata con recording_binary_search_tree, viene
+	caricata in memoria e rieseguita su ogni configurazione, partendo
+	da un albero vuoto. Per ogni configurazione vengono riportati
+	il throughput, i percentili di latenza di ogni operazione e la
+	memoria allocata (picco durante la riesecuzione e memoria ancora
+	allocata alla fine, cioe' l'occupazione dell'albero).
+*/
+
+// Direttive per il pre-compilatore
+
+#include <iostream> // std::cout, std::cerr, std::endl
+#include <iomanip> // std::setprecision
+#include <cstdlib> // std::malloc, std::free
+#include <cstddef> // std::size_t, std::max_align_t
+#include <cstring> // std::strcmp
+#include <new> // std::bad_alloc
+#include <vector> // std::vector
+#include <iterator> // std::back_inserter
+#include <string> // std::string
+#include <chrono> // std::chrono::steady_clock
+#include <functional> // std::hash
+#include "bst.h" // binary_search_tree
+#include "bsttypes.h" // funtori di confronto
+#include "bstsplay.h" // splay_tree
+#include "bstbloom.h" // filtered_binary_search_tree
+#include "bstlatency.h" // bst_latency_recorder, bst_cycle_clock
+#include "bsttrace.h" // bst_trace_reader
+
+/**
+	@brief Contatori della memoria allocata
+
+	Byte allocati con new e non ancora rilasciati, e loro picco.
+	Il programma e' a thread singolo, quindi i contatori non sono
+	sincronizzati.
+*/
+static std::size_t live_bytes = 0;
+static std::size_t peak_bytes = 0;
+
+/**
+	@brief Dimensione dell'intestazione di un blocco allocato
+
+	Ogni blocco e' preceduto dalla sua dimensione, con l'allineamento
+	massimo per non cambiare quello del blocco restituito.
+*/
+static const std::size_t header_size = alignof(std::max_align_t);
+
+/**
+	@brief Operatore new globale
+
+	Sostituisce l'operatore new di default per contare la memoria
+	allocata (anche quella delle librerie standard).
+*/
+void *operator new(std::size_t size) {
+	void *block = std::malloc(size + header_size);
+	if(block == nullptr)
+		throw std::bad_alloc();
+	*static_cast<std::size_t *>(block) = size;
+	live_bytes += size;
+	if(live_bytes > peak_bytes)
+		peak_bytes = live_bytes;
+	return static_cast<char *>(block) + header_size;
+}
+
+/**
+	@brief Operatore delete globale
+
+	Rilascia un blocco allocato con l'operatore new sostituito.
+*/
+void operator delete(void *pointer) noexcept {
+	if(pointer == nullptr)
+		return;
+	void *block = static_cast<char *>(pointer) - header_size;
+	live_bytes -= *static_cast<std::size_t *>(block);
+	std::free(block);
+}
+
+/**
+	@brief Traccia in memoria
+
+	Struttura che contiene le operazioni e le chiavi di una traccia,
+	caricate prima della riesecuzione per non misurare la lettura
+	del file.
+*/
+template <typename T>
+struct loaded_trace {
+	std::vector<unsigned char> ops; ///< operazioni
+	std::vector<T> keys; ///< chiavi (una per operazione, vuota se senza chiave)
+};
+
+/**
+	@brief Caricamento di una traccia
+
+	@param path percorso del file
+
+	@return traccia in memoria
+
+	@throw bst_io_exception se il file non puo' essere letto
+		   o non e' una traccia valida
+*/
+template <typename T, typename C>
+loaded_trace<T> load_trace(const std::string &path) {
+	loaded_trace<T> trace;
+	bst_trace_reader<T, C> reader(path);
+	bst_operation op;
+	T key = T();
+	while(reader.next(op, key)) {
+		trace.ops.push_back(static_cast<unsigned char>(op));
+		trace.keys.push_back(bst_trace_format::keyed(op) ? key : T());
+	}
+	return trace;
+}
+
+/**
+	@brief Esecuzione di un'operazione
+
+	Esegue un'operazione della traccia su un albero. Le eccezioni
+	per valori duplicati o non trovati fanno parte del carico
+	registrato e vengono ignorate.
+
+	@param tree albero
+	@param op operazione
+	@param key chiave dell'operazione
+
+	@return valore derivato dal risultato, per non far eliminare
+			l'operazione al compilatore
+*/
+template <typename T, typename B>
+std::size_t apply(B &tree, bst_operation op, const T &key) {
+	try {
+		switch(op) {
+		case bst_op_insert:
+			tree.insert(key);
+			return 1;
+		case bst_op_exists:
+			return tree.exists(key) ? 1 : 0;
+		case bst_op_erase:
+			tree.erase(key);
+			return 1;
+		case bst_op_subtree:
+			return tree.subtree(key).size();
+		case bst_op_iteration: {
+			std::size_t count = 0;
+			typename B::const_iterator i, ie;
+			for(i = tree.begin(), ie = tree.end(); i != ie; ++i)
+				++count;
+			return count;
+		}
+		case bst_op_copy_in_order: {
+			std::vector<T> values;
+			values.reserve(tree.size());
+			tree.copy_in_order(std::back_inserter(values));
+			return values.size();
+		}
+		default:
+			return 0;
+		}
+	}
+	catch(bst_duplicated_value_exception<T> &e) {}
+	catch(bst_value_not_found_exception<T> &e) {}
+	return 0;
+}
+
+/**
+	@brief Riesecuzione di una traccia su una configurazione
+
+	Riesegue la traccia su un albero vuoto e ne scrive i risultati.
+	Se relayout e' true, l'albero viene compattato in ordine
+	van Emde Boas ogni volta che la sua dimensione raddoppia
+	(il tempo della compattazione e' compreso nel throughput
+	ma non nelle latenze).
+
+	@param name nome della configurazione
+	@param trace traccia in memoria
+	@param tree albero vuoto
+	@param relayout true per compattare l'albero quando cresce
+	@param json true per scrivere i risultati in formato JSON
+	@param first true per la prima configurazione (formato JSON)
+*/
+template <typename T, typename B>
+void replay(const char *name, const loaded_trace<T> &trace, B &tree, bool relayout, bool json, bool first) {
+	bst_latency_recorder latency;
+	std::size_t base_bytes = live_bytes;
+	peak_bytes = live_bytes;
+	std::size_t checksum = 0;
+	std::size_t compacted = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(std::size_t i = 0; i < trace.ops.size(); ++i) {
+		bst_operation op = static_cast<bst_operation>(trace.ops[i]);
+		unsigned long long ticks = bst_cycle_clock::now();
+		checksum += apply(tree, op, trace.keys[i]);
+		latency.record(op, bst_cycle_clock::now() - ticks);
+		if(relayout && tree.size() >= 1024 && tree.size() >= 2 * compacted) {
+			tree.compact(bst_layout_van_emde_boas);
+			compacted = tree.size();
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double throughput = seconds > 0 ? trace.ops.size() / seconds : 0;
+
+	if(json) {
+		std::cout << (first ? "" : ",\n") << "  {\"config\": \"" << name << "\""
+				  << ", \"ops\": " << trace.ops.size()
+				  << ", \"ops_per_s\": " << std::fixed << std::setprecision(0) << throughput
+				  << ", \"peak_bytes\": " << peak_bytes - base_bytes
+				  << ", \"final_bytes\": " << live_bytes - base_bytes
+				  << ", \"final_size\": " << tree.size()
+				  << ", \"checksum\": " << checksum
+				  << ", \"latency\": ";
+		std::cout.unsetf(std::ios::floatfield);
+		std::cout << std::setprecision(6);
+		latency.write_json(std::cout);
+		std::cout << "}";
+		return;
+	}
+
+	std::cout << name << std::endl
+			  << "  ops=" << trace.ops.size()
+			  << " throughput=" << std::fixed << std::setprecision(0) << throughput << " ops/s"
+			  << " peak=" << (peak_bytes - base_bytes) / 1024 << " KB"
+			  << " final=" << (live_bytes - base_bytes) / 1024 << " KB"
+			  << " size=" << tree.size()
+			  << " checksum=" << checksum << std::endl;
+	std::cout.unsetf(std::ios::floatfield);
+	std::cout << std::setprecision(6);
+	latency.write_text(std::cout);
+}
+
+/**
+	@brief Riesecuzione su tutte le configurazioni
+
+	Ogni albero viene distrutto prima di passare alla configurazione
+	successiva, cosi' la memoria di ognuna e' misurata separatamente.
+
+	@param path percorso della traccia
+	@param json true per scrivere i risultati in formato JSON
+*/
+template <typename T, typename O, typename E, typename H, typename C>
+void replay_all(const std::string &path, bool json) {
+	loaded_trace<T> trace = load_trace<T, C>(path);
+
+	if(json)
+		std::cout << "[\n";
+	{
+		binary_search_tree<T, O, E> tree;
+		replay("binary_search_tree", trace, tree, false, json, true);
+	}
+	{
+		binary_search_tree<T, O, E> tree;
+		replay("binary_search_tree+van_emde_boas", trace, tree, true, json, false);
+	}
+	{
+		splay_tree<T, O, E> tree;
+		replay("splay_tree", trace, tree, false, json, false);
+	}
+	{
+		filtered_binary_search_tree<T, O, E, H> tree;
+		replay("filtered_binary_search_tree", trace, tree, false, json, false);
+	}
+	if(json)
+		std::cout << "\n]" << std::endl;
+}
+
+/**
+	@brief Funzione main
+
+	Sceglie il tipo delle chiavi dall'intestazione della traccia:
+	interi (chiavi di 4 byte) o stringhe (chiavi a dimensione variabile).
+*/
+int main(int argc, char *argv[]) {
+	if(argc < 2 || (argc > 2 && std::strcmp(argv[2], "--json") != 0)) {
+		std::cerr << "Uso: " << argv[0] << " traccia [--json]" << std::endl;
+		return 2;
+	}
+	std::string path = argv[1];
+	bool json = argc > 2;
+
+	try {
+		std::size_t key_size = bst_trace_reader<int, bst_pod_codec<int> >::key_size(path);
+		if(key_size == sizeof(int))
+			replay_all<int, compare_int, equal_int, hash_int, bst_pod_codec<int> >(path, json);
+		else if(key_size == 0)
+			replay_all<std::string, compare_string_lexicographic, equal_string_content,
+				std::hash<std::string>, bst_string_codec>(path, json);
+		else {
+			std::cerr << "Dimensione delle chiavi non supportata: " << key_size << std::endl;
+			return 1;
+		}
+	}
+	catch(bst_io_exception &e) {
+		std::cerr << e.what() << e.get_path() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}